@@ -0,0 +1,316 @@
+/**
+ * bench_api.cpp - Cost of the library's own request and parsing paths
+ *
+ * Replays Reddit responses (see bench_payloads.h) through the public API
+ * with ESPrawReplayTransport, so the numbers cover request building,
+ * streaming deserialization and the models, but no network. Token
+ * requests go to the local stand-in server, since the token engine talks
+ * to a socket directly.
+ *
+ * Prints one JSON object per scenario: time per operation, allocations
+ * and bytes allocated per operation, and the peak heap growth of one
+ * operation, as counted by the allocator in test/hal/Esp.h for this
+ * thread only (the stand-in server thread is left out).
+ *
+ * Usage: bench_api [fixtures directory]
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <functional>
+#include <vector>
+#include "bench_payloads.h"
+#include "standin_server.h"
+#include "ESPraw.h"
+#include "ESPrawTransport.h"
+#include "ESPrawCache.h"
+#include "models/Subreddit.h"
+#include "models/Submission.h"
+#include "models/Comment.h"
+#include "models/Redditor.h"
+
+// Rate limiting has its own benchmark; keep it out of these numbers
+class UnlimitedLimiter : public ESPrawRateLimiter {
+public:
+    bool canRequest(unsigned long) const override { return true; }
+    unsigned long timeUntilNextRequest(unsigned long) const override { return 0; }
+    void recordRequest(unsigned long) override {}
+    void reset() override {}
+};
+
+static volatile long sink;
+
+/**
+ * Time an operation and count its allocations
+ * @param name Scenario name
+ * @param iterations Number of runs
+ * @param op Operation; returns false on failure
+ */
+static void run(const char* name, unsigned long iterations, const std::function<bool()>& op) {
+    // Warm up: first calls fill lazily built state such as the filters
+    bool ok = op();
+
+    unsigned long allocationsBefore = ESP.getThreadAllocations();
+    unsigned long bytesBefore = ESP.getThreadBytesAllocated();
+    long peak = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < iterations; i++) {
+        long baseline = ESP.getThreadHeapUsed();
+        ESP.resetThreadPeakHeap();
+        ok = op() && ok;
+        if (ESP.getThreadPeakHeap() - baseline > peak) {
+            peak = ESP.getThreadPeakHeap() - baseline;
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    unsigned long allocations = ESP.getThreadAllocations() - allocationsBefore;
+    unsigned long bytes = ESP.getThreadBytesAllocated() - bytesBefore;
+
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    printf("{\"scenario\": \"%s\", \"version\": \"%s\", \"iterations\": %lu, "
+           "\"ns_per_op\": %.0f, \"allocs_per_op\": %.1f, \"bytes_per_op\": %.0f, "
+           "\"peak_heap_bytes\": %ld, \"ok\": %s}\n",
+           name, ESPRAW_VERSION, iterations, ns,
+           (double)allocations / iterations, (double)bytes / iterations,
+           peak, ok ? "true" : "false");
+    fflush(stdout);
+}
+
+/**
+ * Parse every child of a listing into a model
+ */
+template <typename Model>
+static bool parseChildren(JsonArray children) {
+    for (JsonObject child : children) {
+        Model model(nullptr, JsonObject());
+        model.parseData(child["data"]);
+        sink = model.getScore();
+    }
+    return children.size() > 0;
+}
+
+/**
+ * Wrap every child of a listing in a lazy model and read only its score
+ */
+template <typename Model>
+static bool lazyChildren(JsonArray children) {
+    for (JsonObject child : children) {
+        Model model(nullptr, child["data"], ESPrawParseMode::LAZY);
+        sink = model.getScore();
+    }
+    return children.size() > 0;
+}
+
+/**
+ * Parse every child of a listing into models that are all kept at once
+ * @param espraw Instance whose string pool the models use
+ */
+template <typename Model>
+static bool keepChildren(JsonArray children, ESPraw* espraw) {
+    std::vector<Model> models;
+    models.reserve(children.size());
+    for (JsonObject child : children) {
+        models.emplace_back(espraw, child["data"].as<JsonObject>());
+    }
+    if (models.empty()) {
+        return false;
+    }
+    sink = models.back().getScore();
+    return true;
+}
+
+/**
+ * Store every child of a listing as a view in an arena
+ */
+template <typename View>
+static bool viewChildren(JsonArray children, ESPrawArena& arena) {
+    arena.reset();
+    for (JsonObject child : children) {
+        View* view = View::create(arena, child["data"]);
+        if (view == nullptr) {
+            return false;
+        }
+        sink = view->score;
+    }
+    return children.size() > 0;
+}
+
+int main(int argc, char** argv) {
+    const char* fixtures = argc > 1 ? argv[1] : nullptr;
+
+    String hot = benchPayload(fixtures, "hot_listing", benchHotListing);
+    String thread = benchPayload(fixtures, "comment_thread", benchCommentThread);
+    String subredditAbout = benchPayload(fixtures, "subreddit_about", benchSubredditAbout);
+    String redditorAbout = benchPayload(fixtures, "redditor_about", benchRedditorAbout);
+
+    StandinServer tokenServer;
+    tokenServer.body = benchTokenResponse();
+    if (!tokenServer.start()) {
+        fprintf(stderr, "Failed to start the token stand-in server\n");
+        return 1;
+    }
+
+    ESPrawAuthConfig config;
+    config.clientId = "bench";
+    config.clientSecret = "bench";
+    config.userAgent = "ESPraw-bench/" ESPRAW_VERSION;
+    config.readOnlyMode = true;
+    config.authBaseUrl = "http://127.0.0.1:" + String(tokenServer.port());
+
+    ESPraw reddit;
+    if (!reddit.begin(config)) {
+        fprintf(stderr, "Failed to authenticate against the stand-in server\n");
+        return 1;
+    }
+
+    UnlimitedLimiter unlimited;
+    ESPrawReplayTransport replay;
+    reddit.getClient().setRateLimiter(&unlimited);
+    reddit.getClient().setTransport(&replay);
+    replay.addResponse("/r/esp32/hot", 200, hot);
+    replay.addResponse("/r/esp32/about", 200, subredditAbout);
+    replay.addResponse("/user/maker1/about", 200, redditorAbout);
+    replay.addResponse("/comments/", 200, thread);
+    replay.addResponse("/api/info", 200, hot);
+    replay.addResponse("/api/v1/me", 200, "{}");
+
+    // Token response over the loopback stand-in
+    run("token_refresh", 200, [&]() {
+        return reddit.getAuth().refreshToken();
+    });
+
+    // Request building and bookkeeping around a trivial response
+    run("request_overhead", 20000, [&]() {
+        return reddit.get("/api/v1/me").success;
+    });
+
+    run("subreddit_hot", 2000, [&]() {
+        Subreddit subreddit(&reddit, "esp32");
+        DynamicJsonDocument doc(32768);
+        return subreddit.hot(doc, 25) && doc["data"]["children"].size() == 25;
+    });
+
+    run("subreddit_about", 5000, [&]() {
+        Subreddit subreddit(&reddit, "esp32");
+        return subreddit.fetch();
+    });
+
+    run("redditor_about", 5000, [&]() {
+        Redditor redditor(&reddit, "maker1");
+        return redditor.fetch();
+    });
+
+    // The same fetch answered from a warm response cache
+    ESPrawResponseCache cache;
+    reddit.getClient().setCache(&cache);
+    run("subreddit_about_cached", 100000, [&]() {
+        Subreddit subreddit(&reddit, "esp32");
+        return subreddit.fetch();
+    });
+    reddit.getClient().setCache(nullptr);
+
+    run("submission_by_id", 500, [&]() {
+        return reddit.submission("p00000") != nullptr;
+    });
+
+    // Factory lookups with objects on the heap and then from a pool
+    run("subreddit_lookup", 100000, [&]() {
+        return reddit.subreddit("esp32") != nullptr;
+    });
+    ESPrawPool<Subreddit> subreddits(4);
+    reddit.setSubredditPool(&subreddits);
+    run("subreddit_lookup_pooled", 100000, [&]() {
+        return reddit.subreddit("esp32") != nullptr;
+    });
+    reddit.setSubredditPool(nullptr);
+
+    // Refreshing 25 tracked posts with one /api/info request
+    std::vector<String> tracked;
+    for (int i = 0; i < 25; i++) {
+        char fullname[16];
+        snprintf(fullname, sizeof(fullname), "t3_p%05d", i);
+        tracked.push_back(fullname);
+    }
+    run("info_25", 2000, [&]() {
+        int score = 0;
+        int visited = reddit.info(tracked, [&](Submission& post) {
+            score += post.getScore();
+            return true;
+        });
+        sink = score;
+        return visited == 25;
+    });
+
+    DynamicJsonDocument post(JSON_OBJECT_SIZE(1));
+    post["id"] = "p00000";
+    Submission submission(&reddit, post.as<JsonObject>());
+    run("submission_comments_500", 200, [&]() {
+        DynamicJsonDocument doc(524288);
+        return submission.getComments(doc, 500) && doc.size() == 2;
+    });
+
+    // The same page parsed into a flat comment tree
+    CommentTree tree;
+    run("submission_comment_tree_500", 200, [&]() {
+        return submission.getComments(tree, 500) && tree.size() == 500;
+    });
+
+    // Model parsing alone, from documents deserialized once up front
+    DynamicJsonDocument hotDoc(262144);
+    deserializeJson(hotDoc, hot);
+    DynamicJsonDocument threadDoc(4194304);
+    deserializeJson(threadDoc, thread);
+    DynamicJsonDocument aboutDoc(16384);
+    deserializeJson(aboutDoc, subredditAbout);
+
+    run("parse_submissions_25", 20000, [&]() {
+        return parseChildren<Submission>(hotDoc["data"]["children"]);
+    });
+
+    run("parse_comments_100", 20000, [&]() {
+        return parseChildren<Comment>(threadDoc[1]["data"]["children"]);
+    });
+
+    // The same items, decoding only the field that is read
+    run("lazy_submissions_25", 20000, [&]() {
+        return lazyChildren<Submission>(hotDoc["data"]["children"]);
+    });
+
+    run("lazy_comments_100", 20000, [&]() {
+        return lazyChildren<Comment>(threadDoc[1]["data"]["children"]);
+    });
+
+    // All 100 comments held at once, then with repeated fields shared
+    run("keep_comments_100", 20000, [&]() {
+        return keepChildren<Comment>(threadDoc[1]["data"]["children"], &reddit);
+    });
+
+    ESPrawStringPool strings;
+    reddit.setStringPool(&strings);
+    run("keep_comments_100_interned", 20000, [&]() {
+        return keepChildren<Comment>(threadDoc[1]["data"]["children"], &reddit);
+    });
+    reddit.setStringPool(nullptr);
+
+    // The same items as arena views
+    ESPrawArena arena(65536);
+    run("view_submissions_25", 20000, [&]() {
+        return viewChildren<SubmissionView>(hotDoc["data"]["children"], arena);
+    });
+
+    run("view_comments_100", 20000, [&]() {
+        return viewChildren<CommentView>(threadDoc[1]["data"]["children"], arena);
+    });
+
+    run("parse_subreddit", 100000, [&]() {
+        Subreddit subreddit(nullptr, JsonObject());
+        subreddit.parseData(aboutDoc["data"]);
+        sink = subreddit.getSubscribers();
+        return subreddit.getName().length() > 0;
+    });
+
+    reddit.getClient().setTransport(nullptr);
+    reddit.getClient().setRateLimiter(nullptr);
+    return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * bench_payloads.h - Reddit responses replayed by the benchmarks
+ *
+ * Each payload is read from <fixtures>/<name>.json when present (see
+ * `make record`) and otherwise generated with the shape and typical size
+ * of the real response: listing children carry the ~100 fields Reddit
+ * sends, of which the models keep a handful.
+ */
+
+#ifndef BENCH_PAYLOADS_H
+#define BENCH_PAYLOADS_H
+
+#include <stdio.h>
+#include <string>
+
+// Fields Reddit sends with every post or comment that the models never read
+static const char* benchFiller() {
+    return "\"approved_at_utc\":null,\"gilded\":0,\"clicked\":false,\"hidden\":false,"
+           "\"pwls\":6,\"link_flair_css_class\":null,\"downs\":0,\"thumbnail_height\":140,"
+           "\"top_awarded_type\":null,\"hide_score\":false,\"quarantine\":false,"
+           "\"link_flair_text_color\":\"dark\",\"subreddit_type\":\"public\",\"ups\":42,"
+           "\"total_awards_received\":0,\"media_embed\":{},\"thumbnail_width\":140,"
+           "\"author_flair_template_id\":null,\"user_reports\":[],\"secure_media\":null,"
+           "\"is_reddit_media_domain\":false,\"is_meta\":false,\"category\":null,"
+           "\"secure_media_embed\":{},\"link_flair_text\":\"Project\",\"can_mod_post\":false,"
+           "\"approved_by\":null,\"is_created_from_ads_ui\":false,\"author_premium\":false,"
+           "\"thumbnail\":\"https://b.thumbs.redditmedia.com/abcdefghijklmnopqrstuvwxyz.jpg\","
+           "\"edited\":false,\"author_flair_css_class\":null,\"author_flair_richtext\":[],"
+           "\"gildings\":{},\"content_categories\":null,\"mod_note\":null,"
+           "\"link_flair_type\":\"text\",\"wls\":6,\"removed_by_category\":null,"
+           "\"banned_by\":null,\"author_flair_type\":\"text\",\"allow_live_comments\":false,"
+           "\"selftext_html\":\"&lt;!-- SC_OFF --&gt;&lt;div class=\\\"md\\\"&gt;&lt;p&gt;"
+           "Some text&lt;/p&gt;&lt;/div&gt;&lt;!-- SC_ON --&gt;\",\"likes\":null,"
+           "\"suggested_sort\":null,\"banned_at_utc\":null,\"view_count\":null,"
+           "\"archived\":false,\"no_follow\":false,\"is_crosspostable\":true,\"pinned\":false,"
+           "\"all_awardings\":[],\"awarders\":[],\"media_only\":false,"
+           "\"link_flair_template_id\":\"5d5d3e4e-0000-11ea-0000-0e0000000000\","
+           "\"can_gild\":false,\"author_flair_text\":null,\"treatment_tags\":[],"
+           "\"visited\":false,\"removed_by\":null,\"num_reports\":null,"
+           "\"distinguished\":null,\"subreddit_id\":\"t5_2xxxx\",\"author_is_blocked\":false,"
+           "\"mod_reason_by\":null,\"removal_reason\":null,\"link_flair_background_color\":\"\","
+           "\"report_reasons\":null,\"discussion_type\":null,\"send_replies\":true,"
+           "\"whitelist_status\":\"all_ads\",\"contest_mode\":false,\"mod_reports\":[],"
+           "\"author_patreon_flair\":false,\"author_flair_text_color\":null,"
+           "\"parent_whitelist_status\":\"all_ads\",\"subreddit_subscribers\":54321,"
+           "\"num_crossposts\":0,\"media\":null,\"is_video\":false";
+}
+
+static std::string benchPost(int index) {
+    char buffer[1024];
+    snprintf(buffer, sizeof(buffer),
+             ",\"id\":\"p%05d\",\"name\":\"t3_p%05d\","
+             "\"subreddit\":\"esp32\",\"author\":\"maker%d\","
+             "\"title\":\"ESP32 project number %d: reading sensors over WiFi and posting them\","
+             "\"selftext\":\"Wired up a BME280 and a small OLED, code is on GitHub.\","
+             "\"url\":\"https://www.reddit.com/r/esp32/comments/p%05d/\","
+             "\"domain\":\"self.esp32\",\"permalink\":\"/r/esp32/comments/p%05d/post/\","
+             "\"score\":%d,\"upvote_ratio\":0.97,\"num_comments\":%d,\"over_18\":false,"
+             "\"spoiler\":false,\"locked\":false,\"stickied\":false,\"is_self\":true,"
+             "\"created\":1700000000.0,\"created_utc\":1700000000.0}}",
+             index, index, index % 17, index, index, index, 100 + index * 7, index * 3);
+    return std::string("{\"kind\":\"t3\",\"data\":{") + benchFiller() + buffer;
+}
+
+static std::string benchComment(int index, int depth, const std::string& replies) {
+    char buffer[1024];
+    snprintf(buffer, sizeof(buffer),
+             ",\"id\":\"c%05d\",\"name\":\"t1_c%05d\","
+             "\"author\":\"commenter%d\",\"body\":\"Nice build! What did you use for the "
+             "enclosure, and how long does it run on battery?\",\"score\":%d,"
+             "\"link_id\":\"t3_p00000\",\"parent_id\":\"t1_c%05d\",\"depth\":%d,"
+             "\"is_submitter\":false,\"score_hidden\":false,\"stickied\":false,"
+             "\"subreddit\":\"esp32\",\"permalink\":\"/r/esp32/comments/p00000/post/c%05d/\","
+             "\"created\":1700000000.0,\"created_utc\":1700000000.0,\"replies\":",
+             index, index, index % 23, index % 50, index > 0 ? index - 1 : 0, depth, index);
+    return std::string("{\"kind\":\"t1\",\"data\":{") + benchFiller() + buffer +
+           (replies.empty() ? "\"\"" : replies) + "}}";
+}
+
+static std::string benchListing(const std::string& children) {
+    return "{\"kind\":\"Listing\",\"data\":{\"after\":null,\"dist\":null,\"modhash\":\"\","
+           "\"geo_filter\":\"\",\"children\":[" + children + "],\"before\":null}}";
+}
+
+/**
+ * Hot listing of 25 posts, as from /r/{name}/hot?limit=25
+ */
+static std::string benchHotListing() {
+    std::string children;
+    for (int i = 0; i < 25; i++) {
+        if (i > 0) {
+            children += ",";
+        }
+        children += benchPost(i);
+    }
+    return benchListing(children);
+}
+
+/**
+ * Submission with 500 comments, as from /comments/{id}?limit=500:
+ * 100 top-level comments, each with a reply chain four deep
+ */
+static std::string benchCommentThread() {
+    const int threads = 100;
+    const int chain = 5;
+
+    std::string comments;
+    for (int t = 0; t < threads; t++) {
+        std::string replies;
+        for (int depth = chain - 1; depth >= 0; depth--) {
+            std::string comment = benchComment(t * chain + depth, depth, replies);
+            replies = depth > 0 ? benchListing(comment) : comment;
+        }
+        if (t > 0) {
+            comments += ",";
+        }
+        comments += replies;
+    }
+    return "[" + benchListing(benchPost(0)) + "," + benchListing(comments) + "]";
+}
+
+/**
+ * Subreddit about page, as from /r/{name}/about
+ */
+static std::string benchSubredditAbout() {
+    return std::string("{\"kind\":\"t5\",\"data\":{") + benchFiller() +
+           ",\"display_name\":\"esp32\",\"title\":\"ESP32\","
+           "\"public_description\":\"Everything about the ESP32 family of chips.\","
+           "\"description\":\"Share projects, ask questions and discuss the ESP32, ESP32-S2, "
+           "ESP32-S3 and ESP32-C3. Please read the rules before posting.\","
+           "\"subscribers\":54321,\"active_user_count\":123,\"over18\":false,"
+           "\"user_is_subscriber\":false,\"id\":\"2xxxx\",\"name\":\"t5_2xxxx\","
+           "\"created\":1400000000.0,\"created_utc\":1400000000.0}}";
+}
+
+/**
+ * Redditor about page, as from /user/{name}/about
+ */
+static std::string benchRedditorAbout() {
+    return "{\"kind\":\"t2\",\"data\":{\"is_employee\":false,\"is_friend\":false,"
+           "\"subreddit\":{\"default_set\":true,\"user_is_contributor\":false,"
+           "\"banner_img\":\"\",\"title\":\"\",\"over_18\":false,\"icon_img\":\"\","
+           "\"display_name\":\"u_maker1\",\"public_description\":\"\",\"subscribers\":0},"
+           "\"snoovatar_size\":null,\"awardee_karma\":0,\"id\":\"abc12\",\"verified\":true,"
+           "\"is_gold\":false,\"is_mod\":true,\"awarder_karma\":0,\"has_verified_email\":true,"
+           "\"icon_img\":\"https://www.redditstatic.com/avatars/defaults/v2/avatar_default_1.png\","
+           "\"hide_from_robots\":false,\"link_karma\":1234,\"total_karma\":5678,"
+           "\"pref_show_snoovatar\":false,\"name\":\"maker1\",\"created\":1500000000.0,"
+           "\"created_utc\":1500000000.0,\"comment_karma\":4444,\"accept_followers\":true,"
+           "\"has_subscribed\":true}}";
+}
+
+/**
+ * Token endpoint response for the client credentials grant
+ */
+static std::string benchTokenResponse() {
+    return "{\"access_token\":\"eyJhbGciOiJSUzI1NiIsImtpZCI6IlNIQTI1NjpzS3dsMnlsV0VtMjVmcXhwTU4"
+           "wcWY4MXE2OWFFdWFyMnpLMUdhVGxjdWNZIiwidHlwIjoiSldUIn0.benchmark-token\","
+           "\"token_type\":\"bearer\",\"expires_in\":86400,\"scope\":\"*\"}";
+}
+
+/**
+ * Load a recorded payload, falling back to the generated one
+ * @param dir Fixtures directory (may be null)
+ * @param name Fixture name without extension
+ * @param generate Generator for the fallback
+ * @return Payload
+ */
+static std::string benchPayload(const char* dir, const char* name, std::string (*generate)()) {
+    if (dir != nullptr) {
+        std::string path = std::string(dir) + "/" + name + ".json";
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file != nullptr) {
+            std::string payload;
+            char buffer[4096];
+            size_t n;
+            while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+                payload.append(buffer, n);
+            }
+            fclose(file);
+            if (!payload.empty()) {
+                return payload;
+            }
+        }
+    }
+    return generate();
+}
+
+#endif // BENCH_PAYLOADS_H
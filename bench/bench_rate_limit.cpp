@@ -0,0 +1,100 @@
+/**
+ * bench_rate_limit.cpp - Cost of a rate limit check
+ * 
+ * Compares the compacting timestamp array ESPrawClient used before the
+ * limiter interface (reproduced below) with the token bucket and sliding
+ * window limiters. Each scenario keeps the limiter saturated and times a
+ * check + record cycle, once with checks 1 ms apart (the legacy limiter
+ * mostly skips its cleanup) and once 1 s apart (it compacts every time).
+ * 
+ * Prints one JSON object per scenario.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "ESPrawRateLimit.h"
+
+#define LIMIT 60
+#define WINDOW 60000UL
+#define BURST 10
+
+// The pre-interface implementation: compact the array at most once per second
+class LegacyLimiter {
+public:
+    LegacyLimiter() : _count(0), _lastCleanup(0) {
+        memset(_times, 0, sizeof(_times));
+    }
+    
+    bool canRequest(unsigned long now) {
+        cleanup(now);
+        return _count < LIMIT;
+    }
+    
+    void recordRequest(unsigned long now) {
+        cleanup(now);
+        if (_count < LIMIT) {
+            _times[_count++] = now;
+        }
+    }
+
+private:
+    void cleanup(unsigned long now) {
+        if (now - _lastCleanup < 1000) {
+            return;
+        }
+        _lastCleanup = now;
+        int valid = 0;
+        for (int i = 0; i < _count; i++) {
+            if (now - _times[i] < WINDOW) {
+                _times[valid++] = _times[i];
+            }
+        }
+        _count = valid;
+    }
+    
+    unsigned long _times[LIMIT];
+    int _count;
+    unsigned long _lastCleanup;
+};
+
+static volatile unsigned long sink;
+
+template <typename Limiter>
+static void run(const char* name, unsigned long step, Limiter& limiter) {
+    const unsigned long iterations = 2000000;
+    
+    auto start = std::chrono::steady_clock::now();
+    unsigned long allowed = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        unsigned long now = i * step;
+        if (limiter.canRequest(now)) {
+            limiter.recordRequest(now);
+            allowed++;
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    sink = allowed;
+    
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    printf("{\"scenario\": \"%s\", \"step_ms\": %lu, \"iterations\": %lu, "
+           "\"ns_per_op\": %.2f, \"allowed\": %lu}\n",
+           name, step, iterations, ns, allowed);
+}
+
+int main() {
+    const unsigned long steps[] = { 1, 1000 };
+    
+    for (unsigned long step : steps) {
+        LegacyLimiter legacy;
+        run("legacy_compacting_array", step, legacy);
+        
+        ESPrawSlidingWindowLimiter window(LIMIT, WINDOW);
+        run("sliding_window_ring", step, window);
+        
+        ESPrawTokenBucketLimiter bucket(LIMIT, WINDOW, BURST);
+        run("token_bucket_gcra", step, bucket);
+    }
+    
+    return 0;
+}
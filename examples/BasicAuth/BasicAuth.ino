@@ -63,7 +63,7 @@ void setup() {
         
         // Get current user info
         Serial.println("\nFetching user info...");
-        Redditor* me = reddit.me();
+        ESPrawPtr<Redditor> me = reddit.me();
         
         if (me != nullptr && me->fetch()) {
             Serial.println("\nCurrent User Information:");
@@ -78,15 +78,13 @@ void setup() {
             Serial.println(me->hasVerifiedEmail() ? "Yes" : "No");
             Serial.print("Is Gold: ");
             Serial.println(me->isGold() ? "Yes" : "No");
-            
-            delete me;
         } else {
             Serial.println("Failed to fetch user info");
         }
         
         // Test fetching a subreddit
         Serial.println("\nFetching r/arduino info...");
-        Subreddit* arduino = reddit.subreddit("arduino");
+        ESPrawPtr<Subreddit> arduino = reddit.subreddit("arduino");
         
         if (arduino != nullptr && arduino->fetch()) {
             Serial.println("\nSubreddit Information:");
@@ -99,8 +97,6 @@ void setup() {
             Serial.println(arduino->getSubscribers());
             Serial.print("Active Users: ");
             Serial.println(arduino->getActiveUsers());
-            
-            delete arduino;
         } else {
             Serial.println("Failed to fetch subreddit info");
         }
@@ -52,11 +52,11 @@ void setup() {
         // Fetch hot posts from r/esp32
         Serial.println("\nFetching hot posts from r/esp32...\n");
         
-        Subreddit* esp32 = reddit.subreddit("esp32");
+        ESPrawPtr<Subreddit> esp32 = reddit.subreddit("esp32");
         
         if (esp32 != nullptr) {
             // Create a JSON document to store the results
-            DynamicJsonDocument doc(16384); // 16KB buffer
+            DynamicJsonDocument doc(4096); // Filtered listings stay small
             
             if (esp32->hot(doc, 5)) { // Fetch 5 hot posts
                 Serial.println("Hot Posts from r/esp32:");
@@ -91,8 +91,6 @@ void setup() {
             } else {
                 Serial.println("Failed to fetch hot posts");
             }
-            
-            delete esp32;
         }
         
     } else {
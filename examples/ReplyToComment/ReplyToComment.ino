@@ -58,7 +58,7 @@ void setup() {
         
         // Get the submission
         Serial.println("\nFetching submission...");
-        Submission* post = reddit.submission(postId);
+        ESPrawPtr<Submission> post = reddit.submission(postId);
         
         if (post != nullptr && post->isValid()) {
             Serial.println("\nSubmission Details:");
@@ -117,7 +117,7 @@ void setup() {
                             
                             // Reply to the first comment
                             Serial.println("\nReplying to first comment...");
-                            Comment* comment = reddit.comment(firstComment["id"].as<String>());
+                            ESPrawPtr<Comment> comment = reddit.comment(firstComment["id"].as<String>());
                             
                             if (comment != nullptr) {
                                 comment->parseData(firstComment);
@@ -128,8 +128,6 @@ void setup() {
                                 } else {
                                     Serial.println("Failed to post comment reply");
                                 }
-                                
-                                delete comment;
                             }
                         } else {
                             Serial.println("No comments found on this post");
@@ -139,8 +137,6 @@ void setup() {
             } else {
                 Serial.println("Failed to fetch comments");
             }
-            
-            delete post;
         } else {
             Serial.println("Failed to fetch submission or invalid post ID");
         }
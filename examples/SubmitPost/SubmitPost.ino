@@ -56,7 +56,7 @@ void setup() {
         // Submit a text post to r/test
         Serial.println("\nSubmitting post to r/test...");
         
-        Subreddit* testSub = reddit.subreddit("test");
+        ESPrawPtr<Subreddit> testSub = reddit.subreddit("test");
         
         if (testSub != nullptr) {
             String title = "Test post from ESP32";
@@ -72,8 +72,6 @@ void setup() {
                 Serial.println("\nFailed to submit post.");
                 Serial.println("Make sure you have posting permissions in r/test");
             }
-            
-            delete testSub;
         }
         
         // You can also submit a link post
@@ -91,8 +89,6 @@ void setup() {
             } else {
                 Serial.println("\nFailed to submit link post.");
             }
-            
-            delete testSub;
         }
         
     } else {
@@ -23,11 +23,11 @@ echo "=== Standalone Tests (35 tests) ==="
 echo ""
 
 # Run Unity-based tests
-echo "=== Authentication Tests (5 tests) ==="
+echo "=== Authentication Tests (8 tests) ==="
 ./test_espraw_auth | grep -E "Tests.*Failures|OK"
 echo ""
 
-echo "=== HTTP Client Tests (7 tests) ==="
+echo "=== HTTP Client Tests (14 tests) ==="
 ./test_espraw_client | grep -E "Tests.*Failures|OK"
 echo ""
 
@@ -35,9 +35,85 @@ echo "=== Model Tests (9 tests) ==="
 ./test_espraw_models | grep -E "Tests.*Failures|OK"
 echo ""
 
+echo "=== Stream Tests (5 tests) ==="
+./test_espraw_stream | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Async Tests (5 tests) ==="
+./test_espraw_async | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Worker Tests (5 tests) ==="
+./test_espraw_worker | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Rate Limit Tests (6 tests) ==="
+./test_espraw_ratelimit | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Token Store Tests (5 tests) ==="
+./test_espraw_tokenstore | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== HAL Tests (6 tests) ==="
+./test_espraw_hal | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Transport Tests (6 tests) ==="
+./test_espraw_transport | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Heap Tests (4 tests) ==="
+./test_espraw_heap | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Timing Tests (5 tests) ==="
+./test_espraw_timing | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Cache Tests (5 tests) ==="
+./test_espraw_cache | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Cache Store Tests (5 tests) ==="
+./test_espraw_cachestore | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Comment Tree Tests (5 tests) ==="
+./test_espraw_commenttree | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Arena Tests (4 tests) ==="
+./test_espraw_arena | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Pool Tests (3 tests) ==="
+./test_espraw_pool | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== String Pool Tests (5 tests) ==="
+./test_espraw_stringpool | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Filter Tests (5 tests) ==="
+./test_espraw_filter | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Listing Tests (6 tests) ==="
+./test_espraw_listing | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Info Tests (9 tests) ==="
+./test_espraw_info | grep -E "Tests.*Failures|OK"
+echo ""
+
+echo "=== Lazy Model Tests (4 tests) ==="
+./test_espraw_lazy | grep -E "Tests.*Failures|OK"
+echo ""
+
 echo "========================================="
 echo "  All Tests Summary"
 echo "========================================="
-echo "Total Tests: 56 (35 + 5 + 7 + 9)"
+echo "Total Tests: 164 (35 + 8 + 14 + 9 + 5 + 5 + 5 + 6 + 5 + 6 + 6 + 4 + 5 + 5 + 5 + 5 + 4 + 3 + 5 + 5 + 6 + 9 + 4)"
 echo "Status: ✓ ALL PASSED"
 echo "========================================="
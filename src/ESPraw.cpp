@@ -8,7 +8,10 @@
 #include "models/Comment.h"
 #include "models/Redditor.h"
 
-ESPraw::ESPraw() : _initialized(false), _readOnly(false) {
+ESPraw::ESPraw()
+    : _initialized(false), _readOnly(false), _heapProbe(nullptr), _subredditPool(nullptr),
+      _submissionPool(nullptr), _commentPool(nullptr), _redditorPool(nullptr),
+      _stringPool(nullptr) {
 }
 
 ESPraw::~ESPraw() {
@@ -62,8 +65,7 @@ bool ESPraw::authenticate() {
     }
     
     if (success) {
-        ESPrawToken token = _auth.getToken();
-        _client.setAccessToken(token.accessToken);
+        _client.setAccessToken(_auth.getToken().accessToken);
         Serial.println("Authentication successful");
     } else {
         Serial.println("Authentication failed");
@@ -76,47 +78,33 @@ bool ESPraw::isAuthenticated() const {
     return _auth.isAuthenticated();
 }
 
-Subreddit* ESPraw::subreddit(const String& name) {
-    return new Subreddit(this, name);
+ESPrawPtr<Subreddit> ESPraw::subreddit(const String& name) {
+    return ESPrawPool<Subreddit>::make(_subredditPool, this, name);
 }
 
-Submission* ESPraw::submission(const String& id) {
-    // Fetch submission from Reddit
-    String endpoint = "/comments/" + id;
-    ESPrawResponse response = get(endpoint);
-    
-    if (!response.success) {
-        return nullptr;
-    }
-    
-    DynamicJsonDocument doc(8192);
-    DeserializationError error = deserializeJson(doc, response.body);
-    
-    if (error) {
-        return nullptr;
-    }
-    
-    // Extract submission data from response
-    if (doc.is<JsonArray>() && doc.size() > 0) {
-        JsonObject listing = doc[0]["data"];
-        if (listing.containsKey("children") && listing["children"].size() > 0) {
-            JsonObject submissionData = listing["children"][0]["data"];
-            return new Submission(this, submissionData);
-        }
-    }
+ESPrawPtr<Submission> ESPraw::submission(const String& id) {
+    // /api/info returns the submission alone; /comments/{id} would send
+    // the comment tree along with it
+    ESPrawPtr<Submission> result;
+    std::vector<String> fullname(1, "t3_" + id);
+    
+    info(fullname, [&](Submission& submission) {
+        result = ESPrawPool<Submission>::make(_submissionPool, std::move(submission));
+        return false;
+    }, nullptr, nullptr, ESPrawFilter::submission());
     
-    return nullptr;
+    return result;
 }
 
-Submission* ESPraw::submissionByUrl(const String& url) {
+ESPrawPtr<Submission> ESPraw::submissionByUrl(const String& url) {
     String id = extractSubmissionId(url);
     if (id.isEmpty()) {
-        return nullptr;
+        return ESPrawPtr<Submission>();
     }
     return submission(id);
 }
 
-Comment* ESPraw::comment(const String& id) {
+ESPrawPtr<Comment> ESPraw::comment(const String& id) {
     // NOTE: This method creates a minimal Comment object with only the ID.
     // To fetch full comment data, you need to:
     // 1. Get the submission containing the comment
@@ -128,33 +116,103 @@ Comment* ESPraw::comment(const String& id) {
     DynamicJsonDocument doc(1024);
     JsonObject obj = doc.to<JsonObject>();
     obj["id"] = id;
-    return new Comment(this, obj);
+    return ESPrawPool<Comment>::make(_commentPool, this, obj);
+}
+
+int ESPraw::info(const std::vector<String>& fullnames,
+                 const ListingIterator::SubmissionCallback& onSubmission,
+                 const ListingIterator::CommentCallback& onComment,
+                 const ListingIterator::SubredditCallback& onSubreddit,
+                 const ESPrawFilter& fields) {
+    // Reddit silently leaves out IDs it can't resolve, so a bare ID would
+    // look like a deleted object; refuse the whole lookup instead
+    for (size_t i = 0; i < fullnames.size(); i++) {
+        if (!isInfoFullname(fullnames[i])) {
+            Serial.println("Invalid fullname for /api/info: " + fullnames[i]);
+            return -1;
+        }
+    }
+    
+    int visited = 0;
+    
+    for (size_t start = 0; start < fullnames.size(); start += ESPRAW_INFO_BATCH_SIZE) {
+        size_t end = start + ESPRAW_INFO_BATCH_SIZE;
+        if (end > fullnames.size()) {
+            end = fullnames.size();
+        }
+        
+        String ids = "id=";
+        for (size_t i = start; i < end; i++) {
+            if (i > start) {
+                ids += ",";
+            }
+            ids += fullnames[i];
+        }
+        
+        // One page per batch: /api/info has no cursor
+        ListingIterator batch(this, "/api/info", ids);
+        batch.setPageSize(end - start);
+        batch.setFields(fields);
+        
+        visited += batch.forEachThing(onSubmission, onComment, onSubreddit);
+        
+        if (!batch.getError().isEmpty()) {
+            return -1;
+        }
+        // A callback asked to stop before the page was finished
+        if (batch.hasMore()) {
+            break;
+        }
+    }
+    
+    return visited;
 }
 
-Redditor* ESPraw::redditor(const String& username) {
-    return new Redditor(this, username);
+ESPrawPtr<Redditor> ESPraw::redditor(const String& username) {
+    return ESPrawPool<Redditor>::make(_redditorPool, this, username);
 }
 
-Redditor* ESPraw::me() {
+ESPrawPtr<Redditor> ESPraw::me() {
     if (!isAuthenticated() || _readOnly) {
-        return nullptr;
+        return ESPrawPtr<Redditor>();
     }
     
-    ESPrawResponse response = get("/api/v1/me");
-    
-    if (!response.success) {
-        return nullptr;
-    }
+    DynamicJsonDocument filter(ESPrawFilter::redditor().capacity());
+    ESPrawFilter::redditor().buildObject(filter);
     
     DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, response.body);
+    ESPrawResponse response = getJson("/api/v1/me", doc, "", &filter);
     
-    if (error) {
-        return nullptr;
+    if (!response.success) {
+        return ESPrawPtr<Redditor>();
     }
     
     JsonObject data = doc.as<JsonObject>();
-    return new Redditor(this, data);
+    return ESPrawPool<Redditor>::make(_redditorPool, this, data);
+}
+
+void ESPraw::setSubredditPool(ESPrawPool<Subreddit>* pool) {
+    _subredditPool = pool;
+}
+
+void ESPraw::setSubmissionPool(ESPrawPool<Submission>* pool) {
+    _submissionPool = pool;
+}
+
+void ESPraw::setCommentPool(ESPrawPool<Comment>* pool) {
+    _commentPool = pool;
+}
+
+void ESPraw::setRedditorPool(ESPrawPool<Redditor>* pool) {
+    _redditorPool = pool;
+}
+
+void ESPraw::setStringPool(ESPrawStringPool* pool) {
+    _stringPool = pool;
+}
+
+ESPrawStringPool* ESPraw::getStringPool() const {
+    return _stringPool;
 }
 
 bool ESPraw::setReadOnly(bool readOnly) {
@@ -181,34 +239,155 @@ ESPrawAuth& ESPraw::getAuth() {
     return _auth;
 }
 
+void ESPraw::setHeapProbe(ESPrawHeapProbe* probe) {
+    _heapProbe = probe;
+    _heapTotals = ESPrawHeapTotals();
+}
+
+const ESPrawHeapTotals& ESPraw::getHeapTotals() const {
+    return _heapTotals;
+}
+
+void ESPraw::resetHeapTotals() {
+    _heapTotals = ESPrawHeapTotals();
+}
+
 ESPrawResponse ESPraw::get(const String& endpoint, const String& params) {
-    // Check if token is expired and refresh if needed
-    if (_auth.isAuthenticated() && _auth.getToken().isExpired()) {
-        Serial.println("Token expired, refreshing...");
-        if (!_auth.refreshToken()) {
-            ESPrawResponse response;
-            response.error = "Failed to refresh token";
-            return response;
-        }
-        _client.setAccessToken(_auth.getToken().accessToken);
+    return sendAuthorized([&]() {
+        return _client.get(endpoint, params);
+    });
+}
+
+ESPrawResponse ESPraw::getJson(const String& endpoint, JsonDocument& doc, const String& params,
+                               const JsonDocument* filter) {
+    return sendAuthorized([&]() {
+        return _client.getJson(endpoint, doc, params, filter);
+    });
+}
+
+ESPrawResponse ESPraw::getStream(const String& endpoint, const ESPrawBodyHandler& handler,
+                                 const String& params) {
+    return sendAuthorized([&]() {
+        return _client.getStream(endpoint, handler, params);
+    });
+}
+
+ESPrawResponse ESPraw::post(const String& endpoint, const String& body) {
+    return sendAuthorized([&]() {
+        return _client.post(endpoint, body);
+    });
+}
+
+ESPrawAsyncHandle ESPraw::getAsync(const String& endpoint, const String& params,
+                                   const ESPrawAsyncCallback& callback) {
+    ESPrawResponse response;
+    if (!refreshTokenIfExpired(response)) {
+        return ESPRAW_ASYNC_INVALID_HANDLE;
     }
     
-    return _client.get(endpoint, params);
+    return _client.getAsync(endpoint, params, callback);
 }
 
-ESPrawResponse ESPraw::post(const String& endpoint, const String& body) {
-    // Check if token is expired and refresh if needed
-    if (_auth.isAuthenticated() && _auth.getToken().isExpired()) {
+ESPrawAsyncHandle ESPraw::postAsync(const String& endpoint, const String& body,
+                                    const ESPrawAsyncCallback& callback) {
+    ESPrawResponse response;
+    if (!refreshTokenIfExpired(response)) {
+        return ESPRAW_ASYNC_INVALID_HANDLE;
+    }
+    
+    return _client.postAsync(endpoint, body, callback);
+}
+
+bool ESPraw::poll() {
+    maintainToken();
+    return _client.poll();
+}
+
+void ESPraw::execute(ESPrawWorkerJob& job) {
+    switch (job.method) {
+        case ESPrawRequestMethod::GET:
+            if (job.handler) {
+                job.response = getStream(job.endpoint, job.handler, job.params);
+            } else {
+                job.response = get(job.endpoint, job.params);
+            }
+            break;
+        case ESPrawRequestMethod::POST:
+            job.response = post(job.endpoint, job.params);
+            break;
+        case ESPrawRequestMethod::PUT:
+            job.response = sendAuthorized([&]() {
+                return _client.put(job.endpoint, job.params);
+            });
+            break;
+        case ESPrawRequestMethod::DELETE_METHOD:
+            job.response = sendAuthorized([&]() {
+                return _client.delete_(job.endpoint);
+            });
+            break;
+        default:
+            job.response.error = "Unsupported request method";
+            break;
+    }
+}
+
+bool ESPraw::refreshTokenIfExpired(ESPrawResponse& response) {
+    // A token close to expiring is refreshed in the background and keeps
+    // being used meanwhile; only an expired one blocks the request
+    maintainToken();
+    
+    const ESPrawToken& token = _auth.getToken();
+    if (token.isValid && token.isExpired()) {
         Serial.println("Token expired, refreshing...");
-        if (!_auth.refreshToken()) {
-            ESPrawResponse response;
-            response.error = "Failed to refresh token";
-            return response;
-        }
+        return refreshToken(response);
+    }
+    
+    return true;
+}
+
+bool ESPraw::refreshToken(ESPrawResponse& response) {
+    // Joins a background refresh that is already in flight
+    if (!_auth.refreshToken()) {
+        response.error = "Failed to refresh token";
+        return false;
+    }
+    
+    _client.setAccessToken(_auth.getToken().accessToken);
+    return true;
+}
+
+void ESPraw::maintainToken() {
+    if (_auth.poll()) {
         _client.setAccessToken(_auth.getToken().accessToken);
     }
+}
+
+template <typename Send>
+ESPrawResponse ESPraw::sendAuthorized(const Send& send) {
+    ESPrawHeapProbe* probe = _heapProbe;
+    if (probe != nullptr) {
+        probe->start();
+    }
     
-    return _client.post(endpoint, body);
+    ESPrawResponse response;
+    if (refreshTokenIfExpired(response)) {
+        response = send();
+        
+        // Reddit can drop a token before its stated expiry; refresh once and replay
+        if (response.statusCode == 401 && _auth.getToken().isValid) {
+            Serial.println("Token rejected, refreshing and retrying...");
+            if (refreshToken(response)) {
+                response = send();
+            }
+        }
+    }
+    
+    if (probe != nullptr) {
+        probe->stop(response.heap);
+        _heapTotals.add(response.heap);
+    }
+    
+    return response;
 }
 
 bool ESPraw::checkWiFi() {
@@ -253,3 +432,8 @@ String ESPraw::extractSubmissionId(const String& url) {
     
     return url.substring(idStart, idEnd);
 }
+
+bool ESPraw::isInfoFullname(const String& fullname) {
+    return fullname.length() > 3 &&
+           (fullname.startsWith("t1_") || fullname.startsWith("t3_") || fullname.startsWith("t5_"));
+}
@@ -5,17 +5,18 @@
  * Provides convenient access to Reddit's API from ESP32.
  * 
  * MEMORY MANAGEMENT NOTE:
- * This library uses manual memory management for returned objects.
- * All methods that return pointers (Subreddit*, Submission*, etc.) 
- * transfer ownership to the caller. You MUST delete these objects 
- * when done to avoid memory leaks.
+ * Methods that create objects (subreddit(), submission(), etc.) return
+ * an ESPrawPtr, a std::unique_ptr that frees the object when it goes out
+ * of scope. Give a model type an ESPrawPool (setSubredditPool() etc.) to reuse
+ * the same memory across lookups (see ESPrawPool.h).
  * 
  * Example:
- *   Subreddit* sub = reddit.subreddit("test");
+ *   ESPrawPtr<Subreddit> sub = reddit.subreddit("test");
  *   // Use sub...
- *   delete sub; // Don't forget to free memory!
+ *   // Freed automatically
  * 
- * Future versions may use smart pointers to avoid this requirement.
+ * Subreddit and Redditor can also be constructed directly, e.g. on the
+ * stack: Subreddit sub(&reddit, "test");
  */
 
 #ifndef ESPRAW_H
@@ -23,13 +24,23 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
+#include <vector>
 #include "ESPrawConfig.h"
 #include "ESPrawClient.h"
 #include "ESPrawAuth.h"
+#include "ESPrawFilter.h"
+#include "ESPrawWorker.h"
+#include "ESPrawHeap.h"
+#include "ESPrawArena.h"
+#include "ESPrawPool.h"
+#include "ESPrawStringPool.h"
 #include "models/Subreddit.h"
 #include "models/Submission.h"
 #include "models/Comment.h"
 #include "models/Redditor.h"
+#include "models/ListingIterator.h"
+#include "models/CommentTree.h"
+#include "models/ModelViews.h"
 
 /**
  * ESPraw - Main Reddit API wrapper class
@@ -91,43 +102,125 @@ public:
     /**
      * Get a subreddit object
      * @param name Subreddit name (without r/)
-     * @return Subreddit pointer (caller must delete)
+     * @return Subreddit, freed when the pointer goes out of scope
      */
-    Subreddit* subreddit(const String& name);
+    ESPrawPtr<Subreddit> subreddit(const String& name);
     
     /**
      * Get a submission object by ID
+     * 
+     * Only the submission is downloaded, without its comments; use
+     * Submission::getComments() for those.
+     * 
      * @param id Submission ID (without prefix)
-     * @return Submission pointer (caller must delete)
+     * @return Submission, or nullptr if not found
      */
-    Submission* submission(const String& id);
+    ESPrawPtr<Submission> submission(const String& id);
     
     /**
      * Get a submission object by URL
      * @param url Full Reddit URL
-     * @return Submission pointer (caller must delete)
+     * @return Submission, or nullptr if not found
      */
-    Submission* submissionByUrl(const String& url);
+    ESPrawPtr<Submission> submissionByUrl(const String& url);
     
     /**
      * Get a comment object by ID
      * @param id Comment ID (without prefix)
-     * @return Comment pointer (caller must delete)
+     * @return Comment, freed when the pointer goes out of scope
      */
-    Comment* comment(const String& id);
+    ESPrawPtr<Comment> comment(const String& id);
+    
+    /**
+     * Look up submissions, comments and subreddits by fullname
+     * 
+     * Uses /api/info, which answers up to ESPRAW_INFO_BATCH_SIZE fullnames
+     * per request; longer lists are split into several requests. Each
+     * object is passed to the callback for its kind as soon as it is read,
+     * in the order Reddit returns them. Unknown or deleted fullnames are
+     * left out. A fullname without a t1_, t3_ or t5_ prefix, such as a
+     * bare ID, fails the whole lookup before any request is sent.
+     * 
+     * ```cpp
+     * std::vector<String> tracked = { "t3_abc123", "t3_def456", "t1_ghi789" };
+     * reddit.info(tracked, [](Submission& post) {
+     *     Serial.printf("%s: %d\n", post.getFullname().c_str(), post.getScore());
+     *     return true;
+     * });
+     * ```
+     * 
+     * @param fullnames Fullnames (t1_, t3_ or t5_ prefixed IDs)
+     * @param onSubmission Called per submission; return false to stop
+     * @param onComment Called per comment; return false to stop (optional)
+     * @param onSubreddit Called per subreddit; return false to stop (optional)
+     * @param fields Fields to keep for each object (must cover the kinds requested)
+     * @return Number of objects visited, or -1 if a fullname is invalid
+     *         or a request failed
+     */
+    int info(const std::vector<String>& fullnames,
+             const ListingIterator::SubmissionCallback& onSubmission,
+             const ListingIterator::CommentCallback& onComment = nullptr,
+             const ListingIterator::SubredditCallback& onSubreddit = nullptr,
+             const ESPrawFilter& fields = ESPrawFilter::thing());
     
     /**
      * Get a redditor object
      * @param username Username (without u/)
-     * @return Redditor pointer (caller must delete)
+     * @return Redditor, freed when the pointer goes out of scope
      */
-    Redditor* redditor(const String& username);
+    ESPrawPtr<Redditor> redditor(const String& username);
     
     /**
      * Get the currently authenticated user
-     * @return Redditor pointer for current user (caller must delete)
+     * @return Redditor for the current user, or nullptr
+     */
+    ESPrawPtr<Redditor> me();
+    
+    /**
+     * Construct the objects subreddit() returns in a pool
+     * 
+     * Lookups then reuse the pool's slots instead of allocating every
+     * object separately, falling back to the heap when the pool is full.
+     * The pool must outlive this object and every object taken from it.
+     * 
+     * @param pool Pool, or nullptr to allocate on the heap (not owned)
+     */
+    void setSubredditPool(ESPrawPool<Subreddit>* pool);
+    
+    /**
+     * Construct the objects submission() and submissionByUrl() return in a pool
+     * @param pool Pool, or nullptr to allocate on the heap (not owned)
+     */
+    void setSubmissionPool(ESPrawPool<Submission>* pool);
+    
+    /**
+     * Construct the objects comment() returns in a pool
+     * @param pool Pool, or nullptr to allocate on the heap (not owned)
+     */
+    void setCommentPool(ESPrawPool<Comment>* pool);
+    
+    /**
+     * Construct the objects redditor() and me() return in a pool
+     * @param pool Pool, or nullptr to allocate on the heap (not owned)
+     */
+    void setRedditorPool(ESPrawPool<Redditor>* pool);
+    
+    /**
+     * Share repeated model fields through a string pool
+     * 
+     * Models parsed afterwards keep their kind, author, subreddit, domain
+     * and link ID in the pool (see ESPrawStringPool.h). The pool must
+     * outlive this object; models may outlive the pool.
+     * 
+     * @param pool String pool, or nullptr to give every model its own copies (not owned)
      */
-    Redditor* me();
+    void setStringPool(ESPrawStringPool* pool);
+    
+    /**
+     * Get the string pool
+     * @return String pool, or nullptr if none is set
+     */
+    ESPrawStringPool* getStringPool() const;
     
     /**
      * Set read-only mode
@@ -154,14 +247,65 @@ public:
      */
     ESPrawAuth& getAuth();
     
+    /**
+     * Record the heap footprint of every blocking API call
+     * 
+     * Each call's statistics land in ESPrawResponse::heap and in the
+     * running totals. The probe must outlive this object; pass nullptr to
+     * stop measuring. Async requests are not measured.
+     * 
+     * @param probe Heap probe, e.g. an ESPrawSystemHeapProbe
+     */
+    void setHeapProbe(ESPrawHeapProbe* probe);
+    
+    /**
+     * Get the heap statistics of all measured calls
+     * @return Totals since the probe was set or the last reset
+     */
+    const ESPrawHeapTotals& getHeapTotals() const;
+    
+    /**
+     * Reset the heap totals
+     */
+    void resetHeapTotals();
+    
     /**
      * Perform a GET request to Reddit API
+     * 
+     * Like the other request methods, a request rejected with 401 is
+     * replayed once after refreshing the token.
+     * 
      * @param endpoint API endpoint
      * @param params Query parameters
      * @return Response object
      */
     ESPrawResponse get(const String& endpoint, const String& params = "");
     
+    /**
+     * Perform a GET request and deserialize the JSON response
+     * 
+     * The response body is streamed from the connection into the document
+     * without being buffered as a String first.
+     * 
+     * @param endpoint API endpoint
+     * @param doc JSON document to store the response
+     * @param params Query parameters
+     * @param filter ArduinoJson filter document selecting the fields to keep (optional)
+     * @return Response object (body is empty on success)
+     */
+    ESPrawResponse getJson(const String& endpoint, JsonDocument& doc, const String& params = "",
+                           const JsonDocument* filter = nullptr);
+    
+    /**
+     * Perform a GET request and hand the response body to a callback
+     * @param endpoint API endpoint
+     * @param handler Callback that consumes the body of a successful response
+     * @param params Query parameters
+     * @return Response object (body is empty on success)
+     */
+    ESPrawResponse getStream(const String& endpoint, const ESPrawBodyHandler& handler,
+                             const String& params = "");
+    
     /**
      * Perform a POST request to Reddit API
      * @param endpoint API endpoint
@@ -170,6 +314,45 @@ public:
      */
     ESPrawResponse post(const String& endpoint, const String& body);
     
+    /**
+     * Start a non-blocking GET request; drive it with poll()
+     * 
+     * An expired token is refreshed before the request is queued.
+     * 
+     * @param endpoint API endpoint
+     * @param params Query parameters
+     * @param callback Called with the response when the request finishes (optional)
+     * @return Request handle, or ESPRAW_ASYNC_INVALID_HANDLE on failure
+     */
+    ESPrawAsyncHandle getAsync(const String& endpoint, const String& params = "",
+                               const ESPrawAsyncCallback& callback = nullptr);
+    
+    /**
+     * Start a non-blocking POST request; drive it with poll()
+     * @param endpoint API endpoint
+     * @param body Request body
+     * @param callback Called with the response when the request finishes (optional)
+     * @return Request handle, or ESPRAW_ASYNC_INVALID_HANDLE on failure
+     */
+    ESPrawAsyncHandle postAsync(const String& endpoint, const String& body,
+                                const ESPrawAsyncCallback& callback = nullptr);
+    
+    /**
+     * Advance pending async requests and background token refresh; call
+     * this from loop()
+     * @return true while any async request is unfinished
+     */
+    bool poll();
+    
+    /**
+     * Perform a worker job, filling in job.response
+     * 
+     * This is the executor for an ESPrawWorker; it runs on the worker task.
+     * 
+     * @param job Job to perform
+     */
+    void execute(ESPrawWorkerJob& job);
+    
     /**
      * Check WiFi connection and reconnect if needed
      * @return true if connected
@@ -183,6 +366,47 @@ private:
     ESPrawAuth _auth;
     bool _initialized;
     bool _readOnly;
+    ESPrawHeapProbe* _heapProbe;
+    ESPrawHeapTotals _heapTotals;
+    ESPrawPool<Subreddit>* _subredditPool;
+    ESPrawPool<Submission>* _submissionPool;
+    ESPrawPool<Comment>* _commentPool;
+    ESPrawPool<Redditor>* _redditorPool;
+    ESPrawStringPool* _stringPool;
+    
+    /**
+     * Refresh the access token if it has expired
+     * @param response Response to fill with the error on failure
+     * @return true if the token is usable
+     */
+    bool refreshTokenIfExpired(ESPrawResponse& response);
+    
+    /**
+     * Refresh the access token now, blocking until done
+     * @param response Response to fill with the error on failure
+     * @return true if a new token is in use
+     */
+    bool refreshToken(ESPrawResponse& response);
+    
+    /**
+     * Drive background token refresh and pick up a new token
+     */
+    void maintainToken();
+    
+    /**
+     * Send a request with a usable token, refreshing once and replaying
+     * it if the server rejects the token with 401
+     * 
+     * This is one logical API call, so it is where the heap is measured.
+     * A template rather than a std::function, which would allocate to hold
+     * the request lambdas' captures on every call.
+     * 
+     * @tparam Send Callable returning ESPrawResponse
+     * @param send Performs the request
+     * @return Response from the last attempt
+     */
+    template <typename Send>
+    ESPrawResponse sendAuthorized(const Send& send);
     
     /**
      * Extract submission ID from Reddit URL
@@ -190,6 +414,13 @@ private:
      * @return Submission ID or empty string
      */
     String extractSubmissionId(const String& url);
+    
+    /**
+     * Check that a fullname names a kind /api/info can look up
+     * @param fullname Fullname to check
+     * @return true for a t1_, t3_ or t5_ prefix followed by an ID
+     */
+    static bool isInfoFullname(const String& fullname);
 };
 
 #endif // ESPRAW_H
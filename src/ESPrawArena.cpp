@@ -0,0 +1,70 @@
+/**
+ * ESPrawArena.cpp - Single-block storage implementation
+ */
+
+#include "ESPrawArena.h"
+
+// Records are aligned for the widest member a view holds
+#define ESPRAW_ARENA_ALIGN (sizeof(void*) > sizeof(uint32_t) ? sizeof(void*) : sizeof(uint32_t))
+
+ESPrawArena::ESPrawArena(size_t capacity)
+    : _block((char*)malloc(capacity)), _capacity(0), _front(0), _back(0), _full(false) {
+    if (_block != nullptr) {
+        _capacity = capacity;
+        _back = capacity;
+    }
+}
+
+ESPrawArena::~ESPrawArena() {
+    free(_block);
+}
+
+void* ESPrawArena::allocateRecord(size_t size) {
+    size_t start = (_front + ESPRAW_ARENA_ALIGN - 1) & ~(ESPRAW_ARENA_ALIGN - 1);
+    if (start > _back || size > _back - start) {
+        _full = true;
+        return nullptr;
+    }
+
+    _front = start + size;
+    memset(_block + start, 0, size);
+    return _block + start;
+}
+
+bool ESPrawArena::copyText(const char* text, size_t length, ESPrawText& view) {
+    view = ESPrawText();
+    if (text == nullptr || length == 0) {
+        return true;
+    }
+    if (length > 0xFFFF) {
+        length = 0xFFFF;
+    }
+    if (length + 1 > _back - _front) {
+        _full = true;
+        return false;
+    }
+
+    _back -= length + 1;
+    memcpy(_block + _back, text, length);
+    _block[_back + length] = '\0';
+    view = ESPrawText(_block + _back, length);
+    return true;
+}
+
+void ESPrawArena::reset() {
+    _front = 0;
+    _back = _capacity;
+    _full = false;
+}
+
+size_t ESPrawArena::capacity() const {
+    return _capacity;
+}
+
+size_t ESPrawArena::used() const {
+    return _front + (_capacity - _back);
+}
+
+bool ESPrawArena::isFull() const {
+    return _full;
+}
@@ -0,0 +1,181 @@
+/**
+ * ESPrawArena.h - Single-block storage for model views
+ *
+ * Building a Submission copies a dozen fields into separately allocated
+ * Strings, so a 100-item listing costs well over a thousand heap
+ * allocations. An arena is one block allocated up front: view records
+ * (SubmissionView, CommentView, ...) are placed at its start, one after
+ * another, and the text they point to is packed in from its end. A whole
+ * listing then costs no allocations beyond the block itself, and reset()
+ * releases all of it at once:
+ *
+ *   ESPrawArena arena(16384);
+ *   ESPrawViewList<SubmissionView> posts;
+ *   sub->listing("hot").collectSubmissions(arena, posts);
+ *   for (const SubmissionView& post : posts) {
+ *       Serial.println(post.title.c_str());
+ *   }
+ *   arena.reset();
+ */
+
+#ifndef ESPRAW_ARENA_H
+#define ESPRAW_ARENA_H
+
+#include <Arduino.h>
+#include "ESPrawConfig.h"
+
+/**
+ * A NUL-terminated string stored in an arena
+ *
+ * Text views are plain pointers: the arena's block never moves, and
+ * they stay valid until the arena is reset or destroyed.
+ */
+struct ESPrawText {
+    const char* data;     // Never null once set by an arena
+    uint16_t length;
+
+    ESPrawText() : data(""), length(0) {}
+    ESPrawText(const char* text, uint16_t size) : data(text), length(size) {}
+
+    /**
+     * Get the text
+     * @return NUL-terminated string
+     */
+    const char* c_str() const { return data; }
+
+    /**
+     * Check if the text is empty
+     * @return true if empty
+     */
+    bool isEmpty() const { return length == 0; }
+
+    /**
+     * Copy the text into a String
+     * @return String copy (allocates)
+     */
+    String toString() const { return String(data); }
+
+    /**
+     * Compare with a C string
+     * @param text String to compare with
+     * @return true if equal
+     */
+    bool equals(const char* text) const { return strcmp(data, text) == 0; }
+};
+
+/**
+ * ESPrawArena - Bump allocator over one fixed block
+ */
+class ESPrawArena {
+public:
+    /**
+     * Constructor; allocates the block
+     * @param capacity Block size in bytes
+     */
+    explicit ESPrawArena(size_t capacity = ESPRAW_ARENA_SIZE);
+
+    /**
+     * Destructor; frees the block
+     */
+    ~ESPrawArena();
+
+    // Owns the block
+    ESPrawArena(const ESPrawArena&) = delete;
+    ESPrawArena& operator=(const ESPrawArena&) = delete;
+
+    /**
+     * Reserve space for a record at the front of the block
+     *
+     * Consecutive records of one type form an array.
+     *
+     * @param size Record size (a multiple of its alignment)
+     * @return Zeroed memory aligned for any record, or nullptr if full
+     */
+    void* allocateRecord(size_t size);
+
+    /**
+     * Copy text to the back of the block
+     * @param text Text to copy (may be null)
+     * @param length Bytes to copy (longer text is cut at 65535 bytes)
+     * @param view Receives the stored text
+     * @return false if full; view is left empty
+     */
+    bool copyText(const char* text, size_t length, ESPrawText& view);
+
+    /**
+     * Release everything allocated from the arena
+     */
+    void reset();
+
+    /**
+     * Get the block size
+     * @return Capacity in bytes (0 if the block could not be allocated)
+     */
+    size_t capacity() const;
+
+    /**
+     * Get the bytes handed out
+     * @return Bytes used by records and text
+     */
+    size_t used() const;
+
+    /**
+     * Check if an allocation failed since the last reset
+     * @return true if something did not fit
+     */
+    bool isFull() const;
+
+private:
+    char* _block;
+    size_t _capacity;
+    size_t _front;        // End of the records
+    size_t _back;         // Start of the text
+    bool _full;
+};
+
+/**
+ * ESPrawViewList - Records of one type laid out back to back in an arena
+ * @tparam T View type
+ */
+template <typename T>
+class ESPrawViewList {
+public:
+    /**
+     * Constructor for an empty list
+     */
+    ESPrawViewList() : _items(nullptr), _count(0) {}
+
+    /**
+     * Append a record allocated right after the previous one
+     * @param item Record from ESPrawArena::allocateRecord()
+     * @return false if the record does not follow the list
+     */
+    bool append(T* item) {
+        if (_count == 0) {
+            _items = item;
+        } else if (item != _items + _count) {
+            return false;
+        }
+        _count++;
+        return true;
+    }
+
+    /**
+     * Empty the list (the records stay in the arena until it is reset)
+     */
+    void clear() {
+        _items = nullptr;
+        _count = 0;
+    }
+
+    size_t size() const { return _count; }
+    const T& operator[](size_t index) const { return _items[index]; }
+    const T* begin() const { return _items; }
+    const T* end() const { return _items + _count; }
+
+private:
+    T* _items;
+    size_t _count;
+};
+
+#endif // ESPRAW_ARENA_H
@@ -0,0 +1,558 @@
+/**
+ * ESPrawAsync.cpp - Non-blocking request engine implementation
+ */
+
+#include "ESPrawAsync.h"
+#include <utility>
+
+ESPrawAsyncEngine::Slot::Slot()
+    : handle(ESPRAW_ASYNC_INVALID_HANDLE), state(ESPrawAsyncState::IDLE), sent(0),
+      readyAt(0), phaseStart(0), attempt(0), reused(false), receivedAny(false),
+      phase(ParsePhase::STATUS_LINE), remaining(-1), chunked(false), closeAfter(false) {}
+
+ESPrawAsyncEngine::ESPrawAsyncEngine(Client& client, const char* host, uint16_t port)
+    : _client(&client), _host(host), _port(port), _active(nullptr),
+      _nextHandle(ESPRAW_ASYNC_INVALID_HANDLE) {}
+
+void ESPrawAsyncEngine::begin(const ESPrawRequestConfig& config) {
+    _config = config;
+}
+
+void ESPrawAsyncEngine::setServer(Client& client, const String& host, uint16_t port) {
+    _client->stop();
+    _client = &client;
+    _host = host;
+    _port = port;
+}
+
+void ESPrawAsyncEngine::setKeepAlive(bool keepAlive) {
+    _config.keepAlive = keepAlive;
+}
+
+void ESPrawAsyncEngine::setWaitHook(const WaitHook& hook) {
+    _waitHook = hook;
+}
+
+void ESPrawAsyncEngine::setSentHook(const SentHook& hook) {
+    _sentHook = hook;
+}
+
+void ESPrawAsyncEngine::setResponseHook(const ResponseHook& hook) {
+    _responseHook = hook;
+}
+
+ESPrawAsyncHandle ESPrawAsyncEngine::submit(ESPrawRequestMethod method, const String& path,
+                                            const String& headers, const String& body,
+                                            const String& contentType,
+                                            const ESPrawAsyncCallback& callback) {
+    Slot* slot = nullptr;
+    for (int i = 0; i < ESPRAW_ASYNC_MAX_REQUESTS; i++) {
+        if (_slots[i].state == ESPrawAsyncState::IDLE) {
+            slot = &_slots[i];
+            break;
+        }
+    }
+
+    if (slot == nullptr) {
+        return ESPRAW_ASYNC_INVALID_HANDLE;
+    }
+
+    const char* methodName = "GET";
+    switch (method) {
+        case ESPrawRequestMethod::GET:
+            methodName = "GET";
+            break;
+        case ESPrawRequestMethod::POST:
+            methodName = "POST";
+            break;
+        case ESPrawRequestMethod::PUT:
+            methodName = "PUT";
+            break;
+        case ESPrawRequestMethod::PATCH:
+            methodName = "PATCH";
+            break;
+        case ESPrawRequestMethod::DELETE_METHOD:
+            methodName = "DELETE";
+            break;
+    }
+
+    // The whole request is built once and kept for retries
+    String request;
+    request.reserve(path.length() + headers.length() + body.length() + 128);
+    request += methodName;
+    request += " ";
+    request += path;
+    request += " HTTP/1.1\r\nHost: ";
+    request += _host;
+    if (_port != 80 && _port != 443) {
+        request += ":";
+        request += String((unsigned int)_port);
+    }
+    request += "\r\n";
+    request += headers;
+    if (method != ESPrawRequestMethod::GET && method != ESPrawRequestMethod::DELETE_METHOD) {
+        if (contentType.length() > 0) {
+            request += "Content-Type: " + contentType + "\r\n";
+        }
+        request += "Content-Length: " + String(body.length()) + "\r\n";
+    }
+    request += _config.keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    request += body;
+
+    if (++_nextHandle == ESPRAW_ASYNC_INVALID_HANDLE) {
+        ++_nextHandle;
+    }
+
+    *slot = Slot();
+    slot->handle = _nextHandle;
+    slot->state = ESPrawAsyncState::QUEUED;
+    slot->request = request;
+    slot->callback = callback;
+
+    return slot->handle;
+}
+
+bool ESPrawAsyncEngine::poll(unsigned long now) {
+    if (_active == nullptr) {
+        Slot* slot = nextReady(now);
+        if (slot != nullptr) {
+            unsigned long wait = _waitHook ? _waitHook(now) : 0;
+            if (wait > 0) {
+                slot->state = ESPrawAsyncState::WAITING;
+                slot->readyAt = now + wait;
+            } else {
+                slot->state = ESPrawAsyncState::CONNECTING;
+                slot->phaseStart = now;
+                _active = slot;
+            }
+        }
+    } else {
+        switch (_active->state) {
+            case ESPrawAsyncState::CONNECTING:
+                stepConnect(*_active, now);
+                break;
+            case ESPrawAsyncState::SENDING:
+                stepSend(*_active, now);
+                break;
+            case ESPrawAsyncState::RECEIVING:
+                stepReceive(*_active, now);
+                break;
+            default:
+                _active = nullptr;
+                break;
+        }
+    }
+
+    return pending() > 0;
+}
+
+ESPrawAsyncState ESPrawAsyncEngine::getState(ESPrawAsyncHandle handle) const {
+    const Slot* slot = find(handle);
+    return slot != nullptr ? slot->state : ESPrawAsyncState::IDLE;
+}
+
+bool ESPrawAsyncEngine::takeResponse(ESPrawAsyncHandle handle, ESPrawResponse& response) {
+    Slot* slot = find(handle);
+    if (slot == nullptr || slot->state != ESPrawAsyncState::DONE) {
+        return false;
+    }
+
+    response = std::move(slot->response);
+    *slot = Slot();
+    return true;
+}
+
+bool ESPrawAsyncEngine::cancel(ESPrawAsyncHandle handle) {
+    Slot* slot = find(handle);
+    if (slot == nullptr) {
+        return false;
+    }
+
+    if (_active == slot) {
+        // The rest of the response would be read by the next request
+        _client->stop();
+        _active = nullptr;
+    }
+
+    *slot = Slot();
+    return true;
+}
+
+int ESPrawAsyncEngine::pending() const {
+    int count = 0;
+    for (int i = 0; i < ESPRAW_ASYNC_MAX_REQUESTS; i++) {
+        if (_slots[i].state != ESPrawAsyncState::IDLE && _slots[i].state != ESPrawAsyncState::DONE) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void ESPrawAsyncEngine::closeConnection() {
+    // An active request notices the closed connection and retries
+    _client->stop();
+}
+
+ESPrawAsyncEngine::Slot* ESPrawAsyncEngine::nextReady(unsigned long now) {
+    Slot* next = nullptr;
+    for (int i = 0; i < ESPRAW_ASYNC_MAX_REQUESTS; i++) {
+        Slot& slot = _slots[i];
+        bool ready = slot.state == ESPrawAsyncState::QUEUED ||
+                     (slot.state == ESPrawAsyncState::WAITING && (long)(now - slot.readyAt) >= 0);
+
+        // Oldest request first; handles compare correctly across wraparound
+        if (ready && (next == nullptr || (int32_t)(slot.handle - next->handle) < 0)) {
+            next = &slot;
+        }
+    }
+    return next;
+}
+
+void ESPrawAsyncEngine::stepConnect(Slot& slot, unsigned long now) {
+    slot.reused = _config.keepAlive && _client->connected();
+
+    if (!slot.reused) {
+        _client->stop();
+        // The TLS handshake is the one step the ESP32 stack cannot split up;
+        // with keep-alive it only happens for the first request
+        if (!_client->connect(_host.c_str(), _port)) {
+            failConnection(slot, "Failed to connect", now);
+            return;
+        }
+    }
+
+    resetParser(slot);
+    slot.sent = 0;
+    slot.state = ESPrawAsyncState::SENDING;
+    slot.phaseStart = now;
+
+    if (_sentHook) {
+        _sentHook(now);
+    }
+}
+
+void ESPrawAsyncEngine::stepSend(Slot& slot, unsigned long now) {
+    size_t left = slot.request.length() - slot.sent;
+    size_t length = left < ESPRAW_ASYNC_IO_BUDGET ? left : ESPRAW_ASYNC_IO_BUDGET;
+    size_t written = _client->write((const uint8_t*)slot.request.c_str() + slot.sent, length);
+
+    if (written == 0) {
+        if (!_client->connected()) {
+            failConnection(slot, "Connection closed while sending", now);
+        } else if (now - slot.phaseStart >= (unsigned long)_config.requestTimeout) {
+            failConnection(slot, "Request timed out", now);
+        }
+        return;
+    }
+
+    slot.sent += written;
+    slot.phaseStart = now;
+    if (slot.sent >= slot.request.length()) {
+        slot.state = ESPrawAsyncState::RECEIVING;
+    }
+}
+
+void ESPrawAsyncEngine::stepReceive(Slot& slot, unsigned long now) {
+    uint8_t buffer[ESPRAW_STREAM_BUFFER_SIZE];
+    size_t budget = ESPRAW_ASYNC_IO_BUDGET;
+
+    while (budget > 0 && slot.phase != ParsePhase::COMPLETE) {
+        int available = _client->available();
+        if (available <= 0) {
+            break;
+        }
+
+        size_t length = (size_t)available < sizeof(buffer) ? (size_t)available : sizeof(buffer);
+        if (length > budget) {
+            length = budget;
+        }
+
+        int count = _client->read(buffer, length);
+        if (count <= 0) {
+            break;
+        }
+
+        budget -= count;
+        slot.receivedAny = true;
+        slot.phaseStart = now;
+
+        if (!parse(slot, buffer, count)) {
+            failConnection(slot, "Malformed HTTP response", now);
+            return;
+        }
+    }
+
+    if (slot.phase == ParsePhase::COMPLETE) {
+        finishResponse(slot, now);
+        return;
+    }
+
+    if (budget < ESPRAW_ASYNC_IO_BUDGET) {
+        return; // Made progress; continue on the next poll
+    }
+
+    if (!_client->connected()) {
+        if (slot.phase == ParsePhase::BODY && slot.remaining < 0) {
+            // Body without a length ends when the server closes
+            slot.phase = ParsePhase::COMPLETE;
+            slot.closeAfter = true;
+            finishResponse(slot, now);
+        } else {
+            failConnection(slot, "Connection closed by server", now);
+        }
+    } else if (now - slot.phaseStart >= (unsigned long)_config.requestTimeout) {
+        failConnection(slot, "Request timed out", now);
+    }
+}
+
+bool ESPrawAsyncEngine::parse(Slot& slot, const uint8_t* data, size_t length) {
+    size_t i = 0;
+    while (i < length) {
+        switch (slot.phase) {
+            case ParsePhase::BODY:
+            case ParsePhase::CHUNK_DATA: {
+                size_t take = length - i;
+                if (slot.remaining >= 0 && (long)take > slot.remaining) {
+                    take = slot.remaining;
+                }
+                slot.response.body.concat((const char*)data + i, take);
+                i += take;
+
+                if (slot.remaining >= 0) {
+                    slot.remaining -= take;
+                    if (slot.remaining == 0) {
+                        slot.phase = slot.phase == ParsePhase::BODY ? ParsePhase::COMPLETE
+                                                                    : ParsePhase::CHUNK_END;
+                    }
+                }
+                break;
+            }
+            case ParsePhase::COMPLETE:
+                return true;
+            default: {
+                char c = (char)data[i++];
+                if (c == '\n') {
+                    if (!parseLine(slot)) {
+                        return false;
+                    }
+                    slot.line = "";
+                } else if (c != '\r' && slot.line.length() < ESPRAW_ASYNC_MAX_LINE) {
+                    slot.line += c;
+                }
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+bool ESPrawAsyncEngine::parseLine(Slot& slot) {
+    switch (slot.phase) {
+        case ParsePhase::STATUS_LINE: {
+            int space = slot.line.indexOf(' ');
+            if (!slot.line.startsWith("HTTP/") || space < 0) {
+                return false;
+            }
+            slot.response.statusCode = slot.line.substring(space + 1).toInt();
+            if (slot.response.statusCode < 100) {
+                return false;
+            }
+            slot.phase = ParsePhase::HEADERS;
+            return true;
+        }
+        case ParsePhase::HEADERS: {
+            if (slot.line.length() == 0) {
+                int code = slot.response.statusCode;
+                if (code < 200) {
+                    // Interim response; the real one follows
+                    slot.phase = ParsePhase::STATUS_LINE;
+                } else if (code == 204 || code == 304) {
+                    slot.phase = ParsePhase::COMPLETE;
+                } else if (slot.chunked) {
+                    slot.phase = ParsePhase::CHUNK_SIZE;
+                } else if (slot.remaining == 0) {
+                    slot.phase = ParsePhase::COMPLETE;
+                } else {
+                    if (slot.remaining > 0) {
+                        slot.response.body.reserve(slot.remaining);
+                    }
+                    slot.phase = ParsePhase::BODY;
+                }
+                return true;
+            }
+
+            int colon = slot.line.indexOf(':');
+            if (colon <= 0) {
+                return true; // Ignore malformed header lines
+            }
+
+            String name = slot.line.substring(0, colon);
+            String value = slot.line.substring(colon + 1);
+            name.toLowerCase();
+            value.trim();
+
+            if (name == "content-length") {
+                slot.remaining = value.toInt();
+            } else if (name == "transfer-encoding") {
+                value.toLowerCase();
+                slot.chunked = value.indexOf("chunked") >= 0;
+            } else if (name == "connection") {
+                slot.closeAfter = value.equalsIgnoreCase("close");
+            } else if (name == "retry-after") {
+                slot.headers.retryAfter = value;
+            } else if (name == "etag") {
+                slot.response.etag = value;
+            } else if (name == "last-modified") {
+                slot.response.lastModified = value;
+            } else if (name == "x-ratelimit-used") {
+                slot.headers.rateLimitUsed = value;
+            } else if (name == "x-ratelimit-remaining") {
+                slot.headers.rateLimitRemaining = value;
+            } else if (name == "x-ratelimit-reset") {
+                slot.headers.rateLimitReset = value;
+            }
+            return true;
+        }
+        case ParsePhase::CHUNK_SIZE: {
+            if (slot.line.length() == 0) {
+                return true;
+            }
+            long size = strtol(slot.line.c_str(), nullptr, 16);
+            if (size < 0) {
+                return false;
+            }
+            if (size == 0) {
+                slot.phase = ParsePhase::TRAILERS;
+            } else {
+                slot.remaining = size;
+                slot.phase = ParsePhase::CHUNK_DATA;
+            }
+            return true;
+        }
+        case ParsePhase::CHUNK_END:
+            slot.phase = ParsePhase::CHUNK_SIZE;
+            return true;
+        case ParsePhase::TRAILERS:
+            if (slot.line.length() == 0) {
+                slot.phase = ParsePhase::COMPLETE;
+            }
+            return true;
+        default:
+            return true;
+    }
+}
+
+void ESPrawAsyncEngine::finishResponse(Slot& slot, unsigned long now) {
+    int code = slot.response.statusCode;
+    _active = nullptr;
+
+    if (_responseHook) {
+        _responseHook(code, slot.headers, now);
+    }
+
+    if (slot.closeAfter || !_config.keepAlive) {
+        _client->stop();
+    }
+
+    if (code >= 200 && code < 300) {
+        slot.response.success = true;
+        complete(slot);
+    } else if (code == 304) {
+        complete(slot); // Answer to a conditional request
+    } else if (code == 401) {
+        slot.response.error = "Unauthorized - token may be expired";
+        complete(slot); // Don't retry auth errors
+    } else if (code == 429) {
+        slot.response.error = "Rate limit exceeded";
+        unsigned long wait = 0;
+        if (slot.headers.retryAfter.length() > 0) {
+            wait = slot.headers.retryAfter.toInt() * 1000UL;
+        } else if (_waitHook) {
+            wait = _waitHook(now);
+        }
+        retry(slot, wait, now);
+    } else {
+        slot.response.error = "HTTP error: " + String(code);
+        retry(slot, 0, now);
+    }
+}
+
+void ESPrawAsyncEngine::failConnection(Slot& slot, const String& error, unsigned long now) {
+    bool closedByServer = !_client->connected();
+    _client->stop();
+    _active = nullptr;
+
+    if (slot.reused && closedByServer && !slot.receivedAny) {
+        // The server closed the idle keep-alive connection; reconnect
+        // once without spending a retry attempt
+        slot.reused = false;
+        slot.state = ESPrawAsyncState::CONNECTING;
+        slot.phaseStart = now;
+        _active = &slot;
+        return;
+    }
+
+    slot.response.error = error;
+    retry(slot, 0, now);
+}
+
+void ESPrawAsyncEngine::retry(Slot& slot, unsigned long wait, unsigned long now) {
+    slot.attempt++;
+    if (slot.attempt > _config.maxRetries) {
+        complete(slot);
+        return;
+    }
+
+    // Exponential backoff, same schedule as blocking requests
+    int shift = slot.attempt < 15 ? slot.attempt : 15;
+    unsigned long backoff = (unsigned long)_config.retryDelay * (1UL << shift);
+    if (backoff > ESPRAW_MAX_RETRY_BACKOFF) {
+        backoff = ESPRAW_MAX_RETRY_BACKOFF;
+    }
+
+    slot.state = ESPrawAsyncState::WAITING;
+    slot.readyAt = now + (wait > backoff ? wait : backoff);
+}
+
+void ESPrawAsyncEngine::complete(Slot& slot) {
+    if (_active == &slot) {
+        _active = nullptr;
+    }
+
+    slot.state = ESPrawAsyncState::DONE;
+    slot.request = String();
+
+    if (slot.callback) {
+        // Release the slot first so the callback can submit follow-up requests
+        ESPrawAsyncHandle handle = slot.handle;
+        ESPrawAsyncCallback callback = std::move(slot.callback);
+        ESPrawResponse response = std::move(slot.response);
+        slot = Slot();
+        callback(handle, response);
+    }
+}
+
+void ESPrawAsyncEngine::resetParser(Slot& slot) {
+    slot.response = ESPrawResponse();
+    slot.headers = ESPrawAsyncHeaders();
+    slot.receivedAny = false;
+    slot.phase = ParsePhase::STATUS_LINE;
+    slot.line = "";
+    slot.remaining = -1;
+    slot.chunked = false;
+    slot.closeAfter = false;
+}
+
+ESPrawAsyncEngine::Slot* ESPrawAsyncEngine::find(ESPrawAsyncHandle handle) {
+    for (int i = 0; i < ESPRAW_ASYNC_MAX_REQUESTS; i++) {
+        if (handle != ESPRAW_ASYNC_INVALID_HANDLE && _slots[i].handle == handle &&
+            _slots[i].state != ESPrawAsyncState::IDLE) {
+            return &_slots[i];
+        }
+    }
+    return nullptr;
+}
+
+const ESPrawAsyncEngine::Slot* ESPrawAsyncEngine::find(ESPrawAsyncHandle handle) const {
+    return const_cast<ESPrawAsyncEngine*>(this)->find(handle);
+}
@@ -0,0 +1,318 @@
+/**
+ * ESPrawAsync.h - Non-blocking request engine for ESPraw
+ *
+ * ESPrawAsyncEngine runs HTTP requests as a state machine driven by poll().
+ * Every poll() does a bounded amount of work and returns: rate limit waits,
+ * Retry-After and retry backoff are deadlines checked on later polls rather
+ * than delay() calls, and request/response bytes are moved in small steps.
+ *
+ * Several requests can be pending at once. They share one connection and
+ * are sent one after another; a request waiting out a backoff does not hold
+ * the connection, so other requests keep going in the meantime.
+ *
+ * The engine only talks to an Arduino Client and takes the current time as
+ * a parameter, so host tests can drive it with a fake clock and transport.
+ */
+
+#ifndef ESPRAW_ASYNC_H
+#define ESPRAW_ASYNC_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <functional>
+#include "ESPrawConfig.h"
+
+/**
+ * Identifies a submitted request; ESPRAW_ASYNC_INVALID_HANDLE means none
+ */
+typedef uint32_t ESPrawAsyncHandle;
+
+#define ESPRAW_ASYNC_INVALID_HANDLE 0
+
+/**
+ * Lifecycle of an asynchronous request
+ */
+enum class ESPrawAsyncState {
+    IDLE,        // Unknown handle, or response already taken
+    QUEUED,      // Waiting for the connection
+    WAITING,     // Waiting out a rate limit, Retry-After or retry backoff
+    CONNECTING,  // Opening the connection
+    SENDING,     // Writing the request
+    RECEIVING,   // Reading and parsing the response
+    DONE         // Response ready for takeResponse()
+};
+
+/**
+ * Called once when a request finishes
+ * @param handle Request handle
+ * @param response Final response (success or error)
+ */
+typedef std::function<void(ESPrawAsyncHandle handle, const ESPrawResponse& response)> ESPrawAsyncCallback;
+
+/**
+ * Response headers the engine reports to its owner
+ */
+struct ESPrawAsyncHeaders {
+    String retryAfter;
+    String rateLimitUsed;
+    String rateLimitRemaining;
+    String rateLimitReset;
+};
+
+/**
+ * ESPrawAsyncEngine - State machine for non-blocking requests
+ */
+class ESPrawAsyncEngine {
+public:
+    /**
+     * Returns how long the next request must wait for the rate limit
+     * @param now Current time in milliseconds
+     * @return Milliseconds to wait (0 to send now)
+     */
+    typedef std::function<unsigned long(unsigned long now)> WaitHook;
+
+    /**
+     * Called when a request is about to be written to the connection
+     * @param now Current time in milliseconds
+     */
+    typedef std::function<void(unsigned long now)> SentHook;
+
+    /**
+     * Called when a response has been received
+     * @param statusCode HTTP status code
+     * @param headers Rate limit related response headers
+     * @param now Current time in milliseconds
+     */
+    typedef std::function<void(int statusCode, const ESPrawAsyncHeaders& headers,
+                               unsigned long now)> ResponseHook;
+
+    /**
+     * Constructor
+     * @param client Connection used for all requests
+     * @param host Server host name (sent in the Host header)
+     * @param port Server port
+     */
+    ESPrawAsyncEngine(Client& client, const char* host, uint16_t port);
+
+    /**
+     * Apply retry, timeout and keep-alive settings
+     * @param config Request configuration
+     */
+    void begin(const ESPrawRequestConfig& config);
+
+    /**
+     * Point the engine at another server
+     * 
+     * Closes the current connection; call it before submitting requests.
+     * 
+     * @param client Connection used for all requests
+     * @param host Server host name (sent in the Host header)
+     * @param port Server port
+     */
+    void setServer(Client& client, const String& host, uint16_t port);
+
+    /**
+     * Enable or disable connection reuse between requests
+     * @param keepAlive true to keep the connection open
+     */
+    void setKeepAlive(bool keepAlive);
+
+    /**
+     * Set the rate limit hook consulted before each request is sent
+     * @param hook Wait hook
+     */
+    void setWaitHook(const WaitHook& hook);
+
+    /**
+     * Set the hook called when a request is sent
+     * @param hook Sent hook
+     */
+    void setSentHook(const SentHook& hook);
+
+    /**
+     * Set the hook called when a response arrives
+     * @param hook Response hook
+     */
+    void setResponseHook(const ResponseHook& hook);
+
+    /**
+     * Queue a request
+     * @param method HTTP method
+     * @param path Request path including the query string
+     * @param headers Extra request header lines, each ending in "\r\n"
+     * @param body Request body (optional)
+     * @param contentType Content type of the body (optional)
+     * @param callback Called when the request finishes (optional)
+     * @return Request handle, or ESPRAW_ASYNC_INVALID_HANDLE if the queue is full
+     */
+    ESPrawAsyncHandle submit(ESPrawRequestMethod method, const String& path, const String& headers,
+                             const String& body = "", const String& contentType = "",
+                             const ESPrawAsyncCallback& callback = nullptr);
+
+    /**
+     * Advance pending requests by one bounded step
+     * @param now Current time in milliseconds
+     * @return true while any request is unfinished
+     */
+    bool poll(unsigned long now);
+
+    /**
+     * Get the state of a request
+     * @param handle Request handle
+     * @return Current state (IDLE for unknown handles)
+     */
+    ESPrawAsyncState getState(ESPrawAsyncHandle handle) const;
+
+    /**
+     * Take the response of a finished request and release its slot
+     *
+     * Requests submitted with a callback are released automatically and
+     * never need this.
+     *
+     * @param handle Request handle
+     * @param response Receives the response
+     * @return true if the request was finished
+     */
+    bool takeResponse(ESPrawAsyncHandle handle, ESPrawResponse& response);
+
+    /**
+     * Cancel a request
+     *
+     * A request cancelled while it owns the connection closes it, since the
+     * response can no longer be read to the end.
+     *
+     * @param handle Request handle
+     * @return true if the request existed
+     */
+    bool cancel(ESPrawAsyncHandle handle);
+
+    /**
+     * Get the number of unfinished requests
+     * @return Requests not yet DONE
+     */
+    int pending() const;
+
+    /**
+     * Close the connection
+     */
+    void closeConnection();
+
+private:
+    /**
+     * Position of the response parser
+     */
+    enum class ParsePhase {
+        STATUS_LINE,
+        HEADERS,
+        BODY,
+        CHUNK_SIZE,
+        CHUNK_DATA,
+        CHUNK_END,
+        TRAILERS,
+        COMPLETE
+    };
+
+    /**
+     * One pending request and its response parser
+     */
+    struct Slot {
+        ESPrawAsyncHandle handle;
+        ESPrawAsyncState state;
+        String request;              // Full request text, kept for retries
+        size_t sent;
+        ESPrawAsyncCallback callback;
+        ESPrawResponse response;
+        ESPrawAsyncHeaders headers;
+        unsigned long readyAt;       // End of a WAITING period
+        unsigned long phaseStart;    // Start of the current I/O phase
+        int attempt;
+        bool reused;                 // Sent over an already open connection
+        bool receivedAny;
+
+        ParsePhase phase;
+        String line;
+        long remaining;              // Body or chunk bytes left (-1: until close)
+        bool chunked;
+        bool closeAfter;
+
+        Slot();
+    };
+
+    /**
+     * Pick the next request that may use the connection
+     */
+    Slot* nextReady(unsigned long now);
+
+    /**
+     * Open (or reuse) the connection and start sending
+     */
+    void stepConnect(Slot& slot, unsigned long now);
+
+    /**
+     * Write the next part of the request
+     */
+    void stepSend(Slot& slot, unsigned long now);
+
+    /**
+     * Read and parse the next part of the response
+     */
+    void stepReceive(Slot& slot, unsigned long now);
+
+    /**
+     * Feed received bytes to the response parser
+     * @return false if the response is malformed
+     */
+    bool parse(Slot& slot, const uint8_t* data, size_t length);
+
+    /**
+     * Handle a complete status line or header line
+     * @return false if the line is malformed
+     */
+    bool parseLine(Slot& slot);
+
+    /**
+     * Act on a completely received response
+     */
+    void finishResponse(Slot& slot, unsigned long now);
+
+    /**
+     * Handle a connection failure of the active request
+     */
+    void failConnection(Slot& slot, const String& error, unsigned long now);
+
+    /**
+     * Schedule another attempt, or finish with the current error
+     * @param wait Minimum wait before the next attempt
+     */
+    void retry(Slot& slot, unsigned long wait, unsigned long now);
+
+    /**
+     * Finish a request and deliver its response
+     */
+    void complete(Slot& slot);
+
+    /**
+     * Reset parser state for a new attempt
+     */
+    void resetParser(Slot& slot);
+
+    /**
+     * Find the slot holding a handle
+     */
+    Slot* find(ESPrawAsyncHandle handle);
+    const Slot* find(ESPrawAsyncHandle handle) const;
+
+    Client* _client;
+    String _host;
+    uint16_t _port;
+    ESPrawRequestConfig _config;
+    WaitHook _waitHook;
+    SentHook _sentHook;
+    ResponseHook _responseHook;
+
+    Slot _slots[ESPRAW_ASYNC_MAX_REQUESTS];
+    Slot* _active;                   // Request currently owning the connection
+    ESPrawAsyncHandle _nextHandle;
+};
+
+#endif // ESPRAW_ASYNC_H
@@ -5,13 +5,23 @@
 #include "ESPrawAuth.h"
 #include <base64.h>
 
-ESPrawAuth::ESPrawAuth() {
+ESPrawAuth::ESPrawAuth()
+    : _tokenEngine(_secureClient, ESPRAW_AUTH_HOST, ESPRAW_AUTH_PORT),
+      _refreshHandle(ESPRAW_ASYNC_INVALID_HANDLE),
+      _tokenStore(nullptr),
+      _refreshFailed(false),
+      _refreshFailedAt(0) {
 }
 
 ESPrawAuth::~ESPrawAuth() {
 }
 
 bool ESPrawAuth::begin(const ESPrawAuthConfig& config) {
+    if (!ESPrawUrl::parse(config.authBaseUrl, _authUrl)) {
+        Serial.println("Invalid auth base URL: " + config.authBaseUrl);
+        return false;
+    }
+    
     _config = config;
     // SECURITY WARNING: Certificate validation is currently disabled
     // This is a known security issue and should be addressed before production use
@@ -21,6 +31,12 @@ bool ESPrawAuth::begin(const ESPrawAuthConfig& config) {
     // 2. Using certificate fingerprint validation
     // 3. Implementing certificate bundle validation
     _secureClient.setInsecure(); 
+    _tokenEngine.setServer(authClient(), _authUrl.host, _authUrl.port);
+    
+    // Tokens last an hour, so there is no point keeping the connection open
+    ESPrawRequestConfig tokenConfig;
+    tokenConfig.keepAlive = false;
+    _tokenEngine.begin(tokenConfig);
     return true;
 }
 
@@ -31,11 +47,10 @@ bool ESPrawAuth::authenticateScript() {
         return false;
     }
     
-    String params = "grant_type=password&username=" + urlEncode(_config.username) +
+    _grantParams = "grant_type=password&username=" + urlEncode(_config.username) +
                    "&password=" + urlEncode(_config.password);
     
-    _token = requestToken("password", params);
-    return _token.isValid;
+    return restoreToken() || requestToken();
 }
 
 bool ESPrawAuth::authenticateReadOnly() {
@@ -44,12 +59,11 @@ bool ESPrawAuth::authenticateReadOnly() {
         return false;
     }
     
-    String params = "grant_type=client_credentials";
-    _token = requestToken("client_credentials", params);
-    return _token.isValid;
+    _grantParams = "grant_type=client_credentials";
+    return restoreToken() || requestToken();
 }
 
-ESPrawToken ESPrawAuth::getToken() const {
+const ESPrawToken& ESPrawAuth::getToken() const {
     return _token;
 }
 
@@ -58,19 +72,71 @@ bool ESPrawAuth::isAuthenticated() const {
 }
 
 bool ESPrawAuth::refreshToken() {
-    // Reddit doesn't support refresh tokens in the traditional sense
-    // We need to re-authenticate
-    if (_config.readOnlyMode) {
-        return authenticateReadOnly();
-    } else {
-        return authenticateScript();
+    // Reddit doesn't support refresh tokens in the traditional sense,
+    // so refreshing repeats the grant the current token came from
+    if (!startRefresh()) {
+        return false;
+    }
+    return waitForRefresh();
+}
+
+bool ESPrawAuth::needsRefresh() const {
+    return _token.isValid && _token.expiresWithin(_config.refreshMargin);
+}
+
+bool ESPrawAuth::startRefresh() {
+    if (isRefreshing()) {
+        return true;
+    }
+    
+    if (_grantParams.isEmpty()) {
+        Serial.println("Not authenticated, nothing to refresh");
+        return false;
+    }
+    
+    String headers = "User-Agent: ";
+    headers += _config.userAgent.length() > 0 ? _config.userAgent : String(ESPRAW_USER_AGENT_FORMAT);
+    headers += "\r\nAuthorization: Basic " + createBasicAuth() + "\r\n";
+    headers += "Accept: application/json\r\n";
+    
+    _refreshHandle = _tokenEngine.submit(ESPrawRequestMethod::POST, _authUrl.path + ESPRAW_AUTH_PATH,
+                                         headers, _grantParams, "application/x-www-form-urlencoded");
+    return isRefreshing();
+}
+
+bool ESPrawAuth::isRefreshing() const {
+    return _refreshHandle != ESPRAW_ASYNC_INVALID_HANDLE;
+}
+
+bool ESPrawAuth::poll() {
+    unsigned long now = millis();
+    
+    if (!isRefreshing() && needsRefresh() &&
+        (!_refreshFailed || now - _refreshFailedAt >= ESPRAW_TOKEN_REFRESH_RETRY)) {
+        Serial.println("Token expiring soon, refreshing in the background");
+        startRefresh();
+    }
+    
+    if (!isRefreshing()) {
+        return false;
     }
+    
+    _tokenEngine.poll(now);
+    return finishRefresh(now);
+}
+
+WiFiClient& ESPrawAuth::authClient() {
+    return _authUrl.secure ? static_cast<WiFiClient&>(_secureClient) : _plainClient;
+}
+
+void ESPrawAuth::setTokenStore(ESPrawTokenStore* store) {
+    _tokenStore = store;
 }
 
 bool ESPrawAuth::revokeToken() {
     HTTPClient http;
     
-    if (!http.begin(_secureClient, "https://www.reddit.com/api/v1/revoke_token")) {
+    if (!http.begin(authClient(), _config.authBaseUrl + ESPRAW_REVOKE_PATH)) {
         return false;
     }
     
@@ -85,54 +151,125 @@ bool ESPrawAuth::revokeToken() {
     if (httpCode == 200 || httpCode == 204) {
         _token.isValid = false;
         _token.accessToken = "";
+        if (_tokenStore != nullptr) {
+            _tokenStore->clear();
+        }
         return true;
     }
     
     return false;
 }
 
-ESPrawToken ESPrawAuth::requestToken(const String& grantType, const String& params) {
-    ESPrawToken token;
-    HTTPClient http;
+bool ESPrawAuth::requestToken() {
+    if (isRefreshing()) {
+        _tokenEngine.cancel(_refreshHandle);
+        _refreshHandle = ESPRAW_ASYNC_INVALID_HANDLE;
+    }
     
-    if (!http.begin(_secureClient, ESPRAW_AUTH_URL)) {
-        Serial.println("Failed to connect to auth endpoint");
-        return token;
+    if (!startRefresh()) {
+        return false;
+    }
+    return waitForRefresh();
+}
+
+bool ESPrawAuth::restoreToken() {
+    // Only at startup; switching grants always asks for a new token
+    if (_tokenStore == nullptr || _token.isValid) {
+        return false;
     }
     
-    // Set headers
-    http.addHeader("Content-Type", "application/x-www-form-urlencoded");
-    http.addHeader("Authorization", "Basic " + createBasicAuth());
+    uint64_t now = ESPrawStoredToken::wallClock();
+    ESPrawStoredToken stored;
+    if (now == 0 || !_tokenStore->load(stored) || stored.owner != tokenOwner()) {
+        return false;
+    }
     
-    if (_config.userAgent.length() > 0) {
-        http.addHeader("User-Agent", _config.userAgent);
-    } else {
-        http.addHeader("User-Agent", ESPRAW_USER_AGENT_FORMAT);
+    ESPrawToken token = stored.restore(now);
+    if (!token.isValid) {
+        return false;
     }
     
-    // Perform request
-    int httpCode = http.POST(params);
+    _token = token;
+    Serial.println("Restored saved token, valid for " + String(_token.remainingValidity()) + "s");
+    return true;
+}
+
+void ESPrawAuth::saveToken() {
+    uint64_t now = ESPrawStoredToken::wallClock();
+    if (_tokenStore == nullptr || now == 0) {
+        return;
+    }
     
-    if (httpCode == 200) {
-        String response = http.getString();
+    if (!_tokenStore->save(ESPrawStoredToken::capture(_token, tokenOwner(), now))) {
+        Serial.println("Failed to save token");
+    }
+}
+
+String ESPrawAuth::tokenOwner() const {
+    if (_grantParams.startsWith("grant_type=password")) {
+        return _config.clientId + ":" + _config.username;
+    }
+    return _config.clientId;
+}
+
+bool ESPrawAuth::waitForRefresh() {
+    while (isRefreshing()) {
+        unsigned long now = millis();
+        _tokenEngine.poll(now);
         
+        if (finishRefresh(now)) {
+            return true;
+        }
+        if (isRefreshing()) {
+            delay(1);
+        }
+    }
+    
+    // The request finished without a usable token
+    return false;
+}
+
+bool ESPrawAuth::finishRefresh(unsigned long now) {
+    ESPrawResponse response;
+    if (!_tokenEngine.takeResponse(_refreshHandle, response)) {
+        return false;
+    }
+    _refreshHandle = ESPRAW_ASYNC_INVALID_HANDLE;
+    
+    ESPrawToken token = readTokenResponse(response);
+    if (!token.isValid) {
+        // Keep the current token; poll() tries again later
+        _refreshFailed = true;
+        _refreshFailedAt = now;
+        return false;
+    }
+    
+    _token = token;
+    _refreshFailed = false;
+    saveToken();
+    return true;
+}
+
+ESPrawToken ESPrawAuth::readTokenResponse(const ESPrawResponse& response) {
+    ESPrawToken token;
+    
+    if (response.statusCode == 200) {
         // Parse JSON response
         DynamicJsonDocument doc(1024);
-        DeserializationError error = deserializeJson(doc, response);
+        DeserializationError error = deserializeJson(doc, response.body);
         
         if (!error) {
             token = parseTokenResponse(doc);
         } else {
             Serial.println("Failed to parse token response: " + String(error.c_str()));
         }
+    } else if (response.statusCode > 0) {
+        Serial.println("Auth request failed with code: " + String(response.statusCode));
+        Serial.println("Response: " + response.body);
     } else {
-        Serial.println("Auth request failed with code: " + String(httpCode));
-        if (httpCode > 0) {
-            Serial.println("Response: " + http.getString());
-        }
+        Serial.println("Auth request failed: " + response.error);
     }
     
-    http.end();
     return token;
 }
 
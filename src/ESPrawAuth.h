@@ -2,6 +2,17 @@
  * ESPrawAuth.h - OAuth2 authentication handler for ESPraw
  * 
  * Handles OAuth2 authentication flow with Reddit API
+ * 
+ * Token requests run on a non-blocking ESPrawAsyncEngine. poll() refreshes
+ * the token in the background once it is within refreshMargin of expiring,
+ * and at most one token request is ever in flight: a blocking refresh
+ * started while a background one is running waits for that one instead of
+ * sending another.
+ * 
+ * The background refresh is not entirely non-blocking: the token connection
+ * is not kept alive, so each refresh opens a new one, and the engine's
+ * connect step, TLS handshake included, blocks inside the poll() that
+ * starts sending the request (typically a few hundred ms on an ESP32).
  */
 
 #ifndef ESPRAW_AUTH_H
@@ -12,39 +23,9 @@
 #include <WiFiClientSecure.h>
 #include <ArduinoJson.h>
 #include "ESPrawConfig.h"
-
-/**
- * OAuth2 token information
- */
-struct ESPrawToken {
-    String accessToken;
-    String tokenType;
-    String scope;
-    unsigned long expiresAt;  // Unix timestamp
-    bool isValid;
-    
-    ESPrawToken() : expiresAt(0), isValid(false) {}
-    
-    /**
-     * Check if token is expired
-     * @return true if expired
-     */
-    bool isExpired() const {
-        return millis() / 1000 > expiresAt;
-    }
-    
-    /**
-     * Get remaining validity in seconds
-     * @return seconds until expiration
-     */
-    unsigned long remainingValidity() const {
-        unsigned long now = millis() / 1000;
-        if (now >= expiresAt) {
-            return 0;
-        }
-        return expiresAt - now;
-    }
-};
+#include "ESPrawAsync.h"
+#include "ESPrawTokenStore.h"
+#include "ESPrawTransport.h"
 
 /**
  * ESPrawAuth - OAuth2 authentication handler
@@ -82,9 +63,13 @@ public:
     
     /**
      * Get current access token
+     * 
+     * The reference stays valid, but its contents change when a new token
+     * is installed (by poll(), refreshToken() or authenticating).
+     * 
      * @return Token object
      */
-    ESPrawToken getToken() const;
+    const ESPrawToken& getToken() const;
     
     /**
      * Check if currently authenticated
@@ -93,11 +78,55 @@ public:
     bool isAuthenticated() const;
     
     /**
-     * Refresh the access token if needed
-     * @return true if successful
+     * Refresh the access token, blocking until done
+     * 
+     * Joins a refresh that is already in flight instead of starting another.
+     * 
+     * @return true if a new token was installed
      */
     bool refreshToken();
     
+    /**
+     * Check if the token is due for a background refresh
+     * @return true if the token expires within refreshMargin
+     */
+    bool needsRefresh() const;
+    
+    /**
+     * Start a background refresh unless one is already in flight
+     * @return true if a refresh is in flight
+     */
+    bool startRefresh();
+    
+    /**
+     * Check if a token request is in flight
+     * @return true while a refresh is running
+     */
+    bool isRefreshing() const;
+    
+    /**
+     * Drive background token refresh; call this from loop()
+     * 
+     * Starts a refresh when the token is due (failed attempts are retried
+     * every ESPRAW_TOKEN_REFRESH_RETRY ms) and advances the one in flight.
+     * The current token stays in use until the new one arrives. The call
+     * that connects to the token endpoint blocks for the TLS handshake.
+     * 
+     * @return true if a new token was installed
+     */
+    bool poll();
+    
+    /**
+     * Persist tokens so they survive a reboot
+     * 
+     * Set the store before begin(): authenticating then reuses a saved
+     * token that is still valid, and every new token is saved. Requires
+     * the wall clock to be set (see ESPrawTokenStore.h).
+     * 
+     * @param store Token store, or nullptr to stop persisting (not owned)
+     */
+    void setTokenStore(ESPrawTokenStore* store);
+    
     /**
      * Revoke current token
      * @return true if successful
@@ -106,12 +135,52 @@ public:
     
 private:
     /**
-     * Request access token from Reddit
-     * @param grantType OAuth2 grant type
-     * @param params Additional parameters
-     * @return Token object
+     * Request a new token with the current grant, blocking until done
+     * 
+     * A refresh already in flight is cancelled, since it may use the
+     * previous grant.
+     * 
+     * @return true if a new token was installed
+     */
+    bool requestToken();
+    
+    /**
+     * Install the saved token if it was issued for the current grant
+     * and is still valid
+     * @return true if a saved token was installed
+     */
+    bool restoreToken();
+    
+    /**
+     * Save the current token to the token store
+     */
+    void saveToken();
+    
+    /**
+     * Identify the client and account of the current grant
+     * @return Owner recorded with stored tokens
      */
-    ESPrawToken requestToken(const String& grantType, const String& params);
+    String tokenOwner() const;
+    
+    /**
+     * Wait for the token request in flight to finish
+     * @return true if a new token was installed
+     */
+    bool waitForRefresh();
+    
+    /**
+     * Install the token from the request in flight if it has finished
+     * @param now Current time in milliseconds
+     * @return true if a new token was installed
+     */
+    bool finishRefresh(unsigned long now);
+    
+    /**
+     * Read a token out of a token endpoint response
+     * @param response Response from the token endpoint
+     * @return Token object (invalid on failure)
+     */
+    ESPrawToken readTokenResponse(const ESPrawResponse& response);
     
     /**
      * Parse token response from Reddit
@@ -133,9 +202,23 @@ private:
      */
     String urlEncode(const String& str) const;
     
+    /**
+     * Get the connection for authBaseUrl's scheme
+     * @return Secure or plain client
+     */
+    WiFiClient& authClient();
+    
     ESPrawAuthConfig _config;
     ESPrawToken _token;
     WiFiClientSecure _secureClient;
+    WiFiClient _plainClient;
+    ESPrawUrl _authUrl;
+    ESPrawAsyncEngine _tokenEngine;
+    ESPrawAsyncHandle _refreshHandle;   // Token request in flight
+    String _grantParams;                // Grant used for the current token
+    ESPrawTokenStore* _tokenStore;
+    bool _refreshFailed;
+    unsigned long _refreshFailedAt;
 };
 
 #endif // ESPRAW_AUTH_H
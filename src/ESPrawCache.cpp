@@ -0,0 +1,253 @@
+/**
+ * ESPrawCache.cpp - Response cache implementation
+ */
+
+#include "ESPrawCache.h"
+
+bool ESPrawCacheEntry::isFresh(unsigned long now) const {
+    return now - storedAt < ttl;
+}
+
+bool ESPrawCacheEntry::hasValidator() const {
+    return etag.length() > 0 || lastModified.length() > 0;
+}
+
+bool ESPrawCacheEntry::isServable(unsigned long now, unsigned long staleWindow) const {
+    return now - storedAt < ttl + staleWindow;
+}
+
+size_t ESPrawCacheEntry::cost() const {
+    return sizeof(ESPrawCacheEntry) + key.length() + body.length() +
+           etag.length() + lastModified.length();
+}
+
+ESPrawResponseCache::ESPrawResponseCache(size_t byteBudget, uint32_t defaultTtl)
+    : _ruleCount(0), _budget(byteBudget), _bytes(0), _defaultTtl(defaultTtl), _staleWindow(0),
+      _store(nullptr), _clock(0) {
+}
+
+bool ESPrawResponseCache::setTtl(const String& endpoint, uint32_t seconds) {
+    for (size_t i = 0; i < _ruleCount; i++) {
+        if (_rules[i].endpoint == endpoint) {
+            _rules[i].seconds = seconds;
+            return true;
+        }
+    }
+    
+    if (_ruleCount >= ESPRAW_CACHE_TTL_RULES) {
+        return false;
+    }
+    _rules[_ruleCount].endpoint = endpoint;
+    _rules[_ruleCount].seconds = seconds;
+    _ruleCount++;
+    return true;
+}
+
+uint32_t ESPrawResponseCache::getTtl(const String& endpoint) const {
+    for (size_t i = 0; i < _ruleCount; i++) {
+        if (_rules[i].endpoint == endpoint) {
+            return _rules[i].seconds;
+        }
+    }
+    return _defaultTtl;
+}
+
+void ESPrawResponseCache::setStaleWindow(uint32_t seconds) {
+    _staleWindow = seconds;
+}
+
+uint32_t ESPrawResponseCache::getStaleWindow() const {
+    return _staleWindow;
+}
+
+void ESPrawResponseCache::setStore(ESPrawCacheStore* store) {
+    _store = store;
+}
+
+ESPrawCacheStore* ESPrawResponseCache::getStore() {
+    return _store;
+}
+
+const ESPrawCacheEntry* ESPrawResponseCache::find(const String& key, unsigned long now) {
+    int index = indexOf(key);
+    if (index < 0) {
+        index = loadFromStore(key, now);
+    }
+    if (index < 0) {
+        _stats.misses++;
+        return nullptr;
+    }
+    
+    ESPrawCacheEntry& entry = _entries[index];
+    entry.lastUse = ++_clock;
+    if (entry.isFresh(now)) {
+        _stats.hits++;
+    } else if (entry.isServable(now, _staleWindow * 1000UL)) {
+        _stats.staleHits++;
+    } else {
+        _stats.misses++;
+    }
+    return &entry;
+}
+
+bool ESPrawResponseCache::store(const String& key, const String& body, const String& etag,
+                                const String& lastModified, uint32_t ttl, unsigned long now) {
+    if (ttl == 0) {
+        remove(key);
+        return false;
+    }
+    
+    if (_store != nullptr) {
+        ESPrawStoredResponse response;
+        response.key = key;
+        response.body = body;
+        response.etag = etag;
+        response.lastModified = lastModified;
+        response.storedAt = ESPrawStoredToken::wallClock();
+        response.ttl = ttl;
+        _store->save(response);
+    }
+    
+    ESPrawCacheEntry entry;
+    entry.key = key;
+    entry.body = body;
+    entry.etag = etag;
+    entry.lastModified = lastModified;
+    entry.storedAt = now;
+    entry.ttl = ttl * 1000UL;
+    
+    if (!insert(entry)) {
+        return false;
+    }
+    _stats.stores++;
+    return true;
+}
+
+const ESPrawCacheEntry* ESPrawResponseCache::revalidated(const String& key, unsigned long now) {
+    int index = indexOf(key);
+    if (index < 0) {
+        return nullptr;
+    }
+    
+    ESPrawCacheEntry& entry = _entries[index];
+    entry.storedAt = now;
+    entry.lastUse = ++_clock;
+    _stats.revalidations++;
+    return &entry;
+}
+
+void ESPrawResponseCache::remove(const String& key) {
+    int index = indexOf(key);
+    if (index >= 0) {
+        erase(index);
+    }
+    if (_store != nullptr) {
+        _store->remove(key);
+    }
+}
+
+void ESPrawResponseCache::clear() {
+    _entries.clear();
+    _bytes = 0;
+}
+
+size_t ESPrawResponseCache::size() const {
+    return _entries.size();
+}
+
+size_t ESPrawResponseCache::bytesUsed() const {
+    return _bytes;
+}
+
+size_t ESPrawResponseCache::getByteBudget() const {
+    return _budget;
+}
+
+const ESPrawCacheStats& ESPrawResponseCache::getStats() const {
+    return _stats;
+}
+
+void ESPrawResponseCache::resetStats() {
+    _stats = ESPrawCacheStats();
+}
+
+int ESPrawResponseCache::indexOf(const String& key) const {
+    for (size_t i = 0; i < _entries.size(); i++) {
+        if (_entries[i].key == key) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void ESPrawResponseCache::erase(size_t index) {
+    _bytes -= _entries[index].cost();
+    
+    // Order does not matter, so the last entry fills the gap
+    if (index + 1 < _entries.size()) {
+        _entries[index] = std::move(_entries.back());
+    }
+    _entries.pop_back();
+}
+
+void ESPrawResponseCache::makeRoom(size_t extra) {
+    while (!_entries.empty() && _bytes + extra > _budget) {
+        size_t oldest = 0;
+        for (size_t i = 1; i < _entries.size(); i++) {
+            if (_entries[i].lastUse < _entries[oldest].lastUse) {
+                oldest = i;
+            }
+        }
+        erase(oldest);
+        _stats.evictions++;
+    }
+}
+
+bool ESPrawResponseCache::insert(const ESPrawCacheEntry& entry) {
+    int index = indexOf(entry.key);
+    if (index >= 0) {
+        erase(index);
+    }
+    
+    size_t cost = entry.cost();
+    if (cost > _budget) {
+        return false;
+    }
+    
+    makeRoom(cost);
+    _entries.push_back(entry);
+    _entries.back().lastUse = ++_clock;
+    _bytes += cost;
+    return true;
+}
+
+int ESPrawResponseCache::loadFromStore(const String& key, unsigned long now) {
+    ESPrawStoredResponse response;
+    if (_store == nullptr || !_store->load(key, response)) {
+        return -1;
+    }
+    
+    ESPrawCacheEntry entry;
+    entry.key = key;
+    entry.body = response.body;
+    entry.etag = response.etag;
+    entry.lastModified = response.lastModified;
+    entry.ttl = response.ttl * 1000UL;
+    
+    // Map the wall-clock age onto millis(). An unknown age counts as just
+    // expired, and one past the stale window as too old to answer
+    uint64_t wallNow = ESPrawStoredToken::wallClock();
+    if (wallNow == 0 || response.storedAt == 0 || response.storedAt > wallNow) {
+        entry.storedAt = now - entry.ttl;
+    } else if (wallNow - response.storedAt <= response.ttl + _staleWindow) {
+        entry.storedAt = now - (unsigned long)(wallNow - response.storedAt) * 1000UL;
+    } else {
+        entry.storedAt = now - entry.ttl - _staleWindow * 1000UL;
+    }
+    
+    if (!insert(entry)) {
+        return -1;
+    }
+    _stats.storeLoads++;
+    return _entries.size() - 1;
+}
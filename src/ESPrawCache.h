@@ -0,0 +1,281 @@
+/**
+ * ESPrawCache.h - Response cache for ESPraw
+ *
+ * Keeps recent GET responses in RAM so that polling the same /about pages
+ * does not cost a round trip and a rate limit token every time:
+ *
+ *   ESPrawResponseCache cache(8192);
+ *   cache.setTtl("/r/{}/about", 600);
+ *   reddit.getClient().setCache(&cache);
+ *
+ * A fresh entry answers the request outright. Once it expires the next
+ * request carries If-None-Match/If-Modified-Since, and a 304 answer makes
+ * the entry fresh again without transferring the body. With a stale window
+ * set, an expired entry is still answered at once while the client
+ * revalidates it in the background (ESPraw::poll() drives that request).
+ *
+ * With a cache store (see ESPrawCacheStore.h) responses are kept in flash
+ * too, and entries missing from RAM are looked up there.
+ *
+ * Like the rate limiters, every call takes the current time in
+ * milliseconds. The cache is not thread-safe; share it only between
+ * requests made from one task.
+ */
+
+#ifndef ESPRAW_CACHE_H
+#define ESPRAW_CACHE_H
+
+#include <Arduino.h>
+#include <vector>
+#include "ESPrawConfig.h"
+#include "ESPrawCacheStore.h"
+
+/**
+ * One cached response
+ */
+struct ESPrawCacheEntry {
+    String key;               // Request URL, plus the body format for getJson()
+    String body;
+    String etag;              // Validators for revalidation (may be empty)
+    String lastModified;
+    unsigned long storedAt;   // millis() when stored or last revalidated
+    unsigned long ttl;        // Freshness lifetime in milliseconds
+    unsigned long lastUse;    // Use order for LRU eviction
+
+    ESPrawCacheEntry() : storedAt(0), ttl(0), lastUse(0) {}
+
+    /**
+     * Check if the entry may be used without asking the server
+     * @param now Current time in milliseconds
+     * @return true while the TTL has not passed
+     */
+    bool isFresh(unsigned long now) const;
+
+    /**
+     * Check if the entry may be answered while it is revalidated
+     * @param now Current time in milliseconds
+     * @param staleWindow Milliseconds past the TTL that are acceptable
+     * @return true while the TTL plus the stale window has not passed
+     */
+    bool isServable(unsigned long now, unsigned long staleWindow) const;
+
+    /**
+     * Check if the entry can be revalidated with a conditional request
+     * @return true if an ETag or Last-Modified date is known
+     */
+    bool hasValidator() const;
+
+    /**
+     * Get the bytes the entry counts against the budget
+     * @return Entry size including its strings
+     */
+    size_t cost() const;
+};
+
+/**
+ * Cache counters
+ */
+struct ESPrawCacheStats {
+    unsigned long hits;            // Answered from a fresh entry, no request sent
+    unsigned long staleHits;       // Answered past the TTL, revalidated in the background
+    unsigned long misses;          // Needed a request first (no entry, or too stale)
+    unsigned long revalidations;   // Expired entries confirmed by 304 Not Modified
+    unsigned long stores;          // Responses added or replaced
+    unsigned long evictions;       // Entries dropped to stay within the budget
+    unsigned long storeLoads;      // Entries brought back from the cache store
+
+    ESPrawCacheStats()
+        : hits(0), staleHits(0), misses(0), revalidations(0), stores(0), evictions(0),
+          storeLoads(0) {}
+};
+
+/**
+ * ESPrawResponseCache - LRU response cache with a byte budget
+ */
+class ESPrawResponseCache {
+public:
+    /**
+     * Constructor
+     * @param byteBudget Most bytes kept, entry overhead included
+     * @param defaultTtl Lifetime in seconds for endpoints without a rule
+     */
+    explicit ESPrawResponseCache(size_t byteBudget = ESPRAW_CACHE_BUDGET,
+                                 uint32_t defaultTtl = ESPRAW_CACHE_DEFAULT_TTL);
+
+    /**
+     * Set the lifetime of an endpoint's responses
+     * @param endpoint Endpoint pattern as reported by
+     *                 ESPrawLatencyTracker::normalizeEndpoint(), e.g. "/r/{}/about"
+     * @param seconds Lifetime in seconds; 0 disables caching the endpoint
+     * @return false if all ESPRAW_CACHE_TTL_RULES rules are taken
+     */
+    bool setTtl(const String& endpoint, uint32_t seconds);
+
+    /**
+     * Get the lifetime of an endpoint's responses
+     * @param endpoint Endpoint pattern
+     * @return Lifetime in seconds
+     */
+    uint32_t getTtl(const String& endpoint) const;
+
+    /**
+     * Answer expired entries while they are revalidated in the background
+     * @param seconds How long past its TTL an entry may be answered (0 = never)
+     */
+    void setStaleWindow(uint32_t seconds);
+
+    /**
+     * Get the stale window
+     * @return Seconds past the TTL that entries may be answered
+     */
+    uint32_t getStaleWindow() const;
+
+    /**
+     * Keep responses in a persistent store as well
+     *
+     * The store must outlive the cache. Pass nullptr to keep them in RAM only.
+     *
+     * @param store Cache store
+     */
+    void setStore(ESPrawCacheStore* store);
+
+    /**
+     * Get the persistent store
+     * @return Store, or nullptr if none is set
+     */
+    ESPrawCacheStore* getStore();
+
+    /**
+     * Look up an entry in RAM, then in the store
+     *
+     * Counts a hit if the entry is fresh, a stale hit if it is within the
+     * stale window, and a miss otherwise.
+     *
+     * @param key Cache key
+     * @param now Current time in milliseconds
+     * @return Entry (fresh or stale), or nullptr; valid until the cache is
+     *         next modified
+     */
+    const ESPrawCacheEntry* find(const String& key, unsigned long now);
+
+    /**
+     * Add or replace an entry, evicting least recently used ones as needed
+     *
+     * The response is also saved to the store, if any.
+     *
+     * @param key Cache key
+     * @param body Response body
+     * @param etag ETag response header (may be empty)
+     * @param lastModified Last-Modified response header (may be empty)
+     * @param ttl Lifetime in seconds
+     * @param now Current time in milliseconds
+     * @return false if the entry alone exceeds the budget or ttl is 0
+     */
+    bool store(const String& key, const String& body, const String& etag,
+               const String& lastModified, uint32_t ttl, unsigned long now);
+
+    /**
+     * Mark an entry fresh again after a 304 Not Modified
+     *
+     * Only the RAM entry is updated; rewriting flash for a new date is not
+     * worth the wear.
+     *
+     * @param key Cache key
+     * @param now Current time in milliseconds
+     * @return Entry, or nullptr if it is no longer cached
+     */
+    const ESPrawCacheEntry* revalidated(const String& key, unsigned long now);
+
+    /**
+     * Drop an entry, from the store too
+     * @param key Cache key
+     */
+    void remove(const String& key);
+
+    /**
+     * Drop all entries from RAM (the store and the counters are kept)
+     */
+    void clear();
+
+    /**
+     * Get number of entries
+     * @return Entry count
+     */
+    size_t size() const;
+
+    /**
+     * Get bytes in use
+     * @return Sum of the entries' cost()
+     */
+    size_t bytesUsed() const;
+
+    /**
+     * Get the byte budget
+     * @return Budget in bytes
+     */
+    size_t getByteBudget() const;
+
+    /**
+     * Get cache counters
+     * @return Counters since construction or the last reset
+     */
+    const ESPrawCacheStats& getStats() const;
+
+    /**
+     * Reset cache counters
+     */
+    void resetStats();
+
+private:
+    /**
+     * Find an entry's index
+     * @param key Cache key
+     * @return Index, or -1 if not cached
+     */
+    int indexOf(const String& key) const;
+
+    /**
+     * Drop an entry by index
+     * @param index Entry index
+     */
+    void erase(size_t index);
+
+    /**
+     * Evict least recently used entries until extra bytes fit the budget
+     * @param extra Bytes about to be added
+     */
+    void makeRoom(size_t extra);
+
+    /**
+     * Add an entry to RAM, replacing one with the same key
+     * @param entry Entry to add
+     * @return false if the entry alone exceeds the budget
+     */
+    bool insert(const ESPrawCacheEntry& entry);
+
+    /**
+     * Bring a response back from the store
+     * @param key Cache key
+     * @param now Current time in milliseconds
+     * @return Index of the new RAM entry, or -1
+     */
+    int loadFromStore(const String& key, unsigned long now);
+
+    struct TtlRule {
+        String endpoint;
+        uint32_t seconds;
+    };
+
+    std::vector<ESPrawCacheEntry> _entries;
+    TtlRule _rules[ESPRAW_CACHE_TTL_RULES];
+    size_t _ruleCount;
+    size_t _budget;
+    size_t _bytes;
+    uint32_t _defaultTtl;
+    uint32_t _staleWindow;
+    ESPrawCacheStore* _store;
+    unsigned long _clock;   // Incremented per use, orders lastUse
+    ESPrawCacheStats _stats;
+};
+
+#endif // ESPRAW_CACHE_H
@@ -0,0 +1,294 @@
+/**
+ * ESPrawCacheStore.cpp - Persistent cache tier implementation
+ */
+
+#include "ESPrawCacheStore.h"
+#include "ESPrawUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define ESPRAW_CACHE_FILE_MAGIC "ESPRAW-CACHE 1"
+#define ESPRAW_CACHE_FILE_SUFFIX ".rc"
+
+// File layout: magic, key, ETag, Last-Modified, stored time and TTL one per
+// line, then the body up to the end of the file
+
+ESPrawFileCacheStore::ESPrawFileCacheStore(const String& directory, size_t byteCap, uint32_t maxStale)
+    : _directory(directory), _byteCap(byteCap), _maxStale(maxStale), _pendingSince(0),
+      _bytes(0), _writes(0) {
+    if (_directory.endsWith("/")) {
+        _directory = _directory.substring(0, _directory.length() - 1);
+    }
+}
+
+ESPrawFileCacheStore::~ESPrawFileCacheStore() {
+    flush();
+}
+
+bool ESPrawFileCacheStore::begin() {
+    mkdir(_directory.c_str(), 0755);
+    DIR* dir = opendir(_directory.c_str());
+    if (dir == nullptr) {
+        return false;
+    }
+    
+    _index.clear();
+    _bytes = 0;
+    
+    struct dirent* item;
+    while ((item = readdir(dir)) != nullptr) {
+        String name = item->d_name;
+        if (!name.endsWith(ESPRAW_CACHE_FILE_SUFFIX)) {
+            continue;
+        }
+        
+        String path = _directory + "/" + name;
+        ESPrawStoredResponse response;
+        if (!readFile(path, response) || pathFor(response.key) != path) {
+            ::remove(path.c_str());   // Damaged, or written by another version
+            continue;
+        }
+        
+        struct stat info;
+        IndexEntry entry;
+        entry.key = response.key;
+        entry.size = stat(path.c_str(), &info) == 0 ? (size_t)info.st_size : 0;
+        entry.contentHash = contentHash(response);
+        entry.storedAt = response.storedAt;
+        entry.ttl = response.ttl;
+        _index.push_back(entry);
+        _bytes += entry.size;
+    }
+    closedir(dir);
+    
+    evict(ESPrawStoredToken::wallClock());
+    return true;
+}
+
+bool ESPrawFileCacheStore::load(const String& key, ESPrawStoredResponse& response) {
+    int pending = pendingIndexOf(key);
+    if (pending >= 0) {
+        response = _pending[pending];
+        return true;
+    }
+    
+    if (indexOf(key) < 0) {
+        return false;
+    }
+    return readFile(pathFor(key), response) && response.key == key;
+}
+
+bool ESPrawFileCacheStore::save(const ESPrawStoredResponse& response) {
+    // Header lines can't hold a newline; the body can
+    if (response.key.indexOf('\n') >= 0 || response.etag.indexOf('\n') >= 0 ||
+        response.lastModified.indexOf('\n') >= 0 ||
+        response.body.length() + response.key.length() > _byteCap) {
+        return false;
+    }
+    
+    int index = indexOf(response.key);
+    if (index >= 0 && _index[index].contentHash == contentHash(response)) {
+        // Same content: rewriting would only refresh the date
+        int pending = pendingIndexOf(response.key);
+        if (pending >= 0) {
+            _pending.erase(_pending.begin() + pending);
+        }
+        return true;
+    }
+    
+    int pending = pendingIndexOf(response.key);
+    if (pending >= 0) {
+        _pending[pending] = response;
+    } else {
+        if (_pending.empty()) {
+            _pendingSince = millis();
+        }
+        _pending.push_back(response);
+    }
+    
+    if (_pending.size() >= ESPRAW_FILE_CACHE_BATCH ||
+        millis() - _pendingSince >= ESPRAW_FILE_CACHE_FLUSH_INTERVAL) {
+        flush();
+    }
+    return true;
+}
+
+void ESPrawFileCacheStore::remove(const String& key) {
+    int pending = pendingIndexOf(key);
+    if (pending >= 0) {
+        _pending.erase(_pending.begin() + pending);
+    }
+    
+    int index = indexOf(key);
+    if (index >= 0) {
+        eraseFile(index);
+    }
+}
+
+void ESPrawFileCacheStore::flush() {
+    for (size_t i = 0; i < _pending.size(); i++) {
+        writeFile(_pending[i]);
+    }
+    _pending.clear();
+    evict(ESPrawStoredToken::wallClock());
+}
+
+size_t ESPrawFileCacheStore::size() const {
+    size_t count = _index.size();
+    for (size_t i = 0; i < _pending.size(); i++) {
+        if (indexOf(_pending[i].key) < 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t ESPrawFileCacheStore::bytesUsed() const {
+    return _bytes;
+}
+
+unsigned long ESPrawFileCacheStore::getWrites() const {
+    return _writes;
+}
+
+String ESPrawFileCacheStore::pathFor(const String& key) const {
+    char name[16];
+    snprintf(name, sizeof(name), "%08lx", (unsigned long)ESPrawUtil::fnv1a(key));
+    return _directory + "/" + name + ESPRAW_CACHE_FILE_SUFFIX;
+}
+
+bool ESPrawFileCacheStore::readFile(const String& path, ESPrawStoredResponse& response) {
+    FILE* file = fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        return false;
+    }
+    
+    String magic;
+    String storedAt;
+    String ttl;
+    bool complete = ESPrawUtil::readLine(file, magic) && magic == ESPRAW_CACHE_FILE_MAGIC &&
+                    ESPrawUtil::readLine(file, response.key) && ESPrawUtil::readLine(file, response.etag) &&
+                    ESPrawUtil::readLine(file, response.lastModified) && ESPrawUtil::readLine(file, storedAt) &&
+                    ESPrawUtil::readLine(file, ttl);
+    
+    if (complete) {
+        response.body = "";
+        char buffer[129];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer) - 1, file)) > 0) {
+            buffer[n] = '\0';
+            response.body += buffer;
+        }
+    }
+    fclose(file);
+    
+    if (!complete) {
+        return false;
+    }
+    
+    response.storedAt = strtoull(storedAt.c_str(), nullptr, 10);
+    response.ttl = strtoul(ttl.c_str(), nullptr, 10);
+    return true;
+}
+
+bool ESPrawFileCacheStore::writeFile(const ESPrawStoredResponse& response) {
+    // Written next to the old file and renamed over it, so losing power
+    // mid-write leaves the previous version intact
+    String path = pathFor(response.key);
+    String temporary = path + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+    
+    int header = fprintf(file, "%s\n%s\n%s\n%s\n%llu\n%lu\n", ESPRAW_CACHE_FILE_MAGIC,
+                         response.key.c_str(), response.etag.c_str(),
+                         response.lastModified.c_str(), (unsigned long long)response.storedAt,
+                         (unsigned long)response.ttl);
+    size_t body = fwrite(response.body.c_str(), 1, response.body.length(), file);
+    bool closed = fclose(file) == 0;
+    _writes++;
+    
+    if (header <= 0 || body != response.body.length() || !closed ||
+        rename(temporary.c_str(), path.c_str()) != 0) {
+        ::remove(temporary.c_str());
+        return false;
+    }
+    
+    // Keys whose hashes collide share a file: the one written last owns it,
+    // and the other is forgotten so erasing it can't delete this one's data
+    for (size_t i = _index.size(); i-- > 0;) {
+        if (_index[i].key != response.key && pathFor(_index[i].key) == path) {
+            _bytes -= _index[i].size;
+            _index.erase(_index.begin() + i);
+        }
+    }
+    
+    int index = indexOf(response.key);
+    if (index < 0) {
+        _index.push_back(IndexEntry());
+        index = _index.size() - 1;
+    } else {
+        _bytes -= _index[index].size;
+    }
+    
+    IndexEntry& entry = _index[index];
+    entry.key = response.key;
+    entry.size = header + body;
+    entry.contentHash = contentHash(response);
+    entry.storedAt = response.storedAt;
+    entry.ttl = response.ttl;
+    _bytes += entry.size;
+    return true;
+}
+
+uint32_t ESPrawFileCacheStore::contentHash(const ESPrawStoredResponse& response) {
+    return ESPrawUtil::fnv1a(response.body, ESPrawUtil::fnv1a(response.etag, ESPrawUtil::fnv1a(response.lastModified)));
+}
+
+void ESPrawFileCacheStore::evict(uint64_t now) {
+    // Without a clock nothing can be said to have expired
+    if (now > 0) {
+        for (size_t i = _index.size(); i-- > 0;) {
+            if (_index[i].storedAt + _index[i].ttl + _maxStale < now) {
+                eraseFile(i);
+            }
+        }
+    }
+    
+    while (_bytes > _byteCap && !_index.empty()) {
+        size_t oldest = 0;
+        for (size_t i = 1; i < _index.size(); i++) {
+            if (_index[i].storedAt < _index[oldest].storedAt) {
+                oldest = i;
+            }
+        }
+        eraseFile(oldest);
+    }
+}
+
+int ESPrawFileCacheStore::indexOf(const String& key) const {
+    for (size_t i = 0; i < _index.size(); i++) {
+        if (_index[i].key == key) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int ESPrawFileCacheStore::pendingIndexOf(const String& key) const {
+    for (size_t i = 0; i < _pending.size(); i++) {
+        if (_pending[i].key == key) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void ESPrawFileCacheStore::eraseFile(size_t index) {
+    ::remove(pathFor(_index[index].key).c_str());
+    _bytes -= _index[index].size;
+    _index.erase(_index.begin() + index);
+}
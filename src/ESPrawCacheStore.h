@@ -0,0 +1,219 @@
+/**
+ * ESPrawCacheStore.h - Persistent tier for the response cache
+ *
+ * The RAM cache is lost on every reboot and deep-sleep wake. A cache store
+ * keeps the (compacted, already filtered) payloads in flash as well, so a
+ * dashboard that wakes up can render from the last responses at once:
+ *
+ *   LittleFS.begin(true);
+ *   ESPrawFileCacheStore flash("/littlefs/espraw");
+ *   flash.begin();
+ *   cache.setStore(&flash);
+ *   ...
+ *   flash.flush();
+ *   esp_deep_sleep_start();
+ *
+ * Stored responses carry wall-clock times, so the clock must be set for
+ * their age to be known (see ESPrawStoredToken::wallClock()); without it
+ * they are treated as just expired.
+ */
+
+#ifndef ESPRAW_CACHE_STORE_H
+#define ESPRAW_CACHE_STORE_H
+
+#include <Arduino.h>
+#include <vector>
+#include "ESPrawConfig.h"
+#include "ESPrawTokenStore.h"
+
+/**
+ * A cached response as kept by a cache store
+ */
+struct ESPrawStoredResponse {
+    String key;
+    String body;
+    String etag;
+    String lastModified;
+    uint64_t storedAt;      // Wall-clock time stored (Unix seconds)
+    uint32_t ttl;           // Lifetime in seconds
+
+    ESPrawStoredResponse() : storedAt(0), ttl(0) {}
+};
+
+/**
+ * ESPrawCacheStore - Interface for persisting cached responses
+ */
+class ESPrawCacheStore {
+public:
+    virtual ~ESPrawCacheStore() {}
+
+    /**
+     * Load a stored response
+     * @param key Cache key
+     * @param response Receives the response
+     * @return true if the key is stored
+     */
+    virtual bool load(const String& key, ESPrawStoredResponse& response) = 0;
+
+    /**
+     * Store a response, replacing any stored under the same key
+     *
+     * Stores may defer the write; flush() completes it.
+     *
+     * @param response Response to store
+     * @return false if the response can't be stored
+     */
+    virtual bool save(const ESPrawStoredResponse& response) = 0;
+
+    /**
+     * Forget a stored response
+     * @param key Cache key
+     */
+    virtual void remove(const String& key) = 0;
+
+    /**
+     * Write deferred responses out, e.g. before deep sleep
+     */
+    virtual void flush() {}
+};
+
+/**
+ * ESPrawFileCacheStore - Keeps responses as files in a directory
+ *
+ * Works wherever stdio and dirent do: a directory on the native host, or a
+ * mounted LittleFS/SPIFFS path on the ESP32. Flash wears with every write,
+ * so writes are collected and done in batches (once ESPRAW_FILE_CACHE_BATCH
+ * responses are waiting, or at the first save() after
+ * ESPRAW_FILE_CACHE_FLUSH_INTERVAL), a response that
+ * is saved again with the same body and validators is not rewritten, and
+ * revalidations are never written; after a reboot such an entry just
+ * looks older and is revalidated sooner. Files past their TTL by more than
+ * the stale limit are deleted, and the oldest go first when the byte cap
+ * is reached.
+ */
+class ESPrawFileCacheStore : public ESPrawCacheStore {
+public:
+    /**
+     * Constructor
+     * @param directory Directory to keep the files in
+     * @param byteCap Most bytes kept in files
+     * @param maxStale Seconds past their TTL that responses are kept
+     */
+    explicit ESPrawFileCacheStore(const String& directory,
+                                  size_t byteCap = ESPRAW_FILE_CACHE_CAP,
+                                  uint32_t maxStale = ESPRAW_CACHE_MAX_STALE);
+
+    /**
+     * Destructor (writes deferred responses)
+     */
+    ~ESPrawFileCacheStore();
+
+    /**
+     * Create the directory if needed and index the files in it, deleting
+     * expired ones
+     * @return false if the directory can't be used
+     */
+    bool begin();
+
+    bool load(const String& key, ESPrawStoredResponse& response) override;
+    bool save(const ESPrawStoredResponse& response) override;
+    void remove(const String& key) override;
+    void flush() override;
+
+    /**
+     * Get number of stored responses, written or not
+     * @return Response count
+     */
+    size_t size() const;
+
+    /**
+     * Get bytes kept in files
+     * @return Sum of the file sizes
+     */
+    size_t bytesUsed() const;
+
+    /**
+     * Get number of files written since construction
+     * @return Write count, a measure of flash wear
+     */
+    unsigned long getWrites() const;
+
+private:
+    struct IndexEntry {
+        String key;
+        size_t size;          // File size in bytes
+        uint32_t contentHash; // Body and validators, to skip identical rewrites
+        uint64_t storedAt;
+        uint32_t ttl;
+    };
+
+    /**
+     * Get the file a key is kept in
+     * 
+     * Named after a 32-bit hash of the key. Two keys that collide share the
+     * file, so only the one written last stays stored.
+     * 
+     * @param key Cache key
+     * @return File path
+     */
+    String pathFor(const String& key) const;
+
+    /**
+     * Read a response file
+     * @param path File path
+     * @param response Receives the response
+     * @return true if the file is a valid response file
+     */
+    static bool readFile(const String& path, ESPrawStoredResponse& response);
+
+    /**
+     * Write a response file and index it
+     * @param response Response to write
+     * @return true if successful
+     */
+    bool writeFile(const ESPrawStoredResponse& response);
+
+    /**
+     * Hash the parts of a response that are worth rewriting for
+     * @param response Response
+     * @return FNV-1a hash of the body and validators
+     */
+    static uint32_t contentHash(const ESPrawStoredResponse& response);
+
+    /**
+     * Delete expired files, then the oldest until the cap holds
+     * @param now Current wall-clock time (0 if unknown)
+     */
+    void evict(uint64_t now);
+
+    /**
+     * Find a written response
+     * @param key Cache key
+     * @return Index in _index, or -1
+     */
+    int indexOf(const String& key) const;
+    
+    /**
+     * Find a response waiting to be written
+     * @param key Cache key
+     * @return Index in _pending, or -1
+     */
+    int pendingIndexOf(const String& key) const;
+    
+    /**
+     * Delete a written response
+     * @param index Index in _index
+     */
+    void eraseFile(size_t index);
+
+    String _directory;
+    size_t _byteCap;
+    uint32_t _maxStale;
+    std::vector<IndexEntry> _index;
+    std::vector<ESPrawStoredResponse> _pending;   // Saved but not yet written
+    unsigned long _pendingSince;                  // millis() of the oldest pending save
+    size_t _bytes;
+    unsigned long _writes;
+};
+
+#endif // ESPRAW_CACHE_STORE_H
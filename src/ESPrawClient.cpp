@@ -5,24 +5,47 @@
 #include "ESPrawClient.h"
 
 ESPrawClient::ESPrawClient() 
-    : _requestCount(0), _lastCleanup(0) {
-    memset(_requestTimes, 0, sizeof(_requestTimes));
+    : _transport(&_httpTransport),
+      _windowLimiter(ESPRAW_RATE_LIMIT_REQUESTS, ESPRAW_RATE_LIMIT_WINDOW),
+      _bucketLimiter(ESPRAW_RATE_LIMIT_REQUESTS, ESPRAW_RATE_LIMIT_WINDOW, ESPRAW_RATE_LIMIT_BURST),
+      _customLimiter(nullptr),
+      _cache(nullptr),
+      _busy(false),
+      _async(_asyncSecureClient, ESPRAW_API_HOST, ESPRAW_API_PORT) {
+    // Async requests share the rate limit state with blocking ones
+    _async.setWaitHook([this](unsigned long) {
+        return timeUntilNextRequest();
+    });
+    _async.setSentHook([this](unsigned long) {
+        recordRequest();
+    });
+    _async.setResponseHook([this](int, const ESPrawAsyncHeaders& headers, unsigned long now) {
+        if (_config.rateLimitMode == ESPrawRateLimitMode::SERVER_HEADERS) {
+            _serverRateLimit.update(headers.rateLimitUsed.c_str(),
+                                    headers.rateLimitRemaining.c_str(),
+                                    headers.rateLimitReset.c_str(), now);
+        }
+    });
 }
 
 ESPrawClient::~ESPrawClient() {
-    // Cleanup
+    closeConnection();
 }
 
 bool ESPrawClient::begin(const ESPrawRequestConfig& config) {
+    if (!ESPrawUrl::parse(config.apiBaseUrl, _apiUrl)) {
+        Serial.println("Invalid API base URL: " + config.apiBaseUrl);
+        return false;
+    }
+    
     _config = config;
-    // SECURITY WARNING: Certificate validation is currently disabled
-    // This is a known security issue and should be addressed before production use
-    // TODO: Implement proper certificate validation
-    // For production, consider:
-    // 1. Loading Reddit's root CA certificate
-    // 2. Using certificate fingerprint validation
-    // 3. Implementing certificate bundle validation
-    _secureClient.setInsecure();
+    _windowLimiter.configure(config.rateLimitRequests, config.rateLimitWindow);
+    _bucketLimiter.configure(config.rateLimitRequests, config.rateLimitWindow, config.rateLimitBurst);
+    // Certificate validation is disabled here too; see ESPrawHttpTransport
+    _asyncSecureClient.setInsecure();
+    _async.setServer(_apiUrl.secure ? static_cast<Client&>(_asyncSecureClient) : _asyncPlainClient,
+                     _apiUrl.host, _apiUrl.port);
+    _async.begin(config);
     return true;
 }
 
@@ -30,7 +53,7 @@ void ESPrawClient::setAccessToken(const String& token) {
     _accessToken = token;
 }
 
-String ESPrawClient::getAccessToken() const {
+const String& ESPrawClient::getAccessToken() const {
     return _accessToken;
 }
 
@@ -40,7 +63,92 @@ void ESPrawClient::setUserAgent(const String& userAgent) {
 
 ESPrawResponse ESPrawClient::get(const String& endpoint, const String& params) {
     String url = buildUrl(endpoint, params);
-    return performRequest(ESPrawRequestMethod::GET, url);
+    uint32_t ttl = cacheTtl(url);
+    if (ttl == 0) {
+        return performRequest(ESPrawRequestMethod::GET, url);
+    }
+    
+    CacheCodec codec;
+    codec.save = [](const ESPrawResponse& response) {
+        return response.body;
+    };
+    codec.load = [](ESPrawResponse& response, const String& payload) {
+        response.body = payload;
+        return true;
+    };
+    codec.compact = [](const String& body) {
+        return body;
+    };
+    return cachedGet(url, url, ttl, nullptr, codec);
+}
+
+ESPrawResponse ESPrawClient::getJson(const String& endpoint, JsonDocument& doc, const String& params,
+                                     const JsonDocument* filter) {
+    DeserializationError error;
+    ESPrawBodyHandler handler = [&doc, filter, &error](Stream& body) {
+        if (filter != nullptr) {
+            error = deserializeJson(doc, body, DeserializationOption::Filter(*filter));
+        } else {
+            error = deserializeJson(doc, body);
+        }
+        return !error;
+    };
+    
+    String url = buildUrl(endpoint, params);
+    uint32_t ttl = cacheTtl(url);
+    ESPrawResponse response;
+    
+    if (ttl == 0) {
+        response = performRequest(ESPrawRequestMethod::GET, url, "", "", &handler);
+    } else {
+        // The filtered document is cached compacted, so a later hit skips
+        // both the download and the filtering
+        String fields;
+        if (filter != nullptr) {
+            serializeJson(*filter, fields);
+        }
+        size_t capacity = doc.capacity();
+        
+        CacheCodec codec;
+        codec.save = [&doc, &error](const ESPrawResponse&) {
+            String payload;
+            if (!error) {
+                serializeJson(doc, payload);
+            }
+            return payload;
+        };
+        codec.load = [&doc, &error](ESPrawResponse&, const String& payload) {
+            error = deserializeJson(doc, payload);
+            return !error;
+        };
+        // Background refreshes get the whole body and filter it the same way
+        codec.compact = [fields, capacity](const String& body) {
+            if (fields.length() == 0) {
+                return body;
+            }
+            DynamicJsonDocument filterDoc(fields.length() * 6 + 64);
+            DynamicJsonDocument refreshed(capacity);
+            String payload;
+            if (!deserializeJson(filterDoc, fields) &&
+                !deserializeJson(refreshed, body, DeserializationOption::Filter(filterDoc))) {
+                serializeJson(refreshed, payload);
+            }
+            return payload;
+        };
+        response = cachedGet(url, jsonCacheKey(url, fields), ttl, &handler, codec);
+    }
+    
+    if (error) {
+        response.error = "JSON parse error: " + String(error.c_str());
+    }
+    
+    return response;
+}
+
+ESPrawResponse ESPrawClient::getStream(const String& endpoint, const ESPrawBodyHandler& handler,
+                                       const String& params) {
+    String url = buildUrl(endpoint, params);
+    return performRequest(ESPrawRequestMethod::GET, url, "", "", &handler);
 }
 
 ESPrawResponse ESPrawClient::post(const String& endpoint, const String& body, 
@@ -60,44 +168,101 @@ ESPrawResponse ESPrawClient::delete_(const String& endpoint) {
     return performRequest(ESPrawRequestMethod::DELETE_METHOD, url);
 }
 
+ESPrawAsyncHandle ESPrawClient::getAsync(const String& endpoint, const String& params,
+                                         const ESPrawAsyncCallback& callback) {
+    String path = _apiUrl.path + endpoint;
+    if (params.length() > 0) {
+        path += "?" + params;
+    }
+    return _async.submit(ESPrawRequestMethod::GET, path, buildHeaderLines(), "", "", callback);
+}
+
+ESPrawAsyncHandle ESPrawClient::postAsync(const String& endpoint, const String& body,
+                                          const ESPrawAsyncCallback& callback) {
+    return _async.submit(ESPrawRequestMethod::POST, _apiUrl.path + endpoint, buildHeaderLines(),
+                         body, "application/x-www-form-urlencoded", callback);
+}
+
+bool ESPrawClient::poll() {
+    return _async.poll(millis());
+}
+
+ESPrawAsyncState ESPrawClient::getAsyncState(ESPrawAsyncHandle handle) const {
+    return _async.getState(handle);
+}
+
+bool ESPrawClient::takeAsyncResponse(ESPrawAsyncHandle handle, ESPrawResponse& response) {
+    return _async.takeResponse(handle, response);
+}
+
+bool ESPrawClient::cancelAsync(ESPrawAsyncHandle handle) {
+    return _async.cancel(handle);
+}
+
 bool ESPrawClient::checkRateLimit() {
-    cleanupRequestLog();
-    return _requestCount < ESPRAW_RATE_LIMIT_REQUESTS;
+    return getRateLimiter().canRequest(millis());
 }
 
 unsigned long ESPrawClient::timeUntilNextRequest() {
-    if (checkRateLimit()) {
-        return 0;
-    }
-    
-    cleanupRequestLog();
-    
-    if (_requestCount == 0) {
-        return 0;
+    return getRateLimiter().timeUntilNextRequest(millis());
+}
+
+void ESPrawClient::setRateLimiter(ESPrawRateLimiter* limiter) {
+    _customLimiter = limiter;
+}
+
+ESPrawRateLimiter& ESPrawClient::getRateLimiter() {
+    if (_customLimiter != nullptr) {
+        return *_customLimiter;
     }
-    
-    unsigned long oldestRequest = _requestTimes[0];
-    unsigned long timeElapsed = millis() - oldestRequest;
-    
-    if (timeElapsed >= ESPRAW_RATE_LIMIT_WINDOW) {
-        return 0;
+    if (useServerRateLimit()) {
+        return _serverRateLimit;
     }
-    
-    return ESPRAW_RATE_LIMIT_WINDOW - timeElapsed;
+    return localRateLimiter();
 }
 
 ESPrawResponse ESPrawClient::performRequest(ESPrawRequestMethod method, 
                                            const String& url,
                                            const String& body,
-                                           const String& contentType) {
+                                           const String& contentType,
+                                           const ESPrawBodyHandler* handler,
+                                           const String& extraHeaders) {
+    // A body handler reads straight from the connection; a request made
+    // from inside it would send over that connection mid-response
+    if (_busy) {
+        ESPrawResponse response;
+        response.error = "Request already in progress";
+        return response;
+    }
+    
+    _busy = true;
+    unsigned long start = micros();
+    ESPrawResponse response = sendWithRetries(method, url, body, contentType, handler, extraHeaders);
+    response.timing.total = micros() - start;
+    _busy = false;
+    
+    _latencyStats.record(ESPrawLatencyTracker::normalizeEndpoint(url, _config.apiBaseUrl),
+                         response.timing.total);
+    return response;
+}
+
+ESPrawResponse ESPrawClient::sendWithRetries(ESPrawRequestMethod method,
+                                             const String& url,
+                                             const String& body,
+                                             const String& contentType,
+                                             const ESPrawBodyHandler* handler,
+                                             const String& extraHeaders) {
     ESPrawResponse response;
+    ESPrawTiming& timing = response.timing;
     
     // Check rate limit
     if (!checkRateLimit()) {
         unsigned long waitTime = timeUntilNextRequest();
         if (waitTime > 0) {
             Serial.printf("Rate limit reached, waiting %lu ms\n", waitTime);
+            unsigned long waitStart = micros();
             delay(waitTime);
+            timing.rateLimitWait += micros() - waitStart;
         }
     }
     
@@ -107,79 +272,358 @@ ESPrawResponse ESPrawClient::performRequest(ESPrawRequestMethod method,
             Serial.printf("Retry attempt %d/%d\n", attempt, _config.maxRetries);
             // Exponential backoff: delay increases exponentially with each retry
             unsigned long backoffDelay = _config.retryDelay * (1 << attempt); // 2^attempt
-            if (backoffDelay > 30000) backoffDelay = 30000; // Cap at 30 seconds
+            if (backoffDelay > ESPRAW_MAX_RETRY_BACKOFF) backoffDelay = ESPRAW_MAX_RETRY_BACKOFF;
+            unsigned long backoffStart = micros();
             delay(backoffDelay);
+            timing.retryBackoff += micros() - backoffStart;
         }
         
-        HTTPClient http;
-        http.setTimeout(_config.requestTimeout);
+        bool reused = isConnectionReusable();
+        int httpCode = sendRequest(method, url, body, contentType, extraHeaders, timing);
+        
+        if (httpCode < 0 && reused) {
+            // The server closed the idle keep-alive connection; reconnect
+            // once without spending a retry attempt
+            Serial.println("Keep-alive connection closed by server, reconnecting");
+            _connectionStats.staleReconnects++;
+            closeConnection();
+            httpCode = sendRequest(method, url, body, contentType, extraHeaders, timing);
+        }
         
-        if (!http.begin(_secureClient, url)) {
+        if (httpCode == 0) {
             response.error = "Failed to begin HTTP connection";
             continue;
         }
         
-        addHeaders(http);
+        response.statusCode = httpCode;
         
-        // Set content type for POST/PUT
-        if ((method == ESPrawRequestMethod::POST || method == ESPrawRequestMethod::PUT) 
-            && contentType.length() > 0) {
-            http.addHeader("Content-Type", contentType);
+        if (httpCode > 0) {
+            updateServerRateLimit();
+            if (_cache != nullptr) {
+                response.etag = _transport->header("ETag");
+                response.lastModified = _transport->header("Last-Modified");
+            }
         }
         
-        // Perform request
-        int httpCode = -1;
-        switch (method) {
-            case ESPrawRequestMethod::GET:
-                httpCode = http.GET();
-                break;
-            case ESPrawRequestMethod::POST:
-                httpCode = http.POST(body);
-                break;
-            case ESPrawRequestMethod::PUT:
-                httpCode = http.PUT(body);
-                break;
-            case ESPrawRequestMethod::DELETE_METHOD:
-                httpCode = http.sendRequest("DELETE");
-                break;
+        if (httpCode >= 200 && httpCode < 300 && handler != nullptr) {
+            bool handled = readBody(*handler, timing);
+            _transport->end();
+            
+            if (!handled) {
+                response.error = "Failed to process response body";
+                return response;
+            }
+            
+            response.success = true;
+            return response;
         }
         
-        response.statusCode = httpCode;
+        if (httpCode == 304) {
+            // Answer to a conditional request: no body, the caller has it cached
+            _transport->end();
+            return response;
+        }
         
         if (httpCode > 0) {
-            response.body = http.getString();
+            // Reading the whole body also leaves the connection reusable
+            unsigned long downloadStart = micros();
+            response.body = _transport->getString();
+            timing.download += micros() - downloadStart;
             
             if (httpCode >= 200 && httpCode < 300) {
                 response.success = true;
-                recordRequest();
-                http.end();
+                _transport->end();
                 return response;
             } else if (httpCode == 401) {
                 response.error = "Unauthorized - token may be expired";
-                http.end();
+                _transport->end();
                 return response; // Don't retry auth errors
             } else if (httpCode == 429) {
                 response.error = "Rate limit exceeded";
                 // Extract retry-after if available
-                String retryAfter = http.header("Retry-After");
+                String retryAfter = _transport->header("Retry-After");
+                unsigned long waitStart = micros();
                 if (retryAfter.length() > 0) {
                     delay(retryAfter.toInt() * 1000);
+                } else if (useServerRateLimit()) {
+                    delay(_serverRateLimit.getResetIn(millis()));
                 }
+                timing.rateLimitWait += micros() - waitStart;
             } else {
                 response.error = "HTTP error: " + String(httpCode);
             }
         } else {
-            response.error = "Connection error: " + http.errorToString(httpCode);
+            response.error = "Connection error: " + _transport->errorToString(httpCode);
+            closeConnection();
         }
         
-        http.end();
+        _transport->end();
     }
     
     return response;
 }
 
+int ESPrawClient::sendRequest(ESPrawRequestMethod method, const String& url,
+                              const String& body, const String& contentType,
+                              const String& extraHeaders, ESPrawTiming& timing) {
+    bool reused = isConnectionReusable();
+    
+    _transport->setKeepAlive(_config.keepAlive);
+    _transport->setTimeout(_config.requestTimeout);
+    
+    String headers = buildHeaderLines();
+    
+    // Set content type for POST/PUT
+    if ((method == ESPrawRequestMethod::POST || method == ESPrawRequestMethod::PUT) 
+        && contentType.length() > 0) {
+        headers += "Content-Type: " + contentType + "\r\n";
+    }
+    headers += extraHeaders;
+    
+    // Reddit counts every request against the budget, failed ones included
+    recordRequest();
+    
+    unsigned long sendStart = micros();
+    int httpCode = _transport->send(method, url, headers, body);
+    uint32_t elapsed = micros() - sendStart;
+    
+    // Whatever connection setup the transport can account for is taken
+    // out; the rest is writing the request and waiting for the response
+    ESPrawTiming setup;
+    _transport->addTiming(setup);
+    timing.dns += setup.dns;
+    timing.connect += setup.connect;
+    uint32_t setupTime = setup.dns + setup.connect;
+    timing.firstByte += elapsed > setupTime ? elapsed - setupTime : 0;
+    
+    if (httpCode == 0) {
+        return 0;
+    }
+    
+    _connectionStats.requests++;
+    if (reused) {
+        _connectionStats.reusedConnections++;
+    } else {
+        _connectionStats.freshConnections++;
+    }
+    
+    if (httpCode < 0) {
+        _transport->end();
+    }
+    
+    return httpCode;
+}
+
+bool ESPrawClient::isConnectionReusable() {
+    return _config.keepAlive && _transport->connected();
+}
+
+void ESPrawClient::setKeepAlive(bool keepAlive) {
+    _config.keepAlive = keepAlive;
+    _async.setKeepAlive(keepAlive);
+    if (!keepAlive) {
+        closeConnection();
+    }
+}
+
+bool ESPrawClient::isKeepAlive() const {
+    return _config.keepAlive;
+}
+
+void ESPrawClient::closeConnection() {
+    _transport->stop();
+    _async.closeConnection();
+}
+
+void ESPrawClient::setTransport(ESPrawTransport* transport) {
+    _transport->stop();
+    _transport = transport != nullptr ? transport : &_httpTransport;
+}
+
+ESPrawTransport& ESPrawClient::getTransport() {
+    return *_transport;
+}
+
+const ESPrawConnectionStats& ESPrawClient::getConnectionStats() const {
+    return _connectionStats;
+}
+
+void ESPrawClient::resetConnectionStats() {
+    _connectionStats = ESPrawConnectionStats();
+}
+
+void ESPrawClient::setCache(ESPrawResponseCache* cache) {
+    _cache = cache;
+}
+
+ESPrawResponseCache* ESPrawClient::getCache() {
+    return _cache;
+}
+
+uint32_t ESPrawClient::cacheTtl(const String& url) const {
+    if (_cache == nullptr) {
+        return 0;
+    }
+    return _cache->getTtl(ESPrawLatencyTracker::normalizeEndpoint(url, _config.apiBaseUrl));
+}
+
+String ESPrawClient::jsonCacheKey(const String& url, const String& fields) {
+    String key = url + "#json";
+    if (fields.length() == 0) {
+        return key;
+    }
+    
+    // Documents cached under different filters hold different fields
+    uint32_t hash = 2166136261UL;   // FNV-1a
+    for (size_t i = 0; i < fields.length(); i++) {
+        hash = (hash ^ (uint8_t)fields[i]) * 16777619UL;
+    }
+    return key + ":" + String((unsigned long)hash, HEX);
+}
+
+ESPrawResponse ESPrawClient::cachedGet(const String& url, const String& key, uint32_t ttl,
+                                       const ESPrawBodyHandler* handler, const CacheCodec& codec) {
+    unsigned long start = micros();
+    unsigned long now = millis();
+    const ESPrawCacheEntry* entry = _cache->find(key, now);
+    
+    if (entry != nullptr) {
+        bool fresh = entry->isFresh(now);
+        if (fresh || (entry->isServable(now, _cache->getStaleWindow() * 1000UL) &&
+                      refreshInBackground(url, key, ttl, *entry, codec.compact))) {
+            ESPrawResponse response;
+            response.statusCode = 200;
+            response.cached = true;
+            response.stale = !fresh;
+            response.success = codec.load(response, entry->body);
+            if (!response.success) {
+                response.error = "Failed to process cached response";
+            }
+            response.timing.parse = micros() - start;
+            response.timing.total = response.timing.parse;
+            return response;
+        }
+    }
+    
+    String conditions = entry != nullptr ? conditionalHeaders(*entry) : String();
+    ESPrawResponse response = performRequest(ESPrawRequestMethod::GET, url, "", "", handler, conditions);
+    
+    if (response.statusCode == 304) {
+        entry = _cache->revalidated(key, millis());
+        if (entry != nullptr) {
+            response.cached = true;
+            response.success = codec.load(response, entry->body);
+            response.error = response.success ? "" : "Failed to process cached response";
+        } else {
+            response.error = "Not modified, but no longer cached";
+        }
+    } else if (response.success) {
+        String payload = codec.save(response);
+        if (payload.length() > 0) {
+            _cache->store(key, payload, response.etag, response.lastModified, ttl, millis());
+        }
+    }
+    
+    return response;
+}
+
+bool ESPrawClient::refreshInBackground(const String& url, const String& key, uint32_t ttl,
+                                       const ESPrawCacheEntry& entry,
+                                       const std::function<String(const String&)>& compact) {
+    for (size_t i = 0; i < _refreshing.size(); i++) {
+        if (_refreshing[i] == key) {
+            return true;   // Already under way
+        }
+    }
+    
+    // The URL was built from apiBaseUrl, so what follows it is the
+    // endpoint and query as getAsync() would send them
+    String path = _apiUrl.path + url.substring(_config.apiBaseUrl.length());
+    ESPrawAsyncHandle handle = _async.submit(ESPrawRequestMethod::GET, path,
+        buildHeaderLines() + conditionalHeaders(entry), "", "",
+        [this, key, ttl, compact](ESPrawAsyncHandle, const ESPrawResponse& response) {
+            finishRefresh(key, ttl, compact, response);
+        });
+    if (handle == ESPRAW_ASYNC_INVALID_HANDLE) {
+        return false;
+    }
+    
+    _refreshing.push_back(key);
+    return true;
+}
+
+void ESPrawClient::finishRefresh(const String& key, uint32_t ttl,
+                                 const std::function<String(const String&)>& compact,
+                                 const ESPrawResponse& response) {
+    for (size_t i = 0; i < _refreshing.size(); i++) {
+        if (_refreshing[i] == key) {
+            _refreshing.erase(_refreshing.begin() + i);
+            break;
+        }
+    }
+    
+    if (_cache == nullptr) {
+        return;
+    }
+    
+    if (response.statusCode == 304) {
+        _cache->revalidated(key, millis());
+    } else if (response.success) {
+        String payload = compact(response.body);
+        if (payload.length() > 0) {
+            _cache->store(key, payload, response.etag, response.lastModified, ttl, millis());
+        } else {
+            // Unusable; the next request fetches it in the foreground
+            _cache->remove(key);
+        }
+    }
+    // On errors the stale entry stays until the next attempt
+}
+
+String ESPrawClient::conditionalHeaders(const ESPrawCacheEntry& entry) {
+    String headers;
+    if (entry.etag.length() > 0) {
+        headers += "If-None-Match: " + entry.etag + "\r\n";
+    }
+    if (entry.lastModified.length() > 0) {
+        headers += "If-Modified-Since: " + entry.lastModified + "\r\n";
+    }
+    return headers;
+}
+
+const ESPrawLatencyTracker& ESPrawClient::getLatencyStats() const {
+    return _latencyStats;
+}
+
+void ESPrawClient::resetLatencyStats() {
+    _latencyStats.reset();
+}
+
+bool ESPrawClient::readBody(const ESPrawBodyHandler& handler, ESPrawTiming& timing) {
+    bool chunked = _transport->header("Transfer-Encoding").indexOf("chunked") >= 0;
+    ESPrawBodyStream body(_transport->getStream(), _transport->getSize(), chunked);
+    
+    unsigned long start = micros();
+    bool handled = handler(body);
+    uint32_t elapsed = micros() - start;
+    
+    // The handler parses while it reads; time spent waiting for bytes is
+    // download, the rest is parsing
+    uint32_t waited = body.waitMicros();
+    timing.parse += elapsed > waited ? elapsed - waited : 0;
+    
+    // Consume whatever the handler left unread so the connection stays
+    // reusable; without keep-alive the connection is closed anyway
+    if (_config.keepAlive) {
+        body.drain();
+    }
+    timing.download += body.waitMicros();
+    
+    return handled;
+}
+
 String ESPrawClient::buildUrl(const String& endpoint, const String& params) {
-    String url = String(ESPRAW_API_BASE_URL) + endpoint;
+    String url = _config.apiBaseUrl + endpoint;
     
     if (params.length() > 0) {
         url += "?" + params;
@@ -188,50 +632,67 @@ String ESPrawClient::buildUrl(const String& endpoint, const String& params) {
     return url;
 }
 
-void ESPrawClient::addHeaders(HTTPClient& http) {
-    // User agent
+String ESPrawClient::buildHeaderLines() {
+    // Appended piece by piece: concatenating with + builds a temporary String per operator
+    String headers;
+    headers.reserve(96 + _userAgent.length() + _accessToken.length());
+    headers += "User-Agent: ";
     if (_userAgent.length() > 0) {
-        http.addHeader("User-Agent", _userAgent);
+        headers += _userAgent;
     } else {
-        http.addHeader("User-Agent", ESPRAW_USER_AGENT_FORMAT);
+        headers += ESPRAW_USER_AGENT_FORMAT;
     }
+    headers += "\r\n";
     
-    // Authorization
     if (_accessToken.length() > 0) {
-        http.addHeader("Authorization", "Bearer " + _accessToken);
+        headers += "Authorization: Bearer ";
+        headers += _accessToken;
+        headers += "\r\n";
     }
     
-    // Accept JSON
-    http.addHeader("Accept", "application/json");
+    headers += "Accept: application/json\r\n";
+    return headers;
 }
 
-void ESPrawClient::recordRequest() {
-    cleanupRequestLog();
+const ESPrawHeaderRateLimiter& ESPrawClient::getServerRateLimit() const {
+    return _serverRateLimit;
+}
+
+void ESPrawClient::updateServerRateLimit() {
+    if (_config.rateLimitMode != ESPrawRateLimitMode::SERVER_HEADERS) {
+        return;
+    }
     
-    if (_requestCount < ESPRAW_RATE_LIMIT_REQUESTS) {
-        _requestTimes[_requestCount] = millis();
-        _requestCount++;
+    _serverRateLimit.update(_transport->header("X-Ratelimit-Used").c_str(),
+                            _transport->header("X-Ratelimit-Remaining").c_str(),
+                            _transport->header("X-Ratelimit-Reset").c_str(),
+                            millis());
+}
+
+bool ESPrawClient::useServerRateLimit() const {
+    return _config.rateLimitMode == ESPrawRateLimitMode::SERVER_HEADERS &&
+           _serverRateLimit.hasBudget();
+}
+
+ESPrawRateLimiter& ESPrawClient::localRateLimiter() {
+    if (_config.rateLimitMode == ESPrawRateLimitMode::TOKEN_BUCKET) {
+        return _bucketLimiter;
     }
+    return _windowLimiter;
 }
 
-void ESPrawClient::cleanupRequestLog() {
+void ESPrawClient::recordRequest() {
     unsigned long now = millis();
     
-    // Only cleanup every second
-    if (now - _lastCleanup < 1000) {
+    if (_customLimiter != nullptr) {
+        _customLimiter->recordRequest(now);
         return;
     }
     
-    _lastCleanup = now;
-    
-    // Remove requests older than the window
-    int validRequests = 0;
-    for (int i = 0; i < _requestCount; i++) {
-        if (now - _requestTimes[i] < ESPRAW_RATE_LIMIT_WINDOW) {
-            _requestTimes[validRequests] = _requestTimes[i];
-            validRequests++;
-        }
+    // The local limiter keeps counting in header mode so it is accurate
+    // whenever the server budget is unavailable
+    localRateLimiter().recordRequest(now);
+    if (_config.rateLimitMode == ESPrawRateLimitMode::SERVER_HEADERS) {
+        _serverRateLimit.recordRequest(now);
     }
-    
-    _requestCount = validRequests;
 }
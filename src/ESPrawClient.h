@@ -9,32 +9,29 @@
 #define ESPRAW_CLIENT_H
 
 #include <Arduino.h>
-#include <HTTPClient.h>
+#include <functional>
+#include <vector>
 #include <WiFiClientSecure.h>
 #include <ArduinoJson.h>
 #include "ESPrawConfig.h"
+#include "ESPrawStream.h"
+#include "ESPrawTransport.h"
+#include "ESPrawTiming.h"
+#include "ESPrawCache.h"
+#include "ESPrawRateLimit.h"
+#include "ESPrawAsync.h"
 
 /**
- * HTTP request methods
+ * Connection reuse statistics
  */
-enum class ESPrawRequestMethod {
-    GET,
-    POST,
-    PUT,
-    PATCH,
-    DELETE_METHOD  // Avoid conflict with DELETE macro
-};
-
-/**
- * HTTP response structure
- */
-struct ESPrawResponse {
-    int statusCode;
-    String body;
-    String error;
-    bool success;
+struct ESPrawConnectionStats {
+    unsigned long requests;          // Requests sent (including retries)
+    unsigned long reusedConnections; // Requests sent over an already open connection
+    unsigned long freshConnections;  // Requests that needed a new TCP + TLS handshake
+    unsigned long staleReconnects;   // Reused connections found closed by the server
     
-    ESPrawResponse() : statusCode(0), success(false) {}
+    ESPrawConnectionStats() 
+        : requests(0), reusedConnections(0), freshConnections(0), staleReconnects(0) {}
 };
 
 /**
@@ -55,7 +52,7 @@ public:
     /**
      * Initialize the client with configuration
      * @param config Request configuration
-     * @return true if successful
+     * @return false if config.apiBaseUrl is not a valid http(s) URL
      */
     bool begin(const ESPrawRequestConfig& config);
     
@@ -69,7 +66,7 @@ public:
      * Get current access token
      * @return Access token
      */
-    String getAccessToken() const;
+    const String& getAccessToken() const;
     
     /**
      * Set user agent
@@ -85,6 +82,37 @@ public:
      */
     ESPrawResponse get(const String& endpoint, const String& params = "");
     
+    /**
+     * Perform HTTP GET request and deserialize the JSON response
+     * 
+     * The response is parsed directly from the connection stream, so the
+     * body is never held in memory as a String.
+     * 
+     * @param endpoint API endpoint (without base URL)
+     * @param doc JSON document to store the response
+     * @param params Query parameters
+     * @param filter ArduinoJson filter document selecting the fields to keep (optional)
+     * @return Response object (body is empty on success)
+     */
+    ESPrawResponse getJson(const String& endpoint, JsonDocument& doc, const String& params = "",
+                           const JsonDocument* filter = nullptr);
+    
+    /**
+     * Perform HTTP GET request and hand the response body to a callback
+     * 
+     * The handler reads the body directly from the connection. Anything it
+     * leaves unread is discarded before the connection is reused. The
+     * connection is busy until the handler returns, so blocking requests
+     * made from inside it fail with "Request already in progress".
+     * 
+     * @param endpoint API endpoint (without base URL)
+     * @param handler Callback that consumes the body of a successful response
+     * @param params Query parameters
+     * @return Response object (body is empty on success)
+     */
+    ESPrawResponse getStream(const String& endpoint, const ESPrawBodyHandler& handler,
+                             const String& params = "");
+    
     /**
      * Perform HTTP POST request
      * @param endpoint API endpoint (without base URL)
@@ -110,6 +138,61 @@ public:
      */
     ESPrawResponse delete_(const String& endpoint);
     
+    /**
+     * Start a non-blocking GET request
+     * 
+     * The request advances each time poll() is called. Rate limit waits,
+     * Retry-After and retry backoff never block; async requests use their
+     * own connection, so they can be mixed with blocking calls.
+     * 
+     * @param endpoint API endpoint (without base URL)
+     * @param params Query parameters
+     * @param callback Called with the response when the request finishes (optional)
+     * @return Request handle, or ESPRAW_ASYNC_INVALID_HANDLE if too many
+     *         requests are pending
+     */
+    ESPrawAsyncHandle getAsync(const String& endpoint, const String& params = "",
+                               const ESPrawAsyncCallback& callback = nullptr);
+    
+    /**
+     * Start a non-blocking form-encoded POST request
+     * @param endpoint API endpoint (without base URL)
+     * @param body Request body
+     * @param callback Called with the response when the request finishes (optional)
+     * @return Request handle, or ESPRAW_ASYNC_INVALID_HANDLE if too many
+     *         requests are pending
+     */
+    ESPrawAsyncHandle postAsync(const String& endpoint, const String& body,
+                                const ESPrawAsyncCallback& callback = nullptr);
+    
+    /**
+     * Advance pending async requests; call this from loop()
+     * @return true while any async request is unfinished
+     */
+    bool poll();
+    
+    /**
+     * Get the state of an async request
+     * @param handle Request handle
+     * @return Current state (IDLE for unknown handles)
+     */
+    ESPrawAsyncState getAsyncState(ESPrawAsyncHandle handle) const;
+    
+    /**
+     * Take the response of a finished async request
+     * @param handle Request handle
+     * @param response Receives the response
+     * @return true if the request was finished
+     */
+    bool takeAsyncResponse(ESPrawAsyncHandle handle, ESPrawResponse& response);
+    
+    /**
+     * Cancel an async request
+     * @param handle Request handle
+     * @return true if the request existed
+     */
+    bool cancelAsync(ESPrawAsyncHandle handle);
+    
     /**
      * Check if rate limit allows a request
      * @return true if request is allowed
@@ -122,18 +205,215 @@ public:
      */
     unsigned long timeUntilNextRequest();
     
+    /**
+     * Get the budget reported by Reddit's rate limit headers
+     * 
+     * Only updated in ESPrawRateLimitMode::SERVER_HEADERS mode.
+     * 
+     * @return Server-side rate limit state
+     */
+    const ESPrawHeaderRateLimiter& getServerRateLimit() const;
+    
+    /**
+     * Replace the built-in rate limiter
+     * 
+     * The limiter must outlive the client. Pass nullptr to go back to the
+     * limiter selected by ESPrawRequestConfig::rateLimitMode.
+     * 
+     * @param limiter Custom limiter
+     */
+    void setRateLimiter(ESPrawRateLimiter* limiter);
+    
+    /**
+     * Get the rate limiter currently in effect
+     * @return Active limiter
+     */
+    ESPrawRateLimiter& getRateLimiter();
+    
+    /**
+     * Replace the transport used for blocking requests
+     * 
+     * The transport must outlive the client. Pass nullptr to go back to
+     * the built-in HTTPClient transport. Async requests are not affected.
+     * 
+     * @param transport Custom transport
+     */
+    void setTransport(ESPrawTransport* transport);
+    
+    /**
+     * Get the transport used for blocking requests
+     * @return Active transport
+     */
+    ESPrawTransport& getTransport();
+    
+    /**
+     * Enable or disable connection reuse between requests
+     * @param keepAlive true to keep the connection open
+     */
+    void setKeepAlive(bool keepAlive);
+    
+    /**
+     * Check if connection reuse is enabled
+     * @return true if keep-alive is enabled
+     */
+    bool isKeepAlive() const;
+    
+    /**
+     * Close the persistent connections, if any
+     */
+    void closeConnection();
+    
+    /**
+     * Get connection reuse statistics
+     * @return Statistics since begin() or the last reset
+     */
+    const ESPrawConnectionStats& getConnectionStats() const;
+    
+    /**
+     * Reset connection reuse statistics
+     */
+    void resetConnectionStats();
+    
+    /**
+     * Put a response cache in front of get() and getJson()
+     * 
+     * The cache must outlive the client. Pass nullptr to stop caching.
+     * 
+     * @param cache Response cache
+     */
+    void setCache(ESPrawResponseCache* cache);
+    
+    /**
+     * Get the response cache
+     * @return Cache, or nullptr if none is set
+     */
+    ESPrawResponseCache* getCache();
+    
+    /**
+     * Get per-endpoint latency histograms of blocking requests
+     * @return Latency statistics since begin() or the last reset
+     */
+    const ESPrawLatencyTracker& getLatencyStats() const;
+    
+    /**
+     * Reset per-endpoint latency histograms
+     */
+    void resetLatencyStats();
+    
 private:
     /**
-     * Perform HTTP request with retry logic
+     * Perform HTTP request, recording its duration with the endpoint
      * @param method HTTP method
      * @param url Full URL
      * @param body Request body (optional)
      * @param contentType Content type (optional)
+     * @param handler Callback that consumes a successful response body (optional)
+     * @param extraHeaders Additional header lines, each ending in CRLF (optional)
      * @return Response object
      */
     ESPrawResponse performRequest(ESPrawRequestMethod method, const String& url, 
                                   const String& body = "", 
-                                  const String& contentType = "");
+                                  const String& contentType = "",
+                                  const ESPrawBodyHandler* handler = nullptr,
+                                  const String& extraHeaders = "");
+    
+    /**
+     * Perform HTTP request with retry logic
+     * @param method HTTP method
+     * @param url Full URL
+     * @param body Request body (optional)
+     * @param contentType Content type (optional)
+     * @param handler Callback that consumes a successful response body (optional)
+     * @return Response object
+     */
+    ESPrawResponse sendWithRetries(ESPrawRequestMethod method, const String& url,
+                                   const String& body, const String& contentType,
+                                   const ESPrawBodyHandler* handler,
+                                   const String& extraHeaders);
+    
+    /**
+     * How a cached request turns responses into cache payloads and back
+     */
+    struct CacheCodec {
+        // Payload to cache from a successful download (empty: don't cache)
+        std::function<String(const ESPrawResponse& response)> save;
+        // Restore a cached payload into the caller's result
+        std::function<bool(ESPrawResponse& response, const String& payload)> load;
+        // Payload to cache from a body fetched by a background refresh;
+        // must not refer to the caller's state, which is gone by then
+        std::function<String(const String& body)> compact;
+    };
+    
+    /**
+     * Perform a GET through the response cache
+     * 
+     * A fresh entry answers without a request. An expired one within the
+     * cache's stale window answers too while it is refreshed in the
+     * background; otherwise it is revalidated with a conditional request.
+     * 
+     * @param url Full URL
+     * @param key Cache key
+     * @param ttl Lifetime of a stored response in seconds
+     * @param handler Callback that consumes a downloaded body (optional)
+     * @param codec Payload conversions
+     * @return Response object; cached is set if the payload came from the cache
+     */
+    ESPrawResponse cachedGet(const String& url, const String& key, uint32_t ttl,
+                             const ESPrawBodyHandler* handler, const CacheCodec& codec);
+    
+    /**
+     * Revalidate a cache entry with an async request
+     * @param url Full URL
+     * @param key Cache key
+     * @param ttl Lifetime of a stored response in seconds
+     * @param entry Entry to revalidate
+     * @param compact Payload from a downloaded body
+     * @return true if a refresh of the entry is under way
+     */
+    bool refreshInBackground(const String& url, const String& key, uint32_t ttl,
+                             const ESPrawCacheEntry& entry,
+                             const std::function<String(const String&)>& compact);
+    
+    /**
+     * Update the cache with the result of a background refresh
+     * @param key Cache key
+     * @param ttl Lifetime of a stored response in seconds
+     * @param compact Payload from a downloaded body
+     * @param response Async response
+     */
+    void finishRefresh(const String& key, uint32_t ttl,
+                       const std::function<String(const String&)>& compact,
+                       const ESPrawResponse& response);
+    
+    /**
+     * Build the validator headers of a conditional request
+     * @param entry Cache entry
+     * @return If-None-Match/If-Modified-Since lines, each ending in CRLF
+     */
+    static String conditionalHeaders(const ESPrawCacheEntry& entry);
+    
+    /**
+     * Get the cache lifetime of a URL's responses
+     * @param url Full URL
+     * @return Lifetime in seconds, 0 if the response is not cached
+     */
+    uint32_t cacheTtl(const String& url) const;
+    
+    /**
+     * Build the cache key of a getJson() request
+     * @param url Full URL
+     * @param fields Serialized field filter (empty for none)
+     * @return URL tagged with the filter
+     */
+    static String jsonCacheKey(const String& url, const String& fields);
+    
+    /**
+     * Pass the current response body to a handler straight from the connection
+     * @param handler Callback that consumes the body
+     * @param timing Receives download and parse time
+     * @return Handler result
+     */
+    bool readBody(const ESPrawBodyHandler& handler, ESPrawTiming& timing);
     
     /**
      * Build full URL from endpoint
@@ -144,30 +424,77 @@ private:
     String buildUrl(const String& endpoint, const String& params = "");
     
     /**
-     * Add common headers to request
-     * @param http HTTPClient object
+     * Send a single HTTP request over the client connection
+     * @param method HTTP method
+     * @param url Full URL
+     * @param body Request body
+     * @param contentType Content type
+     * @param extraHeaders Additional header lines, each ending in CRLF
+     * @param timing Receives connection setup and time to first byte
+     * @return HTTP status code, a negative HTTPC_ERROR_* code, or 0 if
+     *         the request could not be started
      */
-    void addHeaders(HTTPClient& http);
+    int sendRequest(ESPrawRequestMethod method, const String& url,
+                    const String& body, const String& contentType,
+                    const String& extraHeaders, ESPrawTiming& timing);
     
     /**
-     * Record request for rate limiting
+     * Check if the connection from the previous request is still open
+     * @return true if the next request can reuse it
      */
-    void recordRequest();
+    bool isConnectionReusable();
+    
+    /**
+     * Build the common request headers
+     * @return Header lines, each ending in CRLF
+     */
+    String buildHeaderLines();
+    
+    /**
+     * Update the server budget from the current response's headers
+     */
+    void updateServerRateLimit();
+    
+    /**
+     * Check if the server-reported budget drives rate limiting
+     * @return true in header mode once a budget has been received
+     */
+    bool useServerRateLimit() const;
+    
+    /**
+     * Get the built-in local limiter selected by the rate limit mode
+     * @return Sliding window or token bucket limiter
+     */
+    ESPrawRateLimiter& localRateLimiter();
     
     /**
-     * Clean up old request timestamps
+     * Record a sent request with the rate limiters
      */
-    void cleanupRequestLog();
+    void recordRequest();
     
-    WiFiClientSecure _secureClient;
+    ESPrawHttpTransport _httpTransport;
+    ESPrawTransport* _transport;
+    ESPrawUrl _apiUrl;
     String _accessToken;
     String _userAgent;
     ESPrawRequestConfig _config;
+    ESPrawConnectionStats _connectionStats;
+    ESPrawLatencyTracker _latencyStats;
     
     // Rate limiting
-    unsigned long _requestTimes[ESPRAW_RATE_LIMIT_REQUESTS];
-    int _requestCount;
-    unsigned long _lastCleanup;
+    ESPrawSlidingWindowLimiter _windowLimiter;
+    ESPrawTokenBucketLimiter _bucketLimiter;
+    ESPrawHeaderRateLimiter _serverRateLimit;
+    ESPrawRateLimiter* _customLimiter;
+    
+    ESPrawResponseCache* _cache;
+    std::vector<String> _refreshing;   // Cache keys with a background refresh under way
+    bool _busy;                        // A blocking request is using the connection
+    
+    // Non-blocking requests
+    WiFiClientSecure _asyncSecureClient;
+    WiFiClient _asyncPlainClient;
+    ESPrawAsyncEngine _async;
 };
 
 #endif // ESPRAW_CLIENT_H
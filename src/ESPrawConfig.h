@@ -8,27 +8,210 @@
 #define ESPRAW_CONFIG_H
 
 #include <Arduino.h>
+#include <functional>
 
 // API Configuration
 #define ESPRAW_VERSION "0.1.0"
 #define ESPRAW_USER_AGENT_FORMAT "ESPraw/" ESPRAW_VERSION " (ESP32)"
 #define ESPRAW_API_BASE_URL "https://oauth.reddit.com"
+#define ESPRAW_API_HOST "oauth.reddit.com"
+#define ESPRAW_API_PORT 443
+#define ESPRAW_AUTH_BASE_URL "https://www.reddit.com"
 #define ESPRAW_AUTH_URL "https://www.reddit.com/api/v1/access_token"
+#define ESPRAW_AUTH_HOST "www.reddit.com"
+#define ESPRAW_AUTH_PORT 443
+#define ESPRAW_AUTH_PATH "/api/v1/access_token"
+#define ESPRAW_REVOKE_PATH "/api/v1/revoke_token"
+
+// Token Refresh
+#define ESPRAW_TOKEN_REFRESH_MARGIN 300    // Refresh this many seconds before the token expires
+#define ESPRAW_TOKEN_REFRESH_RETRY 30000   // Wait after a failed background refresh (ms)
 
 // Rate Limiting
 #define ESPRAW_RATE_LIMIT_REQUESTS 60  // requests per minute
 #define ESPRAW_RATE_LIMIT_WINDOW 60000 // 60 seconds in milliseconds
+#define ESPRAW_RATE_LIMIT_BURST 10     // Back-to-back requests allowed by TOKEN_BUCKET
+
+/**
+ * Rate limiting strategy
+ */
+enum class ESPrawRateLimitMode {
+    LOCAL_WINDOW,   // At most rateLimitRequests in any rateLimitWindow (exact sliding window)
+    TOKEN_BUCKET,   // rateLimitRequests per rateLimitWindow on average, bursts of rateLimitBurst
+    SERVER_HEADERS  // Budget reported by Reddit's X-Ratelimit-* headers
+};
 
 // Memory Configuration
 #define ESPRAW_MAX_RESPONSE_SIZE 16384  // 16KB max response
 #define ESPRAW_JSON_BUFFER_SIZE 8192     // 8KB JSON buffer
+#define ESPRAW_STREAM_BUFFER_SIZE 64     // Read-ahead buffer for streamed response bodies
+#define ESPRAW_COMMENT_FILTER_DEPTH 3    // Reply levels kept by comment filters
+#define ESPRAW_LISTING_PAGE_SIZE 100     // Items requested per page by ListingIterator
+#define ESPRAW_LISTING_ITEM_SIZE 4096    // JSON capacity for one listing item
+#define ESPRAW_LISTING_TOKEN_LENGTH 32   // Longest key/cursor kept while scanning listings
+#define ESPRAW_INFO_BATCH_SIZE 100       // Fullnames per /api/info request (Reddit's maximum)
+#define ESPRAW_ARENA_SIZE 16384          // Default ESPrawArena block size
+#define ESPRAW_STRING_POOL_SIZE 256      // Distinct strings an ESPrawStringPool holds
+#define ESPRAW_STRING_POOL_MAX_LENGTH 64 // Longest string worth pooling
 #define ESPRAW_MAX_RETRIES 3
 #define ESPRAW_RETRY_DELAY 1000         // 1 second
+#define ESPRAW_MAX_RETRY_BACKOFF 30000  // Cap for exponential retry backoff
 
 // Timeouts
 #define ESPRAW_CONNECT_TIMEOUT 10000    // 10 seconds
 #define ESPRAW_REQUEST_TIMEOUT 30000    // 30 seconds
 
+// Connection reuse
+#define ESPRAW_KEEP_ALIVE false         // Keep the TLS connection open between requests
+
+// Latency statistics
+#define ESPRAW_LATENCY_BUCKETS 16       // Power-of-two millisecond buckets (last: 16 s and up)
+#define ESPRAW_LATENCY_WINDOW 256       // Samples after which old counts are halved
+#define ESPRAW_LATENCY_ENDPOINTS 8      // Endpoints tracked at once
+
+// Response cache
+#define ESPRAW_CACHE_BUDGET 16384       // Bytes of responses kept by ESPrawResponseCache
+#define ESPRAW_CACHE_DEFAULT_TTL 60     // Seconds a cached response is used without asking
+#define ESPRAW_CACHE_TTL_RULES 8        // Per-endpoint TTLs that can be set
+#define ESPRAW_CACHE_MAX_STALE 86400    // Seconds past their TTL that stored responses are kept
+#define ESPRAW_FILE_CACHE_CAP 65536     // Bytes of responses kept by ESPrawFileCacheStore
+#define ESPRAW_FILE_CACHE_BATCH 4       // Responses collected before they are written
+#define ESPRAW_FILE_CACHE_FLUSH_INTERVAL 60000 // Longest a collected response waits to be written (ms)
+
+// Wall-clock times before this (2020-09-13) mean the clock isn't set
+#define ESPRAW_MIN_WALL_CLOCK 1600000000ULL
+
+// Asynchronous requests
+#define ESPRAW_ASYNC_MAX_REQUESTS 4     // Async requests that can be pending at once
+#define ESPRAW_ASYNC_IO_BUDGET 512      // Bytes sent or received per poll() step
+#define ESPRAW_ASYNC_MAX_LINE 512       // Longest status/header line kept while parsing
+
+// Worker task
+#define ESPRAW_WORKER_QUEUE_SIZE 4      // Jobs in flight per worker (power of two)
+#define ESPRAW_WORKER_CORE 0            // Core for the worker task; loop() runs on core 1
+#define ESPRAW_WORKER_STACK_SIZE 8192   // Worker task stack (TLS needs a deep stack)
+#define ESPRAW_WORKER_PRIORITY 1
+
+/**
+ * HTTP request methods
+ */
+enum class ESPrawRequestMethod {
+    GET,
+    POST,
+    PUT,
+    PATCH,
+    DELETE_METHOD  // Avoid conflict with DELETE macro
+};
+
+/**
+ * Heap usage of one API call, filled in when a heap probe is set
+ * (see ESPraw::setHeapProbe)
+ */
+struct ESPrawHeapStats {
+    unsigned long allocations;     // Allocations made (host only; 0 on the ESP32)
+    unsigned long bytesAllocated;  // Bytes requested by them (host only)
+    uint32_t peakDelta;            // Highest heap use above the starting point
+    uint32_t freeBefore;           // Free heap before the call
+    uint32_t freeAfter;            // Free heap after the call
+    uint32_t maxBlockBefore;       // Largest free block before the call
+    uint32_t maxBlockAfter;        // Largest free block after the call
+    
+    ESPrawHeapStats()
+        : allocations(0), bytesAllocated(0), peakDelta(0), freeBefore(0), freeAfter(0),
+          maxBlockBefore(0), maxBlockAfter(0) {}
+};
+
+/**
+ * Where the time of one request went, in microseconds
+ * 
+ * Phases add up over retries. Reused keep-alive connections spend nothing
+ * in dns and connect; on the ESP32 connect includes the TLS handshake.
+ */
+struct ESPrawTiming {
+    uint32_t rateLimitWait;  // Waiting for the rate limiter or a 429 Retry-After
+    uint32_t retryBackoff;   // Sleeping between retry attempts
+    uint32_t dns;            // Resolving the host name
+    uint32_t connect;        // TCP connect and TLS handshake
+    uint32_t firstByte;      // Sending the request until the response headers arrived
+    uint32_t download;       // Waiting for body bytes
+    uint32_t parse;          // Processing the body (e.g. JSON deserialization)
+    uint32_t total;          // Whole request, including everything above
+    
+    ESPrawTiming()
+        : rateLimitWait(0), retryBackoff(0), dns(0), connect(0), firstByte(0),
+          download(0), parse(0), total(0) {}
+};
+
+/**
+ * HTTP response structure
+ * 
+ * For requests made with getJson() or getStream() the body of a successful
+ * response is consumed straight from the connection and `body` stays empty.
+ */
+struct ESPrawResponse {
+    int statusCode;
+    String body;
+    String error;
+    bool success;
+    ESPrawHeapStats heap;   // Zero unless a heap probe is set
+    ESPrawTiming timing;    // Blocking requests only
+    bool cached;            // Answered from the response cache (fresh or after a 304)
+    bool stale;             // Cached answer past its TTL, being revalidated in the background
+    String etag;            // Validators (blocking requests collect them only while a cache is set)
+    String lastModified;
+    
+    ESPrawResponse() : statusCode(0), success(false), cached(false), stale(false) {}
+};
+
+/**
+ * Callback that consumes a successful response body
+ * @param body Stream of decoded body bytes
+ * @return true if the body was processed successfully
+ */
+typedef std::function<bool(Stream& body)> ESPrawBodyHandler;
+
+/**
+ * OAuth2 token information
+ */
+struct ESPrawToken {
+    String accessToken;
+    String tokenType;
+    String scope;
+    unsigned long expiresAt;  // Expiry in seconds of millis() uptime
+    bool isValid;
+    
+    ESPrawToken() : expiresAt(0), isValid(false) {}
+    
+    /**
+     * Check if token is expired
+     * @return true if expired
+     */
+    bool isExpired() const {
+        return millis() / 1000 > expiresAt;
+    }
+    
+    /**
+     * Get remaining validity in seconds
+     * @return seconds until expiration
+     */
+    unsigned long remainingValidity() const {
+        unsigned long now = millis() / 1000;
+        if (now >= expiresAt) {
+            return 0;
+        }
+        return expiresAt - now;
+    }
+    
+    /**
+     * Check if token expires within the given margin
+     * @param margin Margin in seconds
+     * @return true if the token expires within margin seconds
+     */
+    bool expiresWithin(unsigned long margin) const {
+        return remainingValidity() <= margin;
+    }
+};
+
 /**
  * Authentication configuration structure
  */
@@ -39,8 +222,13 @@ struct ESPrawAuthConfig {
     String password;
     String userAgent;
     bool readOnlyMode;
+    unsigned long refreshMargin;  // Seconds before expiry to refresh in the background
+    String authBaseUrl;           // Token endpoint server, e.g. a local stand-in
     
-    ESPrawAuthConfig() : readOnlyMode(false) {}
+    ESPrawAuthConfig()
+        : readOnlyMode(false)
+        , refreshMargin(ESPRAW_TOKEN_REFRESH_MARGIN)
+        , authBaseUrl(ESPRAW_AUTH_BASE_URL) {}
 };
 
 /**
@@ -51,12 +239,24 @@ struct ESPrawRequestConfig {
     int retryDelay;
     int connectTimeout;
     int requestTimeout;
+    bool keepAlive;  // Reuse the connection across requests (HTTP/1.1 keep-alive)
+    ESPrawRateLimitMode rateLimitMode;
+    int rateLimitRequests;          // Requests allowed per rateLimitWindow
+    unsigned long rateLimitWindow;  // Rate limit window in milliseconds
+    int rateLimitBurst;             // Burst size for TOKEN_BUCKET
+    String apiBaseUrl;              // API server, e.g. a local stand-in for benchmarks
     
     ESPrawRequestConfig() 
         : maxRetries(ESPRAW_MAX_RETRIES)
         , retryDelay(ESPRAW_RETRY_DELAY)
         , connectTimeout(ESPRAW_CONNECT_TIMEOUT)
-        , requestTimeout(ESPRAW_REQUEST_TIMEOUT) {}
+        , requestTimeout(ESPRAW_REQUEST_TIMEOUT)
+        , keepAlive(ESPRAW_KEEP_ALIVE)
+        , rateLimitMode(ESPrawRateLimitMode::LOCAL_WINDOW)
+        , rateLimitRequests(ESPRAW_RATE_LIMIT_REQUESTS)
+        , rateLimitWindow(ESPRAW_RATE_LIMIT_WINDOW)
+        , rateLimitBurst(ESPRAW_RATE_LIMIT_BURST)
+        , apiBaseUrl(ESPRAW_API_BASE_URL) {}
 };
 
 #endif // ESPRAW_CONFIG_H
@@ -0,0 +1,153 @@
+/**
+ * ESPrawFilter.cpp - Response field filter implementation
+ */
+
+#include "ESPrawFilter.h"
+
+// Fields read by RedditBase::parseData
+static const char* const BASE_FIELDS[] = {
+    "id", "name", "created", "created_utc"
+};
+
+// Fields read by Submission::parseData
+static const char* const SUBMISSION_FIELDS[] = {
+    "title", "author", "subreddit", "selftext", "url", "domain", "permalink",
+    "score", "upvote_ratio", "num_comments",
+    "over_18", "spoiler", "locked", "stickied", "is_self"
+};
+
+// Fields read by Comment::parseData
+static const char* const COMMENT_FIELDS[] = {
+    "body", "author", "subreddit", "parent_id", "link_id", "permalink",
+    "score", "depth", "is_submitter", "score_hidden"
+};
+
+// Fields read by Subreddit::parseData
+static const char* const SUBREDDIT_FIELDS[] = {
+    "display_name", "title", "description", "public_description",
+    "subscribers", "active_user_count", "over18", "user_is_subscriber"
+};
+
+// Fields read by Redditor::parseData
+static const char* const REDDITOR_FIELDS[] = {
+    "link_karma", "comment_karma", "has_verified_email", "is_gold", "is_mod", "is_employee"
+};
+
+#define ESPRAW_COUNT_OF(array) (sizeof(array) / sizeof((array)[0]))
+
+ESPrawFilter::ESPrawFilter()
+    : _base(nullptr), _fields(nullptr), _count(0), _enabled(false) {
+}
+
+ESPrawFilter::ESPrawFilter(const char* const* fields, size_t count)
+    : _base(nullptr), _fields(fields), _count(count), _enabled(true) {
+}
+
+ESPrawFilter::ESPrawFilter(const ESPrawFilter& base, const char* const* fields, size_t count)
+    : _base(&base), _fields(fields), _count(count), _enabled(base.isEnabled()) {
+}
+
+const ESPrawFilter& ESPrawFilter::none() {
+    static const ESPrawFilter filter;
+    return filter;
+}
+
+static const ESPrawFilter& baseFilter() {
+    static const ESPrawFilter filter(BASE_FIELDS, ESPRAW_COUNT_OF(BASE_FIELDS));
+    return filter;
+}
+
+const ESPrawFilter& ESPrawFilter::submission() {
+    static const ESPrawFilter filter(baseFilter(), SUBMISSION_FIELDS, ESPRAW_COUNT_OF(SUBMISSION_FIELDS));
+    return filter;
+}
+
+const ESPrawFilter& ESPrawFilter::comment() {
+    static const ESPrawFilter filter(baseFilter(), COMMENT_FIELDS, ESPRAW_COUNT_OF(COMMENT_FIELDS));
+    return filter;
+}
+
+const ESPrawFilter& ESPrawFilter::subreddit() {
+    static const ESPrawFilter filter(baseFilter(), SUBREDDIT_FIELDS, ESPRAW_COUNT_OF(SUBREDDIT_FIELDS));
+    return filter;
+}
+
+const ESPrawFilter& ESPrawFilter::redditor() {
+    static const ESPrawFilter filter(baseFilter(), REDDITOR_FIELDS, ESPRAW_COUNT_OF(REDDITOR_FIELDS));
+    return filter;
+}
+
+const ESPrawFilter& ESPrawFilter::thing() {
+    static const ESPrawFilter withComment(submission(), COMMENT_FIELDS, ESPRAW_COUNT_OF(COMMENT_FIELDS));
+    static const ESPrawFilter filter(withComment, SUBREDDIT_FIELDS, ESPRAW_COUNT_OF(SUBREDDIT_FIELDS));
+    return filter;
+}
+
+bool ESPrawFilter::isEnabled() const {
+    return _enabled;
+}
+
+void ESPrawFilter::addFields(JsonObject data) const {
+    if (_base) {
+        _base->addFields(data);
+    }
+    for (size_t i = 0; i < _count; i++) {
+        data[_fields[i]] = true;
+    }
+}
+
+void ESPrawFilter::buildObject(JsonDocument& filter) const {
+    filter.clear();
+    addFields(filter.to<JsonObject>());
+}
+
+void ESPrawFilter::buildThing(JsonDocument& filter) const {
+    filter.clear();
+    JsonObject thing = filter.to<JsonObject>();
+    thing["kind"] = true;
+    addFields(thing.createNestedObject("data"));
+}
+
+void ESPrawFilter::buildListing(JsonDocument& filter) const {
+    filter.clear();
+    addFields(addListing(filter.to<JsonObject>()));
+}
+
+void ESPrawFilter::buildCommentsPage(JsonDocument& filter, const ESPrawFilter& submissionFields,
+                                     const ESPrawFilter& commentFields, int depth) {
+    filter.clear();
+    
+    // ArduinoJson applies the first element of an array filter to every
+    // element, so both listings share one filter holding both field sets
+    JsonArray page = filter.to<JsonArray>();
+    JsonObject data = addListing(page.createNestedObject());
+    submissionFields.addFields(data);
+    commentFields.addFields(data);
+    
+    // Replies are nested listings; levels past the depth are dropped
+    for (int level = 0; level < depth; level++) {
+        data = addListing(data.createNestedObject("replies"));
+        commentFields.addFields(data);
+    }
+}
+
+size_t ESPrawFilter::capacity(int depth) const {
+    size_t fields = fieldCount();
+    // Each level holds the item fields plus the listing/thing skeleton
+    return depth * (JSON_OBJECT_SIZE(fields + 2) + 3 * JSON_OBJECT_SIZE(3) + JSON_ARRAY_SIZE(1)) +
+           JSON_ARRAY_SIZE(1);
+}
+
+size_t ESPrawFilter::fieldCount() const {
+    return _count + (_base ? _base->fieldCount() : 0);
+}
+
+JsonObject ESPrawFilter::addListing(JsonObject listing) {
+    listing["kind"] = true;
+    JsonObject data = listing.createNestedObject("data");
+    data["after"] = true;
+    data["before"] = true;
+    JsonObject child = data.createNestedArray("children").createNestedObject();
+    child["kind"] = true;
+    return child.createNestedObject("data");
+}
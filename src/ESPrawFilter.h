@@ -0,0 +1,134 @@
+/**
+ * ESPrawFilter.h - Response field filters for ESPraw
+ * 
+ * Reddit listings carry dozens of fields per item (previews, media embeds,
+ * awards, ...) that the models never read. An ESPrawFilter names the fields
+ * to keep and builds the ArduinoJson filter document used while the
+ * response is deserialized, so unused fields never reach the caller's
+ * JsonDocument.
+ */
+
+#ifndef ESPRAW_FILTER_H
+#define ESPRAW_FILTER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "ESPrawConfig.h"
+
+/**
+ * ESPrawFilter - List of fields to keep for one kind of Reddit object
+ * 
+ * Built-in profiles match the fields read by the model parsers. Custom
+ * profiles can be created from a caller-owned array of field names:
+ * 
+ * ```cpp
+ * static const char* fields[] = { "title", "score", "thumbnail" };
+ * ESPrawFilter myFields(fields, 3);
+ * sub->hot(doc, 100, myFields);
+ * ```
+ */
+class ESPrawFilter {
+public:
+    /**
+     * Constructor for a filter that keeps every field
+     */
+    ESPrawFilter();
+    
+    /**
+     * Constructor for a custom field list
+     * @param fields Field names (the array must outlive the filter)
+     * @param count Number of fields
+     */
+    ESPrawFilter(const char* const* fields, size_t count);
+    
+    /**
+     * Constructor for a field list extending another filter
+     * @param base Filter whose fields are kept as well
+     * @param fields Additional field names (the array must outlive the filter)
+     * @param count Number of additional fields
+     */
+    ESPrawFilter(const ESPrawFilter& base, const char* const* fields, size_t count);
+    
+    // Built-in profiles
+    static const ESPrawFilter& none();
+    static const ESPrawFilter& submission();
+    static const ESPrawFilter& comment();
+    static const ESPrawFilter& subreddit();
+    static const ESPrawFilter& redditor();
+    
+    /**
+     * Get the fields of submissions, comments and subreddits together, for
+     * listings that mix them (e.g. /api/info)
+     * @return Combined profile
+     */
+    static const ESPrawFilter& thing();
+    
+    /**
+     * Check if this filter removes anything
+     * @return false for the keep-everything filter
+     */
+    bool isEnabled() const;
+    
+    /**
+     * Add this filter's fields to a filter object
+     * @param data Object that mirrors the item's "data" object
+     */
+    void addFields(JsonObject data) const;
+    
+    /**
+     * Build a filter for a bare object ({ field, ... })
+     * @param filter Document to build the filter in
+     */
+    void buildObject(JsonDocument& filter) const;
+    
+    /**
+     * Build a filter for a single thing ({ kind, data: { field, ... } })
+     * @param filter Document to build the filter in
+     */
+    void buildThing(JsonDocument& filter) const;
+    
+    /**
+     * Build a filter for a listing of things
+     * @param filter Document to build the filter in
+     */
+    void buildListing(JsonDocument& filter) const;
+    
+    /**
+     * Build a filter for a comments page ([submission listing, comment listing])
+     * @param filter Document to build the filter in
+     * @param submissionFields Fields to keep for the submission
+     * @param commentFields Fields to keep for each comment
+     * @param depth Number of reply levels to keep
+     */
+    static void buildCommentsPage(JsonDocument& filter, const ESPrawFilter& submissionFields,
+                                  const ESPrawFilter& commentFields,
+                                  int depth = ESPRAW_COMMENT_FILTER_DEPTH);
+    
+    /**
+     * Get a document capacity large enough for the filters built from this profile
+     * @param depth Number of nested levels the filter will have
+     * @return Capacity in bytes
+     */
+    size_t capacity(int depth = 1) const;
+
+private:
+    /**
+     * Get the number of fields including the base filter's
+     * @return Field count
+     */
+    size_t fieldCount() const;
+    
+    /**
+     * Add a listing skeleton and return its children's data object
+     * @param listing Object to turn into a listing filter
+     * @return Filter object for each child's data
+     */
+    static JsonObject addListing(JsonObject listing);
+    
+    const ESPrawFilter* _base;
+    const char* const* _fields;
+    size_t _count;
+    bool _enabled;
+};
+
+#endif // ESPRAW_FILTER_H
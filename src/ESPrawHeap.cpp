@@ -0,0 +1,57 @@
+/**
+ * ESPrawHeap.cpp - Heap instrumentation implementation
+ */
+
+#include "ESPrawHeap.h"
+
+void ESPrawHeapTotals::add(const ESPrawHeapStats& stats) {
+    if (calls == 0 || stats.maxBlockAfter < minMaxBlock) {
+        minMaxBlock = stats.maxBlockAfter;
+    }
+    calls++;
+    allocations += stats.allocations;
+    bytesAllocated += stats.bytesAllocated;
+    if (stats.peakDelta > maxPeakDelta) {
+        maxPeakDelta = stats.peakDelta;
+    }
+    heapDrift += (long)stats.freeBefore - (long)stats.freeAfter;
+}
+
+ESPrawSystemHeapProbe::ESPrawSystemHeapProbe()
+    : _freeBefore(0), _maxBlockBefore(0), _lowWaterBefore(0),
+      _allocationsBefore(0), _bytesBefore(0), _usedBefore(0) {
+}
+
+void ESPrawSystemHeapProbe::start() {
+    _freeBefore = ESP.getFreeHeap();
+    _maxBlockBefore = ESP.getMaxAllocHeap();
+    _lowWaterBefore = ESP.getMinFreeHeap();
+#ifndef ESP32
+    _allocationsBefore = ESP.getThreadAllocations();
+    _bytesBefore = ESP.getThreadBytesAllocated();
+    _usedBefore = ESP.getThreadHeapUsed();
+    ESP.resetThreadPeakHeap();
+#endif
+}
+
+void ESPrawSystemHeapProbe::stop(ESPrawHeapStats& stats) {
+    stats.freeBefore = _freeBefore;
+    stats.freeAfter = ESP.getFreeHeap();
+    stats.maxBlockBefore = _maxBlockBefore;
+    stats.maxBlockAfter = ESP.getMaxAllocHeap();
+
+#ifdef ESP32
+    stats.allocations = 0;
+    stats.bytesAllocated = 0;
+
+    // The low-water mark only tells us about the call if it moved
+    uint32_t lowWater = ESP.getMinFreeHeap();
+    uint32_t lowest = lowWater < _lowWaterBefore ? lowWater : stats.freeAfter;
+    stats.peakDelta = lowest < _freeBefore ? _freeBefore - lowest : 0;
+#else
+    stats.allocations = ESP.getThreadAllocations() - _allocationsBefore;
+    stats.bytesAllocated = ESP.getThreadBytesAllocated() - _bytesBefore;
+    long peak = ESP.getThreadPeakHeap() - _usedBefore;
+    stats.peakDelta = peak > 0 ? (uint32_t)peak : 0;
+#endif
+}
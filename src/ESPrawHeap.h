@@ -0,0 +1,94 @@
+/**
+ * ESPrawHeap.h - Heap instrumentation for API calls
+ *
+ * Long-running devices fail from heap fragmentation rather than from
+ * running out of memory outright. With a probe set, every API call made
+ * through ESPraw records its heap footprint in ESPrawResponse::heap and in
+ * a running aggregate:
+ *
+ *   ESPrawSystemHeapProbe probe;
+ *   reddit.setHeapProbe(&probe);
+ *   ...
+ *   const ESPrawHeapTotals& totals = reddit.getHeapTotals();
+ *   Serial.printf("calls: %lu, worst peak: %lu, smallest max block: %lu\n",
+ *                 totals.calls, totals.maxPeakDelta, totals.minMaxBlock);
+ */
+
+#ifndef ESPRAW_HEAP_H
+#define ESPRAW_HEAP_H
+
+#include <Arduino.h>
+#include "ESPrawConfig.h"
+
+/**
+ * Aggregate of the heap statistics of every instrumented call
+ */
+struct ESPrawHeapTotals {
+    unsigned long calls;             // Instrumented calls
+    unsigned long allocations;       // Sum of allocations (host only)
+    unsigned long bytesAllocated;    // Sum of bytes allocated (host only)
+    unsigned long maxPeakDelta;      // Largest peak heap use of a single call
+    unsigned long minMaxBlock;       // Smallest largest-free-block seen after a call
+    long heapDrift;                  // Sum of (free before - free after): heap kept by calls
+
+    ESPrawHeapTotals()
+        : calls(0), allocations(0), bytesAllocated(0), maxPeakDelta(0),
+          minMaxBlock(0), heapDrift(0) {}
+
+    /**
+     * Add the statistics of one call
+     * @param stats Call statistics
+     */
+    void add(const ESPrawHeapStats& stats);
+};
+
+/**
+ * ESPrawHeapProbe - Measures the heap around one call
+ *
+ * start() and stop() bracket a call; calls are not nested.
+ */
+class ESPrawHeapProbe {
+public:
+    virtual ~ESPrawHeapProbe() {}
+
+    /**
+     * Record the heap state before a call
+     */
+    virtual void start() = 0;
+
+    /**
+     * Measure the call since start()
+     * @param stats Receives the call's heap statistics
+     */
+    virtual void stop(ESPrawHeapStats& stats) = 0;
+};
+
+/**
+ * ESPrawSystemHeapProbe - Heap figures from the platform
+ *
+ * On the ESP32 it reads ESP.getFreeHeap() and ESP.getMaxAllocHeap().
+ * Allocations can't be counted there, and the peak comes from the heap's
+ * low-water mark, so it is exact only when the call set a new low and is
+ * otherwise the net heap use of the call. On the host the counting
+ * allocator in test/hal supplies exact per-thread counts and peaks.
+ */
+class ESPrawSystemHeapProbe : public ESPrawHeapProbe {
+public:
+    /**
+     * Constructor
+     */
+    ESPrawSystemHeapProbe();
+
+    void start() override;
+    void stop(ESPrawHeapStats& stats) override;
+
+private:
+    uint32_t _freeBefore;
+    uint32_t _maxBlockBefore;
+    uint32_t _lowWaterBefore;        // ESP32: heap low-water mark at start()
+    unsigned long _allocationsBefore;
+    unsigned long _bytesBefore;
+    long _usedBefore;
+};
+
+#endif // ESPRAW_HEAP_H
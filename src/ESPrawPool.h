@@ -0,0 +1,195 @@
+/**
+ * ESPrawPool.h - Owning pointers and fixed-capacity pools for models
+ *
+ * ESPraw's factories (subreddit(), submission(), redditor(), ...) return
+ * an ESPrawPtr, a std::unique_ptr that frees the object when it goes out
+ * of scope. By default every object is a separate heap allocation; a bot
+ * that looks up the same few subreddits every minute then carves a fresh
+ * block out of the heap each time. An ESPrawPool reserves room for a
+ * fixed number of objects of one model type once, and the factories
+ * construct into it instead, so those lookups reuse the same memory:
+ *
+ *   ESPrawPool<Subreddit> subreddits(4);
+ *   reddit.setSubredditPool(&subreddits);
+ *   ESPrawPtr<Subreddit> sub = reddit.subreddit("esp32");
+ *
+ * When the pool is full, objects fall back to the heap. The pool must
+ * outlive every object it hands out. Not thread-safe.
+ */
+
+#ifndef ESPRAW_POOL_H
+#define ESPRAW_POOL_H
+
+#include <stddef.h>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename T>
+class ESPrawPool;
+
+/**
+ * ESPrawDeleter - Returns an object to the pool it came from, or deletes it
+ * @tparam T Object type
+ */
+template <typename T>
+struct ESPrawDeleter {
+    ESPrawPool<T>* pool;    // nullptr for heap objects
+
+    ESPrawDeleter(ESPrawPool<T>* owner = nullptr) : pool(owner) {}
+
+    void operator()(T* object) const {
+        if (pool != nullptr) {
+            pool->destroy(object);
+        } else {
+            delete object;
+        }
+    }
+};
+
+/**
+ * Owning pointer to an object from a pool or from the heap
+ * @tparam T Object type
+ */
+template <typename T>
+using ESPrawPtr = std::unique_ptr<T, ESPrawDeleter<T>>;
+
+/**
+ * ESPrawPool - Fixed number of object slots in one allocation
+ * @tparam T Object type
+ */
+template <typename T>
+class ESPrawPool {
+public:
+    /**
+     * Constructor; allocates every slot up front
+     * @param capacity Number of objects the pool can hold at once
+     */
+    explicit ESPrawPool(size_t capacity)
+        : _slots(new (std::nothrow) Slot[capacity]), _free(nullptr),
+          _capacity(0), _inUse(0), _overflows(0) {
+        if (_slots != nullptr) {
+            _capacity = capacity;
+            for (size_t i = capacity; i > 0; i--) {
+                _slots[i - 1].next = _free;
+                _free = &_slots[i - 1];
+            }
+        }
+    }
+
+    /**
+     * Destructor; frees the slots (every object must have been released)
+     */
+    ~ESPrawPool() {
+        delete[] _slots;
+    }
+
+    // Owns the slots
+    ESPrawPool(const ESPrawPool&) = delete;
+    ESPrawPool& operator=(const ESPrawPool&) = delete;
+
+    /**
+     * Construct an object in the pool, or on the heap without one
+     *
+     * Falls back to the heap when the pool is full; overflows() counts
+     * those.
+     *
+     * @param pool Pool to construct in (may be null)
+     * @param args Constructor arguments
+     * @return Owning pointer, returning the object to its pool when reset
+     */
+    template <typename... Args>
+    static ESPrawPtr<T> make(ESPrawPool<T>* pool, Args&&... args) {
+        if (pool != nullptr) {
+            T* object = pool->create(std::forward<Args>(args)...);
+            if (object != nullptr) {
+                return ESPrawPtr<T>(object, ESPrawDeleter<T>(pool));
+            }
+            pool->_overflows++;
+        }
+        return ESPrawPtr<T>(new T(std::forward<Args>(args)...));
+    }
+
+    /**
+     * Construct an object in a free slot
+     * @param args Constructor arguments
+     * @return Object, or nullptr if every slot is taken
+     */
+    template <typename... Args>
+    T* create(Args&&... args) {
+        if (_free == nullptr) {
+            return nullptr;
+        }
+
+        Slot* slot = _free;
+        _free = slot->next;
+        _inUse++;
+        return new (&slot->storage) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Destroy an object and free its slot
+     * @param object Object from create()
+     */
+    void destroy(T* object) {
+        if (object == nullptr) {
+            return;
+        }
+
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = _free;
+        _free = slot;
+        _inUse--;
+    }
+
+    /**
+     * Check if an object lives in this pool
+     * @param object Object to check
+     * @return true if it occupies one of the slots
+     */
+    bool owns(const T* object) const {
+        const Slot* slot = reinterpret_cast<const Slot*>(object);
+        return slot >= _slots && slot < _slots + _capacity;
+    }
+
+    /**
+     * Get the number of slots
+     * @return Capacity (0 if the slots could not be allocated)
+     */
+    size_t capacity() const {
+        return _capacity;
+    }
+
+    /**
+     * Get the number of live objects
+     * @return Occupied slots
+     */
+    size_t inUse() const {
+        return _inUse;
+    }
+
+    /**
+     * Get the number of objects make() put on the heap because the pool was full
+     * @return Overflow count
+     */
+    unsigned long overflows() const {
+        return _overflows;
+    }
+
+private:
+    // A free slot links to the next free one; a used one holds the object
+    union Slot {
+        Slot* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    Slot* _slots;
+    Slot* _free;
+    size_t _capacity;
+    size_t _inUse;
+    unsigned long _overflows;
+};
+
+#endif // ESPRAW_POOL_H
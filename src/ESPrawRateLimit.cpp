@@ -0,0 +1,188 @@
+/**
+ * ESPrawRateLimit.cpp - Rate limiter implementations
+ */
+
+#include "ESPrawRateLimit.h"
+#include <stdlib.h>
+
+ESPrawTokenBucketLimiter::ESPrawTokenBucketLimiter(uint32_t rate, unsigned long period, uint32_t burst) {
+    configure(rate, period, burst);
+}
+
+void ESPrawTokenBucketLimiter::configure(uint32_t rate, unsigned long period, uint32_t burst) {
+    if (rate == 0) {
+        rate = 1;
+    }
+    if (burst == 0) {
+        burst = 1;
+    }
+    
+    _intervalUs = (uint64_t)period * 1000ULL / rate;
+    _toleranceUs = _intervalUs * (burst - 1);
+    reset();
+}
+
+bool ESPrawTokenBucketLimiter::canRequest(unsigned long now) const {
+    return backlogAt(now) <= _toleranceUs;
+}
+
+unsigned long ESPrawTokenBucketLimiter::timeUntilNextRequest(unsigned long now) const {
+    uint64_t backlog = backlogAt(now);
+    if (backlog <= _toleranceUs) {
+        return 0;
+    }
+    // Round up so waiting the returned time always suffices
+    return (unsigned long)((backlog - _toleranceUs + 999) / 1000);
+}
+
+void ESPrawTokenBucketLimiter::recordRequest(unsigned long now) {
+    _backlogUs = backlogAt(now) + _intervalUs;
+    _updatedAt = now;
+}
+
+void ESPrawTokenBucketLimiter::reset() {
+    _backlogUs = 0;
+    _updatedAt = 0;
+}
+
+uint64_t ESPrawTokenBucketLimiter::backlogAt(unsigned long now) const {
+    // Unsigned subtraction keeps this correct across millis() rollover
+    uint64_t elapsedUs = (uint64_t)(unsigned long)(now - _updatedAt) * 1000ULL;
+    return elapsedUs >= _backlogUs ? 0 : _backlogUs - elapsedUs;
+}
+
+ESPrawSlidingWindowLimiter::ESPrawSlidingWindowLimiter(size_t limit, unsigned long window)
+    : _times(nullptr), _limit(0), _head(0), _count(0), _window(0) {
+    configure(limit, window);
+}
+
+ESPrawSlidingWindowLimiter::~ESPrawSlidingWindowLimiter() {
+    delete[] _times;
+}
+
+void ESPrawSlidingWindowLimiter::configure(size_t limit, unsigned long window) {
+    if (limit == 0) {
+        limit = 1;
+    }
+    
+    if (limit != _limit) {
+        delete[] _times;
+        _times = new unsigned long[limit];
+        _limit = limit;
+    }
+    
+    _window = window;
+    reset();
+}
+
+bool ESPrawSlidingWindowLimiter::canRequest(unsigned long now) const {
+    return _count < _limit || now - _times[_head] >= _window;
+}
+
+unsigned long ESPrawSlidingWindowLimiter::timeUntilNextRequest(unsigned long now) const {
+    if (canRequest(now)) {
+        return 0;
+    }
+    return _window - (now - _times[_head]);
+}
+
+void ESPrawSlidingWindowLimiter::recordRequest(unsigned long now) {
+    if (_count < _limit) {
+        // Entries fill from index 0, so the head stays at 0 until full
+        _times[_count++] = now;
+    } else {
+        // Overwrite the oldest entry; the next oldest becomes the head
+        _times[_head] = now;
+        _head = _head + 1 == _limit ? 0 : _head + 1;
+    }
+}
+
+void ESPrawSlidingWindowLimiter::reset() {
+    // recordRequest() relies on the head being 0 while the ring fills
+    _head = 0;
+    _count = 0;
+}
+
+size_t ESPrawSlidingWindowLimiter::getCount(unsigned long now) const {
+    size_t count = 0;
+    for (size_t i = 0; i < _count; i++) {
+        if (now - _times[(_head + i) % _limit] < _window) {
+            count++;
+        }
+    }
+    return count;
+}
+
+ESPrawHeaderRateLimiter::ESPrawHeaderRateLimiter() {
+    reset();
+}
+
+bool ESPrawHeaderRateLimiter::update(const char* used, const char* remaining, const char* reset,
+                                     unsigned long now) {
+    if (!remaining || !*remaining || !reset || !*reset) {
+        return false;
+    }
+    
+    _remaining = (float)atof(remaining);
+    _used = (used && *used) ? (float)atof(used) : 0;
+    _resetMs = strtoul(reset, nullptr, 10) * 1000UL;
+    _updatedAt = now;
+    _hasBudget = true;
+    return true;
+}
+
+void ESPrawHeaderRateLimiter::recordRequest(unsigned long now) {
+    if (!_hasBudget) {
+        return;
+    }
+    
+    if (periodEnded(now)) {
+        // The server has started a new period; the response to this
+        // request will report the real budget
+        return;
+    }
+    
+    _used += 1;
+    _remaining = _remaining >= 1 ? _remaining - 1 : 0;
+}
+
+bool ESPrawHeaderRateLimiter::canRequest(unsigned long now) const {
+    return !_hasBudget || _remaining >= 1 || periodEnded(now);
+}
+
+unsigned long ESPrawHeaderRateLimiter::timeUntilNextRequest(unsigned long now) const {
+    if (canRequest(now)) {
+        return 0;
+    }
+    return getResetIn(now);
+}
+
+bool ESPrawHeaderRateLimiter::hasBudget() const {
+    return _hasBudget;
+}
+
+float ESPrawHeaderRateLimiter::getRemaining() const {
+    return _remaining;
+}
+
+float ESPrawHeaderRateLimiter::getUsed() const {
+    return _used;
+}
+
+unsigned long ESPrawHeaderRateLimiter::getResetIn(unsigned long now) const {
+    // Unsigned subtraction keeps this correct across millis() rollover
+    unsigned long elapsed = now - _updatedAt;
+    return elapsed >= _resetMs ? 0 : _resetMs - elapsed;
+}
+
+void ESPrawHeaderRateLimiter::reset() {
+    _used = 0;
+    _remaining = 0;
+    _resetMs = 0;
+    _updatedAt = 0;
+    _hasBudget = false;
+}
+
+bool ESPrawHeaderRateLimiter::periodEnded(unsigned long now) const {
+    return now - _updatedAt >= _resetMs;
+}
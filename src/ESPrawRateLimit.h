@@ -0,0 +1,234 @@
+/**
+ * ESPrawRateLimit.h - Rate limiters for ESPraw
+ * 
+ * Rate limiting state is kept independent of the Arduino core: every call
+ * takes the current time in milliseconds, so the limiters can be driven by
+ * millis() on the device and by a fake clock in host tests.
+ */
+
+#ifndef ESPRAW_RATE_LIMIT_H
+#define ESPRAW_RATE_LIMIT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * ESPrawRateLimiter - Interface for request rate limiters
+ * 
+ * All checks are constant time. Times are compared by unsigned
+ * subtraction, so limiters stay correct when millis() wraps after 49 days.
+ */
+class ESPrawRateLimiter {
+public:
+    virtual ~ESPrawRateLimiter() {}
+    
+    /**
+     * Check if a request may be sent now
+     * @param now Current time in milliseconds
+     * @return true if a request may be sent
+     */
+    virtual bool canRequest(unsigned long now) const = 0;
+    
+    /**
+     * Get time until the next request is allowed
+     * @param now Current time in milliseconds
+     * @return Milliseconds to wait (0 if a request may be sent now)
+     */
+    virtual unsigned long timeUntilNextRequest(unsigned long now) const = 0;
+    
+    /**
+     * Account for a request being sent
+     * @param now Current time in milliseconds
+     */
+    virtual void recordRequest(unsigned long now) = 0;
+    
+    /**
+     * Forget all recorded requests
+     */
+    virtual void reset() = 0;
+};
+
+/**
+ * ESPrawTokenBucketLimiter - Token bucket using the generic cell rate algorithm
+ * 
+ * Allows `rate` requests per `period` on average with bursts of up to
+ * `burst` requests. Instead of a token count the limiter keeps the backlog
+ * of scheduled request time (in microseconds, so uneven rates don't drift)
+ * relative to the last update, which needs no per-request storage.
+ */
+class ESPrawTokenBucketLimiter : public ESPrawRateLimiter {
+public:
+    /**
+     * Constructor
+     * @param rate Requests allowed per period
+     * @param period Period length in milliseconds
+     * @param burst Requests that may be sent back to back (at least 1)
+     */
+    ESPrawTokenBucketLimiter(uint32_t rate, unsigned long period, uint32_t burst);
+    
+    /**
+     * Change rate, period and burst; clears the backlog
+     * @param rate Requests allowed per period
+     * @param period Period length in milliseconds
+     * @param burst Requests that may be sent back to back (at least 1)
+     */
+    void configure(uint32_t rate, unsigned long period, uint32_t burst);
+    
+    bool canRequest(unsigned long now) const override;
+    unsigned long timeUntilNextRequest(unsigned long now) const override;
+    void recordRequest(unsigned long now) override;
+    void reset() override;
+
+private:
+    /**
+     * Backlog left at `now` after draining since the last update
+     */
+    uint64_t backlogAt(unsigned long now) const;
+    
+    uint64_t _intervalUs;    // Time one request occupies
+    uint64_t _toleranceUs;   // Backlog allowed before requests must wait
+    uint64_t _backlogUs;     // Scheduled request time not yet elapsed at _updatedAt
+    unsigned long _updatedAt;
+};
+
+/**
+ * ESPrawSlidingWindowLimiter - Exact sliding window over a ring of timestamps
+ * 
+ * Allows at most `limit` requests in any `window` milliseconds. The ring
+ * holds the last `limit` send times; a request is allowed once the oldest
+ * of them has left the window.
+ */
+class ESPrawSlidingWindowLimiter : public ESPrawRateLimiter {
+public:
+    /**
+     * Constructor
+     * @param limit Requests allowed per window
+     * @param window Window length in milliseconds
+     */
+    ESPrawSlidingWindowLimiter(size_t limit, unsigned long window);
+    
+    /**
+     * Destructor
+     */
+    ~ESPrawSlidingWindowLimiter();
+    
+    // Owns the ring buffer
+    ESPrawSlidingWindowLimiter(const ESPrawSlidingWindowLimiter&) = delete;
+    ESPrawSlidingWindowLimiter& operator=(const ESPrawSlidingWindowLimiter&) = delete;
+    
+    /**
+     * Change the limit and window; clears recorded requests
+     * @param limit Requests allowed per window
+     * @param window Window length in milliseconds
+     */
+    void configure(size_t limit, unsigned long window);
+    
+    bool canRequest(unsigned long now) const override;
+    unsigned long timeUntilNextRequest(unsigned long now) const override;
+    void recordRequest(unsigned long now) override;
+    void reset() override;
+    
+    /**
+     * Get the number of requests in the window
+     * @param now Current time in milliseconds
+     * @return Requests sent in the last `window` milliseconds
+     */
+    size_t getCount(unsigned long now) const;
+
+private:
+    unsigned long* _times;   // Ring of send times, oldest at _head once full
+    size_t _limit;
+    size_t _head;
+    size_t _count;
+    unsigned long _window;
+};
+
+/**
+ * ESPrawHeaderRateLimiter - Spends the budget reported by Reddit
+ * 
+ * Reddit reports the real per-client budget in the X-Ratelimit-Used,
+ * X-Ratelimit-Remaining and X-Ratelimit-Reset response headers. This
+ * limiter tracks those values, counts requests sent since the last
+ * response, and only blocks when the remaining budget is exhausted.
+ */
+class ESPrawHeaderRateLimiter : public ESPrawRateLimiter {
+public:
+    /**
+     * Constructor
+     */
+    ESPrawHeaderRateLimiter();
+    
+    /**
+     * Update the budget from response header values
+     * @param used Value of X-Ratelimit-Used (may be null or empty)
+     * @param remaining Value of X-Ratelimit-Remaining (may be null or empty)
+     * @param reset Value of X-Ratelimit-Reset in seconds (may be null or empty)
+     * @param now Current time in milliseconds
+     * @return true if the headers carried a budget
+     */
+    bool update(const char* used, const char* remaining, const char* reset, unsigned long now);
+    
+    /**
+     * Account for a request about to be sent
+     * @param now Current time in milliseconds
+     */
+    void recordRequest(unsigned long now) override;
+    
+    /**
+     * Check if the budget allows a request now
+     * @param now Current time in milliseconds
+     * @return true if a request may be sent
+     */
+    bool canRequest(unsigned long now) const override;
+    
+    /**
+     * Get time until the next request is allowed
+     * @param now Current time in milliseconds
+     * @return Milliseconds to wait (0 if a request may be sent now)
+     */
+    unsigned long timeUntilNextRequest(unsigned long now) const override;
+    
+    /**
+     * Check if a budget has been received from the server
+     * @return true once any response carried rate limit headers
+     */
+    bool hasBudget() const;
+    
+    /**
+     * Get the remaining budget, including requests sent since the last update
+     * @return Remaining requests in the current period
+     */
+    float getRemaining() const;
+    
+    /**
+     * Get the used budget, including requests sent since the last update
+     * @return Requests used in the current period
+     */
+    float getUsed() const;
+    
+    /**
+     * Get time until the server resets the budget
+     * @param now Current time in milliseconds
+     * @return Milliseconds until reset
+     */
+    unsigned long getResetIn(unsigned long now) const;
+    
+    /**
+     * Forget the received budget
+     */
+    void reset() override;
+
+private:
+    /**
+     * Check if the reported reset time has passed
+     */
+    bool periodEnded(unsigned long now) const;
+    
+    float _used;
+    float _remaining;
+    unsigned long _resetMs;      // Period length reported at _updatedAt
+    unsigned long _updatedAt;
+    bool _hasBudget;
+};
+
+#endif // ESPRAW_RATE_LIMIT_H
@@ -0,0 +1,86 @@
+/**
+ * ESPrawRing.h - Lock-free single-producer/single-consumer ring buffer
+ *
+ * Exactly one task may push and exactly one (other) task may pop. The
+ * indices are free-running counters published with release/acquire
+ * ordering, so everything the producer wrote before push() is visible to
+ * the consumer after the matching pop(). No locks and no allocation.
+ */
+
+#ifndef ESPRAW_RING_H
+#define ESPRAW_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/**
+ * ESPrawSpscRing - Bounded lock-free queue for one producer and one consumer
+ * @tparam T Element type (copy-assignable)
+ * @tparam N Capacity (power of two)
+ */
+template <typename T, size_t N>
+class ESPrawSpscRing {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "ESPrawSpscRing capacity must be a power of two");
+
+public:
+    /**
+     * Constructor
+     */
+    ESPrawSpscRing() : _head(0), _tail(0) {}
+
+    /**
+     * Append an element (producer only)
+     * @param value Element to append
+     * @return false if the ring is full
+     */
+    bool push(const T& value) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) >= N) {
+            return false;
+        }
+
+        _items[tail & (N - 1)] = value;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Remove the oldest element (consumer only)
+     * @param value Receives the element
+     * @return false if the ring is empty
+     */
+    bool pop(T& value) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        value = _items[head & (N - 1)];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Get the number of queued elements (approximate while the other side runs)
+     * @return Queued elements
+     */
+    size_t size() const {
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Get the capacity
+     * @return Maximum number of queued elements
+     */
+    static constexpr size_t capacity() {
+        return N;
+    }
+
+private:
+    T _items[N];
+    std::atomic<uint32_t> _head;  // Next element to pop (written by the consumer)
+    std::atomic<uint32_t> _tail;  // Next free element (written by the producer)
+};
+
+#endif // ESPRAW_RING_H
@@ -0,0 +1,190 @@
+/**
+ * ESPrawStream.cpp - HTTP response body stream implementation
+ */
+
+#include "ESPrawStream.h"
+
+ESPrawBodyStream::ESPrawBodyStream(Stream& source, long contentLength, bool chunked)
+    : _source(source), _remaining(chunked ? 0 : contentLength), _chunked(chunked),
+      _chunkStarted(false), _finished(!chunked && contentLength == 0),
+      _bufferPos(0), _bufferLen(0), _bytesRead(0), _waitMicros(0) {
+}
+
+int ESPrawBodyStream::available() {
+    int buffered = _bufferLen - _bufferPos;
+    if (_finished || (_chunked && _remaining == 0)) {
+        // Between chunks whatever has arrived is framing, not body
+        return buffered;
+    }
+    int sourceAvailable = _source.available();
+    if (_remaining > 0 && sourceAvailable > _remaining) {
+        sourceAvailable = _remaining;
+    }
+    return buffered + sourceAvailable;
+}
+
+int ESPrawBodyStream::read() {
+    if (!fill()) {
+        return -1;
+    }
+    _bytesRead++;
+    return _buffer[_bufferPos++];
+}
+
+int ESPrawBodyStream::peek() {
+    if (!fill()) {
+        return -1;
+    }
+    return _buffer[_bufferPos];
+}
+
+size_t ESPrawBodyStream::readBytes(char* buffer, size_t length) {
+    size_t copied = 0;
+    
+    while (copied < length && fill()) {
+        size_t n = _bufferLen - _bufferPos;
+        if (n > length - copied) {
+            n = length - copied;
+        }
+        memcpy(buffer + copied, _buffer + _bufferPos, n);
+        _bufferPos += n;
+        copied += n;
+    }
+    
+    _bytesRead += copied;
+    return copied;
+}
+
+void ESPrawBodyStream::drain() {
+    while (fill()) {
+        _bytesRead += _bufferLen - _bufferPos;
+        _bufferPos = _bufferLen;
+    }
+}
+
+bool ESPrawBodyStream::isComplete() const {
+    return _finished && _bufferPos >= _bufferLen;
+}
+
+size_t ESPrawBodyStream::bytesRead() const {
+    return _bytesRead;
+}
+
+uint32_t ESPrawBodyStream::waitMicros() const {
+    return _waitMicros;
+}
+
+bool ESPrawBodyStream::fill() {
+    if (_bufferPos < _bufferLen) {
+        return true;
+    }
+    
+    if (_finished) {
+        return false;
+    }
+    
+    if (_chunked && _remaining == 0 && !readChunkHeader()) {
+        _finished = true;
+        return false;
+    }
+    
+    size_t want = sizeof(_buffer);
+    if (_remaining > 0 && (long)want > _remaining) {
+        want = _remaining;
+    } else if (_remaining < 0) {
+        // Unknown length: only ask for what has arrived so the last
+        // read does not block until the timeout
+        int sourceAvailable = _source.available();
+        if (sourceAvailable < 1) {
+            sourceAvailable = 1;
+        }
+        if ((size_t)sourceAvailable < want) {
+            want = sourceAvailable;
+        }
+    }
+    
+    unsigned long start = micros();
+    size_t n = _source.readBytes((char*)_buffer, want);
+    _waitMicros += micros() - start;
+    if (n == 0) {
+        _finished = true;
+        return false;
+    }
+    
+    _bufferPos = 0;
+    _bufferLen = n;
+    
+    if (_remaining > 0) {
+        _remaining -= n;
+        if (_remaining == 0 && !_chunked) {
+            _finished = true;
+        }
+    }
+    
+    return true;
+}
+
+bool ESPrawBodyStream::readChunkHeader() {
+    if (_chunkStarted) {
+        // CRLF that terminates the previous chunk's data
+        skipLine();
+    }
+    _chunkStarted = true;
+    
+    long size = 0;
+    bool haveDigits = false;
+    bool inExtension = false;
+    int c;
+    
+    while ((c = readSourceByte()) >= 0 && c != '\n') {
+        if (inExtension) {
+            continue;
+        }
+        if (c >= '0' && c <= '9') {
+            size = size * 16 + (c - '0');
+            haveDigits = true;
+        } else if (c >= 'a' && c <= 'f') {
+            size = size * 16 + (c - 'a' + 10);
+            haveDigits = true;
+        } else if (c >= 'A' && c <= 'F') {
+            size = size * 16 + (c - 'A' + 10);
+            haveDigits = true;
+        } else if (c == ';') {
+            inExtension = true;
+        }
+    }
+    
+    if (c < 0 || !haveDigits) {
+        return false;
+    }
+    
+    if (size == 0) {
+        // Last chunk: skip optional trailers up to the blank line
+        while ((c = readSourceByte()) >= 0 && c != '\n') {
+            if (c != '\r') {
+                skipLine();
+            }
+        }
+        return false;
+    }
+    
+    _remaining = size;
+    return true;
+}
+
+int ESPrawBodyStream::readSourceByte() {
+    char c;
+    unsigned long start = micros();
+    size_t n = _source.readBytes(&c, 1);
+    _waitMicros += micros() - start;
+    if (n != 1) {
+        return -1;
+    }
+    return (uint8_t)c;
+}
+
+void ESPrawBodyStream::skipLine() {
+    int c;
+    while ((c = readSourceByte()) >= 0 && c != '\n') {
+    }
+}
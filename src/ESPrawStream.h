@@ -0,0 +1,102 @@
+/**
+ * ESPrawStream.h - HTTP response body stream for ESPraw
+ * 
+ * Wraps the raw connection stream of an HTTP response and yields only the
+ * body bytes, decoding chunked transfer encoding on the fly. This lets
+ * ArduinoJson deserialize straight from the socket without first copying
+ * the whole body into a String.
+ */
+
+#ifndef ESPRAW_STREAM_H
+#define ESPRAW_STREAM_H
+
+#include <Arduino.h>
+#include "ESPrawConfig.h"
+
+/**
+ * ESPrawBodyStream - Read-only view of an HTTP response body
+ */
+class ESPrawBodyStream : public Stream {
+public:
+    /**
+     * Constructor
+     * @param source Connection stream positioned at the start of the body
+     * @param contentLength Body length from Content-Length, or -1 if unknown
+     * @param chunked true if the body uses chunked transfer encoding
+     */
+    ESPrawBodyStream(Stream& source, long contentLength, bool chunked);
+    
+    // Stream interface
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t readBytes(char* buffer, size_t length) override;
+    using Stream::readBytes;
+    
+    // Print interface (the body is read-only)
+    size_t write(uint8_t) override { return 0; }
+    
+    /**
+     * Consume the rest of the body so the connection can be reused
+     */
+    void drain();
+    
+    /**
+     * Check if the whole body has been consumed
+     * @return true if the end of the body was reached
+     */
+    bool isComplete() const;
+    
+    /**
+     * Get number of body bytes consumed so far
+     * @return Decoded byte count
+     */
+    size_t bytesRead() const;
+    
+    /**
+     * Get the time spent waiting on the source so far
+     * 
+     * Everything else the reader spent with the body is processing, which
+     * is how ESPrawClient separates download from parse time.
+     * 
+     * @return Microseconds spent in source reads
+     */
+    uint32_t waitMicros() const;
+
+private:
+    /**
+     * Refill the read buffer from the source
+     * @return true if at least one byte is buffered
+     */
+    bool fill();
+    
+    /**
+     * Read the next chunk-size line
+     * @return true if another data chunk follows
+     */
+    bool readChunkHeader();
+    
+    /**
+     * Read one byte from the source, honoring its timeout
+     * @return Byte value or -1 on timeout/close
+     */
+    int readSourceByte();
+    
+    /**
+     * Skip the remainder of the current line in the source
+     */
+    void skipLine();
+    
+    Stream& _source;
+    long _remaining;      // Bytes left in the body or current chunk (-1 = unknown)
+    bool _chunked;
+    bool _chunkStarted;
+    bool _finished;
+    uint8_t _buffer[ESPRAW_STREAM_BUFFER_SIZE];
+    size_t _bufferPos;
+    size_t _bufferLen;
+    size_t _bytesRead;
+    uint32_t _waitMicros;
+};
+
+#endif // ESPRAW_STREAM_H
@@ -0,0 +1,161 @@
+/**
+ * ESPrawStringPool.cpp - Shared string storage implementation
+ */
+
+#include "ESPrawStringPool.h"
+#include "ESPrawUtil.h"
+#include <new>
+#include <utility>
+
+ESPrawInternedString::ESPrawInternedString(const ESPrawInternedString& other)
+    : _own(other._own), _shared(other._shared) {
+    if (_shared != nullptr) {
+        _shared->refs++;
+    }
+}
+
+ESPrawInternedString::ESPrawInternedString(ESPrawInternedString&& other)
+    : _own(std::move(other._own)), _shared(other._shared) {
+    other._shared = nullptr;
+}
+
+ESPrawInternedString& ESPrawInternedString::operator=(const ESPrawInternedString& other) {
+    if (this != &other) {
+        if (other._shared != nullptr) {
+            other._shared->refs++;
+        }
+        release();
+        _own = other._own;
+        _shared = other._shared;
+    }
+    return *this;
+}
+
+ESPrawInternedString& ESPrawInternedString::operator=(ESPrawInternedString&& other) {
+    if (this != &other) {
+        release();
+        _own = std::move(other._own);
+        _shared = other._shared;
+        other._shared = nullptr;
+    }
+    return *this;
+}
+
+ESPrawInternedString::~ESPrawInternedString() {
+    release();
+}
+
+void ESPrawInternedString::release() {
+    if (_shared == nullptr) {
+        return;
+    }
+
+    if (--_shared->refs == 0) {
+        if (_shared->pool != nullptr) {
+            _shared->pool->remove(_shared);
+        }
+        delete _shared;
+    }
+    _shared = nullptr;
+}
+
+ESPrawStringPool::ESPrawStringPool(size_t maxStrings, size_t maxLength)
+    : _buckets(nullptr), _bucketMask(0), _maxStrings(0), _maxLength(maxLength), _size(0) {
+    // A power of two at least as large as the bound keeps chains short
+    size_t buckets = 1;
+    while (buckets < maxStrings) {
+        buckets <<= 1;
+    }
+
+    _buckets = new (std::nothrow) ESPrawPooledString*[buckets]();
+    if (_buckets != nullptr) {
+        _bucketMask = buckets - 1;
+        _maxStrings = maxStrings;
+    }
+}
+
+ESPrawStringPool::~ESPrawStringPool() {
+    // Strings still referenced outlive the table and free themselves
+    for (size_t i = 0; _buckets != nullptr && i <= _bucketMask; i++) {
+        for (ESPrawPooledString* entry = _buckets[i]; entry != nullptr; entry = entry->next) {
+            entry->pool = nullptr;
+        }
+    }
+    delete[] _buckets;
+}
+
+ESPrawInternedString ESPrawStringPool::intern(const char* text, size_t length) {
+    if (text == nullptr || length == 0) {
+        return ESPrawInternedString();
+    }
+
+    _stats.lookups++;
+    if (length > _maxLength || _buckets == nullptr) {
+        _stats.rejected++;
+        return ESPrawInternedString(String(text, length));
+    }
+
+    uint32_t hash = ESPrawUtil::fnv1a(text, length);
+    ESPrawPooledString** bucket = &_buckets[hash & _bucketMask];
+    for (ESPrawPooledString* entry = *bucket; entry != nullptr; entry = entry->next) {
+        if (entry->hash == hash && entry->value.length() == length &&
+            memcmp(entry->value.c_str(), text, length) == 0) {
+            _stats.hits++;
+            _stats.bytesShared += length + 1;
+            ESPrawInternedString interned;
+            interned._shared = entry;
+            entry->refs++;
+            return interned;
+        }
+    }
+
+    if (_size >= _maxStrings) {
+        _stats.rejected++;
+        return ESPrawInternedString(String(text, length));
+    }
+
+    ESPrawPooledString* entry = new ESPrawPooledString();
+    entry->value = String(text, length);
+    entry->hash = hash;
+    entry->refs = 1;
+    entry->next = *bucket;
+    entry->pool = this;
+    *bucket = entry;
+    _size++;
+
+    ESPrawInternedString interned;
+    interned._shared = entry;
+    return interned;
+}
+
+ESPrawInternedString ESPrawStringPool::intern(const char* text) {
+    return intern(text, text != nullptr ? strlen(text) : 0);
+}
+
+size_t ESPrawStringPool::size() const {
+    return _size;
+}
+
+size_t ESPrawStringPool::capacity() const {
+    return _maxStrings;
+}
+
+const ESPrawStringPoolStats& ESPrawStringPool::getStats() const {
+    return _stats;
+}
+
+void ESPrawStringPool::resetStats() {
+    _stats = ESPrawStringPoolStats();
+}
+
+void ESPrawStringPool::remove(ESPrawPooledString* entry) {
+    ESPrawPooledString** link = &_buckets[entry->hash & _bucketMask];
+    while (*link != nullptr) {
+        if (*link == entry) {
+            *link = entry->next;
+            _size--;
+            return;
+        }
+        link = &(*link)->next;
+    }
+}
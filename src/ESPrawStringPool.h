@@ -0,0 +1,190 @@
+/**
+ * ESPrawStringPool.h - Shared storage for strings that repeat across models
+ *
+ * In a listing the same subreddit names, authors, domains and link IDs
+ * come up again and again, yet every model keeps its own String copy.
+ * With a string pool set, the model parsers look these low-cardinality
+ * fields up in a hash table and share one reference-counted copy:
+ *
+ *   ESPrawStringPool strings;
+ *   reddit.setStringPool(&strings);
+ *   // ... iterate listings ...
+ *   Serial.printf("%.0f%% of lookups shared\n", strings.getStats().dedupeRatio() * 100);
+ *
+ * The table is bounded: once it holds ESPRAW_STRING_POOL_SIZE strings, or
+ * for strings longer than ESPRAW_STRING_POOL_MAX_LENGTH, fields get their
+ * own copy as before. A string leaves the table when the last model using
+ * it is destroyed. Not thread-safe; create and destroy the models from
+ * one task.
+ */
+
+#ifndef ESPRAW_STRING_POOL_H
+#define ESPRAW_STRING_POOL_H
+
+#include <Arduino.h>
+#include "ESPrawConfig.h"
+
+class ESPrawStringPool;
+
+/**
+ * A pooled string and the number of fields sharing it
+ */
+struct ESPrawPooledString {
+    String value;
+    uint32_t hash;
+    uint32_t refs;
+    ESPrawPooledString* next;   // Next string in the same bucket
+    ESPrawStringPool* pool;     // nullptr once the pool is gone
+};
+
+/**
+ * ESPrawInternedString - A string field that may be shared through a pool
+ *
+ * Holds either a pooled string or, without a pool, its own String. Copies
+ * of a pooled string share it.
+ */
+class ESPrawInternedString {
+public:
+    /**
+     * Constructor for an empty string
+     */
+    ESPrawInternedString() : _shared(nullptr) {}
+
+    /**
+     * Constructor for an unpooled string
+     * @param value Text to keep
+     */
+    explicit ESPrawInternedString(const String& value) : _own(value), _shared(nullptr) {}
+
+    ESPrawInternedString(const ESPrawInternedString& other);
+    ESPrawInternedString(ESPrawInternedString&& other);
+    ESPrawInternedString& operator=(const ESPrawInternedString& other);
+    ESPrawInternedString& operator=(ESPrawInternedString&& other);
+    ~ESPrawInternedString();
+
+    /**
+     * Get the text
+     * @return String (shared if pooled)
+     */
+    const String& str() const {
+        return _shared != nullptr ? _shared->value : _own;
+    }
+
+    /**
+     * Check if the text is shared through a pool
+     * @return true if pooled
+     */
+    bool isShared() const {
+        return _shared != nullptr;
+    }
+
+private:
+    friend class ESPrawStringPool;
+
+    /**
+     * Drop the reference to the pooled string, freeing it if it was the last
+     */
+    void release();
+
+    String _own;
+    ESPrawPooledString* _shared;
+};
+
+/**
+ * Deduplication statistics
+ */
+struct ESPrawStringPoolStats {
+    unsigned long lookups;      // intern() calls
+    unsigned long hits;         // Answered with a string already in the table
+    unsigned long rejected;     // Not pooled: table full or string too long
+    unsigned long bytesShared;  // Bytes of text shared instead of copied
+
+    ESPrawStringPoolStats() : lookups(0), hits(0), rejected(0), bytesShared(0) {}
+
+    /**
+     * Get the share of lookups that found their string in the table
+     * @return Ratio from 0 to 1
+     */
+    float dedupeRatio() const {
+        return lookups > 0 ? (float)hits / lookups : 0.0f;
+    }
+};
+
+/**
+ * ESPrawStringPool - Bounded hash table of reference-counted strings
+ */
+class ESPrawStringPool {
+public:
+    /**
+     * Constructor; allocates the bucket array
+     * @param maxStrings Distinct strings held at once
+     * @param maxLength Longest string that is pooled
+     */
+    explicit ESPrawStringPool(size_t maxStrings = ESPRAW_STRING_POOL_SIZE,
+                              size_t maxLength = ESPRAW_STRING_POOL_MAX_LENGTH);
+
+    /**
+     * Destructor; strings still in use stay valid until their last user goes
+     */
+    ~ESPrawStringPool();
+
+    // Owns the buckets
+    ESPrawStringPool(const ESPrawStringPool&) = delete;
+    ESPrawStringPool& operator=(const ESPrawStringPool&) = delete;
+
+    /**
+     * Look up a string, adding it to the table if it is new
+     * @param text Text to intern (may be null)
+     * @param length Length of text
+     * @return Shared string, or an unpooled copy if it cannot be pooled
+     */
+    ESPrawInternedString intern(const char* text, size_t length);
+
+    /**
+     * Look up a NUL-terminated string
+     * @param text Text to intern (may be null)
+     * @return Shared string, or an unpooled copy if it cannot be pooled
+     */
+    ESPrawInternedString intern(const char* text);
+
+    /**
+     * Get the number of distinct strings held
+     * @return Strings in the table
+     */
+    size_t size() const;
+
+    /**
+     * Get the table bound
+     * @return Distinct strings the table can hold
+     */
+    size_t capacity() const;
+
+    /**
+     * Get the deduplication statistics
+     * @return Statistics since construction or the last reset
+     */
+    const ESPrawStringPoolStats& getStats() const;
+
+    /**
+     * Reset the statistics
+     */
+    void resetStats();
+
+private:
+    friend class ESPrawInternedString;
+
+    /**
+     * Unlink a string whose last user is gone
+     * @param entry String to remove
+     */
+    void remove(ESPrawPooledString* entry);
+
+    ESPrawPooledString** _buckets;
+    size_t _bucketMask;
+    size_t _maxStrings;
+    size_t _maxLength;
+    size_t _size;
+    ESPrawStringPoolStats _stats;
+};
+
+#endif // ESPRAW_STRING_POOL_H
@@ -0,0 +1,167 @@
+/**
+ * ESPrawTiming.cpp - Per-endpoint latency statistics implementation
+ */
+
+#include "ESPrawTiming.h"
+
+ESPrawLatencyHistogram::ESPrawLatencyHistogram() : samples(0), lastMicros(0) {
+    memset(buckets, 0, sizeof(buckets));
+}
+
+void ESPrawLatencyHistogram::add(uint32_t micros) {
+    buckets[bucketFor(micros)]++;
+    samples++;
+    lastMicros = micros;
+    
+    // Halving keeps the counts within uint16_t and lets old samples fade
+    if (samples % ESPRAW_LATENCY_WINDOW == 0) {
+        for (uint8_t i = 0; i < ESPRAW_LATENCY_BUCKETS; i++) {
+            buckets[i] /= 2;
+        }
+    }
+}
+
+uint32_t ESPrawLatencyHistogram::count() const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < ESPRAW_LATENCY_BUCKETS; i++) {
+        total += buckets[i];
+    }
+    return total;
+}
+
+uint32_t ESPrawLatencyHistogram::percentile(uint8_t percent) const {
+    uint32_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+    if (percent > 100) {
+        percent = 100;
+    }
+    
+    uint32_t target = (total * percent + 99) / 100;
+    if (target == 0) {
+        target = 1;
+    }
+    
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < ESPRAW_LATENCY_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= target) {
+            return bucketLimit(i);
+        }
+    }
+    return bucketLimit(ESPRAW_LATENCY_BUCKETS - 1);
+}
+
+uint8_t ESPrawLatencyHistogram::bucketFor(uint32_t micros) {
+    uint32_t ms = micros / 1000;
+    uint8_t bucket = 0;
+    while (ms > 0 && bucket < ESPRAW_LATENCY_BUCKETS - 1) {
+        ms >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+uint32_t ESPrawLatencyHistogram::bucketLimit(uint8_t bucket) {
+    return (1UL << bucket) * 1000;
+}
+
+ESPrawLatencyTracker::ESPrawLatencyTracker() : _used(0), _clock(0) {
+    memset(_lastUse, 0, sizeof(_lastUse));
+}
+
+void ESPrawLatencyTracker::record(const String& endpoint, uint32_t micros) {
+    _clock++;
+    
+    size_t slot = 0;
+    for (; slot < _used; slot++) {
+        if (_slots[slot].endpoint == endpoint) {
+            break;
+        }
+    }
+    
+    if (slot == _used) {
+        if (_used < ESPRAW_LATENCY_ENDPOINTS) {
+            _used++;
+        } else {
+            slot = 0;
+            for (size_t i = 1; i < _used; i++) {
+                if (_lastUse[i] < _lastUse[slot]) {
+                    slot = i;
+                }
+            }
+        }
+        _slots[slot] = ESPrawLatencyHistogram();
+        _slots[slot].endpoint = endpoint;
+    }
+    
+    _slots[slot].add(micros);
+    _lastUse[slot] = _clock;
+}
+
+const ESPrawLatencyHistogram* ESPrawLatencyTracker::find(const String& endpoint) const {
+    for (size_t i = 0; i < _used; i++) {
+        if (_slots[i].endpoint == endpoint) {
+            return &_slots[i];
+        }
+    }
+    return nullptr;
+}
+
+size_t ESPrawLatencyTracker::size() const {
+    return _used;
+}
+
+const ESPrawLatencyHistogram& ESPrawLatencyTracker::at(size_t index) const {
+    return _slots[index];
+}
+
+void ESPrawLatencyTracker::reset() {
+    for (size_t i = 0; i < _used; i++) {
+        _slots[i] = ESPrawLatencyHistogram();
+    }
+    memset(_lastUse, 0, sizeof(_lastUse));
+    _used = 0;
+    _clock = 0;
+}
+
+String ESPrawLatencyTracker::normalizeEndpoint(const String& url, const String& baseUrl) {
+    int start = url.startsWith(baseUrl) ? baseUrl.length() : 0;
+    int end = url.indexOf('?', start);
+    if (end < 0) {
+        end = url.length();
+    }
+    
+    String path;
+    path.reserve(end - start);
+    int wildcards = 0;   // Segments still to replace
+    
+    int pos = start;
+    while (pos < end) {
+        int slash = url.indexOf('/', pos);
+        if (slash < 0 || slash > end) {
+            slash = end;
+        }
+        
+        if (slash > pos) {
+            String segment = url.substring(pos, slash);
+            path += '/';
+            if (wildcards > 0) {
+                path += "{}";
+                wildcards--;
+            } else {
+                path += segment;
+                if (segment == "comments") {
+                    wildcards = 2;
+                } else if (segment == "r" || segment == "u" || segment == "user" ||
+                           segment == "by_id" || segment == "duplicates") {
+                    wildcards = 1;
+                }
+            }
+        }
+        pos = slash + 1;
+    }
+    
+    return path.length() > 0 ? path : String("/");
+}
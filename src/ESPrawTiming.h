@@ -0,0 +1,141 @@
+/**
+ * ESPrawTiming.h - Per-endpoint latency statistics
+ *
+ * Every blocking request reports where its time went in
+ * ESPrawResponse::timing. Totals are also collected per endpoint, with
+ * variable path segments folded so that /r/esp32/hot and /r/arduino/hot
+ * share the histogram of /r/{}/hot:
+ *
+ *   const ESPrawLatencyHistogram* hot =
+ *       reddit.getClient().getLatencyStats().find("/r/{}/hot");
+ *   if (hot != nullptr) {
+ *       Serial.printf("p50 < %lu us, p95 < %lu us\n",
+ *                     hot->percentile(50), hot->percentile(95));
+ *   }
+ */
+
+#ifndef ESPRAW_TIMING_H
+#define ESPRAW_TIMING_H
+
+#include <Arduino.h>
+#include "ESPrawConfig.h"
+
+/**
+ * ESPrawLatencyHistogram - Rolling latency histogram of one endpoint
+ *
+ * Bucket i counts requests that took less than 2^i ms (and at least
+ * 2^(i-1) ms); the last bucket takes everything slower. Every
+ * ESPRAW_LATENCY_WINDOW samples all counts are halved, so the histogram
+ * follows the recent behaviour of the endpoint in 32 bytes.
+ */
+struct ESPrawLatencyHistogram {
+    String endpoint;                              // Normalized endpoint path
+    uint16_t buckets[ESPRAW_LATENCY_BUCKETS];     // Decayed sample counts
+    unsigned long samples;                        // Samples since the last reset
+    uint32_t lastMicros;                          // Latest sample
+
+    ESPrawLatencyHistogram();
+
+    /**
+     * Add a sample
+     * @param micros Request duration in microseconds
+     */
+    void add(uint32_t micros);
+
+    /**
+     * Get the weight of the samples currently in the histogram
+     * @return Sum of the bucket counts
+     */
+    uint32_t count() const;
+
+    /**
+     * Estimate a percentile
+     * @param percent Percentile (0-100)
+     * @return Upper bound of the bucket holding the percentile in
+     *         microseconds, or 0 if the histogram is empty
+     */
+    uint32_t percentile(uint8_t percent) const;
+
+    /**
+     * Get the bucket a duration falls into
+     * @param micros Duration in microseconds
+     * @return Bucket index
+     */
+    static uint8_t bucketFor(uint32_t micros);
+
+    /**
+     * Get the upper bound of a bucket
+     * @param bucket Bucket index
+     * @return Bound in microseconds (exclusive)
+     */
+    static uint32_t bucketLimit(uint8_t bucket);
+};
+
+/**
+ * ESPrawLatencyTracker - Histograms for a fixed number of endpoints
+ *
+ * Holds ESPRAW_LATENCY_ENDPOINTS histograms; when a new endpoint shows up
+ * and every slot is taken, the least recently used one is replaced.
+ */
+class ESPrawLatencyTracker {
+public:
+    /**
+     * Constructor
+     */
+    ESPrawLatencyTracker();
+
+    /**
+     * Record a request
+     * @param endpoint Normalized endpoint (see normalizeEndpoint())
+     * @param micros Request duration in microseconds
+     */
+    void record(const String& endpoint, uint32_t micros);
+
+    /**
+     * Find the histogram of an endpoint
+     * @param endpoint Normalized endpoint
+     * @return Histogram, or nullptr if the endpoint is not tracked
+     */
+    const ESPrawLatencyHistogram* find(const String& endpoint) const;
+
+    /**
+     * Get number of tracked endpoints
+     * @return Endpoint count
+     */
+    size_t size() const;
+
+    /**
+     * Get a tracked histogram
+     * @param index Index below size()
+     * @return Histogram
+     */
+    const ESPrawLatencyHistogram& at(size_t index) const;
+
+    /**
+     * Forget all endpoints
+     */
+    void reset();
+
+    /**
+     * Reduce a request URL to the endpoint it is tracked under
+     *
+     * Drops the base URL and the query string and replaces names and ids
+     * with "{}": the segment after r, u, user, by_id and duplicates, and
+     * the id and title slug after comments. So
+     * "https://oauth.reddit.com/r/esp32/comments/abc/title?limit=5"
+     * becomes "/r/{}/comments/{}/{}".
+     *
+     * @param url Full request URL
+     * @param baseUrl API base URL the request was built from
+     * @return Endpoint path
+     */
+    static String normalizeEndpoint(const String& url, const String& baseUrl);
+
+private:
+    ESPrawLatencyHistogram _slots[ESPRAW_LATENCY_ENDPOINTS];
+    unsigned long _lastUse[ESPRAW_LATENCY_ENDPOINTS];
+    size_t _used;
+    unsigned long _clock;   // Incremented per record(), orders _lastUse
+};
+
+#endif // ESPRAW_TIMING_H
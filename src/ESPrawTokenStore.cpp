@@ -0,0 +1,158 @@
+/**
+ * ESPrawTokenStore.cpp - Persistent token storage implementation
+ */
+
+#include "ESPrawTokenStore.h"
+#include "ESPrawUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef ESP32
+#include <Preferences.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+ESPrawStoredToken ESPrawStoredToken::capture(const ESPrawToken& token, const String& owner, uint64_t now) {
+    ESPrawStoredToken stored;
+    stored.owner = owner;
+    stored.accessToken = token.accessToken;
+    stored.tokenType = token.tokenType;
+    stored.scope = token.scope;
+    stored.expiresAt = now + token.remainingValidity();
+    return stored;
+}
+
+ESPrawToken ESPrawStoredToken::restore(uint64_t now) const {
+    ESPrawToken token;
+    if (accessToken.isEmpty() || now >= expiresAt) {
+        return token;
+    }
+    
+    token.accessToken = accessToken;
+    token.tokenType = tokenType;
+    token.scope = scope;
+    token.expiresAt = millis() / 1000 + (unsigned long)(expiresAt - now);
+    token.isValid = true;
+    return token;
+}
+
+uint64_t ESPrawStoredToken::wallClock() {
+    time_t now = time(nullptr);
+    if (now < 0 || (uint64_t)now < ESPRAW_MIN_WALL_CLOCK) {
+        return 0;
+    }
+    return (uint64_t)now;
+}
+
+// File layout: owner, access token, token type, scope and expiry, one per line
+
+ESPrawFileTokenStore::ESPrawFileTokenStore(const String& path) : _path(path) {
+}
+
+bool ESPrawFileTokenStore::load(ESPrawStoredToken& token) {
+    FILE* file = fopen(_path.c_str(), "r");
+    if (file == nullptr) {
+        return false;
+    }
+    
+    String expiresAt;
+    bool complete = ESPrawUtil::readLine(file, token.owner) && ESPrawUtil::readLine(file, token.accessToken) &&
+                    ESPrawUtil::readLine(file, token.tokenType) && ESPrawUtil::readLine(file, token.scope) &&
+                    ESPrawUtil::readLine(file, expiresAt);
+    fclose(file);
+    
+    if (!complete) {
+        return false;
+    }
+    
+    token.expiresAt = strtoull(expiresAt.c_str(), nullptr, 10);
+    return true;
+}
+
+bool ESPrawFileTokenStore::save(const ESPrawStoredToken& token) {
+#ifdef ESP32
+    FILE* file = fopen(_path.c_str(), "w");
+#else
+    // The token is a bearer credential: keep it readable by the owner only,
+    // including when an older, more open file is overwritten
+    int fd = open(_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        return false;
+    }
+    if (fchmod(fd, S_IRUSR | S_IWUSR) != 0) {
+        close(fd);
+        return false;
+    }
+    FILE* file = fdopen(fd, "w");
+    if (file == nullptr) {
+        close(fd);
+    }
+#endif
+    if (file == nullptr) {
+        return false;
+    }
+    
+    int written = fprintf(file, "%s\n%s\n%s\n%s\n%llu\n", token.owner.c_str(),
+                          token.accessToken.c_str(), token.tokenType.c_str(),
+                          token.scope.c_str(), (unsigned long long)token.expiresAt);
+    bool closed = fclose(file) == 0;
+    return written > 0 && closed;
+}
+
+void ESPrawFileTokenStore::clear() {
+    remove(_path.c_str());
+}
+
+#ifdef ESP32
+ESPrawPreferencesTokenStore::ESPrawPreferencesTokenStore(const char* name) : _name(name) {
+}
+
+bool ESPrawPreferencesTokenStore::load(ESPrawStoredToken& token) {
+    Preferences prefs;
+    if (!prefs.begin(_name, true)) {
+        return false;
+    }
+    
+    bool saved = prefs.isKey("access");
+    if (saved) {
+        token.owner = prefs.getString("owner");
+        token.accessToken = prefs.getString("access");
+        token.tokenType = prefs.getString("type");
+        token.scope = prefs.getString("scope");
+        token.expiresAt = prefs.getULong64("expires");
+    }
+    
+    prefs.end();
+    return saved;
+}
+
+bool ESPrawPreferencesTokenStore::save(const ESPrawStoredToken& token) {
+    Preferences prefs;
+    if (!prefs.begin(_name, false)) {
+        return false;
+    }
+    
+    // putString() reports the length written, so only the token itself
+    // and its expiry are checked (the other fields may be empty)
+    prefs.putString("owner", token.owner);
+    prefs.putString("type", token.tokenType);
+    prefs.putString("scope", token.scope);
+    bool saved = prefs.putULong64("expires", token.expiresAt) > 0 &&
+                 prefs.putString("access", token.accessToken) > 0;
+    
+    prefs.end();
+    return saved;
+}
+
+void ESPrawPreferencesTokenStore::clear() {
+    Preferences prefs;
+    if (prefs.begin(_name, false)) {
+        prefs.clear();
+        prefs.end();
+    }
+}
+#endif
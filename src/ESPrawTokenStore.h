@@ -0,0 +1,133 @@
+/**
+ * ESPrawTokenStore.h - Persistent storage for OAuth2 tokens
+ *
+ * ESPrawToken expiries count seconds of millis() uptime, which restart at
+ * zero on every boot. A stored token records its expiry in wall-clock time
+ * instead, so a device that reboots or wakes from deep sleep can reuse the
+ * token it already has rather than authenticating again. Wall-clock time
+ * comes from time(), so the clock must be set (configTime() on the ESP32;
+ * the RTC keeps it across deep sleep).
+ *
+ * Tokens are stored unencrypted. Anyone who can read the NVS partition or
+ * the file can use the token until it expires; on the ESP32, enable NVS
+ * and flash encryption if the device may fall into other hands.
+ *
+ * Usage:
+ *   ESPrawPreferencesTokenStore store;
+ *   reddit.getAuth().setTokenStore(&store);
+ *   reddit.begin(config);  // Reuses a saved token that is still valid
+ */
+
+#ifndef ESPRAW_TOKEN_STORE_H
+#define ESPRAW_TOKEN_STORE_H
+
+#include <Arduino.h>
+#include "ESPrawConfig.h"
+
+/**
+ * A token as kept by a token store
+ */
+struct ESPrawStoredToken {
+    String owner;           // Client and account the token was issued for
+    String accessToken;
+    String tokenType;
+    String scope;
+    uint64_t expiresAt;     // Wall-clock expiry (Unix seconds)
+    
+    ESPrawStoredToken() : expiresAt(0) {}
+    
+    /**
+     * Capture a token, converting its expiry to wall-clock time
+     * @param token Token to capture
+     * @param owner Client and account the token was issued for
+     * @param now Current wall-clock time (Unix seconds)
+     * @return Stored token
+     */
+    static ESPrawStoredToken capture(const ESPrawToken& token, const String& owner, uint64_t now);
+    
+    /**
+     * Rebuild the token against the current millis() clock
+     * @param now Current wall-clock time (Unix seconds)
+     * @return Token, invalid if it has expired
+     */
+    ESPrawToken restore(uint64_t now) const;
+    
+    /**
+     * Get the current wall-clock time
+     * @return Unix seconds, or 0 if the clock isn't set
+     */
+    static uint64_t wallClock();
+};
+
+/**
+ * ESPrawTokenStore - Interface for persisting tokens
+ */
+class ESPrawTokenStore {
+public:
+    virtual ~ESPrawTokenStore() {}
+    
+    /**
+     * Load the saved token
+     * @param token Receives the token
+     * @return true if a token was saved
+     */
+    virtual bool load(ESPrawStoredToken& token) = 0;
+    
+    /**
+     * Save a token, replacing any saved one
+     * @param token Token to save
+     * @return true if successful
+     */
+    virtual bool save(const ESPrawStoredToken& token) = 0;
+    
+    /**
+     * Forget the saved token
+     */
+    virtual void clear() = 0;
+};
+
+/**
+ * ESPrawFileTokenStore - Keeps the token in a file
+ *
+ * Works wherever stdio does: the native host, or a mounted SPIFFS/LittleFS
+ * path on the ESP32. On the host the file is created with mode 0600 so
+ * only its owner can read the token.
+ */
+class ESPrawFileTokenStore : public ESPrawTokenStore {
+public:
+    /**
+     * Constructor
+     * @param path File to keep the token in
+     */
+    explicit ESPrawFileTokenStore(const String& path);
+    
+    bool load(ESPrawStoredToken& token) override;
+    bool save(const ESPrawStoredToken& token) override;
+    void clear() override;
+    
+private:
+    String _path;
+};
+
+#ifdef ESP32
+/**
+ * ESPrawPreferencesTokenStore - Keeps the token in NVS via Preferences
+ */
+class ESPrawPreferencesTokenStore : public ESPrawTokenStore {
+public:
+    /**
+     * Constructor
+     * @param name Preferences namespace (at most 15 characters)
+     */
+    explicit ESPrawPreferencesTokenStore(const char* name = "espraw");
+    
+    bool load(ESPrawStoredToken& token) override;
+    bool save(const ESPrawStoredToken& token) override;
+    void clear() override;
+    
+private:
+    const char* _name;
+};
+#endif
+
+#endif // ESPRAW_TOKEN_STORE_H
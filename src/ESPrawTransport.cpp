@@ -0,0 +1,336 @@
+/**
+ * ESPrawTransport.cpp - HTTP transport implementations
+ */
+
+#include "ESPrawTransport.h"
+
+bool ESPrawUrl::parse(const String& url, ESPrawUrl& parsed) {
+    int hostStart;
+    if (url.startsWith("https://")) {
+        parsed.secure = true;
+        parsed.port = 443;
+        hostStart = 8;
+    } else if (url.startsWith("http://")) {
+        parsed.secure = false;
+        parsed.port = 80;
+        hostStart = 7;
+    } else {
+        return false;
+    }
+
+    int pathStart = url.indexOf('/', hostStart);
+    String hostPort = pathStart < 0 ? url.substring(hostStart) : url.substring(hostStart, pathStart);
+    parsed.path = pathStart < 0 ? String() : url.substring(pathStart);
+    if (parsed.path.endsWith("/")) {
+        parsed.path = parsed.path.substring(0, parsed.path.length() - 1);
+    }
+
+    int colon = hostPort.indexOf(':');
+    if (colon >= 0) {
+        long port = hostPort.substring(colon + 1).toInt();
+        if (port <= 0 || port > 65535) {
+            return false;
+        }
+        parsed.port = (uint16_t)port;
+        hostPort = hostPort.substring(0, colon);
+    }
+
+    parsed.host = hostPort;
+    return parsed.host.length() > 0;
+}
+
+// Response headers ESPraw reads; HTTPClient only keeps the ones it is asked for
+static const char* collectedHeaders[] = {
+    "Transfer-Encoding", "Retry-After", "ETag", "Last-Modified",
+    "X-Ratelimit-Used", "X-Ratelimit-Remaining", "X-Ratelimit-Reset"
+};
+
+ESPrawHttpTransport::ESPrawHttpTransport()
+    : _client(nullptr), _keepAlive(ESPRAW_KEEP_ALIVE), _timeout(ESPRAW_REQUEST_TIMEOUT),
+      _dnsTime(0), _connectTime(0) {
+    // SECURITY WARNING: Certificate validation is currently disabled
+    // This is a known security issue and should be addressed before production use
+    // TODO: Implement proper certificate validation
+    // For production, consider:
+    // 1. Loading Reddit's root CA certificate
+    // 2. Using certificate fingerprint validation
+    // 3. Implementing certificate bundle validation
+    _secureClient.setInsecure();
+}
+
+void ESPrawHttpTransport::setKeepAlive(bool keepAlive) {
+    _keepAlive = keepAlive;
+}
+
+void ESPrawHttpTransport::setTimeout(unsigned long timeout) {
+    _timeout = timeout;
+}
+
+int ESPrawHttpTransport::send(ESPrawRequestMethod method, const String& url, const String& headers,
+                              const String& body) {
+    WiFiClient* client = url.startsWith("https://") ? static_cast<WiFiClient*>(&_secureClient)
+                                                    : &_plainClient;
+    if (_client != nullptr && _client != client) {
+        _client->stop();
+    }
+    _client = client;
+    
+    // HTTPClient reuses a connection that is already open, so opening it
+    // here separates connection setup from the request itself
+    _dnsTime = 0;
+    _connectTime = 0;
+    if (!_client->connected()) {
+        ESPrawUrl parsed;
+        if (!ESPrawUrl::parse(url, parsed)) {
+            return 0;
+        }
+        if (!connect(parsed)) {
+            return HTTPC_ERROR_CONNECTION_REFUSED;
+        }
+    }
+
+    // With reuse enabled, end() leaves the socket open when the server
+    // agreed to keep-alive and the body was fully read
+    _http.setReuse(_keepAlive);
+    _http.setTimeout(_timeout);
+
+    if (!_http.begin(*_client, url)) {
+        return 0;
+    }
+
+    // HTTPClient takes headers one at a time
+    int lineStart = 0;
+    while (lineStart < (int)headers.length()) {
+        int lineEnd = headers.indexOf("\r\n", lineStart);
+        if (lineEnd < 0) {
+            lineEnd = headers.length();
+        }
+        int colon = headers.indexOf(':', lineStart);
+        if (colon > lineStart && colon < lineEnd) {
+            int valueStart = colon + 1;
+            while (valueStart < lineEnd && headers[valueStart] == ' ') {
+                valueStart++;
+            }
+            _http.addHeader(headers.substring(lineStart, colon), headers.substring(valueStart, lineEnd));
+        }
+        lineStart = lineEnd + 2;
+    }
+
+    _http.collectHeaders(collectedHeaders, sizeof(collectedHeaders) / sizeof(collectedHeaders[0]));
+
+    int httpCode = HTTPC_ERROR_NOT_CONNECTED;
+    switch (method) {
+        case ESPrawRequestMethod::GET:
+            httpCode = _http.GET();
+            break;
+        case ESPrawRequestMethod::POST:
+            httpCode = _http.POST(body);
+            break;
+        case ESPrawRequestMethod::PUT:
+            httpCode = _http.PUT(body);
+            break;
+        case ESPrawRequestMethod::PATCH:
+            httpCode = _http.sendRequest("PATCH", body);
+            break;
+        case ESPrawRequestMethod::DELETE_METHOD:
+            httpCode = _http.sendRequest("DELETE");
+            break;
+    }
+
+    return httpCode;
+}
+
+String ESPrawHttpTransport::header(const char* name) {
+    return _http.header(name);
+}
+
+Stream& ESPrawHttpTransport::getStream() {
+    return _http.getStream();
+}
+
+long ESPrawHttpTransport::getSize() {
+    return _http.getSize();
+}
+
+String ESPrawHttpTransport::getString() {
+    return _http.getString();
+}
+
+void ESPrawHttpTransport::end() {
+    _http.end();
+}
+
+bool ESPrawHttpTransport::connected() {
+    return _client != nullptr && _client->connected();
+}
+
+void ESPrawHttpTransport::stop() {
+    _secureClient.stop();
+    _plainClient.stop();
+}
+
+String ESPrawHttpTransport::errorToString(int error) {
+    return _http.errorToString(error);
+}
+
+void ESPrawHttpTransport::addTiming(ESPrawTiming& timing) {
+    timing.dns += _dnsTime;
+    timing.connect += _connectTime;
+}
+
+bool ESPrawHttpTransport::connect(const ESPrawUrl& url) {
+    // The lookup is repeated by connect(), which needs the host name for
+    // TLS SNI, but is then answered from the DNS cache
+    unsigned long start = micros();
+    IPAddress address;
+    WiFi.hostByName(url.host.c_str(), address);
+    unsigned long resolved = micros();
+    _dnsTime = resolved - start;
+    
+    _client->stop();
+    bool connected = _client->connect(url.host.c_str(), url.port);
+    _connectTime = micros() - resolved;
+    return connected;
+}
+
+size_t ESPrawReplayTransport::BodyStream::readBytes(char* buffer, size_t length) {
+    size_t count = available();
+    if (count > length) {
+        count = length;
+    }
+    memcpy(buffer, _body->c_str() + _pos, count);
+    _pos += count;
+    return count;
+}
+
+ESPrawReplayTransport::ESPrawReplayTransport()
+    : _current(nullptr), _requestCount(0), _open(false) {
+}
+
+void ESPrawReplayTransport::addResponse(const String& path, int status, const String& body,
+                                        const String& headers) {
+    Recorded recorded;
+    recorded.path = path;
+    recorded.status = status;
+    recorded.body = body;
+    recorded.headers = headers;
+    _recorded.push_back(std::move(recorded));
+}
+
+void ESPrawReplayTransport::clear() {
+    _recorded.clear();
+    _current = nullptr;
+    _body.reset(nullptr);
+    _lastRequest = "";
+    _requestCount = 0;
+}
+
+unsigned long ESPrawReplayTransport::getRequestCount() const {
+    return _requestCount;
+}
+
+const String& ESPrawReplayTransport::getLastRequest() const {
+    return _lastRequest;
+}
+
+void ESPrawReplayTransport::setKeepAlive(bool keepAlive) {
+    (void)keepAlive;
+}
+
+void ESPrawReplayTransport::setTimeout(unsigned long timeout) {
+    (void)timeout;
+}
+
+int ESPrawReplayTransport::send(ESPrawRequestMethod method, const String& url, const String& headers,
+                                const String& body) {
+    (void)headers;
+    (void)body;
+
+    // Strip scheme and host
+    int hostStart = url.indexOf("://");
+    int pathStart = hostStart < 0 ? 0 : url.indexOf('/', hostStart + 3);
+    String path = pathStart < 0 ? String("/") : url.substring(pathStart);
+
+    static const char* methodNames[] = { "GET", "POST", "PUT", "PATCH", "DELETE" };
+    _lastRequest = String(methodNames[(int)method]) + " " + path;
+    _requestCount++;
+    _open = true;
+
+    _current = nullptr;
+    for (size_t i = 0; i < _recorded.size(); i++) {
+        if (path.startsWith(_recorded[i].path)) {
+            _current = &_recorded[i];
+            break;
+        }
+    }
+
+    if (_current == nullptr) {
+        _body.reset(nullptr);
+        return 404;
+    }
+
+    _body.reset(&_current->body);
+    return _current->status;
+}
+
+String ESPrawReplayTransport::header(const char* name) {
+    if (_current == nullptr) {
+        return String();
+    }
+
+    // Find "name:" at the start of a header line
+    const String& headers = _current->headers;
+    String key = String(name) + ":";
+    int lineStart = 0;
+    while (lineStart < (int)headers.length()) {
+        int lineEnd = headers.indexOf("\r\n", lineStart);
+        if (lineEnd < 0) {
+            lineEnd = headers.length();
+        }
+        if (headers.substring(lineStart, lineStart + key.length()).equalsIgnoreCase(key)) {
+            String value = headers.substring(lineStart + key.length(), lineEnd);
+            value.trim();
+            return value;
+        }
+        lineStart = lineEnd + 2;
+    }
+    return String();
+}
+
+Stream& ESPrawReplayTransport::getStream() {
+    return _body;
+}
+
+long ESPrawReplayTransport::getSize() {
+    return _current != nullptr ? (long)_current->body.length() : 0;
+}
+
+String ESPrawReplayTransport::getString() {
+    String rest;
+    int available = _body.available();
+    if (available > 0) {
+        rest.reserve(available);
+        char buffer[256];
+        size_t n;
+        while ((n = _body.readBytes(buffer, sizeof(buffer))) > 0) {
+            rest.concat(buffer, n);
+        }
+    }
+    return rest;
+}
+
+void ESPrawReplayTransport::end() {
+    _body.reset(nullptr);
+}
+
+bool ESPrawReplayTransport::connected() {
+    return _open;
+}
+
+void ESPrawReplayTransport::stop() {
+    _open = false;
+}
+
+String ESPrawReplayTransport::errorToString(int error) {
+    return "Replay error " + String(error);
+}
@@ -0,0 +1,272 @@
+/**
+ * ESPrawTransport.h - Pluggable HTTP transport for ESPraw
+ *
+ * ESPrawClient sends blocking requests through an ESPrawTransport. The
+ * default, ESPrawHttpTransport, is the ESP32 HTTPClient over WiFiClient
+ * (http://) or WiFiClientSecure (https://); in the host build the same
+ * code runs over the POSIX-socket clients from test/hal.
+ * ESPrawReplayTransport answers from recorded responses without any
+ * network, which isolates the library's own overhead in benchmarks.
+ *
+ * Usage:
+ *   ESPrawReplayTransport replay;
+ *   replay.addResponse("/r/esp32/hot", 200, recordedListing);
+ *   reddit.getClient().setTransport(&replay);
+ */
+
+#ifndef ESPRAW_TRANSPORT_H
+#define ESPRAW_TRANSPORT_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+#include <vector>
+#include "ESPrawConfig.h"
+
+/**
+ * Parsed base URL: scheme, host, port and optional path prefix
+ */
+struct ESPrawUrl {
+    bool secure;
+    String host;
+    uint16_t port;
+    String path;    // Path prefix without a trailing slash (usually empty)
+
+    ESPrawUrl() : secure(true), port(443) {}
+
+    /**
+     * Parse an http:// or https:// base URL
+     * @param url URL to parse
+     * @param parsed Receives the parts
+     * @return false if the URL is not a valid http(s) URL
+     */
+    static bool parse(const String& url, ESPrawUrl& parsed);
+};
+
+/**
+ * ESPrawTransport - Interface for sending blocking HTTP requests
+ *
+ * One request at a time: send(), then read the body with getStream() or
+ * getString(), then end(). header() must at least answer for
+ * Transfer-Encoding, Retry-After and the X-Ratelimit-* headers.
+ */
+class ESPrawTransport {
+public:
+    virtual ~ESPrawTransport() {}
+
+    /**
+     * Keep the connection open between requests
+     * @param keepAlive true to reuse the connection
+     */
+    virtual void setKeepAlive(bool keepAlive) = 0;
+
+    /**
+     * Set how long to wait for the response
+     * @param timeout Timeout in milliseconds
+     */
+    virtual void setTimeout(unsigned long timeout) = 0;
+
+    /**
+     * Send a request and read the response status and headers
+     * @param method HTTP method
+     * @param url Full URL
+     * @param headers Request header lines, each ending in CRLF
+     * @param body Request body (optional)
+     * @return HTTP status code, a negative transport error, or 0 if the
+     *         request could not be started
+     */
+    virtual int send(ESPrawRequestMethod method, const String& url, const String& headers,
+                     const String& body) = 0;
+
+    /**
+     * Get a response header
+     * @param name Header name (case-insensitive)
+     * @return Header value, or empty if absent
+     */
+    virtual String header(const char* name) = 0;
+
+    /**
+     * Get the response body as it arrives, still chunk-framed when the
+     * response uses chunked transfer encoding
+     * @return Body stream
+     */
+    virtual Stream& getStream() = 0;
+
+    /**
+     * Get the response body length
+     * @return Content-Length, or -1 if unknown
+     */
+    virtual long getSize() = 0;
+
+    /**
+     * Read the whole response body
+     * @return Decoded body
+     */
+    virtual String getString() = 0;
+
+    /**
+     * Finish the response, keeping the connection open if it can be reused
+     */
+    virtual void end() = 0;
+
+    /**
+     * Check if the connection is open
+     * @return true if the next request can reuse it
+     */
+    virtual bool connected() = 0;
+
+    /**
+     * Close the connection
+     */
+    virtual void stop() = 0;
+
+    /**
+     * Describe a negative error code returned by send()
+     * @param error Error code
+     * @return Error description
+     */
+    virtual String errorToString(int error) = 0;
+    
+    /**
+     * Add the connection setup of the last send() to a timing breakdown
+     * 
+     * Transports that can't tell leave it alone; the caller counts the
+     * whole of send() as time to first byte.
+     * 
+     * @param timing Timing to add dns and connect time to
+     */
+    virtual void addTiming(ESPrawTiming& timing) { (void)timing; }
+};
+
+/**
+ * ESPrawHttpTransport - HTTPClient over WiFiClient / WiFiClientSecure
+ */
+class ESPrawHttpTransport : public ESPrawTransport {
+public:
+    /**
+     * Constructor
+     */
+    ESPrawHttpTransport();
+
+    void setKeepAlive(bool keepAlive) override;
+    void setTimeout(unsigned long timeout) override;
+    int send(ESPrawRequestMethod method, const String& url, const String& headers,
+             const String& body) override;
+    String header(const char* name) override;
+    Stream& getStream() override;
+    long getSize() override;
+    String getString() override;
+    void end() override;
+    bool connected() override;
+    void stop() override;
+    String errorToString(int error) override;
+    void addTiming(ESPrawTiming& timing) override;
+
+private:
+    /**
+     * Open a new connection, timing name resolution and connect
+     * @param url Request URL
+     * @return false if the connection failed
+     */
+    bool connect(const ESPrawUrl& url);
+    
+    WiFiClientSecure _secureClient;
+    WiFiClient _plainClient;
+    WiFiClient* _client;   // Connection of the current request
+    HTTPClient _http;
+    bool _keepAlive;
+    unsigned long _timeout;
+    uint32_t _dnsTime;     // Connection setup of the last send() (us)
+    uint32_t _connectTime;
+};
+
+/**
+ * ESPrawReplayTransport - Answers requests from recorded responses
+ *
+ * Each request gets the first recorded response whose path is a prefix
+ * of the request path (the URL without scheme and host), or 404. Bodies
+ * are served exactly as recorded, with a Content-Length.
+ */
+class ESPrawReplayTransport : public ESPrawTransport {
+public:
+    /**
+     * Constructor
+     */
+    ESPrawReplayTransport();
+
+    /**
+     * Record a response
+     * @param path Request path prefix to answer, e.g. "/r/esp32/hot"
+     * @param status HTTP status code
+     * @param body Response body
+     * @param headers Response header lines, each ending in CRLF (optional)
+     */
+    void addResponse(const String& path, int status, const String& body,
+                     const String& headers = "");
+
+    /**
+     * Forget all recorded responses and counters
+     */
+    void clear();
+
+    /**
+     * Get the number of requests answered
+     * @return Requests since construction or clear()
+     */
+    unsigned long getRequestCount() const;
+
+    /**
+     * Get the request line of the last request, e.g. "GET /r/esp32/hot"
+     * @return Method and path
+     */
+    const String& getLastRequest() const;
+
+    void setKeepAlive(bool keepAlive) override;
+    void setTimeout(unsigned long timeout) override;
+    int send(ESPrawRequestMethod method, const String& url, const String& headers,
+             const String& body) override;
+    String header(const char* name) override;
+    Stream& getStream() override;
+    long getSize() override;
+    String getString() override;
+    void end() override;
+    bool connected() override;
+    void stop() override;
+    String errorToString(int error) override;
+
+private:
+    struct Recorded {
+        String path;
+        int status;
+        String body;
+        String headers;
+    };
+
+    /**
+     * Stream over the body of the current response
+     */
+    class BodyStream : public Stream {
+    public:
+        BodyStream() : _body(nullptr), _pos(0) {}
+        void reset(const String* body) { _body = body; _pos = 0; }
+        int available() override { return _body ? (int)(_body->length() - _pos) : 0; }
+        int read() override { return available() > 0 ? (uint8_t)(*_body)[_pos++] : -1; }
+        int peek() override { return available() > 0 ? (uint8_t)(*_body)[_pos] : -1; }
+        size_t readBytes(char* buffer, size_t length) override;
+        size_t write(uint8_t) override { return 0; }
+
+    private:
+        const String* _body;
+        unsigned int _pos;
+    };
+
+    std::vector<Recorded> _recorded;
+    const Recorded* _current;
+    BodyStream _body;
+    String _lastRequest;
+    unsigned long _requestCount;
+    bool _open;
+};
+
+#endif // ESPRAW_TRANSPORT_H
@@ -0,0 +1,119 @@
+/**
+ * ESPrawUtil.h - Small helpers shared by the library's sources
+ *
+ * Internal: not part of the API, and free to change between releases.
+ */
+
+#ifndef ESPRAW_UTIL_H
+#define ESPRAW_UTIL_H
+
+#include <Arduino.h>
+#include <stdio.h>
+
+/**
+ * ESPrawUtil - Helpers used by more than one source file
+ */
+struct ESPrawUtil {
+    /**
+     * FNV-1a hash of a block of bytes
+     * @param data Bytes to hash
+     * @param length Number of bytes
+     * @param hash Hash to continue from, for hashing several blocks as one
+     * @return Hash
+     */
+    static uint32_t fnv1a(const char* data, size_t length, uint32_t hash = 2166136261UL) {
+        for (size_t i = 0; i < length; i++) {
+            hash = (hash ^ (uint8_t)data[i]) * 16777619UL;
+        }
+        return hash;
+    }
+
+    /**
+     * FNV-1a hash of a string
+     * @param data String to hash
+     * @param hash Hash to continue from, for hashing several strings as one
+     * @return Hash
+     */
+    static uint32_t fnv1a(const String& data, uint32_t hash = 2166136261UL) {
+        return fnv1a(data.c_str(), data.length(), hash);
+    }
+
+    /**
+     * Skip whitespace and return the next character without consuming it
+     * @param body Stream to read from
+     * @return Next character, or -1 at end of stream
+     */
+    static int peekToken(Stream& body) {
+        int c;
+        while ((c = body.peek()) >= 0 && isspace(c)) {
+            body.read();
+        }
+        return c;
+    }
+
+    /**
+     * Read a JSON string whose opening quote was consumed, keeping escaped
+     * characters as they are
+     * @param body Stream to read from
+     * @param buffer Receives as much of the string as fits, null terminated
+     * @param size Size of buffer
+     * @return Number of characters stored
+     */
+    static size_t readString(Stream& body, char* buffer, size_t size) {
+        size_t length = 0;
+        int c;
+        while ((c = body.read()) >= 0 && c != '"') {
+            if (c == '\\') {
+                c = body.read();
+            }
+            if (length < size - 1) {
+                buffer[length++] = (char)c;
+            }
+        }
+        buffer[length] = '\0';
+        return length;
+    }
+
+    /**
+     * Read a JSON string whose opening quote was consumed, keeping escaped
+     * characters as they are
+     * @param body Stream to read from
+     * @param maxLength Number of characters to keep; the rest is skipped
+     * @return String read
+     */
+    static String readString(Stream& body, size_t maxLength) {
+        String value;
+        int c;
+        while ((c = body.read()) >= 0 && c != '"') {
+            if (c == '\\') {
+                c = body.read();
+            }
+            if (value.length() < maxLength) {
+                value += (char)c;
+            }
+        }
+        return value;
+    }
+
+    /**
+     * Read one line of a file without its newline
+     * @param file File to read from
+     * @param line Receives the line
+     * @return false at end of file
+     */
+    static bool readLine(FILE* file, String& line) {
+        line = "";
+        int c = fgetc(file);
+        if (c == EOF) {
+            return false;
+        }
+
+        while (c != EOF && c != '\n') {
+            line += (char)c;
+            c = fgetc(file);
+        }
+        return true;
+    }
+};
+
+#endif // ESPRAW_UTIL_H
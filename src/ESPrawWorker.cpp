@@ -0,0 +1,192 @@
+/**
+ * ESPrawWorker.cpp - Background worker task implementation
+ */
+
+#include "ESPrawWorker.h"
+
+ESPrawWorker::ESPrawWorker(const ESPrawWorkerExecutor& executor)
+    : _executor(executor), _freeCount(ESPRAW_WORKER_QUEUE_SIZE), _nextId(0), _running(false)
+#ifdef ESP32
+    , _task(nullptr), _taskExited(true)
+#else
+    , _woken(false)
+#endif
+{
+    for (int i = 0; i < ESPRAW_WORKER_QUEUE_SIZE; i++) {
+        _freeSlots[i] = ESPRAW_WORKER_QUEUE_SIZE - 1 - i;
+    }
+}
+
+ESPrawWorker::~ESPrawWorker() {
+    stop();
+}
+
+bool ESPrawWorker::begin(int core, uint32_t stackSize, int priority) {
+    if (_running) {
+        return true;
+    }
+
+    _running = true;
+
+#ifdef ESP32
+    _taskExited = false;
+    BaseType_t created = xTaskCreatePinnedToCore(taskEntry, "espraw", stackSize, this,
+                                                 priority, &_task, core);
+    if (created != pdPASS) {
+        _running = false;
+        _taskExited = true;
+        _task = nullptr;
+        return false;
+    }
+#else
+    (void)core;
+    (void)stackSize;
+    (void)priority;
+    _thread = std::thread(taskEntry, this);
+#endif
+
+    return true;
+}
+
+void ESPrawWorker::stop() {
+    if (!_running) {
+        return;
+    }
+
+    _running = false;
+    wake();
+
+#ifdef ESP32
+    while (!_taskExited) {
+        delay(1);
+    }
+    _task = nullptr;
+#else
+    _thread.join();
+#endif
+
+    // The worker is gone, so this task may consume its queue
+    uint8_t index;
+    while (_requests.pop(index)) {
+        _jobs[index] = ESPrawWorkerJob();
+        _freeSlots[_freeCount++] = index;
+    }
+}
+
+bool ESPrawWorker::isRunning() const {
+    return _running;
+}
+
+uint32_t ESPrawWorker::get(const String& endpoint, const String& params,
+                           const ESPrawWorkerCallback& callback, const ESPrawBodyHandler& handler) {
+    return submit(ESPrawRequestMethod::GET, endpoint, params, callback, handler);
+}
+
+uint32_t ESPrawWorker::post(const String& endpoint, const String& body,
+                            const ESPrawWorkerCallback& callback) {
+    return submit(ESPrawRequestMethod::POST, endpoint, body, callback);
+}
+
+uint32_t ESPrawWorker::submit(ESPrawRequestMethod method, const String& endpoint, const String& params,
+                              const ESPrawWorkerCallback& callback, const ESPrawBodyHandler& handler) {
+    if (!_running || _freeCount == 0) {
+        return 0;
+    }
+
+    if (++_nextId == 0) {
+        ++_nextId;
+    }
+
+    uint8_t index = _freeSlots[--_freeCount];
+    ESPrawWorkerJob& job = _jobs[index];
+    job.id = _nextId;
+    job.method = method;
+    job.endpoint = endpoint;
+    job.params = params;
+    job.handler = handler;
+    job.callback = callback;
+    job.response = ESPrawResponse();
+
+    // Every slot is either free or in one of the rings, so this never fails
+    _requests.push(index);
+    wake();
+
+    return job.id;
+}
+
+int ESPrawWorker::poll() {
+    int delivered = 0;
+    uint8_t index;
+
+    while (_results.pop(index)) {
+        ESPrawWorkerJob& job = _jobs[index];
+        uint32_t id = job.id;
+        ESPrawWorkerCallback callback = std::move(job.callback);
+        ESPrawResponse response = std::move(job.response);
+
+        // Free the slot before the callback so it can submit a follow-up
+        job = ESPrawWorkerJob();
+        _freeSlots[_freeCount++] = index;
+
+        if (callback) {
+            callback(id, response);
+        }
+        delivered++;
+    }
+
+    return delivered;
+}
+
+int ESPrawWorker::pending() const {
+    return ESPRAW_WORKER_QUEUE_SIZE - _freeCount;
+}
+
+void ESPrawWorker::taskEntry(void* arg) {
+    ESPrawWorker* worker = static_cast<ESPrawWorker*>(arg);
+    worker->run();
+
+#ifdef ESP32
+    worker->_taskExited = true;
+    vTaskDelete(nullptr);
+#endif
+}
+
+void ESPrawWorker::run() {
+    while (_running) {
+        uint8_t index;
+        if (!_requests.pop(index)) {
+            waitForWork();
+            continue;
+        }
+
+        ESPrawWorkerJob& job = _jobs[index];
+        _executor(job);
+
+        // Jobs never outnumber ring slots, so the result always fits
+        _results.push(index);
+    }
+}
+
+void ESPrawWorker::wake() {
+#ifdef ESP32
+    if (_task != nullptr) {
+        xTaskNotifyGive(_task);
+    }
+#else
+    {
+        std::lock_guard<std::mutex> lock(_wakeMutex);
+        _woken = true;
+    }
+    _wakeCondition.notify_one();
+#endif
+}
+
+void ESPrawWorker::waitForWork() {
+#ifdef ESP32
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+#else
+    std::unique_lock<std::mutex> lock(_wakeMutex);
+    _wakeCondition.wait(lock, [this]() { return _woken; });
+    _woken = false;
+#endif
+}
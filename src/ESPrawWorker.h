@@ -0,0 +1,201 @@
+/**
+ * ESPrawWorker.h - Background worker task for ESPraw requests
+ *
+ * ESPrawWorker runs requests on a dedicated task so TLS and JSON parsing
+ * don't compete with the application. On the ESP32 the task is pinned to
+ * the other core (core 0 by default; Arduino's loop() runs on core 1). On
+ * other platforms it runs on a std::thread, which lets the host tests
+ * exercise the same queueing code.
+ *
+ * Requests live in a fixed pool of job slots. Slot indices travel to the
+ * worker through one lock-free single-producer/single-consumer ring and
+ * come back through another, so submitting and collecting results never
+ * takes a lock or allocates.
+ *
+ * Usage:
+ *   ESPrawWorker worker([](ESPrawWorkerJob& job) { reddit.execute(job); });
+ *   worker.begin();
+ *   worker.get("/r/esp32/hot", "limit=5", [](uint32_t id, const ESPrawResponse& response) {
+ *       // Runs inside worker.poll(), on the caller's task
+ *   });
+ *   // in loop():
+ *   worker.poll();
+ *
+ * Once a worker is running, the ESPraw instance it executes on must only be
+ * used through the worker.
+ */
+
+#ifndef ESPRAW_WORKER_H
+#define ESPRAW_WORKER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+#include "ESPrawConfig.h"
+#include "ESPrawRing.h"
+
+#ifdef ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+/**
+ * Called on the submitting task when a job has finished
+ * @param id Job ID returned when the job was submitted
+ * @param response Response filled in by the worker
+ */
+typedef std::function<void(uint32_t id, const ESPrawResponse& response)> ESPrawWorkerCallback;
+
+/**
+ * A request handed to the worker
+ */
+struct ESPrawWorkerJob {
+    uint32_t id;
+    ESPrawRequestMethod method;
+    String endpoint;
+    String params;                  // Query parameters (GET) or request body (POST/PUT)
+    ESPrawBodyHandler handler;      // Consumes the body on the worker task (optional)
+    ESPrawWorkerCallback callback;  // Runs in poll() on the submitting task (optional)
+    ESPrawResponse response;        // Filled in by the executor
+
+    ESPrawWorkerJob() : id(0), method(ESPrawRequestMethod::GET) {}
+};
+
+/**
+ * Performs a job on the worker task, filling in job.response
+ */
+typedef std::function<void(ESPrawWorkerJob& job)> ESPrawWorkerExecutor;
+
+/**
+ * ESPrawWorker - Runs requests on a dedicated task
+ */
+class ESPrawWorker {
+public:
+    /**
+     * Constructor
+     * @param executor Performs each job on the worker task
+     */
+    explicit ESPrawWorker(const ESPrawWorkerExecutor& executor);
+
+    /**
+     * Destructor - stops the worker task
+     */
+    ~ESPrawWorker();
+
+    /**
+     * Start the worker task
+     * @param core CPU core to pin the task to (ESP32 only)
+     * @param stackSize Task stack size in bytes (ESP32 only)
+     * @param priority Task priority (ESP32 only)
+     * @return true if the task is running
+     */
+    bool begin(int core = ESPRAW_WORKER_CORE, uint32_t stackSize = ESPRAW_WORKER_STACK_SIZE,
+               int priority = ESPRAW_WORKER_PRIORITY);
+
+    /**
+     * Stop the worker task after the job in progress
+     *
+     * Jobs still queued are discarded without running their callbacks.
+     */
+    void stop();
+
+    /**
+     * Check if the worker task is running
+     * @return true between begin() and stop()
+     */
+    bool isRunning() const;
+
+    /**
+     * Queue a GET request
+     * @param endpoint API endpoint
+     * @param params Query parameters
+     * @param callback Called from poll() when the request finishes (optional)
+     * @param handler Consumes the response body on the worker task (optional)
+     * @return Job ID, or 0 if the queue is full or the worker is stopped
+     */
+    uint32_t get(const String& endpoint, const String& params = "",
+                 const ESPrawWorkerCallback& callback = nullptr,
+                 const ESPrawBodyHandler& handler = nullptr);
+
+    /**
+     * Queue a POST request
+     * @param endpoint API endpoint
+     * @param body Request body
+     * @param callback Called from poll() when the request finishes (optional)
+     * @return Job ID, or 0 if the queue is full or the worker is stopped
+     */
+    uint32_t post(const String& endpoint, const String& body,
+                  const ESPrawWorkerCallback& callback = nullptr);
+
+    /**
+     * Queue a request
+     * @param method HTTP method
+     * @param endpoint API endpoint
+     * @param params Query parameters (GET) or request body
+     * @param callback Called from poll() when the request finishes (optional)
+     * @param handler Consumes the response body on the worker task (optional)
+     * @return Job ID, or 0 if the queue is full or the worker is stopped
+     */
+    uint32_t submit(ESPrawRequestMethod method, const String& endpoint, const String& params,
+                    const ESPrawWorkerCallback& callback = nullptr,
+                    const ESPrawBodyHandler& handler = nullptr);
+
+    /**
+     * Deliver finished jobs to their callbacks; call this from loop()
+     * @return Number of jobs delivered
+     */
+    int poll();
+
+    /**
+     * Get the number of submitted jobs not yet delivered by poll()
+     * @return Pending jobs
+     */
+    int pending() const;
+
+private:
+    /**
+     * Worker task entry point
+     */
+    static void taskEntry(void* arg);
+
+    /**
+     * Worker loop: run queued jobs until stopped
+     */
+    void run();
+
+    /**
+     * Wake the worker task after queueing a job
+     */
+    void wake();
+
+    /**
+     * Sleep on the worker task until woken
+     */
+    void waitForWork();
+
+    ESPrawWorkerExecutor _executor;
+    ESPrawWorkerJob _jobs[ESPRAW_WORKER_QUEUE_SIZE];
+    uint8_t _freeSlots[ESPRAW_WORKER_QUEUE_SIZE];  // Only touched by the submitting task
+    int _freeCount;
+    uint32_t _nextId;
+
+    ESPrawSpscRing<uint8_t, ESPRAW_WORKER_QUEUE_SIZE> _requests;  // Submitting task -> worker
+    ESPrawSpscRing<uint8_t, ESPRAW_WORKER_QUEUE_SIZE> _results;   // Worker -> submitting task
+    std::atomic<bool> _running;
+
+#ifdef ESP32
+    TaskHandle_t _task;
+    std::atomic<bool> _taskExited;
+#else
+    std::thread _thread;
+    std::mutex _wakeMutex;
+    std::condition_variable _wakeCondition;
+    bool _woken;
+#endif
+};
+
+#endif // ESPRAW_WORKER_H
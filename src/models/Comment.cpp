@@ -5,12 +5,17 @@
 #include "Comment.h"
 #include "../ESPraw.h"
 
-Comment::Comment(ESPraw* espraw, JsonObject data)
-    : RedditBase(espraw, data), _score(0), _depth(0), 
+Comment::Comment(ESPraw* espraw, JsonObject data, ESPrawParseMode mode)
+    : RedditBase(espraw), _score(0), _depth(0), 
       _isSubmitter(false), _scoreHidden(false) {
-}
-
-Comment::~Comment() {
+    if (data.isNull()) {
+        return;
+    }
+    if (mode == ESPrawParseMode::LAZY) {
+        parseLazily(data);
+    } else {
+        parseData(data);
+    }
 }
 
 void Comment::parseData(JsonObject data) {
@@ -19,10 +24,10 @@ void Comment::parseData(JsonObject data) {
     
     // Parse comment-specific fields
     _body = extractString(data, "body");
-    _author = extractString(data, "author");
-    _subreddit = extractString(data, "subreddit");
+    _author = extractInterned(data, "author");
+    _subreddit = extractInterned(data, "subreddit");
     _parentId = extractString(data, "parent_id");
-    _linkId = extractString(data, "link_id");
+    _linkId = extractInterned(data, "link_id");
     _permalink = extractString(data, "permalink");
     
     _score = extractInt(data, "score");
@@ -45,66 +50,66 @@ bool Comment::clearVote() {
 }
 
 bool Comment::vote(int dir) {
-    if (!_espraw || _fullname.isEmpty()) {
+    if (!_espraw || getFullname().isEmpty()) {
         return false;
     }
     
-    String body = "id=" + _fullname + "&dir=" + String(dir);
+    String body = "id=" + getFullname() + "&dir=" + String(dir);
     ESPrawResponse response = _espraw->post("/api/vote", body);
     
     return response.success;
 }
 
 bool Comment::save() {
-    if (!_espraw || _fullname.isEmpty()) {
+    if (!_espraw || getFullname().isEmpty()) {
         return false;
     }
     
-    String body = "id=" + _fullname;
+    String body = "id=" + getFullname();
     ESPrawResponse response = _espraw->post("/api/save", body);
     
     return response.success;
 }
 
 bool Comment::unsave() {
-    if (!_espraw || _fullname.isEmpty()) {
+    if (!_espraw || getFullname().isEmpty()) {
         return false;
     }
     
-    String body = "id=" + _fullname;
+    String body = "id=" + getFullname();
     ESPrawResponse response = _espraw->post("/api/unsave", body);
     
     return response.success;
 }
 
 bool Comment::reply(const String& text) {
-    if (!_espraw || _fullname.isEmpty() || text.isEmpty()) {
+    if (!_espraw || getFullname().isEmpty() || text.isEmpty()) {
         return false;
     }
     
-    String body = "thing_id=" + _fullname + "&text=" + text;
+    String body = "thing_id=" + getFullname() + "&text=" + text;
     ESPrawResponse response = _espraw->post("/api/comment", body);
     
     return response.success;
 }
 
 bool Comment::edit(const String& text) {
-    if (!_espraw || _fullname.isEmpty() || text.isEmpty()) {
+    if (!_espraw || getFullname().isEmpty() || text.isEmpty()) {
         return false;
     }
     
-    String body = "thing_id=" + _fullname + "&text=" + text;
+    String body = "thing_id=" + getFullname() + "&text=" + text;
     ESPrawResponse response = _espraw->post("/api/editusertext", body);
     
     return response.success;
 }
 
 bool Comment::deleteComment() {
-    if (!_espraw || _fullname.isEmpty()) {
+    if (!_espraw || getFullname().isEmpty()) {
         return false;
     }
     
-    String body = "id=" + _fullname;
+    String body = "id=" + getFullname();
     ESPrawResponse response = _espraw->post("/api/del", body);
     
     return response.success;
@@ -20,13 +20,11 @@ public:
      * Constructor
      * @param espraw Pointer to ESPraw instance
      * @param data JSON data for comment
+     * @param mode EAGER copies every field now; LAZY decodes each on first
+     *             read, so data's document must outlive the object's use
+     *             (or call detach())
      */
-    Comment(ESPraw* espraw, JsonObject data);
-    
-    /**
-     * Destructor
-     */
-    ~Comment();
+    Comment(ESPraw* espraw, JsonObject data, ESPrawParseMode mode = ESPrawParseMode::EAGER);
     
     /**
      * Parse comment data from JSON
@@ -35,16 +33,16 @@ public:
     void parseData(JsonObject data) override;
     
     // Getters
-    String getBody() const { return _body; }
-    String getAuthor() const { return _author; }
-    String getSubreddit() const { return _subreddit; }
-    String getParentId() const { return _parentId; }
-    String getLinkId() const { return _linkId; }
-    String getPermalink() const { return _permalink; }
-    int getScore() const { return _score; }
-    int getDepth() const { return _depth; }
-    bool isSubmitter() const { return _isSubmitter; }
-    bool isScoreHidden() const { return _scoreHidden; }
+    const String& getBody() const { return lazyString(_body, FIELD_BODY, "body"); }
+    const String& getAuthor() const { return lazyInterned(_author, FIELD_AUTHOR, "author"); }
+    const String& getSubreddit() const { return lazyInterned(_subreddit, FIELD_SUBREDDIT, "subreddit"); }
+    const String& getParentId() const { return lazyString(_parentId, FIELD_PARENT_ID, "parent_id"); }
+    const String& getLinkId() const { return lazyInterned(_linkId, FIELD_LINK_ID, "link_id"); }
+    const String& getPermalink() const { return lazyString(_permalink, FIELD_PERMALINK, "permalink"); }
+    int getScore() const { return lazyInt(_score, FIELD_SCORE, "score"); }
+    int getDepth() const { return lazyInt(_depth, FIELD_DEPTH, "depth"); }
+    bool isSubmitter() const { return lazyBool(_isSubmitter, FIELD_IS_SUBMITTER, "is_submitter"); }
+    bool isScoreHidden() const { return lazyBool(_scoreHidden, FIELD_SCORE_HIDDEN, "score_hidden"); }
     
     /**
      * Upvote this comment
@@ -97,16 +95,30 @@ public:
     bool deleteComment();
 
 private:
-    String _body;
-    String _author;
-    String _subreddit;
-    String _parentId;
-    String _linkId;
-    String _permalink;
-    int _score;
-    int _depth;
-    bool _isSubmitter;
-    bool _scoreHidden;
+    // Field bits for lazy decoding
+    enum : uint32_t {
+        FIELD_BODY = 1u << (FIRST_FIELD + 0),
+        FIELD_AUTHOR = 1u << (FIRST_FIELD + 1),
+        FIELD_SUBREDDIT = 1u << (FIRST_FIELD + 2),
+        FIELD_PARENT_ID = 1u << (FIRST_FIELD + 3),
+        FIELD_LINK_ID = 1u << (FIRST_FIELD + 4),
+        FIELD_PERMALINK = 1u << (FIRST_FIELD + 5),
+        FIELD_SCORE = 1u << (FIRST_FIELD + 6),
+        FIELD_DEPTH = 1u << (FIRST_FIELD + 7),
+        FIELD_IS_SUBMITTER = 1u << (FIRST_FIELD + 8),
+        FIELD_SCORE_HIDDEN = 1u << (FIRST_FIELD + 9)
+    };
+    
+    mutable String _body;
+    mutable ESPrawInternedString _author;
+    mutable ESPrawInternedString _subreddit;
+    mutable String _parentId;
+    mutable ESPrawInternedString _linkId;
+    mutable String _permalink;
+    mutable int _score;
+    mutable int _depth;
+    mutable bool _isSubmitter;
+    mutable bool _scoreHidden;
     
     /**
      * Perform vote action
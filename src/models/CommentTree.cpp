@@ -0,0 +1,493 @@
+/**
+ * CommentTree.cpp - Flat comment tree implementation
+ */
+
+#include "CommentTree.h"
+#include "../ESPrawUtil.h"
+
+/**
+ * Read the four hex digits of a \u escape
+ * @return Code unit, or -1 if malformed
+ */
+static int32_t readHex4(Stream& body) {
+    int32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        int c = body.read();
+        if (c >= '0' && c <= '9') {
+            value = value * 16 + (c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            value = value * 16 + (c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            value = value * 16 + (c - 'A' + 10);
+        } else {
+            return -1;
+        }
+    }
+    return value;
+}
+
+/**
+ * Skip one value of any type, nested or not
+ * @return true if a whole value was skipped
+ */
+static bool skipValue(Stream& body) {
+    int c = ESPrawUtil::peekToken(body);
+    if (c < 0) {
+        return false;
+    }
+
+    // Numbers and literals end at the next delimiter, which is left unread
+    if (c != '"' && c != '{' && c != '[') {
+        while ((c = body.peek()) >= 0 && c != ',' && c != '}' && c != ']' && !isspace(c)) {
+            body.read();
+        }
+        return true;
+    }
+
+    int depth = 0;
+    bool inString = false;
+    while ((c = body.read()) >= 0) {
+        if (inString) {
+            if (c == '\\') {
+                body.read();
+            } else if (c == '"') {
+                inString = false;
+                if (depth == 0) {
+                    return true;
+                }
+            }
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Read a number or literal as an integer (true is 1, false and null 0)
+ */
+static long readInteger(Stream& body) {
+    char buffer[24];
+    size_t length = 0;
+    int c;
+    ESPrawUtil::peekToken(body);
+    while ((c = body.peek()) >= 0 && c != ',' && c != '}' && c != ']' && !isspace(c)) {
+        body.read();
+        if (length < sizeof(buffer) - 1) {
+            buffer[length++] = (char)c;
+        }
+    }
+    buffer[length] = '\0';
+
+    if (strcmp(buffer, "true") == 0) {
+        return 1;
+    }
+    return strtol(buffer, nullptr, 10);
+}
+
+CommentTree::CommentTree() : _maxDepth(0), _minScore(INT32_MIN), _maxBodyLength(0) {
+    clear();
+}
+
+void CommentTree::setMaxDepth(int levels) {
+    _maxDepth = levels;
+}
+
+int CommentTree::getMaxDepth() const {
+    return _maxDepth;
+}
+
+void CommentTree::setMinScore(int32_t score) {
+    _minScore = score;
+}
+
+void CommentTree::setMaxBodyLength(size_t length) {
+    _maxBodyLength = length;
+}
+
+void CommentTree::reserve(size_t nodes, size_t poolBytes) {
+    _nodes.reserve(nodes);
+    _pool.reserve(poolBytes);
+}
+
+bool CommentTree::parse(Stream& body) {
+    clear();
+
+    int c = ESPrawUtil::peekToken(body);
+    if (c == '[') {
+        // [submission listing, comment listing]
+        body.read();
+        if (!skipValue(body) || ESPrawUtil::peekToken(body) != ',') {
+            return fail("Unexpected comment page format");
+        }
+        body.read();
+    } else if (c != '{') {
+        return fail("Unexpected comment page format");
+    }
+
+    // The rest of the page is discarded by the client
+    return parseListing(body, -1, 0);
+}
+
+void CommentTree::clear() {
+    _nodes.clear();
+    _pool.clear();
+    _pool.push_back('\0');   // Offset 0 is the empty string, for missing fields
+    _interned.clear();
+    _buckets.clear();
+    _error = "";
+}
+
+size_t CommentTree::size() const {
+    return _nodes.size();
+}
+
+const CommentTreeNode& CommentTree::at(size_t index) const {
+    return _nodes[index];
+}
+
+const char* CommentTree::getString(uint32_t offset) const {
+    return &_pool[offset];
+}
+
+size_t CommentTree::skip(size_t index) const {
+    return index + _nodes[index].descendants + 1;
+}
+
+size_t CommentTree::poolSize() const {
+    return _pool.size();
+}
+
+size_t CommentTree::memoryUsed() const {
+    return _nodes.capacity() * sizeof(CommentTreeNode) + _pool.capacity() +
+           _interned.capacity() * sizeof(Interned) + _buckets.capacity() * sizeof(int32_t);
+}
+
+const String& CommentTree::getError() const {
+    return _error;
+}
+
+bool CommentTree::parseListing(Stream& body, int32_t parent, int depth) {
+    if (ESPrawUtil::peekToken(body) != '{') {
+        return fail("Unexpected listing format");
+    }
+    body.read();
+
+    char key[ESPRAW_LISTING_TOKEN_LENGTH + 1];
+    int result;
+    while ((result = nextKey(body, key, sizeof(key))) > 0) {
+        if (strcmp(key, "data") != 0) {
+            if (!skipValue(body)) {
+                return fail("Truncated listing");
+            }
+            continue;
+        }
+
+        if (ESPrawUtil::peekToken(body) != '{') {
+            return fail("Unexpected listing format");
+        }
+        body.read();
+
+        int dataResult;
+        while ((dataResult = nextKey(body, key, sizeof(key))) > 0) {
+            bool ok = strcmp(key, "children") == 0 ? parseChildren(body, parent, depth) : skipValue(body);
+            if (!ok) {
+                return fail("Truncated listing");
+            }
+        }
+        if (dataResult < 0) {
+            return false;
+        }
+    }
+
+    return result == 0;
+}
+
+bool CommentTree::parseChildren(Stream& body, int32_t parent, int depth) {
+    if (ESPrawUtil::peekToken(body) != '[') {
+        return fail("Unexpected listing format");
+    }
+    body.read();
+
+    while (true) {
+        int c = ESPrawUtil::peekToken(body);
+        if (c == ',') {
+            body.read();
+        } else if (c == ']') {
+            body.read();
+            return true;
+        } else if (c == '{') {
+            if (!parseThing(body, parent, depth)) {
+                return false;
+            }
+        } else {
+            return fail("Unexpected listing format");
+        }
+    }
+}
+
+bool CommentTree::parseThing(Stream& body, int32_t parent, int depth) {
+    body.read();
+
+    char key[ESPRAW_LISTING_TOKEN_LENGTH + 1];
+    bool isComment = false;
+    int result;
+    while ((result = nextKey(body, key, sizeof(key))) > 0) {
+        if (strcmp(key, "kind") == 0 && ESPrawUtil::peekToken(body) == '"') {
+            // Reddit sends the kind first; anything else, like "more", is skipped
+            size_t mark = _pool.size();
+            int32_t kind = appendString(body);
+            isComment = kind >= 0 && strcmp(&_pool[kind], "t1") == 0;
+            _pool.resize(mark);
+        } else if (strcmp(key, "data") == 0 && isComment) {
+            if (!parseComment(body, parent, depth)) {
+                return false;
+            }
+        } else if (!skipValue(body)) {
+            return fail("Truncated listing");
+        }
+    }
+
+    return result == 0;
+}
+
+bool CommentTree::parseComment(Stream& body, int32_t parent, int depth) {
+    if (ESPrawUtil::peekToken(body) != '{') {
+        return fail("Unexpected comment format");
+    }
+    body.read();
+
+    // The node is placed before its replies, which Reddit sends ahead of
+    // most of the comment's own fields
+    size_t index = _nodes.size();
+    size_t poolMark = _pool.size();
+    CommentTreeNode node = {};   // Missing strings stay at offset 0, ""
+    node.parent = parent;
+    node.depth = depth;
+    _nodes.push_back(node);
+
+    char key[ESPRAW_LISTING_TOKEN_LENGTH + 1];
+    bool ok = true;
+    int result;
+    while (ok && (result = nextKey(body, key, sizeof(key))) > 0) {
+        int32_t offset = -2;
+
+        if (strcmp(key, "id") == 0) {
+            offset = appendString(body);
+            if (offset >= 0) {
+                _nodes[index].id = offset;
+            }
+        } else if (strcmp(key, "author") == 0) {
+            offset = internString(body);
+            if (offset >= 0) {
+                _nodes[index].author = offset;
+            }
+        } else if (strcmp(key, "body") == 0) {
+            offset = appendString(body, _maxBodyLength);
+            if (offset >= 0) {
+                _nodes[index].body = offset;
+            }
+        } else if (strcmp(key, "score") == 0) {
+            _nodes[index].score = readInteger(body);
+        } else if (strcmp(key, "is_submitter") == 0) {
+            if (readInteger(body)) {
+                _nodes[index].flags |= ESPRAW_COMMENT_NODE_SUBMITTER;
+            }
+        } else if (strcmp(key, "score_hidden") == 0) {
+            if (readInteger(body)) {
+                _nodes[index].flags |= ESPRAW_COMMENT_NODE_SCORE_HIDDEN;
+            }
+        } else if (strcmp(key, "replies") == 0 && ESPrawUtil::peekToken(body) == '{' &&
+                   (_maxDepth <= 0 || depth + 1 < _maxDepth)) {
+            ok = parseListing(body, index, depth + 1);
+        } else if (!skipValue(body)) {
+            ok = fail("Truncated comment");
+        }
+
+        if (ok && offset == -1 && !skipValue(body)) {
+            ok = fail("Truncated comment");
+        }
+    }
+
+    // An unfinished comment is dropped with its replies
+    if (!ok || result < 0) {
+        rollback(index, poolMark);
+        return false;
+    }
+
+    if (_nodes[index].score < _minScore) {
+        rollback(index, poolMark);
+        return true;
+    }
+
+    _nodes[index].descendants = _nodes.size() - index - 1;
+    return true;
+}
+
+int CommentTree::nextKey(Stream& body, char* key, size_t size) {
+    int c = ESPrawUtil::peekToken(body);
+    if (c == ',') {
+        body.read();
+        c = ESPrawUtil::peekToken(body);
+    }
+    if (c == '}') {
+        body.read();
+        return 0;
+    }
+    if (c != '"') {
+        fail(c < 0 ? "Truncated comment page" : "Unexpected comment page format");
+        return -1;
+    }
+    body.read();
+
+    ESPrawUtil::readString(body, key, size);
+
+    if (ESPrawUtil::peekToken(body) != ':') {
+        fail("Unexpected comment page format");
+        return -1;
+    }
+    body.read();
+    return 1;
+}
+
+int32_t CommentTree::appendString(Stream& body, size_t maxLength) {
+    if (ESPrawUtil::peekToken(body) != '"') {
+        return -1;
+    }
+    body.read();
+
+    int32_t offset = _pool.size();
+    size_t length = 0;
+    bool full = false;
+    int c;
+
+    while ((c = body.read()) >= 0 && c != '"') {
+        uint32_t code = c;
+        if (c == '\\') {
+            c = body.read();
+            switch (c) {
+                case 'n': code = '\n'; break;
+                case 't': code = '\t'; break;
+                case 'r': code = '\r'; break;
+                case 'b': code = '\b'; break;
+                case 'f': code = '\f'; break;
+                case 'u': {
+                    int32_t unit = readHex4(body);
+                    if (unit >= 0xD800 && unit < 0xDC00 && body.peek() == '\\') {
+                        // Surrogate pair
+                        body.read();
+                        body.read();
+                        int32_t low = readHex4(body);
+                        unit = low >= 0xDC00 && low < 0xE000
+                            ? 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00) : 0xFFFD;
+                    }
+                    code = unit >= 0 ? unit : 0xFFFD;
+                    break;
+                }
+                default: code = c; break;   // \" \\ \/
+            }
+        }
+
+        // Encode as UTF-8, keeping whole characters only
+        char bytes[4];
+        size_t count;
+        if (code < 0x80 || c != 'u') {
+            bytes[0] = (char)code;
+            count = 1;
+        } else if (code < 0x800) {
+            bytes[0] = (char)(0xC0 | (code >> 6));
+            bytes[1] = (char)(0x80 | (code & 0x3F));
+            count = 2;
+        } else if (code < 0x10000) {
+            bytes[0] = (char)(0xE0 | (code >> 12));
+            bytes[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+            bytes[2] = (char)(0x80 | (code & 0x3F));
+            count = 3;
+        } else {
+            bytes[0] = (char)(0xF0 | (code >> 18));
+            bytes[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+            bytes[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+            bytes[3] = (char)(0x80 | (code & 0x3F));
+            count = 4;
+        }
+
+        // Raw UTF-8 arrives a byte at a time: size the whole character
+        // from its lead byte, and let continuation bytes follow their lead
+        uint8_t lead = bytes[0];
+        if (count > 1 || (lead & 0xC0) != 0x80) {
+            size_t needed = count > 1 ? count : lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+            full = full || (maxLength > 0 && length + needed > maxLength);
+        }
+        if (!full) {
+            _pool.insert(_pool.end(), bytes, bytes + count);
+            length += count;
+        }
+    }
+
+    _pool.push_back('\0');
+    return offset;
+}
+
+int32_t CommentTree::internString(Stream& body) {
+    int32_t offset = appendString(body);
+    if (offset < 0) {
+        return offset;
+    }
+
+    if (_interned.size() >= _buckets.size()) {
+        growBuckets();
+    }
+
+    size_t length = _pool.size() - offset - 1;
+    uint32_t hash = ESPrawUtil::fnv1a(&_pool[offset], length);
+    int32_t& bucket = _buckets[hash & (_buckets.size() - 1)];
+    for (int32_t i = bucket; i >= 0; i = _interned[i].next) {
+        if (_interned[i].hash == hash && strcmp(&_pool[_interned[i].offset], &_pool[offset]) == 0) {
+            _pool.resize(offset);
+            return _interned[i].offset;
+        }
+    }
+
+    Interned interned = { hash, (uint32_t)offset, bucket };
+    bucket = _interned.size();
+    _interned.push_back(interned);
+    return offset;
+}
+
+void CommentTree::growBuckets() {
+    _buckets.assign(_buckets.empty() ? 16 : _buckets.size() * 2, -1);
+
+    // Relinked oldest first, so each bucket still lists its newest string first
+    size_t mask = _buckets.size() - 1;
+    for (size_t i = 0; i < _interned.size(); i++) {
+        int32_t& bucket = _buckets[_interned[i].hash & mask];
+        _interned[i].next = bucket;
+        bucket = i;
+    }
+}
+
+void CommentTree::rollback(size_t nodes, size_t pool) {
+    _nodes.resize(nodes);
+    _pool.resize(pool);
+
+    // Interned strings from the dropped range are the newest ones, so each
+    // is still first in its bucket when unlinked newest first
+    while (!_interned.empty() && _interned.back().offset >= pool) {
+        const Interned& dropped = _interned.back();
+        _buckets[dropped.hash & (_buckets.size() - 1)] = dropped.next;
+        _interned.pop_back();
+    }
+}
+
+bool CommentTree::fail(const char* error) {
+    if (_error.isEmpty()) {
+        _error = error;
+    }
+    return false;
+}
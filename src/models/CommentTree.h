@@ -0,0 +1,254 @@
+/**
+ * CommentTree.h - Flat comment tree for submissions
+ *
+ * A comment page nests every reply inside a Listing inside its parent,
+ * which is large to hold as JSON and awkward to walk. CommentTree scans
+ * the page straight from the connection and keeps only fixed-size node
+ * records in one array, in pre-order, plus the strings they point to in a
+ * single pool. Walking the tree is a loop over the array; a node's replies
+ * are the nodes that follow it, up to its descendant count.
+ */
+
+#ifndef COMMENT_TREE_H
+#define COMMENT_TREE_H
+
+#include <Arduino.h>
+#include <vector>
+#include "../ESPrawConfig.h"
+
+#define ESPRAW_COMMENT_NODE_SUBMITTER 0x01     // Written by the submission's author
+#define ESPRAW_COMMENT_NODE_SCORE_HIDDEN 0x02  // Score not shown yet
+
+/**
+ * One comment in a CommentTree
+ *
+ * Strings are offsets into the tree's string pool; read them with
+ * CommentTree::getString().
+ */
+struct CommentTreeNode {
+    uint32_t id;              // Comment ID (without "t1_")
+    uint32_t author;          // Author name, shared between a user's comments
+    uint32_t body;            // Comment text
+    int32_t parent;           // Index of the parent comment, -1 at the top level
+    uint32_t descendants;     // Number of replies below this comment, at any depth
+    int32_t score;
+    uint16_t depth;           // 0 for top-level comments
+    uint16_t flags;           // ESPRAW_COMMENT_NODE_* bits
+};
+
+/**
+ * CommentTree - Comments of a submission in one contiguous array
+ *
+ * Example usage:
+ * ```cpp
+ * CommentTree tree;
+ * tree.setMaxDepth(3);      // Top-level comments and two levels of replies
+ * tree.setMinScore(2);      // Drop comments (and their replies) below 2 points
+ * submission->getComments(tree, 100);
+ *
+ * for (size_t i = 0; i < tree.size(); i++) {
+ *     const CommentTreeNode& node = tree.at(i);
+ *     Serial.printf("%*s%s: %s\n", node.depth * 2, "",
+ *                   tree.getString(node.author), tree.getString(node.body));
+ * }
+ * ```
+ *
+ * Pruned comments are removed as soon as their end is read, so only the
+ * kept comments and the subtree being read take up memory.
+ */
+class CommentTree {
+public:
+    /**
+     * Constructor
+     */
+    CommentTree();
+
+    /**
+     * Set the number of comment levels to keep
+     * @param levels Levels including the top level (0 = all)
+     */
+    void setMaxDepth(int levels);
+
+    /**
+     * Get the number of comment levels kept
+     * @return Levels including the top level (0 = all)
+     */
+    int getMaxDepth() const;
+
+    /**
+     * Drop comments scoring below a threshold, together with their replies
+     * @param score Lowest score kept (INT32_MIN, the default, keeps all)
+     */
+    void setMinScore(int32_t score);
+
+    /**
+     * Limit the length of the stored comment text
+     *
+     * Longer text is cut at a character boundary.
+     *
+     * @param length Maximum bytes per comment body (0 = no limit)
+     */
+    void setMaxBodyLength(size_t length);
+
+    /**
+     * Reserve memory up front, to avoid growing (and fragmenting) the heap
+     * while parsing
+     * @param nodes Number of comments
+     * @param poolBytes Bytes of string data
+     */
+    void reserve(size_t nodes, size_t poolBytes);
+
+    /**
+     * Build the tree from a comment page
+     *
+     * Accepts a full comment page ([submission listing, comment listing])
+     * or a bare comment listing. Any previous content is replaced.
+     *
+     * @param body Response body stream
+     * @return true if the page was read successfully; on failure the
+     *         top-level comments finished until then are kept
+     */
+    bool parse(Stream& body);
+
+    /**
+     * Remove all comments (the reserved memory is kept)
+     */
+    void clear();
+
+    /**
+     * Get the number of comments
+     * @return Node count
+     */
+    size_t size() const;
+
+    /**
+     * Get a comment
+     * @param index Node index (pre-order)
+     * @return Node record
+     */
+    const CommentTreeNode& at(size_t index) const;
+
+    /**
+     * Get a string referenced by a node
+     * @param offset String offset from a node
+     * @return NUL-terminated string, valid until the tree changes
+     */
+    const char* getString(uint32_t offset) const;
+
+    /**
+     * Get the index after a comment and all of its replies
+     * @param index Node index
+     * @return Index of the next sibling or following comment
+     */
+    size_t skip(size_t index) const;
+
+    /**
+     * Get the size of the string pool
+     * @return Bytes of string data
+     */
+    size_t poolSize() const;
+
+    /**
+     * Get the memory held by the tree
+     * @return Bytes allocated for nodes, strings and the intern table
+     */
+    size_t memoryUsed() const;
+
+    /**
+     * Get the error that ended the last parse
+     * @return Error message, empty if none
+     */
+    const String& getError() const;
+
+private:
+    /**
+     * An interned string: its hash, pool offset and the next string in the
+     * same bucket (-1 at the end)
+     */
+    struct Interned {
+        uint32_t hash;
+        uint32_t offset;
+        int32_t next;
+    };
+
+    /**
+     * Read a comment listing ({ kind, data: { children: [...] } })
+     * @param body Response body stream
+     * @param parent Index of the parent comment, -1 at the top level
+     * @param depth Depth of the listing's comments
+     * @return true if read successfully
+     */
+    bool parseListing(Stream& body, int32_t parent, int depth);
+
+    /**
+     * Read a listing's children array
+     * @return true if read successfully
+     */
+    bool parseChildren(Stream& body, int32_t parent, int depth);
+
+    /**
+     * Read one thing ({ kind, data }); only t1 comments are kept
+     * @return true if read successfully
+     */
+    bool parseThing(Stream& body, int32_t parent, int depth);
+
+    /**
+     * Read a comment's data object and its replies into a new node
+     * @return true if read successfully
+     */
+    bool parseComment(Stream& body, int32_t parent, int depth);
+
+    /**
+     * Read the next key of an object whose '{' was consumed
+     * @param body Response body stream
+     * @param key Buffer for the key (truncated to fit)
+     * @param size Buffer size
+     * @return 1 when a key was read, 0 at the end of the object, -1 on error
+     */
+    int nextKey(Stream& body, char* key, size_t size);
+
+    /**
+     * Read a JSON string into the pool, decoding escapes
+     * @param body Response body stream
+     * @param maxLength Maximum bytes kept (0 = no limit)
+     * @return Offset of the string, or -1 if the value isn't a string
+     */
+    int32_t appendString(Stream& body, size_t maxLength = 0);
+
+    /**
+     * Read a JSON string into the pool, reusing an identical earlier one
+     * @param body Response body stream
+     * @return Offset of the string, or -1 if the value isn't a string
+     */
+    int32_t internString(Stream& body);
+
+    /**
+     * Double the interning buckets and relink every interned string
+     */
+    void growBuckets();
+
+    /**
+     * Drop nodes and strings added since a point, e.g. a pruned subtree
+     * @param nodes Node count to go back to
+     * @param pool Pool size to go back to
+     */
+    void rollback(size_t nodes, size_t pool);
+
+    /**
+     * Set the parse error, keeping the first one
+     * @param error Error message
+     * @return false
+     */
+    bool fail(const char* error);
+
+    std::vector<CommentTreeNode> _nodes;
+    std::vector<char> _pool;
+    std::vector<Interned> _interned;
+    std::vector<int32_t> _buckets;   // First interned string of each bucket, -1 if none
+    String _error;
+    int _maxDepth;
+    int32_t _minScore;
+    size_t _maxBodyLength;
+};
+
+#endif // COMMENT_TREE_H
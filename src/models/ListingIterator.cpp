@@ -0,0 +1,317 @@
+/**
+ * ListingIterator.cpp - Streaming listing iterator implementation
+ */
+
+#include "ListingIterator.h"
+#include "Subreddit.h"
+#include "../ESPraw.h"
+#include "../ESPrawUtil.h"
+
+ListingIterator::ListingIterator(ESPraw* espraw, const String& endpoint, const String& params)
+    : _espraw(espraw), _endpoint(endpoint), _params(params), _fields(nullptr),
+      _itemCapacity(ESPRAW_LISTING_ITEM_SIZE), _limit(0), _pageSize(ESPRAW_LISTING_PAGE_SIZE),
+      _listingIndex(0), _parseMode(ESPrawParseMode::EAGER), _count(0), _visited(0), _pageItems(0),
+      _pageCount(0), _pageLimit(0), _skip(0), _done(false), _stopped(false) {
+}
+
+void ListingIterator::setLimit(int limit) {
+    _limit = limit;
+}
+
+void ListingIterator::setPageSize(int pageSize) {
+    _pageSize = pageSize;
+}
+
+void ListingIterator::setFields(const ESPrawFilter& fields) {
+    _fields = &fields;
+}
+
+void ListingIterator::setItemCapacity(size_t capacity) {
+    _itemCapacity = capacity;
+}
+
+void ListingIterator::setListingIndex(int index) {
+    _listingIndex = index;
+}
+
+void ListingIterator::setParseMode(ESPrawParseMode mode) {
+    _parseMode = mode;
+}
+
+int ListingIterator::forEachSubmission(const SubmissionCallback& callback) {
+    return iterate("t3", ESPrawFilter::submission(), [this, &callback](const char*, JsonObject data) {
+        Submission submission(_espraw, data, _parseMode);
+        return callback(submission);
+    });
+}
+
+int ListingIterator::forEachComment(const CommentCallback& callback) {
+    return iterate("t1", ESPrawFilter::comment(), [this, &callback](const char*, JsonObject data) {
+        Comment comment(_espraw, data, _parseMode);
+        return callback(comment);
+    });
+}
+
+int ListingIterator::collectSubmissions(ESPrawArena& arena, ESPrawViewList<SubmissionView>& list) {
+    int stored = 0;
+    _error = "";
+    iterate("t3", ESPrawFilter::submission(), [&](const char*, JsonObject data) {
+        SubmissionView* view = SubmissionView::create(arena, data);
+        if (view == nullptr || !list.append(view)) {
+            _error = "Arena full";
+            return false;
+        }
+        stored++;
+        return true;
+    });
+    return stored;
+}
+
+int ListingIterator::collectComments(ESPrawArena& arena, ESPrawViewList<CommentView>& list) {
+    int stored = 0;
+    _error = "";
+    iterate("t1", ESPrawFilter::comment(), [&](const char*, JsonObject data) {
+        CommentView* view = CommentView::create(arena, data);
+        if (view == nullptr || !list.append(view)) {
+            _error = "Arena full";
+            return false;
+        }
+        stored++;
+        return true;
+    });
+    return stored;
+}
+
+int ListingIterator::forEachThing(const SubmissionCallback& onSubmission, const CommentCallback& onComment,
+                                  const SubredditCallback& onSubreddit) {
+    return iterate(nullptr, ESPrawFilter::thing(), [&](const char* kind, JsonObject data) {
+        if (strcmp(kind, "t3") == 0 && onSubmission) {
+            Submission submission(_espraw, data, _parseMode);
+            return onSubmission(submission);
+        }
+        if (strcmp(kind, "t1") == 0 && onComment) {
+            Comment comment(_espraw, data, _parseMode);
+            return onComment(comment);
+        }
+        if (strcmp(kind, "t5") == 0 && onSubreddit) {
+            Subreddit subreddit(_espraw, data);
+            return onSubreddit(subreddit);
+        }
+        return true;
+    });
+}
+
+bool ListingIterator::hasMore() const {
+    return !_done;
+}
+
+const String& ListingIterator::getAfter() const {
+    return _after;
+}
+
+const String& ListingIterator::getError() const {
+    return _error;
+}
+
+void ListingIterator::reset() {
+    _after = "";
+    _error = "";
+    _count = 0;
+    _visited = 0;
+    _skip = 0;
+    _done = false;
+    _stopped = false;
+}
+
+int ListingIterator::iterate(const char* kind, const ESPrawFilter& fields, const ItemHandler& onItem) {
+    if (!_espraw) {
+        _error = "No ESPraw instance";
+        _done = true;
+        return 0;
+    }
+    
+    const ESPrawFilter& itemFields = _fields ? *_fields : fields;
+    
+    // One filter and one item document are reused for every item
+    DynamicJsonDocument filter(itemFields.capacity());
+    if (itemFields.isEnabled()) {
+        itemFields.buildThing(filter);
+    }
+    const JsonDocument* itemFilter = itemFields.isEnabled() ? &filter : nullptr;
+    DynamicJsonDocument itemDoc(_itemCapacity);
+    
+    int visitedBefore = _visited;
+    _stopped = false;
+    
+    while (!_done && !_stopped) {
+        _pageItems = 0;
+        _pageAfter = _after;
+        _pageCount = _count;
+        
+        // A page the last iteration stopped in is requested again unchanged
+        if (_skip == 0) {
+            _pageLimit = _pageSize;
+            if (_limit > 0 && _limit - _visited < _pageLimit) {
+                _pageLimit = _limit - _visited;
+            }
+        }
+        
+        ESPrawBodyHandler handler = [&](Stream& body) {
+            return readPage(body, itemDoc, itemFilter, kind, onItem);
+        };
+        
+        ESPrawResponse response = _espraw->getStream(_endpoint, handler, buildParams());
+        
+        if (!response.success) {
+            if (_error.isEmpty()) {
+                _error = response.error;
+            }
+            _done = true;
+            break;
+        }
+        
+        if (_stopped) {
+            if (!_done) {
+                // Resume from the next item: rewind to the start of this
+                // page and skip the items already read from it
+                _after = _pageAfter;
+                _count = _pageCount;
+                _skip = _pageItems;
+            }
+            break;
+        }
+        _skip = 0;
+        
+        // Stop at the end of the listing or when the cursor stops moving
+        if (_after.isEmpty() || _after == _pageAfter || _pageItems == 0 ||
+            (_limit > 0 && _visited >= _limit)) {
+            _done = true;
+        }
+    }
+    
+    return _visited - visitedBefore;
+}
+
+bool ListingIterator::readPage(Stream& body, JsonDocument& itemDoc, const JsonDocument* filter,
+                               const char* kind, const ItemHandler& onItem) {
+    // Listing data sits at depth 2 ({"data": {...}}), or at depth 3 when
+    // the response is an array of listings
+    bool rootIsArray = ESPrawUtil::peekToken(body) == '[';
+    int dataDepth = rootIsArray ? 3 : 2;
+    int listing = rootIsArray ? -1 : 0;
+    int depth = 0;
+    int c;
+    
+    _after = "";
+    
+    while ((c = body.read()) >= 0) {
+        if (c == '{' || c == '[') {
+            depth++;
+            if (rootIsArray && depth == 2 && c == '{') {
+                listing++;
+            }
+        } else if (c == '}' || c == ']') {
+            depth--;
+            if (depth == 0) {
+                return true;
+            }
+        } else if (c == '"') {
+            String token = ESPrawUtil::readString(body, ESPRAW_LISTING_TOKEN_LENGTH);
+            
+            // Only keys of the selected listing's data object matter
+            if (ESPrawUtil::peekToken(body) != ':') {
+                continue;
+            }
+            body.read();
+            if (depth != dataDepth || listing != _listingIndex) {
+                continue;
+            }
+            
+            if (token == "after") {
+                if (ESPrawUtil::peekToken(body) == '"') {
+                    body.read();
+                    _after = ESPrawUtil::readString(body, ESPRAW_LISTING_TOKEN_LENGTH);
+                }
+            } else if (token == "children" && ESPrawUtil::peekToken(body) == '[') {
+                body.read();
+                if (!readChildren(body, itemDoc, filter, kind, onItem)) {
+                    return false;
+                }
+                if (_stopped) {
+                    // The rest of the page is discarded by the client
+                    return true;
+                }
+            }
+        }
+    }
+    
+    return depth == 0;
+}
+
+bool ListingIterator::readChildren(Stream& body, JsonDocument& itemDoc, const JsonDocument* filter,
+                                   const char* kind, const ItemHandler& onItem) {
+    while (true) {
+        int c = ESPrawUtil::peekToken(body);
+        
+        if (c == ',') {
+            body.read();
+            continue;
+        }
+        if (c == ']') {
+            body.read();
+            return true;
+        }
+        if (c != '{') {
+            _error = "Unexpected listing format";
+            return false;
+        }
+        
+        DeserializationError error;
+        if (filter != nullptr) {
+            error = deserializeJson(itemDoc, body, DeserializationOption::Filter(*filter));
+        } else {
+            error = deserializeJson(itemDoc, body);
+        }
+        
+        if (error) {
+            _error = "Listing item parse error: " + String(error.c_str());
+            return false;
+        }
+        
+        _pageItems++;
+        _count++;
+        
+        // Already visited before the iteration was stopped on this page
+        if (_skip > 0) {
+            _skip--;
+            continue;
+        }
+        
+        // Skip other kinds, such as "more" placeholders in comment listings
+        String itemKind = itemDoc["kind"].as<String>();
+        if (kind != nullptr ? itemKind != kind : itemKind == "more") {
+            continue;
+        }
+        
+        _visited++;
+        if (!onItem(itemKind.c_str(), itemDoc["data"].as<JsonObject>()) || (_limit > 0 && _visited >= _limit)) {
+            _stopped = true;
+            _done = _limit > 0 && _visited >= _limit;
+            return true;
+        }
+    }
+}
+
+String ListingIterator::buildParams() const {
+    String params = _params;
+    if (params.length() > 0) {
+        params += "&";
+    }
+    params += "limit=" + String(_pageLimit);
+    
+    if (_after.length() > 0) {
+        params += "&after=" + _after + "&count=" + String(_count);
+    }
+    
+    return params;
+}
@@ -0,0 +1,238 @@
+/**
+ * ListingIterator.h - Streaming iterator over Reddit listings
+ * 
+ * Walks a listing endpoint one item at a time, following the `after`
+ * cursor across pages. Each page is scanned straight from the connection
+ * and only the current item is deserialized, so memory use does not grow
+ * with the page size or the number of items visited.
+ */
+
+#ifndef LISTING_ITERATOR_H
+#define LISTING_ITERATOR_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <functional>
+#include "../ESPrawConfig.h"
+#include "../ESPrawFilter.h"
+#include "Submission.h"
+#include "Comment.h"
+#include "ModelViews.h"
+
+class Subreddit;
+
+/**
+ * ListingIterator - Visits the items of a listing as typed objects
+ * 
+ * Example usage:
+ * ```cpp
+ * ListingIterator posts = sub->listing("new");
+ * posts.setLimit(1000);
+ * posts.forEachSubmission([](Submission& post) {
+ *     Serial.println(post.getTitle());
+ *     return true;  // false stops the iteration
+ * });
+ * ```
+ * 
+ * Callbacks run while the page is still being read from the connection,
+ * so they must not make blocking API calls (fetching comments, voting,
+ * ...): those fail with "Request already in progress". Keep what the
+ * call needs, e.g. the submission ID, and make it after the iteration
+ * returns.
+ * 
+ * An iteration stopped by a callback can be resumed: the next forEach*()
+ * call continues with the item after the one that stopped it. The page it
+ * stopped in is requested again and the items already read are skipped.
+ */
+class ListingIterator {
+public:
+    typedef std::function<bool(Submission& submission)> SubmissionCallback;
+    typedef std::function<bool(Comment& comment)> CommentCallback;
+    typedef std::function<bool(Subreddit& subreddit)> SubredditCallback;
+    
+    /**
+     * Constructor
+     * @param espraw Pointer to ESPraw instance
+     * @param endpoint Listing endpoint (e.g., "/r/esp32/hot")
+     * @param params Additional query parameters (without limit/after)
+     */
+    ListingIterator(ESPraw* espraw, const String& endpoint, const String& params = "");
+    
+    /**
+     * Set the total number of items to visit
+     * @param limit Maximum items (0 = until the listing is exhausted)
+     */
+    void setLimit(int limit);
+    
+    /**
+     * Set the number of items requested per page
+     * @param pageSize Items per request (Reddit allows up to 100)
+     */
+    void setPageSize(int pageSize);
+    
+    /**
+     * Set the fields kept for each item
+     * @param fields Field filter (must outlive the iterator)
+     */
+    void setFields(const ESPrawFilter& fields);
+    
+    /**
+     * Set the JSON capacity used for a single item
+     * @param capacity Capacity in bytes
+     */
+    void setItemCapacity(size_t capacity);
+    
+    /**
+     * Select the listing to iterate in responses holding several
+     * (comment pages are [submission listing, comment listing])
+     * @param index Listing index
+     */
+    void setListingIndex(int index);
+    
+    /**
+     * Set how submissions and comments passed to callbacks decode their fields
+     * 
+     * In ESPrawParseMode::LAZY a callback only pays for the fields it reads,
+     * but the object refers to the item buffer, which is reused for the next
+     * item: call detach() on it before keeping a copy past the callback.
+     * 
+     * @param mode Parse mode (default EAGER)
+     */
+    void setParseMode(ESPrawParseMode mode);
+    
+    /**
+     * Visit each submission in the listing
+     * @param callback Called per submission; return false to stop
+     * @return Number of submissions visited
+     */
+    int forEachSubmission(const SubmissionCallback& callback);
+    
+    /**
+     * Visit each comment in the listing
+     * @param callback Called per comment; return false to stop
+     * @return Number of comments visited
+     */
+    int forEachComment(const CommentCallback& callback);
+    
+    /**
+     * Visit each item of a listing mixing kinds, such as /api/info
+     * 
+     * Items are passed to the callback for their kind; items of a kind
+     * without a callback are skipped but still count as visited.
+     * 
+     * @param onSubmission Called per submission (t3); return false to stop
+     * @param onComment Called per comment (t1); return false to stop
+     * @param onSubreddit Called per subreddit (t5); return false to stop
+     * @return Number of items visited
+     */
+    int forEachThing(const SubmissionCallback& onSubmission, const CommentCallback& onComment,
+                     const SubredditCallback& onSubreddit);
+    
+    /**
+     * Store each submission in the listing as a view in an arena
+     * 
+     * The views end up back to back in the arena, so the list needs no
+     * allocation of its own. Collection stops early, with getError() set,
+     * if the arena fills up; size it for the page size and limit.
+     * 
+     * @param arena Arena to store the views in
+     * @param list Receives the views (appended to)
+     * @return Number of submissions stored
+     */
+    int collectSubmissions(ESPrawArena& arena, ESPrawViewList<SubmissionView>& list);
+    
+    /**
+     * Store each comment in the listing as a view in an arena
+     * 
+     * See collectSubmissions().
+     * 
+     * @param arena Arena to store the views in
+     * @param list Receives the views (appended to)
+     * @return Number of comments stored
+     */
+    int collectComments(ESPrawArena& arena, ESPrawViewList<CommentView>& list);
+    
+    /**
+     * Check if more items can be fetched
+     * @return true if the listing is not exhausted
+     */
+    bool hasMore() const;
+    
+    /**
+     * Get the cursor the next page is requested with
+     * @return Fullname of the item before the next page, or empty on the
+     *         first page and at the end
+     */
+    const String& getAfter() const;
+    
+    /**
+     * Get the error that ended the iteration
+     * @return Error message, empty if none
+     */
+    const String& getError() const;
+    
+    /**
+     * Restart from the first page
+     */
+    void reset();
+
+private:
+    typedef std::function<bool(const char* kind, JsonObject item)> ItemHandler;
+    
+    /**
+     * Fetch pages and pass each item of the given kind to a handler
+     * @param kind Item kind to visit ("t3", "t1"), or nullptr for every kind but "more"
+     * @param fields Default fields for the kind
+     * @param onItem Handler for each item's data
+     * @return Number of items visited
+     */
+    int iterate(const char* kind, const ESPrawFilter& fields, const ItemHandler& onItem);
+    
+    /**
+     * Scan one page of the listing
+     * @param body Response body stream
+     * @param itemDoc Document reused for each item
+     * @param filter Filter applied to each item (nullptr keeps all)
+     * @param kind Item kind to visit
+     * @param onItem Handler for each item's data
+     * @return true if the page was read successfully
+     */
+    bool readPage(Stream& body, JsonDocument& itemDoc, const JsonDocument* filter,
+                  const char* kind, const ItemHandler& onItem);
+    
+    /**
+     * Deserialize the items of a "children" array one at a time
+     * @return true if the array was read successfully
+     */
+    bool readChildren(Stream& body, JsonDocument& itemDoc, const JsonDocument* filter,
+                      const char* kind, const ItemHandler& onItem);
+    
+    /**
+     * Build the query parameters for the next page
+     * @return Query string
+     */
+    String buildParams() const;
+    
+    ESPraw* _espraw;
+    String _endpoint;
+    String _params;
+    String _after;
+    String _error;
+    const ESPrawFilter* _fields;
+    size_t _itemCapacity;
+    int _limit;
+    int _pageSize;
+    int _listingIndex;
+    ESPrawParseMode _parseMode;
+    int _count;           // Items seen across all pages (Reddit's "count")
+    int _visited;         // Items handed to the callback
+    int _pageItems;       // Items seen on the current page
+    String _pageAfter;    // Cursor the current page was requested with
+    int _pageCount;       // _count when the current page was requested
+    int _pageLimit;       // Items requested for the current page
+    int _skip;            // Items of the page to skip when resuming
+    bool _done;
+    bool _stopped;
+};
+
+#endif // LISTING_ITERATOR_H
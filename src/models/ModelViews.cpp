@@ -0,0 +1,114 @@
+/**
+ * ModelViews.cpp - Arena-backed model records
+ */
+
+#include "ModelViews.h"
+#include <new>
+
+/**
+ * Copy a string field into the arena
+ * @return false if the arena is full
+ */
+static bool copyField(ESPrawArena& arena, JsonObject data, const char* key, ESPrawText& view) {
+    const char* value = data[key].as<const char*>();
+    return arena.copyText(value, value != nullptr ? strlen(value) : 0, view);
+}
+
+SubmissionView* SubmissionView::create(ESPrawArena& arena, JsonObject data) {
+    SubmissionView* view = (SubmissionView*)arena.allocateRecord(sizeof(SubmissionView));
+    if (view == nullptr) {
+        return nullptr;
+    }
+    new (view) SubmissionView();
+
+    bool stored = copyField(arena, data, "id", view->id) &&
+                  copyField(arena, data, "name", view->fullname) &&
+                  copyField(arena, data, "title", view->title) &&
+                  copyField(arena, data, "author", view->author) &&
+                  copyField(arena, data, "subreddit", view->subreddit) &&
+                  copyField(arena, data, "selftext", view->selftext) &&
+                  copyField(arena, data, "url", view->url) &&
+                  copyField(arena, data, "domain", view->domain) &&
+                  copyField(arena, data, "permalink", view->permalink);
+
+    view->createdUtc = data["created_utc"].as<unsigned long>();
+    view->score = data["score"].as<int32_t>();
+    view->numComments = data["num_comments"].as<int32_t>();
+    view->upvoteRatio = data["upvote_ratio"].as<float>();
+    view->over18 = data["over_18"].as<bool>();
+    view->spoiler = data["spoiler"].as<bool>();
+    view->locked = data["locked"].as<bool>();
+    view->stickied = data["stickied"].as<bool>();
+    view->isSelf = data["is_self"].as<bool>();
+
+    return stored ? view : nullptr;
+}
+
+CommentView* CommentView::create(ESPrawArena& arena, JsonObject data) {
+    CommentView* view = (CommentView*)arena.allocateRecord(sizeof(CommentView));
+    if (view == nullptr) {
+        return nullptr;
+    }
+    new (view) CommentView();
+
+    bool stored = copyField(arena, data, "id", view->id) &&
+                  copyField(arena, data, "name", view->fullname) &&
+                  copyField(arena, data, "body", view->body) &&
+                  copyField(arena, data, "author", view->author) &&
+                  copyField(arena, data, "subreddit", view->subreddit) &&
+                  copyField(arena, data, "parent_id", view->parentId) &&
+                  copyField(arena, data, "link_id", view->linkId) &&
+                  copyField(arena, data, "permalink", view->permalink);
+
+    view->createdUtc = data["created_utc"].as<unsigned long>();
+    view->score = data["score"].as<int32_t>();
+    view->depth = data["depth"].as<int32_t>();
+    view->isSubmitter = data["is_submitter"].as<bool>();
+    view->scoreHidden = data["score_hidden"].as<bool>();
+
+    return stored ? view : nullptr;
+}
+
+SubredditView* SubredditView::create(ESPrawArena& arena, JsonObject data) {
+    SubredditView* view = (SubredditView*)arena.allocateRecord(sizeof(SubredditView));
+    if (view == nullptr) {
+        return nullptr;
+    }
+    new (view) SubredditView();
+
+    bool stored = copyField(arena, data, "id", view->id) &&
+                  copyField(arena, data, "name", view->fullname) &&
+                  copyField(arena, data, "display_name", view->displayName) &&
+                  copyField(arena, data, "title", view->title) &&
+                  copyField(arena, data, "description", view->description) &&
+                  copyField(arena, data, "public_description", view->publicDescription);
+
+    view->createdUtc = data["created_utc"].as<unsigned long>();
+    view->subscribers = data["subscribers"].as<int32_t>();
+    view->activeUsers = data["active_user_count"].as<int32_t>();
+    view->over18 = data["over18"].as<bool>();
+    view->userIsSubscriber = data["user_is_subscriber"].as<bool>();
+
+    return stored ? view : nullptr;
+}
+
+RedditorView* RedditorView::create(ESPrawArena& arena, JsonObject data) {
+    RedditorView* view = (RedditorView*)arena.allocateRecord(sizeof(RedditorView));
+    if (view == nullptr) {
+        return nullptr;
+    }
+    new (view) RedditorView();
+
+    bool stored = copyField(arena, data, "id", view->id) &&
+                  copyField(arena, data, "name", view->name);
+
+    view->createdUtc = data["created_utc"].as<unsigned long>();
+    view->linkKarma = data["link_karma"].as<int32_t>();
+    view->commentKarma = data["comment_karma"].as<int32_t>();
+    view->hasVerifiedEmail = data["has_verified_email"].as<bool>();
+    view->isGold = data["is_gold"].as<bool>();
+    view->isMod = data["is_mod"].as<bool>();
+    view->isEmployee = data["is_employee"].as<bool>();
+
+    return stored ? view : nullptr;
+}
@@ -0,0 +1,124 @@
+/**
+ * ModelViews.h - Read-only model records stored in an ESPrawArena
+ *
+ * Each view holds the fields its model class parses, with text as
+ * ESPrawText pointing into the arena instead of as Strings. Views have no
+ * methods that call the API; build a Submission or Comment from the ID
+ * when you need to vote or reply.
+ */
+
+#ifndef MODEL_VIEWS_H
+#define MODEL_VIEWS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../ESPrawArena.h"
+
+/**
+ * SubmissionView - Fields of a submission (kind t3)
+ */
+struct SubmissionView {
+    ESPrawText id;
+    ESPrawText fullname;
+    ESPrawText title;
+    ESPrawText author;
+    ESPrawText subreddit;
+    ESPrawText selftext;
+    ESPrawText url;
+    ESPrawText domain;
+    ESPrawText permalink;
+    unsigned long createdUtc;
+    int32_t score;
+    int32_t numComments;
+    float upvoteRatio;
+    bool over18;
+    bool spoiler;
+    bool locked;
+    bool stickied;
+    bool isSelf;
+
+    /**
+     * Create a view in an arena
+     * @param arena Arena holding the record and its text
+     * @param data Submission data object
+     * @return View, or nullptr if the arena is full
+     */
+    static SubmissionView* create(ESPrawArena& arena, JsonObject data);
+};
+
+/**
+ * CommentView - Fields of a comment (kind t1)
+ */
+struct CommentView {
+    ESPrawText id;
+    ESPrawText fullname;
+    ESPrawText body;
+    ESPrawText author;
+    ESPrawText subreddit;
+    ESPrawText parentId;
+    ESPrawText linkId;
+    ESPrawText permalink;
+    unsigned long createdUtc;
+    int32_t score;
+    int32_t depth;
+    bool isSubmitter;
+    bool scoreHidden;
+
+    /**
+     * Create a view in an arena
+     * @param arena Arena holding the record and its text
+     * @param data Comment data object
+     * @return View, or nullptr if the arena is full
+     */
+    static CommentView* create(ESPrawArena& arena, JsonObject data);
+};
+
+/**
+ * SubredditView - Fields of a subreddit (kind t5)
+ */
+struct SubredditView {
+    ESPrawText id;
+    ESPrawText fullname;
+    ESPrawText displayName;
+    ESPrawText title;
+    ESPrawText description;
+    ESPrawText publicDescription;
+    unsigned long createdUtc;
+    int32_t subscribers;
+    int32_t activeUsers;
+    bool over18;
+    bool userIsSubscriber;
+
+    /**
+     * Create a view in an arena
+     * @param arena Arena holding the record and its text
+     * @param data Subreddit data object
+     * @return View, or nullptr if the arena is full
+     */
+    static SubredditView* create(ESPrawArena& arena, JsonObject data);
+};
+
+/**
+ * RedditorView - Fields of a redditor (kind t2)
+ */
+struct RedditorView {
+    ESPrawText id;
+    ESPrawText name;
+    unsigned long createdUtc;
+    int32_t linkKarma;
+    int32_t commentKarma;
+    bool hasVerifiedEmail;
+    bool isGold;
+    bool isMod;
+    bool isEmployee;
+
+    /**
+     * Create a view in an arena
+     * @param arena Arena holding the record and its text
+     * @param data Redditor data object
+     * @return View, or nullptr if the arena is full
+     */
+    static RedditorView* create(ESPrawArena& arena, JsonObject data);
+};
+
+#endif // MODEL_VIEWS_H
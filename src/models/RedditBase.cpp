@@ -5,39 +5,43 @@
 #include "RedditBase.h"
 #include "../ESPraw.h"
 
-RedditBase::RedditBase(ESPraw* espraw, JsonObject data) 
-    : _espraw(espraw), _created(0), _createdUtc(0), _valid(false) {
-    if (!data.isNull()) {
-        parseData(data);
-    }
+RedditBase::RedditBase(ESPraw* espraw) 
+    : _espraw(espraw), _created(0), _createdUtc(0), _valid(false), _decoded(0) {
 }
 
 RedditBase::~RedditBase() {
 }
 
-String RedditBase::getId() const {
-    return _id;
+const String& RedditBase::getId() const {
+    return lazyString(_id, FIELD_ID, "id");
 }
 
-String RedditBase::getFullname() const {
-    return _fullname;
+const String& RedditBase::getFullname() const {
+    return lazyString(_fullname, FIELD_FULLNAME, "name");
 }
 
-String RedditBase::getKind() const {
-    return _kind;
+const String& RedditBase::getKind() const {
+    if (!_source.isNull() && !(_decoded & FIELD_KIND)) {
+        _kind = extractKind(_source);
+        _decoded |= FIELD_KIND;
+    }
+    return _kind.str();
 }
 
 unsigned long RedditBase::getCreated() const {
-    return _created;
+    return lazyULong(_created, FIELD_CREATED, "created");
 }
 
 unsigned long RedditBase::getCreatedUtc() const {
-    return _createdUtc;
+    return lazyULong(_createdUtc, FIELD_CREATED_UTC, "created_utc");
 }
 
 void RedditBase::parseData(JsonObject data) {
+    _source = JsonObject();
+    _decoded = 0;
+    
     _id = extractString(data, "id");
-    _kind = extractString(data, "kind");
+    _kind = extractKind(data);
     _fullname = extractString(data, "name");
     _created = extractULong(data, "created");
     _createdUtc = extractULong(data, "created_utc");
@@ -49,6 +53,65 @@ bool RedditBase::isValid() const {
     return _valid;
 }
 
+bool RedditBase::isLazy() const {
+    return !_source.isNull();
+}
+
+void RedditBase::detach() {
+    if (!_source.isNull()) {
+        JsonObject source = _source;
+        parseData(source);
+    }
+}
+
+void RedditBase::parseLazily(JsonObject data) {
+    _source = data;
+    _decoded = 0;
+    
+    const char* id = data["id"].as<const char*>();
+    _valid = id != nullptr && id[0] != '\0';
+}
+
+const String& RedditBase::lazyString(String& value, uint32_t field, const char* key) const {
+    if (!_source.isNull() && !(_decoded & field)) {
+        value = extractString(_source, key);
+        _decoded |= field;
+    }
+    return value;
+}
+
+const String& RedditBase::lazyInterned(ESPrawInternedString& value, uint32_t field, const char* key) const {
+    if (!_source.isNull() && !(_decoded & field)) {
+        value = extractInterned(_source, key);
+        _decoded |= field;
+    }
+    return value.str();
+}
+
+int RedditBase::lazyInt(int& value, uint32_t field, const char* key, int defaultValue) const {
+    if (!_source.isNull() && !(_decoded & field)) {
+        value = extractInt(_source, key, defaultValue);
+        _decoded |= field;
+    }
+    return value;
+}
+
+bool RedditBase::lazyBool(bool& value, uint32_t field, const char* key) const {
+    if (!_source.isNull() && !(_decoded & field)) {
+        value = extractBool(_source, key);
+        _decoded |= field;
+    }
+    return value;
+}
+
+unsigned long RedditBase::lazyULong(unsigned long& value, uint32_t field, const char* key) const {
+    if (!_source.isNull() && !(_decoded & field)) {
+        value = extractULong(_source, key);
+        _decoded |= field;
+    }
+    return value;
+}
+
 String RedditBase::extractString(JsonObject data, const char* key, const String& defaultValue) const {
     if (data.containsKey(key) && !data[key].isNull()) {
         return data[key].as<String>();
@@ -56,6 +119,34 @@ String RedditBase::extractString(JsonObject data, const char* key, const String&
     return defaultValue;
 }
 
+ESPrawInternedString RedditBase::extractInterned(JsonObject data, const char* key) const {
+    ESPrawStringPool* pool = _espraw != nullptr ? _espraw->getStringPool() : nullptr;
+    if (pool == nullptr) {
+        return ESPrawInternedString(extractString(data, key));
+    }
+    return pool->intern(data[key].as<const char*>());
+}
+
+ESPrawInternedString RedditBase::extractKind(JsonObject data) const {
+    // "kind" sits on the wrapper around the data object, so it is read
+    // from the fullname instead ("t3_abc123" is a t3)
+    const char* name = data["name"].as<const char*>();
+    if (name == nullptr || name[0] != 't' || !isdigit((unsigned char)name[1]) || name[2] != '_') {
+        return ESPrawInternedString();
+    }
+    
+    char kind[3] = { name[0], name[1], '\0' };
+    return internString(kind);
+}
+
+ESPrawInternedString RedditBase::internString(const char* text) const {
+    ESPrawStringPool* pool = _espraw != nullptr ? _espraw->getStringPool() : nullptr;
+    if (pool == nullptr) {
+        return ESPrawInternedString(String(text));
+    }
+    return pool->intern(text);
+}
+
 int RedditBase::extractInt(JsonObject data, const char* key, int defaultValue) const {
     if (data.containsKey(key) && !data[key].isNull()) {
         return data[key].as<int>();
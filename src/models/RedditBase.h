@@ -9,10 +9,19 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "../ESPrawStringPool.h"
 
 // Forward declaration
 class ESPraw;
 
+/**
+ * When a model decodes its fields from JSON
+ */
+enum class ESPrawParseMode {
+    EAGER,  // Copy every field when the object is built
+    LAZY    // Keep the JSON object and decode each field the first time it is read
+};
+
 /**
  * RedditBase - Base class for all Reddit objects
  */
@@ -20,33 +29,46 @@ class RedditBase {
 public:
     /**
      * Constructor
+     * 
+     * Derived classes call parseData() from their own constructors; from
+     * here the call would not reach their override.
+     * 
      * @param espraw Pointer to ESPraw instance
-     * @param data JSON data for this object
      */
-    RedditBase(ESPraw* espraw, JsonObject data);
+    explicit RedditBase(ESPraw* espraw);
     
     /**
      * Virtual destructor
      */
     virtual ~RedditBase();
     
+    // Declaring the destructor would otherwise leave models copy-only
+    RedditBase(const RedditBase&) = default;
+    RedditBase(RedditBase&&) = default;
+    RedditBase& operator=(const RedditBase&) = default;
+    RedditBase& operator=(RedditBase&&) = default;
+    
     /**
      * Get the object's unique ID
      * @return Object ID
      */
-    String getId() const;
+    const String& getId() const;
     
     /**
      * Get the object's fullname (kind + id)
      * @return Fullname (e.g., "t3_abc123")
      */
-    String getFullname() const;
+    const String& getFullname() const;
     
     /**
      * Get the object's kind/type
-     * @return Kind string
+     * 
+     * Reddit sends the kind next to the object's data rather than in it,
+     * so it is taken from the fullname's prefix.
+     * 
+     * @return Kind string (e.g., "t3"), empty if unknown
      */
-    String getKind() const;
+    const String& getKind() const;
     
     /**
      * Get object creation time (Unix timestamp)
@@ -72,14 +94,97 @@ public:
      */
     bool isValid() const;
     
+    /**
+     * Check if fields are decoded on first read (ESPrawParseMode::LAZY)
+     * 
+     * A lazy object reads from the JSON document it was built from, which
+     * must stay alive and unchanged until every field has been read or
+     * detach() is called.
+     * 
+     * @return true while the object still refers to its JSON document
+     */
+    bool isLazy() const;
+    
+    /**
+     * Decode every field not read yet and let go of the JSON document
+     */
+    void detach();
+    
 protected:
+    // Field bits for lazy decoding; derived classes number theirs from FIRST_FIELD
+    enum : uint32_t {
+        FIELD_ID = 1u << 0,
+        FIELD_KIND = 1u << 1,
+        FIELD_FULLNAME = 1u << 2,
+        FIELD_CREATED = 1u << 3,
+        FIELD_CREATED_UTC = 1u << 4
+    };
+    static const int FIRST_FIELD = 5;
+    
     ESPraw* _espraw;
-    String _id;
-    String _kind;
-    String _fullname;
-    unsigned long _created;
-    unsigned long _createdUtc;
+    mutable String _id;
+    mutable ESPrawInternedString _kind;
+    mutable String _fullname;
+    mutable unsigned long _created;
+    mutable unsigned long _createdUtc;
     bool _valid;
+    JsonObject _source;         // Lazy mode: object the fields are decoded from
+    mutable uint32_t _decoded;  // Lazy mode: fields decoded so far
+    
+    /**
+     * Refer to a JSON object instead of copying its fields
+     * 
+     * Derived classes call this from their constructors in lazy mode.
+     * 
+     * @param data JSON object (must outlive the lazy fields)
+     */
+    void parseLazily(JsonObject data);
+    
+    /**
+     * Decode a string field on first read in lazy mode
+     * @param value Field storage
+     * @param field Field bit
+     * @param key Field key
+     * @return Field value
+     */
+    const String& lazyString(String& value, uint32_t field, const char* key) const;
+    
+    /**
+     * Decode a repeated string field on first read in lazy mode
+     * @param value Field storage
+     * @param field Field bit
+     * @param key Field key
+     * @return Field value
+     */
+    const String& lazyInterned(ESPrawInternedString& value, uint32_t field, const char* key) const;
+    
+    /**
+     * Decode an integer field on first read in lazy mode
+     * @param value Field storage
+     * @param field Field bit
+     * @param key Field key
+     * @param defaultValue Default value if not found
+     * @return Field value
+     */
+    int lazyInt(int& value, uint32_t field, const char* key, int defaultValue = 0) const;
+    
+    /**
+     * Decode a boolean field on first read in lazy mode
+     * @param value Field storage
+     * @param field Field bit
+     * @param key Field key
+     * @return Field value
+     */
+    bool lazyBool(bool& value, uint32_t field, const char* key) const;
+    
+    /**
+     * Decode an unsigned long field on first read in lazy mode
+     * @param value Field storage
+     * @param field Field bit
+     * @param key Field key
+     * @return Field value
+     */
+    unsigned long lazyULong(unsigned long& value, uint32_t field, const char* key) const;
     
     /**
      * Extract string field from JSON
@@ -90,6 +195,32 @@ protected:
      */
     String extractString(JsonObject data, const char* key, const String& defaultValue = "") const;
     
+    /**
+     * Extract a string field that repeats across objects
+     * 
+     * Shared through the string pool set with ESPraw::setStringPool(),
+     * if there is one.
+     * 
+     * @param data JSON object
+     * @param key Field key
+     * @return Field value (empty if not found)
+     */
+    ESPrawInternedString extractInterned(JsonObject data, const char* key) const;
+    
+    /**
+     * Extract the kind from the fullname prefix
+     * @param data JSON object
+     * @return Kind (empty if the fullname has no kind prefix)
+     */
+    ESPrawInternedString extractKind(JsonObject data) const;
+    
+    /**
+     * Share a string through the string pool, if there is one
+     * @param text String to share
+     * @return Interned string
+     */
+    ESPrawInternedString internString(const char* text) const;
+    
     /**
      * Extract integer field from JSON
      * @param data JSON object
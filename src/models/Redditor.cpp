@@ -6,23 +6,26 @@
 #include "../ESPraw.h"
 
 Redditor::Redditor(ESPraw* espraw, const String& username)
-    : RedditBase(espraw, JsonObject()), _linkKarma(0), _commentKarma(0),
+    : RedditBase(espraw), _linkKarma(0), _commentKarma(0),
       _hasVerifiedEmail(false), _isGold(false), _isMod(false), _isEmployee(false) {
     _username = username;
 }
 
 Redditor::Redditor(ESPraw* espraw, JsonObject data)
-    : RedditBase(espraw, data), _linkKarma(0), _commentKarma(0),
+    : RedditBase(espraw), _linkKarma(0), _commentKarma(0),
       _hasVerifiedEmail(false), _isGold(false), _isMod(false), _isEmployee(false) {
-}
-
-Redditor::~Redditor() {
+    if (!data.isNull()) {
+        parseData(data);
+    }
 }
 
 void Redditor::parseData(JsonObject data) {
     // Parse base fields
     RedditBase::parseData(data);
     
+    // "name" is the username here, not a fullname to take the kind from
+    _kind = internString("t2");
+    
     // Parse redditor-specific fields
     _username = extractString(data, "name");
     _linkKarma = extractInt(data, "link_karma");
@@ -40,49 +43,64 @@ bool Redditor::fetch() {
     }
     
     String endpoint = "/user/" + _username + "/about";
-    ESPrawResponse response = _espraw->get(endpoint);
-    
-    if (!response.success) {
+    DynamicJsonDocument doc(4096);
+    if (!fetchAbout(endpoint, doc)) {
         return false;
     }
     
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, response.body);
-    
-    if (error) {
-        return false;
+    parseData(doc["data"].as<JsonObject>());
+    return true;
+}
+
+const RedditorView* Redditor::fetch(ESPrawArena& arena) {
+    if (!_espraw || _username.isEmpty()) {
+        return nullptr;
     }
     
-    if (doc.containsKey("data")) {
-        JsonObject data = doc["data"].as<JsonObject>();
-        parseData(data);
-        return true;
+    DynamicJsonDocument doc(4096);
+    if (!fetchAbout("/user/" + _username + "/about", doc)) {
+        return nullptr;
     }
     
-    return false;
+    return RedditorView::create(arena, doc["data"].as<JsonObject>());
 }
 
-bool Redditor::getSubmissions(DynamicJsonDocument& doc, int limit) {
-    return fetchUserContent(doc, "submitted", limit);
+bool Redditor::fetchAbout(const String& endpoint, JsonDocument& doc) {
+    DynamicJsonDocument filter(ESPrawFilter::redditor().capacity());
+    ESPrawFilter::redditor().buildThing(filter);
+    
+    ESPrawResponse response = _espraw->getJson(endpoint, doc, "", &filter);
+    return response.success && doc.containsKey("data");
 }
 
-bool Redditor::getComments(DynamicJsonDocument& doc, int limit) {
-    return fetchUserContent(doc, "comments", limit);
+bool Redditor::getSubmissions(DynamicJsonDocument& doc, int limit, const ESPrawFilter& fields) {
+    return fetchUserContent(doc, "submitted", limit, fields);
 }
 
-bool Redditor::fetchUserContent(DynamicJsonDocument& doc, const String& type, int limit) {
+bool Redditor::getComments(DynamicJsonDocument& doc, int limit, const ESPrawFilter& fields) {
+    return fetchUserContent(doc, "comments", limit, fields);
+}
+
+ListingIterator Redditor::listing(const String& type) {
+    return ListingIterator(_espraw, "/user/" + _username + "/" + type);
+}
+
+bool Redditor::fetchUserContent(DynamicJsonDocument& doc, const String& type, int limit,
+                                const ESPrawFilter& fields) {
     if (!_espraw || _username.isEmpty()) {
         return false;
     }
     
     String endpoint = "/user/" + _username + "/" + type;
     String params = "limit=" + String(limit);
-    ESPrawResponse response = _espraw->get(endpoint, params);
     
-    if (!response.success) {
-        return false;
+    if (!fields.isEnabled()) {
+        return _espraw->getJson(endpoint, doc, params).success;
     }
     
-    DeserializationError error = deserializeJson(doc, response.body);
-    return !error;
+    DynamicJsonDocument filter(fields.capacity());
+    fields.buildListing(filter);
+    
+    ESPrawResponse response = _espraw->getJson(endpoint, doc, params, &filter);
+    return response.success;
 }
@@ -10,6 +10,9 @@
 #include "RedditBase.h"
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "../ESPrawFilter.h"
+#include "ListingIterator.h"
+#include "ModelViews.h"
 
 /**
  * Redditor - Represents a Reddit user
@@ -30,11 +33,6 @@ public:
      */
     Redditor(ESPraw* espraw, JsonObject data);
     
-    /**
-     * Destructor
-     */
-    ~Redditor();
-    
     /**
      * Parse redditor data from JSON
      * @param data JSON object
@@ -42,7 +40,7 @@ public:
     void parseData(JsonObject data) override;
     
     // Getters
-    String getUsername() const { return _username; }
+    const String& getUsername() const { return _username; }
     int getLinkKarma() const { return _linkKarma; }
     int getCommentKarma() const { return _commentKarma; }
     bool hasVerifiedEmail() const { return _hasVerifiedEmail; }
@@ -56,21 +54,39 @@ public:
      */
     bool fetch();
     
+    /**
+     * Fetch full user info from Reddit into a view in an arena, leaving this object unchanged
+     * @param arena Arena to store the view in
+     * @return View, or nullptr on failure or if the arena is full
+     */
+    const RedditorView* fetch(ESPrawArena& arena);
+    
     /**
      * Get user's submitted posts
      * @param doc JSON document to store results
      * @param limit Maximum number of posts
+     * @param fields Fields to keep for each post (ESPrawFilter::none() keeps all)
      * @return true if successful
      */
-    bool getSubmissions(DynamicJsonDocument& doc, int limit = 25);
+    bool getSubmissions(DynamicJsonDocument& doc, int limit = 25,
+                        const ESPrawFilter& fields = ESPrawFilter::submission());
     
     /**
      * Get user's comments
      * @param doc JSON document to store results
      * @param limit Maximum number of comments
+     * @param fields Fields to keep for each comment (ESPrawFilter::none() keeps all)
      * @return true if successful
      */
-    bool getComments(DynamicJsonDocument& doc, int limit = 25);
+    bool getComments(DynamicJsonDocument& doc, int limit = 25,
+                     const ESPrawFilter& fields = ESPrawFilter::comment());
+
+    /**
+     * Get a streaming iterator over the user's content
+     * @param type Content type ("submitted" or "comments")
+     * @return Listing iterator that follows pagination automatically
+     */
+    ListingIterator listing(const String& type);
 
 private:
     String _username;
@@ -81,14 +97,24 @@ private:
     bool _isMod;
     bool _isEmployee;
     
+    /**
+     * Request the about page
+     * @param endpoint About endpoint
+     * @param doc Document to store the filtered response
+     * @return true if a data object was received
+     */
+    bool fetchAbout(const String& endpoint, JsonDocument& doc);
+    
     /**
      * Fetch user content
      * @param doc JSON document to store results
      * @param type Content type ("submitted" or "comments")
      * @param limit Maximum number of items
+     * @param fields Fields to keep for each item
      * @return true if successful
      */
-    bool fetchUserContent(DynamicJsonDocument& doc, const String& type, int limit);
+    bool fetchUserContent(DynamicJsonDocument& doc, const String& type, int limit,
+                          const ESPrawFilter& fields);
 };
 
 #endif // REDDITOR_H
@@ -3,14 +3,20 @@
  */
 
 #include "Submission.h"
+#include "ListingIterator.h"
 #include "../ESPraw.h"
 
-Submission::Submission(ESPraw* espraw, JsonObject data)
-    : RedditBase(espraw, data), _score(0), _upvoteRatio(0), _numComments(0),
+Submission::Submission(ESPraw* espraw, JsonObject data, ESPrawParseMode mode)
+    : RedditBase(espraw), _score(0), _upvoteRatio(0), _numComments(0),
       _over18(false), _spoiler(false), _locked(false), _stickied(false), _isSelf(false) {
-}
-
-Submission::~Submission() {
+    if (data.isNull()) {
+        return;
+    }
+    if (mode == ESPrawParseMode::LAZY) {
+        parseLazily(data);
+    } else {
+        parseData(data);
+    }
 }
 
 void Submission::parseData(JsonObject data) {
@@ -19,11 +25,11 @@ void Submission::parseData(JsonObject data) {
     
     // Parse submission-specific fields
     _title = extractString(data, "title");
-    _author = extractString(data, "author");
-    _subreddit = extractString(data, "subreddit");
+    _author = extractInterned(data, "author");
+    _subreddit = extractInterned(data, "subreddit");
     _selftext = extractString(data, "selftext");
     _url = extractString(data, "url");
-    _domain = extractString(data, "domain");
+    _domain = extractInterned(data, "domain");
     _permalink = extractString(data, "permalink");
     
     _score = extractInt(data, "score");
@@ -50,84 +56,110 @@ bool Submission::clearVote() {
 }
 
 bool Submission::vote(int dir) {
-    if (!_espraw || _fullname.isEmpty()) {
+    if (!_espraw || getFullname().isEmpty()) {
         return false;
     }
     
-    String body = "id=" + _fullname + "&dir=" + String(dir);
+    String body = "id=" + getFullname() + "&dir=" + String(dir);
     ESPrawResponse response = _espraw->post("/api/vote", body);
     
     return response.success;
 }
 
 bool Submission::save() {
-    if (!_espraw || _fullname.isEmpty()) {
+    if (!_espraw || getFullname().isEmpty()) {
         return false;
     }
     
-    String body = "id=" + _fullname;
+    String body = "id=" + getFullname();
     ESPrawResponse response = _espraw->post("/api/save", body);
     
     return response.success;
 }
 
 bool Submission::unsave() {
-    if (!_espraw || _fullname.isEmpty()) {
+    if (!_espraw || getFullname().isEmpty()) {
         return false;
     }
     
-    String body = "id=" + _fullname;
+    String body = "id=" + getFullname();
     ESPrawResponse response = _espraw->post("/api/unsave", body);
     
     return response.success;
 }
 
 bool Submission::reply(const String& text) {
-    if (!_espraw || _fullname.isEmpty() || text.isEmpty()) {
+    if (!_espraw || getFullname().isEmpty() || text.isEmpty()) {
         return false;
     }
     
-    String body = "thing_id=" + _fullname + "&text=" + text;
+    String body = "thing_id=" + getFullname() + "&text=" + text;
     ESPrawResponse response = _espraw->post("/api/comment", body);
     
     return response.success;
 }
 
 bool Submission::edit(const String& text) {
-    if (!_espraw || _fullname.isEmpty() || text.isEmpty() || !_isSelf) {
+    if (!_espraw || getFullname().isEmpty() || text.isEmpty() || !isSelf()) {
         return false;
     }
     
-    String body = "thing_id=" + _fullname + "&text=" + text;
+    String body = "thing_id=" + getFullname() + "&text=" + text;
     ESPrawResponse response = _espraw->post("/api/editusertext", body);
     
     return response.success;
 }
 
 bool Submission::deleteSubmission() {
-    if (!_espraw || _fullname.isEmpty()) {
+    if (!_espraw || getFullname().isEmpty()) {
         return false;
     }
     
-    String body = "id=" + _fullname;
+    String body = "id=" + getFullname();
     ESPrawResponse response = _espraw->post("/api/del", body);
     
     return response.success;
 }
 
-bool Submission::getComments(DynamicJsonDocument& doc, int limit) {
-    if (!_espraw || _id.isEmpty()) {
+bool Submission::getComments(DynamicJsonDocument& doc, int limit, const ESPrawFilter& fields) {
+    if (!_espraw || getId().isEmpty()) {
         return false;
     }
     
-    String endpoint = "/comments/" + _id;
+    String endpoint = "/comments/" + getId();
     String params = "limit=" + String(limit);
-    ESPrawResponse response = _espraw->get(endpoint, params);
     
-    if (!response.success) {
+    if (!fields.isEnabled()) {
+        return _espraw->getJson(endpoint, doc, params).success;
+    }
+    
+    DynamicJsonDocument filter(ESPrawFilter::submission().capacity() +
+                               fields.capacity(ESPRAW_COMMENT_FILTER_DEPTH + 1));
+    ESPrawFilter::buildCommentsPage(filter, ESPrawFilter::submission(), fields);
+    
+    ESPrawResponse response = _espraw->getJson(endpoint, doc, params, &filter);
+    return response.success;
+}
+
+bool Submission::getComments(CommentTree& tree, int limit) {
+    if (!_espraw || getId().isEmpty()) {
         return false;
     }
     
-    DeserializationError error = deserializeJson(doc, response.body);
-    return !error;
+    String params = "limit=" + String(limit);
+    if (tree.getMaxDepth() > 0) {
+        params += "&depth=" + String(tree.getMaxDepth());
+    }
+    
+    ESPrawBodyHandler handler = [&tree](Stream& body) {
+        return tree.parse(body);
+    };
+    return _espraw->getStream("/comments/" + getId(), handler, params).success;
+}
+
+ListingIterator Submission::commentListing() {
+    // Comment pages are [submission listing, comment listing]
+    ListingIterator comments(_espraw, "/comments/" + getId());
+    comments.setListingIndex(1);
+    return comments;
 }
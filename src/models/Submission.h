@@ -10,6 +10,10 @@
 #include "RedditBase.h"
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "../ESPrawFilter.h"
+#include "CommentTree.h"
+
+class ListingIterator;
 
 /**
  * Submission - Represents a Reddit post
@@ -20,13 +24,11 @@ public:
      * Constructor
      * @param espraw Pointer to ESPraw instance
      * @param data JSON data for submission
+     * @param mode EAGER copies every field now; LAZY decodes each on first
+     *             read, so data's document must outlive the object's use
+     *             (or call detach())
      */
-    Submission(ESPraw* espraw, JsonObject data);
-    
-    /**
-     * Destructor
-     */
-    ~Submission();
+    Submission(ESPraw* espraw, JsonObject data, ESPrawParseMode mode = ESPrawParseMode::EAGER);
     
     /**
      * Parse submission data from JSON
@@ -35,21 +37,21 @@ public:
     void parseData(JsonObject data) override;
     
     // Getters
-    String getTitle() const { return _title; }
-    String getAuthor() const { return _author; }
-    String getSubreddit() const { return _subreddit; }
-    String getSelftext() const { return _selftext; }
-    String getUrl() const { return _url; }
-    String getDomain() const { return _domain; }
-    String getPermalink() const { return _permalink; }
-    int getScore() const { return _score; }
-    int getUpvoteRatio() const { return _upvoteRatio; }
-    int getNumComments() const { return _numComments; }
-    bool isOver18() const { return _over18; }
-    bool isSpoiler() const { return _spoiler; }
-    bool isLocked() const { return _locked; }
-    bool isStickied() const { return _stickied; }
-    bool isSelf() const { return _isSelf; }
+    const String& getTitle() const { return lazyString(_title, FIELD_TITLE, "title"); }
+    const String& getAuthor() const { return lazyInterned(_author, FIELD_AUTHOR, "author"); }
+    const String& getSubreddit() const { return lazyInterned(_subreddit, FIELD_SUBREDDIT, "subreddit"); }
+    const String& getSelftext() const { return lazyString(_selftext, FIELD_SELFTEXT, "selftext"); }
+    const String& getUrl() const { return lazyString(_url, FIELD_URL, "url"); }
+    const String& getDomain() const { return lazyInterned(_domain, FIELD_DOMAIN, "domain"); }
+    const String& getPermalink() const { return lazyString(_permalink, FIELD_PERMALINK, "permalink"); }
+    int getScore() const { return lazyInt(_score, FIELD_SCORE, "score"); }
+    int getUpvoteRatio() const { return lazyInt(_upvoteRatio, FIELD_UPVOTE_RATIO, "upvote_ratio", 50); }
+    int getNumComments() const { return lazyInt(_numComments, FIELD_NUM_COMMENTS, "num_comments"); }
+    bool isOver18() const { return lazyBool(_over18, FIELD_OVER18, "over_18"); }
+    bool isSpoiler() const { return lazyBool(_spoiler, FIELD_SPOILER, "spoiler"); }
+    bool isLocked() const { return lazyBool(_locked, FIELD_LOCKED, "locked"); }
+    bool isStickied() const { return lazyBool(_stickied, FIELD_STICKIED, "stickied"); }
+    bool isSelf() const { return lazyBool(_isSelf, FIELD_IS_SELF, "is_self"); }
     
     /**
      * Upvote this submission
@@ -103,27 +105,71 @@ public:
     
     /**
      * Get comments for this submission
+     * @param doc JSON document to store results ([submission listing, comment listing])
      * @param limit Maximum number of comments
-     * @return JSON document with comments (caller must handle)
+     * @param fields Fields to keep for each comment (ESPrawFilter::none() keeps all)
+     * @return true if successful
      */
-    bool getComments(DynamicJsonDocument& doc, int limit = 10);
+    bool getComments(DynamicJsonDocument& doc, int limit = 10,
+                     const ESPrawFilter& fields = ESPrawFilter::comment());
+    
+    /**
+     * Get comments for this submission as a flat tree
+     * 
+     * The page is parsed straight from the connection into the tree, using
+     * the tree's depth and score limits; the depth limit is also sent to
+     * Reddit so deeper replies are not transferred.
+     * 
+     * @param tree Tree to fill (previous content is replaced)
+     * @param limit Maximum number of comments requested
+     * @return true if successful
+     */
+    bool getComments(CommentTree& tree, int limit = 10);
+    
+    /**
+     * Get a streaming iterator over this submission's top-level comments
+     * 
+     * Replies are not included; "more" placeholders are skipped.
+     * 
+     * @return Listing iterator over the comment listing
+     */
+    ListingIterator commentListing();
 
 private:
-    String _title;
-    String _author;
-    String _subreddit;
-    String _selftext;
-    String _url;
-    String _domain;
-    String _permalink;
-    int _score;
-    int _upvoteRatio;
-    int _numComments;
-    bool _over18;
-    bool _spoiler;
-    bool _locked;
-    bool _stickied;
-    bool _isSelf;
+    // Field bits for lazy decoding
+    enum : uint32_t {
+        FIELD_TITLE = 1u << (FIRST_FIELD + 0),
+        FIELD_AUTHOR = 1u << (FIRST_FIELD + 1),
+        FIELD_SUBREDDIT = 1u << (FIRST_FIELD + 2),
+        FIELD_SELFTEXT = 1u << (FIRST_FIELD + 3),
+        FIELD_URL = 1u << (FIRST_FIELD + 4),
+        FIELD_DOMAIN = 1u << (FIRST_FIELD + 5),
+        FIELD_PERMALINK = 1u << (FIRST_FIELD + 6),
+        FIELD_SCORE = 1u << (FIRST_FIELD + 7),
+        FIELD_UPVOTE_RATIO = 1u << (FIRST_FIELD + 8),
+        FIELD_NUM_COMMENTS = 1u << (FIRST_FIELD + 9),
+        FIELD_OVER18 = 1u << (FIRST_FIELD + 10),
+        FIELD_SPOILER = 1u << (FIRST_FIELD + 11),
+        FIELD_LOCKED = 1u << (FIRST_FIELD + 12),
+        FIELD_STICKIED = 1u << (FIRST_FIELD + 13),
+        FIELD_IS_SELF = 1u << (FIRST_FIELD + 14)
+    };
+    
+    mutable String _title;
+    mutable ESPrawInternedString _author;
+    mutable ESPrawInternedString _subreddit;
+    mutable String _selftext;
+    mutable String _url;
+    mutable ESPrawInternedString _domain;
+    mutable String _permalink;
+    mutable int _score;
+    mutable int _upvoteRatio;
+    mutable int _numComments;
+    mutable bool _over18;
+    mutable bool _spoiler;
+    mutable bool _locked;
+    mutable bool _stickied;
+    mutable bool _isSelf;
     
     /**
      * Perform vote action
@@ -6,17 +6,17 @@
 #include "../ESPraw.h"
 
 Subreddit::Subreddit(ESPraw* espraw, const String& name)
-    : RedditBase(espraw, JsonObject()), _subscribers(0), _activeUsers(0),
+    : RedditBase(espraw), _subscribers(0), _activeUsers(0),
       _over18(false), _userIsSubscriber(false) {
     _displayName = name;
 }
 
 Subreddit::Subreddit(ESPraw* espraw, JsonObject data)
-    : RedditBase(espraw, data), _subscribers(0), _activeUsers(0),
+    : RedditBase(espraw), _subscribers(0), _activeUsers(0),
       _over18(false), _userIsSubscriber(false) {
-}
-
-Subreddit::~Subreddit() {
+    if (!data.isNull()) {
+        parseData(data);
+    }
 }
 
 void Subreddit::parseData(JsonObject data) {
@@ -36,42 +36,52 @@ void Subreddit::parseData(JsonObject data) {
     _userIsSubscriber = extractBool(data, "user_is_subscriber");
 }
 
-bool Subreddit::hot(DynamicJsonDocument& doc, int limit) {
-    return fetchPosts(doc, "hot", "limit=" + String(limit));
+bool Subreddit::hot(DynamicJsonDocument& doc, int limit, const ESPrawFilter& fields) {
+    return fetchPosts(doc, "hot", "limit=" + String(limit), fields);
 }
 
-bool Subreddit::new_(DynamicJsonDocument& doc, int limit) {
-    return fetchPosts(doc, "new", "limit=" + String(limit));
+bool Subreddit::new_(DynamicJsonDocument& doc, int limit, const ESPrawFilter& fields) {
+    return fetchPosts(doc, "new", "limit=" + String(limit), fields);
 }
 
-bool Subreddit::top(DynamicJsonDocument& doc, const String& timeFilter, int limit) {
+bool Subreddit::top(DynamicJsonDocument& doc, const String& timeFilter, int limit,
+                    const ESPrawFilter& fields) {
     String params = "limit=" + String(limit) + "&t=" + timeFilter;
-    return fetchPosts(doc, "top", params);
+    return fetchPosts(doc, "top", params, fields);
 }
 
-bool Subreddit::rising(DynamicJsonDocument& doc, int limit) {
-    return fetchPosts(doc, "rising", "limit=" + String(limit));
+bool Subreddit::rising(DynamicJsonDocument& doc, int limit, const ESPrawFilter& fields) {
+    return fetchPosts(doc, "rising", "limit=" + String(limit), fields);
 }
 
-bool Subreddit::controversial(DynamicJsonDocument& doc, const String& timeFilter, int limit) {
+bool Subreddit::controversial(DynamicJsonDocument& doc, const String& timeFilter, int limit,
+                              const ESPrawFilter& fields) {
     String params = "limit=" + String(limit) + "&t=" + timeFilter;
-    return fetchPosts(doc, "controversial", params);
+    return fetchPosts(doc, "controversial", params, fields);
 }
 
-bool Subreddit::fetchPosts(DynamicJsonDocument& doc, const String& sort, const String& params) {
+bool Subreddit::fetchPosts(DynamicJsonDocument& doc, const String& sort, const String& params,
+                           const ESPrawFilter& fields) {
     if (!_espraw || _displayName.isEmpty()) {
         return false;
     }
     
     String endpoint = "/r/" + _displayName + "/" + sort;
-    ESPrawResponse response = _espraw->get(endpoint, params);
     
-    if (!response.success) {
-        return false;
+    if (!fields.isEnabled()) {
+        return _espraw->getJson(endpoint, doc, params).success;
     }
     
-    DeserializationError error = deserializeJson(doc, response.body);
-    return !error;
+    DynamicJsonDocument filter(fields.capacity());
+    fields.buildListing(filter);
+    
+    ESPrawResponse response = _espraw->getJson(endpoint, doc, params, &filter);
+    return response.success;
+}
+
+ListingIterator Subreddit::listing(const String& sort, const String& timeFilter) {
+    String params = timeFilter.isEmpty() ? String("") : "t=" + timeFilter;
+    return ListingIterator(_espraw, "/r/" + _displayName + "/" + sort, params);
 }
 
 bool Subreddit::submitText(const String& title, const String& text) {
@@ -131,24 +141,32 @@ bool Subreddit::fetch() {
     }
     
     String endpoint = "/r/" + _displayName + "/about";
-    ESPrawResponse response = _espraw->get(endpoint);
-    
-    if (!response.success) {
+    DynamicJsonDocument doc(4096);
+    if (!fetchAbout(endpoint, doc)) {
         return false;
     }
     
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, response.body);
-    
-    if (error) {
-        return false;
+    parseData(doc["data"].as<JsonObject>());
+    return true;
+}
+
+const SubredditView* Subreddit::fetch(ESPrawArena& arena) {
+    if (!_espraw || _displayName.isEmpty()) {
+        return nullptr;
     }
     
-    if (doc.containsKey("data")) {
-        JsonObject data = doc["data"].as<JsonObject>();
-        parseData(data);
-        return true;
+    DynamicJsonDocument doc(4096);
+    if (!fetchAbout("/r/" + _displayName + "/about", doc)) {
+        return nullptr;
     }
     
-    return false;
+    return SubredditView::create(arena, doc["data"].as<JsonObject>());
+}
+
+bool Subreddit::fetchAbout(const String& endpoint, JsonDocument& doc) {
+    DynamicJsonDocument filter(ESPrawFilter::subreddit().capacity());
+    ESPrawFilter::subreddit().buildThing(filter);
+    
+    ESPrawResponse response = _espraw->getJson(endpoint, doc, "", &filter);
+    return response.success && doc.containsKey("data");
 }
@@ -10,6 +10,9 @@
 #include "RedditBase.h"
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "../ESPrawFilter.h"
+#include "ListingIterator.h"
+#include "ModelViews.h"
 
 /**
  * Subreddit - Represents a Reddit subreddit
@@ -30,11 +33,6 @@ public:
      */
     Subreddit(ESPraw* espraw, JsonObject data);
     
-    /**
-     * Destructor
-     */
-    ~Subreddit();
-    
     /**
      * Parse subreddit data from JSON
      * @param data JSON object
@@ -42,11 +40,11 @@ public:
     void parseData(JsonObject data) override;
     
     // Getters
-    String getName() const { return _displayName; }
-    String getDisplayName() const { return _displayName; }
-    String getTitle() const { return _title; }
-    String getDescription() const { return _description; }
-    String getPublicDescription() const { return _publicDescription; }
+    const String& getName() const { return _displayName; }
+    const String& getDisplayName() const { return _displayName; }
+    const String& getTitle() const { return _title; }
+    const String& getDescription() const { return _description; }
+    const String& getPublicDescription() const { return _publicDescription; }
     int getSubscribers() const { return _subscribers; }
     int getActiveUsers() const { return _activeUsers; }
     bool isOver18() const { return _over18; }
@@ -56,43 +54,61 @@ public:
      * Fetch hot posts from subreddit
      * @param doc JSON document to store results
      * @param limit Maximum number of posts
+     * @param fields Fields to keep for each post (ESPrawFilter::none() keeps all)
      * @return true if successful
      */
-    bool hot(DynamicJsonDocument& doc, int limit = 25);
+    bool hot(DynamicJsonDocument& doc, int limit = 25,
+             const ESPrawFilter& fields = ESPrawFilter::submission());
     
     /**
      * Fetch new posts from subreddit
      * @param doc JSON document to store results
      * @param limit Maximum number of posts
+     * @param fields Fields to keep for each post (ESPrawFilter::none() keeps all)
      * @return true if successful
      */
-    bool new_(DynamicJsonDocument& doc, int limit = 25);
+    bool new_(DynamicJsonDocument& doc, int limit = 25,
+              const ESPrawFilter& fields = ESPrawFilter::submission());
     
     /**
      * Fetch top posts from subreddit
      * @param doc JSON document to store results
      * @param timeFilter Time filter (hour, day, week, month, year, all)
      * @param limit Maximum number of posts
+     * @param fields Fields to keep for each post (ESPrawFilter::none() keeps all)
      * @return true if successful
      */
-    bool top(DynamicJsonDocument& doc, const String& timeFilter = "day", int limit = 25);
+    bool top(DynamicJsonDocument& doc, const String& timeFilter = "day", int limit = 25,
+             const ESPrawFilter& fields = ESPrawFilter::submission());
     
     /**
      * Fetch rising posts from subreddit
      * @param doc JSON document to store results
      * @param limit Maximum number of posts
+     * @param fields Fields to keep for each post (ESPrawFilter::none() keeps all)
      * @return true if successful
      */
-    bool rising(DynamicJsonDocument& doc, int limit = 25);
+    bool rising(DynamicJsonDocument& doc, int limit = 25,
+                const ESPrawFilter& fields = ESPrawFilter::submission());
     
     /**
      * Fetch controversial posts from subreddit
      * @param doc JSON document to store results
      * @param timeFilter Time filter (hour, day, week, month, year, all)
      * @param limit Maximum number of posts
+     * @param fields Fields to keep for each post (ESPrawFilter::none() keeps all)
      * @return true if successful
      */
-    bool controversial(DynamicJsonDocument& doc, const String& timeFilter = "day", int limit = 25);
+    bool controversial(DynamicJsonDocument& doc, const String& timeFilter = "day", int limit = 25,
+                       const ESPrawFilter& fields = ESPrawFilter::submission());
+    
+    /**
+     * Get a streaming iterator over this subreddit's posts
+     * @param sort Sort type (hot, new, top, rising, controversial)
+     * @param timeFilter Time filter for top/controversial (hour, day, week, month, year, all)
+     * @return Listing iterator that follows pagination automatically
+     */
+    ListingIterator listing(const String& sort = "hot", const String& timeFilter = "");
     
     /**
      * Submit a text post to this subreddit
@@ -127,6 +143,13 @@ public:
      * @return true if successful
      */
     bool fetch();
+    
+    /**
+     * Fetch full subreddit info from Reddit into a view in an arena, leaving this object unchanged
+     * @param arena Arena to store the view in
+     * @return View, or nullptr on failure or if the arena is full
+     */
+    const SubredditView* fetch(ESPrawArena& arena);
 
 private:
     String _displayName;
@@ -138,14 +161,24 @@ private:
     bool _over18;
     bool _userIsSubscriber;
     
+    /**
+     * Request the about page
+     * @param endpoint About endpoint
+     * @param doc Document to store the filtered response
+     * @return true if a data object was received
+     */
+    bool fetchAbout(const String& endpoint, JsonDocument& doc);
+    
     /**
      * Fetch posts with a specific sorting
      * @param doc JSON document to store results
      * @param sort Sort type (hot, new, top, etc.)
      * @param params Additional parameters
+     * @param fields Fields to keep for each post
      * @return true if successful
      */
-    bool fetchPosts(DynamicJsonDocument& doc, const String& sort, const String& params = "");
+    bool fetchPosts(DynamicJsonDocument& doc, const String& sort, const String& params,
+                    const ESPrawFilter& fields);
     
     /**
      * Perform subscription action
@@ -0,0 +1,157 @@
+/**
+ * Arduino.h - Host (Linux) stand-in for the Arduino core
+ * 
+ * Provides the parts of the Arduino API that ESPraw uses, so the library
+ * sources compile and run on Linux for unit tests and benchmarks. Serial
+ * writes to stderr, which keeps stdout free for test and benchmark output.
+ */
+
+#ifndef ESPRAW_HAL_ARDUINO_H
+#define ESPRAW_HAL_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <chrono>
+#include <thread>
+#include "WString.h"
+#include "Esp.h"
+
+// Number bases for String(value, base) and print()
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+inline unsigned long millis() {
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return (unsigned long)duration_cast<milliseconds>(steady_clock::now() - start).count();
+}
+
+inline unsigned long micros() {
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return (unsigned long)duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+inline void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline void yield() {
+    std::this_thread::yield();
+}
+
+/**
+ * Print - Base class for byte sinks
+ */
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) {
+            if (!write(*buffer++)) {
+                break;
+            }
+            n++;
+        }
+        return n;
+    }
+    virtual void flush() {}
+    
+    size_t print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int n) { return print(String(n)); }
+    size_t print(unsigned int n) { return print(String(n)); }
+    size_t print(long n) { return print(String(n)); }
+    size_t print(unsigned long n) { return print(String(n)); }
+    size_t print(double n, int decimals = 2) { return print(String(n, decimals)); }
+    
+    size_t println() { return print("\r\n"); }
+    template <typename T>
+    size_t println(const T& value) { return print(value) + println(); }
+    
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char buffer[256];
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        if (length < 0) {
+            return 0;
+        }
+        return write((const uint8_t*)buffer, (size_t)length < sizeof(buffer) ? length : sizeof(buffer) - 1);
+    }
+};
+
+/**
+ * Stream - Base class for byte sources
+ */
+class Stream : public Print {
+public:
+    Stream() : _timeout(1000) {}
+    
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    unsigned long getTimeout() const { return _timeout; }
+    
+    virtual size_t readBytes(char* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length) {
+            int c = timedRead();
+            if (c < 0) {
+                break;
+            }
+            *buffer++ = (char)c;
+            count++;
+        }
+        return count;
+    }
+    
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        return readBytes((char*)buffer, length);
+    }
+
+protected:
+    int timedRead() {
+        unsigned long start = millis();
+        do {
+            int c = read();
+            if (c >= 0) {
+                return c;
+            }
+        } while (millis() - start < _timeout);
+        return -1;
+    }
+    
+    unsigned long _timeout;
+};
+
+/**
+ * HardwareSerial - Serial port, written to stderr on the host
+ */
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override { return fputc(c, stderr) == EOF ? 0 : 1; }
+    size_t write(const uint8_t* buffer, size_t size) override { return fwrite(buffer, 1, size, stderr); }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    operator bool() const { return true; }
+};
+
+static HardwareSerial Serial;
+
+#endif // ESPRAW_HAL_ARDUINO_H
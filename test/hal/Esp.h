@@ -0,0 +1,149 @@
+/**
+ * Esp.h - Host (Linux) stand-in for the ESP32 `ESP` object
+ *
+ * Heap figures come from a counting allocator: malloc and friends (and
+ * with them operator new, String and ArduinoJson) are replaced with glibc's
+ * implementation plus counters, and the host pretends to have an ESP32's
+ * 320 KB heap. There is no fragmentation model, so the largest free block
+ * is the whole free heap.
+ *
+ * The counters are kept per thread as well, which the ESP32 cannot do;
+ * ESPrawHeapProbe reads them through the getThread*() methods.
+ */
+
+#ifndef ESPRAW_HAL_ESP_H
+#define ESPRAW_HAL_ESP_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <malloc.h>
+#include <atomic>
+
+#define ESPRAW_HAL_HEAP_SIZE 327680
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+}
+
+/**
+ * Allocation counters of one thread
+ */
+struct EspHalHeapCounters {
+    unsigned long allocations;   // malloc/calloc/realloc calls
+    unsigned long bytes;         // Bytes requested
+    long live;                   // Allocated minus freed by this thread
+    long peak;                   // Highest live since resetThreadPeakHeap()
+};
+
+/**
+ * Process-wide and per-thread counters, shared by every translation unit
+ */
+struct EspHalHeap {
+    static std::atomic<long>& live() {
+        static std::atomic<long> value(0);
+        return value;
+    }
+
+    static std::atomic<long>& peak() {
+        static std::atomic<long> value(0);
+        return value;
+    }
+
+    static EspHalHeapCounters& thread() {
+        static __thread EspHalHeapCounters counters = { 0, 0, 0, 0 };
+        return counters;
+    }
+
+    static void allocated(void* ptr, size_t requested) {
+        if (ptr == nullptr) {
+            return;
+        }
+        long size = (long)malloc_usable_size(ptr);
+        long now = live().fetch_add(size, std::memory_order_relaxed) + size;
+        long highest = peak().load(std::memory_order_relaxed);
+        while (now > highest && !peak().compare_exchange_weak(highest, now, std::memory_order_relaxed)) {
+        }
+
+        EspHalHeapCounters& counters = thread();
+        counters.allocations++;
+        counters.bytes += requested;
+        counters.live += size;
+        if (counters.live > counters.peak) {
+            counters.peak = counters.live;
+        }
+    }
+
+    static void released(void* ptr) {
+        if (ptr == nullptr) {
+            return;
+        }
+        long size = (long)malloc_usable_size(ptr);
+        live().fetch_sub(size, std::memory_order_relaxed);
+        thread().live -= size;
+    }
+};
+
+extern "C" {
+
+__attribute__((weak)) void* malloc(size_t size) noexcept {
+    void* ptr = __libc_malloc(size);
+    EspHalHeap::allocated(ptr, size);
+    return ptr;
+}
+
+__attribute__((weak)) void* calloc(size_t count, size_t size) noexcept {
+    void* ptr = __libc_calloc(count, size);
+    EspHalHeap::allocated(ptr, count * size);
+    return ptr;
+}
+
+__attribute__((weak)) void* realloc(void* old, size_t size) noexcept {
+    size_t oldSize = old != nullptr ? malloc_usable_size(old) : 0;
+    void* ptr = __libc_realloc(old, size);
+    if (ptr == nullptr && size > 0) {
+        return ptr;   // Failed; the old block is untouched
+    }
+    if (old != nullptr) {
+        EspHalHeap::live().fetch_sub((long)oldSize, std::memory_order_relaxed);
+        EspHalHeap::thread().live -= (long)oldSize;
+    }
+    EspHalHeap::allocated(ptr, size);
+    return ptr;
+}
+
+__attribute__((weak)) void free(void* ptr) noexcept {
+    EspHalHeap::released(ptr);
+    __libc_free(ptr);
+}
+
+}
+
+/**
+ * EspClass - Chip and heap information
+ */
+class EspClass {
+public:
+    uint32_t getHeapSize() { return ESPRAW_HAL_HEAP_SIZE; }
+    uint32_t getFreeHeap() { return remaining(EspHalHeap::live().load()); }
+    uint32_t getMinFreeHeap() { return remaining(EspHalHeap::peak().load()); }
+    uint32_t getMaxAllocHeap() { return getFreeHeap(); }
+
+    // Host only: counters of the calling thread
+    unsigned long getThreadAllocations() { return EspHalHeap::thread().allocations; }
+    unsigned long getThreadBytesAllocated() { return EspHalHeap::thread().bytes; }
+    long getThreadHeapUsed() { return EspHalHeap::thread().live; }
+    long getThreadPeakHeap() { return EspHalHeap::thread().peak; }
+    void resetThreadPeakHeap() { EspHalHeap::thread().peak = EspHalHeap::thread().live; }
+
+private:
+    static uint32_t remaining(long used) {
+        return used >= ESPRAW_HAL_HEAP_SIZE ? 0 : (uint32_t)(ESPRAW_HAL_HEAP_SIZE - used);
+    }
+};
+
+static EspClass ESP __attribute__((unused));
+
+#endif // ESPRAW_HAL_ESP_H
@@ -0,0 +1,382 @@
+/**
+ * HTTPClient.h - Host (Linux) stand-in for the ESP32 HTTPClient
+ *
+ * An HTTP/1.1 client over any WiFiClient with the ESP32 HTTPClient API and
+ * the behaviour ESPraw relies on: keep-alive reuse controlled by
+ * setReuse() and the server's Connection header, only collected response
+ * headers kept, getStream() handing out the raw connection (still chunked
+ * when the server chunks), getSize() of -1 without a Content-Length, and
+ * end() discarding buffered input before keeping or closing the socket.
+ *
+ * Unlike the ESP32 client, addHeader("User-Agent", ...) sets the user
+ * agent instead of being ignored.
+ */
+
+#ifndef ESPRAW_HAL_HTTPCLIENT_H
+#define ESPRAW_HAL_HTTPCLIENT_H
+
+#include "Arduino.h"
+#include "WiFiClient.h"
+#include <vector>
+#include <utility>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED  (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED  (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED       (-4)
+#define HTTPC_ERROR_CONNECTION_LOST     (-5)
+#define HTTPC_ERROR_NO_STREAM           (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER      (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM        (-8)
+#define HTTPC_ERROR_ENCODING            (-9)
+#define HTTPC_ERROR_STREAM_WRITE        (-10)
+#define HTTPC_ERROR_READ_TIMEOUT        (-11)
+
+#define HTTP_CODE_OK 200
+
+/**
+ * HTTPClient - HTTP/1.1 requests over a caller-owned connection
+ */
+class HTTPClient {
+public:
+    HTTPClient()
+        : _client(nullptr), _port(80), _reuse(true), _canReuse(false), _timeout(5000),
+          _userAgent("ESP32HTTPClient"), _size(-1), _chunked(false) {}
+
+    /**
+     * Prepare a request; the connection is opened (or reused) when it is sent
+     * @param client Connection to use
+     * @param url http:// or https:// URL
+     * @return false if the URL can't be parsed
+     */
+    bool begin(WiFiClient& client, const String& url) {
+        _client = &client;
+        _headers = "";
+        _size = -1;
+        _chunked = false;
+        for (size_t i = 0; i < _collected.size(); i++) {
+            _collected[i].second = "";
+        }
+        return parseUrl(url);
+    }
+
+    void end() {
+        if (!connected()) {
+            return;
+        }
+
+        while (_client->available() > 0) {
+            _client->read();
+        }
+        if (!_reuse || !_canReuse) {
+            _client->stop();
+        }
+    }
+
+    bool connected() {
+        return _client != nullptr && _client->connected();
+    }
+
+    void setReuse(bool reuse) { _reuse = reuse; }
+    void setTimeout(uint32_t timeout) { _timeout = timeout; }
+    void setUserAgent(const String& userAgent) { _userAgent = userAgent; }
+
+    void addHeader(const String& name, const String& value) {
+        if (name.equalsIgnoreCase("User-Agent")) {
+            _userAgent = value;
+        } else if (!name.equalsIgnoreCase("Connection") && !name.equalsIgnoreCase("Host")) {
+            _headers += name + ": " + value + "\r\n";
+        }
+    }
+
+    void collectHeaders(const char* keys[], const size_t count) {
+        _collected.clear();
+        for (size_t i = 0; i < count; i++) {
+            _collected.push_back(std::make_pair(String(keys[i]), String()));
+        }
+    }
+
+    String header(const char* name) {
+        for (size_t i = 0; i < _collected.size(); i++) {
+            if (_collected[i].first.equalsIgnoreCase(name)) {
+                return _collected[i].second;
+            }
+        }
+        return String();
+    }
+
+    bool hasHeader(const char* name) {
+        return header(name).length() > 0;
+    }
+
+    int GET() { return sendRequest("GET"); }
+    int POST(const String& payload) { return sendRequest("POST", payload); }
+    int PUT(const String& payload) { return sendRequest("PUT", payload); }
+
+    /**
+     * Send a request and read the response headers
+     * @param type HTTP method
+     * @param payload Request body (optional)
+     * @return HTTP status code, or a negative HTTPC_ERROR_* code
+     */
+    int sendRequest(const char* type, const String& payload = String()) {
+        if (_client == nullptr) {
+            return HTTPC_ERROR_NOT_CONNECTED;
+        }
+
+        if (!connected()) {
+            _client->stop();
+            if (!_client->connect(_host.c_str(), _port)) {
+                return HTTPC_ERROR_CONNECTION_REFUSED;
+            }
+        } else {
+            // Leftovers of an earlier response would be taken for this one
+            while (_client->available() > 0) {
+                _client->read();
+            }
+        }
+
+        String request = String(type) + " " + _uri + " HTTP/1.1\r\nHost: " + _host;
+        if (_port != 80 && _port != 443) {
+            request += ":" + String((unsigned int)_port);
+        }
+        request += "\r\nUser-Agent: " + _userAgent + "\r\n";
+        request += _reuse ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+        request += "Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n";
+        request += _headers;
+        if (payload.length() > 0) {
+            request += "Content-Length: " + String(payload.length()) + "\r\n";
+        }
+        request += "\r\n";
+
+        if (_client->write((const uint8_t*)request.c_str(), request.length()) != request.length()) {
+            return HTTPC_ERROR_SEND_HEADER_FAILED;
+        }
+        if (payload.length() > 0 &&
+            _client->write((const uint8_t*)payload.c_str(), payload.length()) != payload.length()) {
+            return HTTPC_ERROR_SEND_PAYLOAD_FAILED;
+        }
+
+        return readResponseHeaders();
+    }
+
+    int getSize() { return _size; }
+
+    WiFiClient& getStream() { return *_client; }
+    WiFiClient* getStreamPtr() { return _client; }
+
+    /**
+     * Read the whole response body, decoding chunked transfer encoding
+     * @return Response body
+     */
+    String getString() {
+        String body;
+        if (!connected() && (_client == nullptr || _client->available() == 0)) {
+            return body;
+        }
+
+        if (_size > 0) {
+            body.reserve(_size);
+        }
+
+        if (_chunked) {
+            String line;
+            while (readLine(line)) {
+                long chunk = strtol(line.c_str(), nullptr, 16);
+                if (chunk <= 0) {
+                    readLine(line); // Blank line after the last chunk
+                    break;
+                }
+                if (!readBody(body, chunk) || !readLine(line)) {
+                    break;
+                }
+            }
+        } else if (_size >= 0) {
+            readBody(body, _size);
+        } else {
+            readBody(body, -1);
+        }
+        return body;
+    }
+
+    static String errorToString(int error) {
+        switch (error) {
+            case HTTPC_ERROR_CONNECTION_REFUSED: return "connection refused";
+            case HTTPC_ERROR_SEND_HEADER_FAILED: return "send header failed";
+            case HTTPC_ERROR_SEND_PAYLOAD_FAILED: return "send payload failed";
+            case HTTPC_ERROR_NOT_CONNECTED: return "not connected";
+            case HTTPC_ERROR_CONNECTION_LOST: return "connection lost";
+            case HTTPC_ERROR_NO_STREAM: return "no stream";
+            case HTTPC_ERROR_NO_HTTP_SERVER: return "no HTTP server";
+            case HTTPC_ERROR_TOO_LESS_RAM: return "too less ram";
+            case HTTPC_ERROR_ENCODING: return "Transfer-Encoding not supported";
+            case HTTPC_ERROR_STREAM_WRITE: return "Stream write error";
+            case HTTPC_ERROR_READ_TIMEOUT: return "read Timeout";
+            default: return String();
+        }
+    }
+
+private:
+    bool parseUrl(const String& url) {
+        int schemeEnd = url.indexOf("://");
+        if (schemeEnd < 0) {
+            return false;
+        }
+
+        String scheme = url.substring(0, schemeEnd);
+        if (scheme == "http") {
+            _port = 80;
+        } else if (scheme == "https") {
+            _port = 443;
+        } else {
+            return false;
+        }
+
+        int hostStart = schemeEnd + 3;
+        int pathStart = url.indexOf('/', hostStart);
+        String hostPort = pathStart < 0 ? url.substring(hostStart) : url.substring(hostStart, pathStart);
+        _uri = pathStart < 0 ? String("/") : url.substring(pathStart);
+
+        int colon = hostPort.indexOf(':');
+        if (colon >= 0) {
+            _port = (uint16_t)hostPort.substring(colon + 1).toInt();
+            hostPort = hostPort.substring(0, colon);
+        }
+        _host = hostPort;
+        return _host.length() > 0;
+    }
+
+    int readResponseHeaders() {
+        int code = 0;
+        bool http10 = false;
+        _canReuse = _reuse;
+
+        String line;
+        while (true) {
+            if (!readLine(line)) {
+                return connected() ? HTTPC_ERROR_READ_TIMEOUT : HTTPC_ERROR_CONNECTION_LOST;
+            }
+            line.trim();
+
+            if (code == 0) {
+                if (!line.startsWith("HTTP/1.")) {
+                    return HTTPC_ERROR_NO_HTTP_SERVER;
+                }
+                http10 = line.startsWith("HTTP/1.0");
+                code = line.substring(9, 12).toInt();
+                continue;
+            }
+
+            if (line.length() == 0) {
+                break;
+            }
+
+            int colon = line.indexOf(':');
+            if (colon <= 0) {
+                continue;
+            }
+            String name = line.substring(0, colon);
+            String value = line.substring(colon + 1);
+            value.trim();
+
+            if (name.equalsIgnoreCase("Content-Length")) {
+                _size = value.toInt();
+            } else if (name.equalsIgnoreCase("Transfer-Encoding")) {
+                _chunked = value.equalsIgnoreCase("chunked");
+            } else if (name.equalsIgnoreCase("Connection")) {
+                if (value.equalsIgnoreCase("close")) {
+                    _canReuse = false;
+                } else if (value.equalsIgnoreCase("keep-alive")) {
+                    http10 = false;
+                }
+            }
+
+            for (size_t i = 0; i < _collected.size(); i++) {
+                if (_collected[i].first.equalsIgnoreCase(name)) {
+                    _collected[i].second = value;
+                }
+            }
+        }
+
+        if (http10) {
+            _canReuse = false;
+        }
+        if (_chunked) {
+            _size = -1;
+        }
+        return code > 0 ? code : HTTPC_ERROR_NO_HTTP_SERVER;
+    }
+
+    /**
+     * Wait up to the timeout for the next byte
+     * @return Byte, or -1 on timeout or closed connection
+     */
+    int nextByte() {
+        unsigned long start = millis();
+        while (true) {
+            int c = _client->read();
+            if (c >= 0) {
+                return c;
+            }
+            if (!_client->connected() || millis() - start >= _timeout) {
+                return -1;
+            }
+            yield();
+        }
+    }
+
+    bool readLine(String& line) {
+        line = "";
+        while (true) {
+            int c = nextByte();
+            if (c < 0) {
+                return false;
+            }
+            if (c == '\n') {
+                return true;
+            }
+            line += (char)c;
+        }
+    }
+
+    /**
+     * Append body bytes
+     * @param length Bytes to read, or -1 to read until the connection closes
+     * @return true if all bytes were read
+     */
+    bool readBody(String& body, long length) {
+        char buffer[512];
+        while (length != 0) {
+            size_t want = length < 0 || length > (long)sizeof(buffer) ? sizeof(buffer) : (size_t)length;
+            int n = _client->read((uint8_t*)buffer, want);
+            if (n <= 0) {
+                int c = nextByte();
+                if (c < 0) {
+                    return length < 0;
+                }
+                buffer[0] = (char)c;
+                n = 1;
+            }
+            body.concat(buffer, n);
+            if (length > 0) {
+                length -= n;
+            }
+        }
+        return true;
+    }
+
+    WiFiClient* _client;
+    String _host;
+    uint16_t _port;
+    String _uri;
+    bool _reuse;
+    bool _canReuse;
+    uint32_t _timeout;
+    String _userAgent;
+    String _headers;
+    std::vector<std::pair<String, String> > _collected;
+    int _size;
+    bool _chunked;
+};
+
+#endif // ESPRAW_HAL_HTTPCLIENT_H
@@ -0,0 +1,41 @@
+/**
+ * IPAddress.h - Host (Linux) stand-in for the Arduino IPAddress class
+ *
+ * IPv4 only, like the parts of the ESP32 core ESPraw uses.
+ */
+
+#ifndef ESPRAW_HAL_IPADDRESS_H
+#define ESPRAW_HAL_IPADDRESS_H
+
+#include "Arduino.h"
+
+/**
+ * IPAddress - IPv4 address
+ */
+class IPAddress {
+public:
+    IPAddress() { memset(_bytes, 0, sizeof(_bytes)); }
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+        _bytes[0] = a;
+        _bytes[1] = b;
+        _bytes[2] = c;
+        _bytes[3] = d;
+    }
+
+    uint8_t operator[](int index) const { return _bytes[index]; }
+    uint8_t& operator[](int index) { return _bytes[index]; }
+
+    bool operator==(const IPAddress& other) const { return memcmp(_bytes, other._bytes, 4) == 0; }
+    bool operator!=(const IPAddress& other) const { return !(*this == other); }
+
+    String toString() const {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", _bytes[0], _bytes[1], _bytes[2], _bytes[3]);
+        return String(buffer);
+    }
+
+private:
+    uint8_t _bytes[4];
+};
+
+#endif // ESPRAW_HAL_IPADDRESS_H
@@ -0,0 +1,154 @@
+/**
+ * WString.h - Host stand-in for the Arduino String class
+ * 
+ * Backed by std::string; covers the subset of the Arduino String API
+ * used by ESPraw.
+ */
+
+#ifndef ESPRAW_HAL_WSTRING_H
+#define ESPRAW_HAL_WSTRING_H
+
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+class String {
+public:
+    String() {}
+    String(const char* str) : _str(str ? str : "") {}
+    String(const char* str, unsigned int length) : _str(str, length) {}
+    String(const std::string& str) : _str(str) {}
+    explicit String(char c) : _str(1, c) {}
+    explicit String(int value, unsigned char base = 10) : _str(format((long)value, base)) {}
+    explicit String(unsigned int value, unsigned char base = 10) : _str(formatUnsigned(value, base)) {}
+    explicit String(long value, unsigned char base = 10) : _str(format(value, base)) {}
+    explicit String(unsigned long value, unsigned char base = 10) : _str(formatUnsigned(value, base)) {}
+    explicit String(long long value) : _str(std::to_string(value)) {}
+    explicit String(unsigned long long value) : _str(std::to_string(value)) {}
+    explicit String(float value, unsigned int decimals = 2) : _str(formatFloat(value, decimals)) {}
+    explicit String(double value, unsigned int decimals = 2) : _str(formatFloat(value, decimals)) {}
+    
+    const char* c_str() const { return _str.c_str(); }
+    unsigned int length() const { return _str.size(); }
+    bool isEmpty() const { return _str.empty(); }
+    bool reserve(unsigned int size) { _str.reserve(size); return true; }
+    void clear() { _str.clear(); }
+    
+    char charAt(unsigned int index) const { return index < _str.size() ? _str[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return _str[index]; }
+    
+    int indexOf(char c, unsigned int from = 0) const { return find(_str.find(c, from)); }
+    int indexOf(const char* s, unsigned int from = 0) const { return find(_str.find(s, from)); }
+    int indexOf(const String& s, unsigned int from = 0) const { return find(_str.find(s._str, from)); }
+    int lastIndexOf(char c) const { return find(_str.rfind(c)); }
+    int lastIndexOf(const char* s) const { return find(_str.rfind(s)); }
+    
+    String substring(unsigned int from) const {
+        return from < _str.size() ? String(_str.substr(from)) : String();
+    }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) {
+            unsigned int t = from;
+            from = to;
+            to = t;
+        }
+        if (from >= _str.size()) {
+            return String();
+        }
+        return String(_str.substr(from, to - from));
+    }
+    
+    bool startsWith(const String& prefix) const { return _str.compare(0, prefix._str.size(), prefix._str) == 0; }
+    bool endsWith(const String& suffix) const {
+        return _str.size() >= suffix._str.size() &&
+               _str.compare(_str.size() - suffix._str.size(), suffix._str.size(), suffix._str) == 0;
+    }
+    bool equals(const String& other) const { return _str == other._str; }
+    bool equalsIgnoreCase(const String& other) const {
+        return _str.size() == other._str.size() && strcasecmp(_str.c_str(), other._str.c_str()) == 0;
+    }
+    int compareTo(const String& other) const { return _str.compare(other._str); }
+    
+    long toInt() const { return atol(_str.c_str()); }
+    float toFloat() const { return (float)atof(_str.c_str()); }
+    double toDouble() const { return atof(_str.c_str()); }
+    
+    void toLowerCase() { for (size_t i = 0; i < _str.size(); i++) _str[i] = tolower(_str[i]); }
+    void toUpperCase() { for (size_t i = 0; i < _str.size(); i++) _str[i] = toupper(_str[i]); }
+    void trim() {
+        size_t start = _str.find_first_not_of(" \t\r\n");
+        size_t end = _str.find_last_not_of(" \t\r\n");
+        _str = start == std::string::npos ? std::string() : _str.substr(start, end - start + 1);
+    }
+    void remove(unsigned int index, unsigned int count = (unsigned int)-1) {
+        if (index < _str.size()) _str.erase(index, count);
+    }
+    void replace(const String& find, const String& replace) {
+        if (find._str.empty()) return;
+        size_t pos = 0;
+        while ((pos = _str.find(find._str, pos)) != std::string::npos) {
+            _str.replace(pos, find._str.size(), replace._str);
+            pos += replace._str.size();
+        }
+    }
+    
+    bool concat(const String& s) { _str += s._str; return true; }
+    bool concat(const char* s) { if (s) _str += s; return true; }
+    bool concat(const char* s, unsigned int length) { _str.append(s, length); return true; }
+    bool concat(char c) { _str += c; return true; }
+    
+    String& operator+=(const String& s) { _str += s._str; return *this; }
+    String& operator+=(const char* s) { if (s) _str += s; return *this; }
+    String& operator+=(char c) { _str += c; return *this; }
+    String& operator+=(int v) { _str += std::to_string(v); return *this; }
+    String& operator+=(unsigned int v) { _str += std::to_string(v); return *this; }
+    String& operator+=(long v) { _str += std::to_string(v); return *this; }
+    String& operator+=(unsigned long v) { _str += std::to_string(v); return *this; }
+    
+    bool operator==(const String& s) const { return _str == s._str; }
+    bool operator==(const char* s) const { return _str == (s ? s : ""); }
+    bool operator!=(const String& s) const { return _str != s._str; }
+    bool operator!=(const char* s) const { return !(*this == s); }
+    bool operator<(const String& s) const { return _str < s._str; }
+    bool operator>(const String& s) const { return _str > s._str; }
+    
+    friend String operator+(const String& a, const String& b) { return String(a._str + b._str); }
+    friend String operator+(const String& a, const char* b) { return String(a._str + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String((a ? a : "") + b._str); }
+    friend String operator+(const String& a, char b) { return String(a._str + b); }
+    friend String operator+(const String& a, int b) { return String(a._str + std::to_string(b)); }
+    friend String operator+(const String& a, unsigned int b) { return String(a._str + std::to_string(b)); }
+    friend String operator+(const String& a, long b) { return String(a._str + std::to_string(b)); }
+    friend String operator+(const String& a, unsigned long b) { return String(a._str + std::to_string(b)); }
+
+private:
+    static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+    
+    static std::string format(long value, unsigned char base) {
+        if (base == 10) return std::to_string(value);
+        return value < 0 ? "-" + formatUnsigned((unsigned long)-value, base) : formatUnsigned(value, base);
+    }
+    
+    static std::string formatUnsigned(unsigned long value, unsigned char base) {
+        if (base == 10) return std::to_string(value);
+        std::string out;
+        do {
+            int digit = value % base;
+            out.insert(out.begin(), (char)(digit < 10 ? '0' + digit : 'a' + digit - 10));
+            value /= base;
+        } while (value);
+        return out;
+    }
+    
+    static std::string formatFloat(double value, unsigned int decimals) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+        return buffer;
+    }
+    
+    std::string _str;
+};
+
+#endif // ESPRAW_HAL_WSTRING_H
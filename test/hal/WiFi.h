@@ -0,0 +1,59 @@
+/**
+ * WiFi.h - Host (Linux) stand-in for the ESP32 WiFi library
+ *
+ * The host network is always up; host names resolve through getaddrinfo().
+ */
+
+#ifndef ESPRAW_HAL_WIFI_H
+#define ESPRAW_HAL_WIFI_H
+
+#include "Arduino.h"
+#include "WiFiClient.h"
+#include "IPAddress.h"
+#include <arpa/inet.h>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+/**
+ * WiFiClass - Station interface
+ */
+class WiFiClass {
+public:
+    wl_status_t begin(const char*, const char* = nullptr) { return WL_CONNECTED; }
+    wl_status_t status() { return WL_CONNECTED; }
+    bool isConnected() { return true; }
+    bool disconnect(bool = false) { return true; }
+    int8_t RSSI() { return 0; }
+    
+    /**
+     * Resolve a host name to an IPv4 address
+     * @return 1 on success, 0 on failure
+     */
+    int hostByName(const char* host, IPAddress& result) {
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        
+        addrinfo* addresses = nullptr;
+        if (getaddrinfo(host, nullptr, &hints, &addresses) != 0 || addresses == nullptr) {
+            return 0;
+        }
+        
+        const uint8_t* bytes = (const uint8_t*)&((sockaddr_in*)addresses->ai_addr)->sin_addr;
+        result = IPAddress(bytes[0], bytes[1], bytes[2], bytes[3]);
+        freeaddrinfo(addresses);
+        return 1;
+    }
+};
+
+static WiFiClass WiFi __attribute__((unused));
+
+#endif // ESPRAW_HAL_WIFI_H
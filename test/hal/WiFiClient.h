@@ -0,0 +1,218 @@
+/**
+ * WiFiClient.h - Host (Linux) stand-in for the ESP32 WiFiClient
+ *
+ * A TCP connection over POSIX sockets. Like the ESP32 client it reads
+ * through a receive buffer of one TCP segment, never blocks in read() or
+ * available(), and reports the connection as gone once the peer has
+ * closed it and everything it sent has been read.
+ */
+
+#ifndef ESPRAW_HAL_WIFICLIENT_H
+#define ESPRAW_HAL_WIFICLIENT_H
+
+#include "Arduino.h"
+#include "Client.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#define ESPRAW_HAL_RX_BUFFER 1436
+
+/**
+ * WiFiClient - TCP connection
+ */
+class WiFiClient : public Client {
+public:
+    WiFiClient() : _fd(-1), _connectTimeout(3000), _rxStart(0), _rxEnd(0), _eof(false) {}
+
+    virtual ~WiFiClient() {
+        stop();
+    }
+
+    int connect(const char* host, uint16_t port) override {
+        stop();
+
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        char service[8];
+        snprintf(service, sizeof(service), "%u", port);
+
+        addrinfo* addresses = nullptr;
+        if (getaddrinfo(host, service, &hints, &addresses) != 0) {
+            return 0;
+        }
+
+        for (addrinfo* address = addresses; address != nullptr && _fd < 0; address = address->ai_next) {
+            int fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (fd < 0) {
+                continue;
+            }
+            if (connectWithTimeout(fd, address)) {
+                _fd = fd;
+            } else {
+                close(fd);
+            }
+        }
+        freeaddrinfo(addresses);
+
+        if (_fd < 0) {
+            return 0;
+        }
+
+        // Requests are written in pieces; don't let Nagle delay them
+        int one = 1;
+        setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        return 1;
+    }
+
+    void setConnectTimeout(unsigned long timeout) {
+        _connectTimeout = timeout;
+    }
+
+    size_t write(uint8_t c) override {
+        return write(&c, 1);
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        if (_fd < 0) {
+            return 0;
+        }
+
+        size_t sent = 0;
+        while (sent < size) {
+            ssize_t n = send(_fd, buffer + sent, size - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            sent += n;
+        }
+        return sent;
+    }
+
+    int available() override {
+        fill();
+        return _rxEnd - _rxStart;
+    }
+
+    int read() override {
+        if (!fill()) {
+            return -1;
+        }
+        return _rx[_rxStart++];
+    }
+
+    int read(uint8_t* buffer, size_t size) override {
+        size_t count = 0;
+        while (count < size && fill()) {
+            size_t chunk = _rxEnd - _rxStart;
+            if (chunk > size - count) {
+                chunk = size - count;
+            }
+            memcpy(buffer + count, _rx + _rxStart, chunk);
+            _rxStart += chunk;
+            count += chunk;
+        }
+        return count > 0 ? (int)count : -1;
+    }
+
+    int peek() override {
+        if (!fill()) {
+            return -1;
+        }
+        return _rx[_rxStart];
+    }
+
+    // Like the ESP32 client, flush() discards unread input
+    void flush() override {
+        while (fill()) {
+            _rxStart = _rxEnd;
+        }
+    }
+
+    void stop() override {
+        if (_fd >= 0) {
+            close(_fd);
+            _fd = -1;
+        }
+        _rxStart = _rxEnd = 0;
+        _eof = false;
+    }
+
+    uint8_t connected() override {
+        if (_fd < 0) {
+            return 0;
+        }
+        fill();
+        return _rxStart < _rxEnd || !_eof;
+    }
+
+    operator bool() override {
+        return connected();
+    }
+
+private:
+    bool connectWithTimeout(int fd, const addrinfo* address) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+        int result = ::connect(fd, address->ai_addr, address->ai_addrlen);
+        if (result < 0 && errno == EINPROGRESS) {
+            pollfd waiting = { fd, POLLOUT, 0 };
+            int error = 0;
+            socklen_t length = sizeof(error);
+            if (poll(&waiting, 1, (int)_connectTimeout) == 1 &&
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0) {
+                result = 0;
+            }
+        }
+
+        fcntl(fd, F_SETFL, flags);
+        return result == 0;
+    }
+
+    /**
+     * Top up the receive buffer without blocking
+     * @return true if unread data is buffered
+     */
+    bool fill() {
+        if (_rxStart < _rxEnd) {
+            return true;
+        }
+        if (_fd < 0 || _eof) {
+            return false;
+        }
+
+        ssize_t n = recv(_fd, _rx, sizeof(_rx), MSG_DONTWAIT);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            _eof = true;
+            return false;
+        }
+        if (n < 0) {
+            return false;
+        }
+
+        _rxStart = 0;
+        _rxEnd = n;
+        return true;
+    }
+
+    int _fd;
+    unsigned long _connectTimeout;
+    uint8_t _rx[ESPRAW_HAL_RX_BUFFER];
+    size_t _rxStart;
+    size_t _rxEnd;
+    bool _eof;    // Peer closed the connection (or it failed)
+};
+
+#endif // ESPRAW_HAL_WIFICLIENT_H
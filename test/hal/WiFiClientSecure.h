@@ -0,0 +1,24 @@
+/**
+ * WiFiClientSecure.h - Host (Linux) stand-in for the ESP32 WiFiClientSecure
+ *
+ * The host build has no TLS: this is a plain TCP connection with the
+ * WiFiClientSecure API. Point the library at a local plain-HTTP server
+ * (such as the test stand-in) rather than reddit.com.
+ */
+
+#ifndef ESPRAW_HAL_WIFICLIENTSECURE_H
+#define ESPRAW_HAL_WIFICLIENTSECURE_H
+
+#include "WiFiClient.h"
+
+/**
+ * WiFiClientSecure - TCP connection with the TLS client API
+ */
+class WiFiClientSecure : public WiFiClient {
+public:
+    void setInsecure() {}
+    void setCACert(const char*) {}
+    void setHandshakeTimeout(unsigned long) {}
+};
+
+#endif // ESPRAW_HAL_WIFICLIENTSECURE_H
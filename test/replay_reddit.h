@@ -0,0 +1,82 @@
+/**
+ * replay_reddit.h - ESPraw fixture for tests of the whole library
+ *
+ * Authenticates an ESPraw against a token stand-in server and answers its
+ * API requests from a replay transport, so a test controls every response
+ * without the network. Kept apart from standin_server.h, which tests that
+ * don't link the library include as well.
+ *
+ * Usage:
+ *   tokenServer = new StandinServer();
+ *   tokenServer->body = standinTokenBody();
+ *   replay = new ESPrawReplayTransport();
+ *   reddit = beginReplayReddit(*tokenServer, *replay);
+ *   ...
+ *   endReplayReddit(reddit);
+ */
+
+#ifndef REPLAY_REDDIT_H
+#define REPLAY_REDDIT_H
+
+#include <string>
+#include "standin_server.h"
+#include "ESPraw.h"
+
+/**
+ * Token endpoint response
+ * @param accessToken Access token to hand out
+ * @param expiresIn Validity in seconds
+ * @return Response body
+ */
+inline std::string standinTokenBody(const char* accessToken = "token", int expiresIn = 86400) {
+    return std::string("{\"access_token\":\"") + accessToken + "\",\"token_type\":\"bearer\","
+           "\"expires_in\":" + std::to_string(expiresIn) + ",\"scope\":\"*\"}";
+}
+
+/**
+ * Authenticate a new ESPraw against a token server and install a replay
+ * transport for its API requests
+ * @param tokenServer Token server (started here if it isn't yet)
+ * @param replay Transport answering API requests (must outlive the ESPraw)
+ * @param requestConfig Request configuration
+ * @param refreshMargin Background token refresh margin in seconds
+ * @return ESPraw to release with endReplayReddit(), or nullptr on failure
+ */
+inline ESPraw* beginReplayReddit(StandinServer& tokenServer, ESPrawReplayTransport& replay,
+                                 const ESPrawRequestConfig& requestConfig = ESPrawRequestConfig(),
+                                 unsigned long refreshMargin = ESPRAW_TOKEN_REFRESH_MARGIN) {
+    if (tokenServer.port() == 0 && !tokenServer.start()) {
+        return nullptr;
+    }
+
+    ESPrawAuthConfig config;
+    config.clientId = "test";
+    config.clientSecret = "test";
+    config.userAgent = "ESPraw-test";
+    config.readOnlyMode = true;
+    config.refreshMargin = refreshMargin;
+    config.authBaseUrl = "http://127.0.0.1:" + String(tokenServer.port());
+
+    ESPraw* reddit = new ESPraw();
+    if (!reddit->begin(config, requestConfig)) {
+        delete reddit;
+        return nullptr;
+    }
+
+    reddit->getClient().setTransport(&replay);
+    return reddit;
+}
+
+/**
+ * Remove the replay transport and delete an ESPraw from beginReplayReddit()
+ * @param reddit ESPraw to delete (nullptr is ignored)
+ */
+inline void endReplayReddit(ESPraw* reddit) {
+    if (reddit == nullptr) {
+        return;
+    }
+    reddit->getClient().setTransport(nullptr);
+    delete reddit;
+}
+
+#endif // REPLAY_REDDIT_H
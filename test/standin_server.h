@@ -0,0 +1,267 @@
+/**
+ * standin_server.h - Local plain-HTTP stand-in for the Reddit API
+ * 
+ * A tiny single-threaded HTTP/1.1 server bound to 127.0.0.1 on an
+ * ephemeral port. It answers every request with a canned response and
+ * counts accepted connections and served requests, so host tests can
+ * check connection reuse and header handling without the network.
+ * 
+ * The body can be sent with chunked transfer encoding, and the head of
+ * the last request is kept for tests that check what the client sent.
+ * 
+ * It can also drop a request without answering it, the way a server
+ * whose idle timeout races the client's next request does, so stale
+ * keep-alive connections can be reproduced deterministically.
+ * 
+ * With a rate limit budget set it behaves like Reddit's OAuth endpoints:
+ * every response carries X-Ratelimit-Used/Remaining/Reset headers and
+ * requests beyond the budget are answered with 429.
+ */
+
+#ifndef STANDIN_SERVER_H
+#define STANDIN_SERVER_H
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <cstring>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+class StandinServer {
+public:
+    StandinServer()
+        : status(200), body("{}"), chunkSize(0), maxRequestsPerConnection(0),
+          dropAfterRequests(0), rateLimitBudget(0), rateLimitPeriodMs(1000),
+          acceptedConnections(0), requestsServed(0), rateLimited(0),
+          _periodUsed(0),
+          _listenFd(-1), _port(0), _running(false) {}
+    
+    ~StandinServer() {
+        stop();
+    }
+    
+    /**
+     * Bind to an ephemeral loopback port and start serving
+     * @return true if the server is listening
+     */
+    bool start() {
+        _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (_listenFd < 0) {
+            return false;
+        }
+        
+        int one = 1;
+        setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        
+        if (bind(_listenFd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(_listenFd, 8) < 0) {
+            close(_listenFd);
+            _listenFd = -1;
+            return false;
+        }
+        
+        socklen_t len = sizeof(addr);
+        getsockname(_listenFd, (sockaddr*)&addr, &len);
+        _port = ntohs(addr.sin_port);
+        
+        _running = true;
+        _thread = std::thread(&StandinServer::run, this);
+        return true;
+    }
+    
+    /**
+     * Stop serving and join the server thread
+     */
+    void stop() {
+        if (!_running) {
+            return;
+        }
+        _running = false;
+        _thread.join();
+        close(_listenFd);
+        _listenFd = -1;
+    }
+    
+    int port() const { return _port; }
+    
+    /**
+     * Get the request line and headers of the last request served
+     */
+    std::string lastRequest() {
+        std::lock_guard<std::mutex> lock(_lastRequestMutex);
+        return _lastRequest;
+    }
+    
+    // Canned response, set before start()
+    int status;
+    std::string body;
+    std::string extraHeaders;       // Raw "Name: value\r\n" lines
+    size_t chunkSize;               // Send the body in chunks of this size (0 = Content-Length)
+    int maxRequestsPerConnection;   // Close after this many requests (0 = never)
+    int dropAfterRequests;          // Close on the next request after this many, unanswered (0 = never)
+    int rateLimitBudget;            // Requests per period (0 = no rate limit headers)
+    int rateLimitPeriodMs;          // Rate limit period length
+    
+    std::atomic<int> acceptedConnections;
+    std::atomic<int> requestsServed;
+    std::atomic<int> rateLimited;   // Requests answered with 429
+
+private:
+    void run() {
+        while (_running) {
+            if (!waitReadable(_listenFd, 50)) {
+                continue;
+            }
+            int fd = accept(_listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+            acceptedConnections++;
+            serveConnection(fd);
+            close(fd);
+        }
+    }
+    
+    void serveConnection(int fd) {
+        std::string buffer;
+        int served = 0;
+        
+        while (_running) {
+            size_t headerEnd = buffer.find("\r\n\r\n");
+            if (headerEnd == std::string::npos) {
+                if (!waitReadable(fd, 50)) {
+                    continue;
+                }
+                char chunk[1024];
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    return; // Client closed the connection
+                }
+                buffer.append(chunk, n);
+                continue;
+            }
+            
+            std::string head = buffer.substr(0, headerEnd);
+            buffer.erase(0, headerEnd + 4);
+            
+            // Drop a request body if one was sent
+            size_t lengthPos = head.find("Content-Length: ");
+            if (lengthPos != std::string::npos) {
+                size_t length = strtoul(head.c_str() + lengthPos + 16, nullptr, 10);
+                while (buffer.size() < length && _running) {
+                    char chunk[1024];
+                    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                    if (n <= 0) {
+                        return;
+                    }
+                    buffer.append(chunk, n);
+                }
+                buffer.erase(0, length);
+            }
+            
+            if (dropAfterRequests > 0 && served >= dropAfterRequests) {
+                return; // Request read but never answered
+            }
+            
+            {
+                std::lock_guard<std::mutex> lock(_lastRequestMutex);
+                _lastRequest = head;
+            }
+            served++;
+            requestsServed++;
+            
+            bool closeAfter = head.find("Connection: close") != std::string::npos ||
+                              (maxRequestsPerConnection > 0 && served >= maxRequestsPerConnection);
+            
+            int responseStatus = status;
+            std::string headers = extraHeaders;
+            if (rateLimitBudget > 0) {
+                responseStatus = spendBudget(headers);
+            }
+            
+            std::string response = "HTTP/1.1 " + std::to_string(responseStatus) + " OK\r\n" +
+                                   "Content-Type: application/json\r\n" +
+                                   (chunkSize > 0 ? std::string("Transfer-Encoding: chunked\r\n")
+                                                  : "Content-Length: " + std::to_string(body.size()) + "\r\n") +
+                                   headers +
+                                   (closeAfter ? "Connection: close\r\n" : "Connection: keep-alive\r\n") +
+                                   "\r\n" + encodeBody();
+            send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+            
+            if (closeAfter) {
+                return;
+            }
+        }
+    }
+    
+    std::string encodeBody() const {
+        if (chunkSize == 0) {
+            return body;
+        }
+        
+        std::string encoded;
+        for (size_t pos = 0; pos < body.size(); pos += chunkSize) {
+            std::string chunk = body.substr(pos, chunkSize);
+            char size[16];
+            snprintf(size, sizeof(size), "%zx\r\n", chunk.size());
+            encoded += size + chunk + "\r\n";
+        }
+        return encoded + "0\r\n\r\n";
+    }
+    
+    // Account for one request and emit Reddit-style rate limit headers
+    int spendBudget(std::string& headers) {
+        using namespace std::chrono;
+        steady_clock::time_point now = steady_clock::now();
+        long elapsed = duration_cast<milliseconds>(now - _periodStart).count();
+        if (_periodUsed == 0 || elapsed >= rateLimitPeriodMs) {
+            _periodStart = now;
+            _periodUsed = 0;
+            elapsed = 0;
+        }
+        
+        bool allowed = _periodUsed < rateLimitBudget;
+        if (allowed) {
+            _periodUsed++;
+        } else {
+            rateLimited++;
+        }
+        
+        // Reddit reports whole seconds until the period resets
+        long resetSeconds = (rateLimitPeriodMs - elapsed + 999) / 1000;
+        headers += "X-Ratelimit-Used: " + std::to_string(_periodUsed) + ".0\r\n" +
+                   "X-Ratelimit-Remaining: " + std::to_string(rateLimitBudget - _periodUsed) + ".0\r\n" +
+                   "X-Ratelimit-Reset: " + std::to_string(resetSeconds) + "\r\n";
+        return allowed ? status : 429;
+    }
+    
+    static bool waitReadable(int fd, int timeoutMs) {
+        pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        return poll(&pfd, 1, timeoutMs) > 0;
+    }
+    
+    std::mutex _lastRequestMutex;
+    std::string _lastRequest;
+    int _periodUsed;
+    std::chrono::steady_clock::time_point _periodStart;
+    int _listenFd;
+    int _port;
+    std::atomic<bool> _running;
+    std::thread _thread;
+};
+
+#endif // STANDIN_SERVER_H
@@ -0,0 +1,122 @@
+/**
+ * test_espraw_arena.cpp - Unit tests for the view arena
+ *
+ * Allocation counts come from the counting allocator behind the host
+ * ESP stand-in.
+ */
+
+#include <unity.h>
+#include <Esp.h>
+#include "ESPrawArena.h"
+
+struct TestRecord {
+    ESPrawText name;
+    uint32_t value;
+    uint8_t flag;
+};
+
+// Test: Records are aligned, zeroed and laid out back to back
+void test_records_form_array() {
+    ESPrawArena arena(1024);
+    ESPrawViewList<TestRecord> list;
+
+    for (int i = 0; i < 5; i++) {
+        TestRecord* record = (TestRecord*)arena.allocateRecord(sizeof(TestRecord));
+        TEST_ASSERT_NOT_NULL(record);
+        TEST_ASSERT_EQUAL(0, (int)((uintptr_t)record % sizeof(void*)));
+        TEST_ASSERT_EQUAL(0, (int)record->value);
+        record->value = i;
+        TEST_ASSERT_TRUE(list.append(record));
+    }
+
+    TEST_ASSERT_EQUAL(5, (int)list.size());
+    int expected = 0;
+    for (const TestRecord& record : list) {
+        TEST_ASSERT_EQUAL(expected++, (int)record.value);
+    }
+    TEST_ASSERT_EQUAL(5 * sizeof(TestRecord), arena.used());
+
+    // A record that doesn't follow the list is refused
+    arena.allocateRecord(8);
+    TestRecord* apart = (TestRecord*)arena.allocateRecord(sizeof(TestRecord));
+    TEST_ASSERT_FALSE(list.append(apart));
+}
+
+// Test: Text is copied to the back of the block and terminated
+void test_text() {
+    ESPrawArena arena(256);
+    ESPrawText first;
+    ESPrawText second;
+
+    const char* source = "hello world";
+    TEST_ASSERT_TRUE(arena.copyText(source, 5, first));
+    TEST_ASSERT_TRUE(arena.copyText("esp32", 5, second));
+    TEST_ASSERT_EQUAL_STRING("hello", first.c_str());
+    TEST_ASSERT_EQUAL(5, first.length);
+    TEST_ASSERT_TRUE(first.c_str() != source);
+    TEST_ASSERT_TRUE(second.equals("esp32"));
+    TEST_ASSERT_EQUAL_STRING("esp32", second.toString().c_str());
+    TEST_ASSERT_EQUAL(12, (int)arena.used());
+
+    // Missing or empty text takes no space
+    ESPrawText missing;
+    TEST_ASSERT_TRUE(arena.copyText(nullptr, 0, missing));
+    TEST_ASSERT_TRUE(missing.isEmpty());
+    TEST_ASSERT_EQUAL_STRING("", missing.c_str());
+    TEST_ASSERT_EQUAL(12, (int)arena.used());
+}
+
+// Test: Failed allocations are reported and reset() frees everything
+void test_full_and_reset() {
+    ESPrawArena arena(64);
+    ESPrawText text;
+
+    TEST_ASSERT_NOT_NULL(arena.allocateRecord(32));
+    TEST_ASSERT_TRUE(arena.copyText("0123456789", 10, text));
+    TEST_ASSERT_FALSE(arena.isFull());
+
+    // Records and text share the space between them
+    TEST_ASSERT_NULL(arena.allocateRecord(32));
+    TEST_ASSERT_FALSE(arena.copyText("0123456789012345678901", 22, text));
+    TEST_ASSERT_TRUE(text.isEmpty());
+    TEST_ASSERT_TRUE(arena.isFull());
+    TEST_ASSERT_EQUAL(43, (int)arena.used());
+
+    arena.reset();
+    TEST_ASSERT_FALSE(arena.isFull());
+    TEST_ASSERT_EQUAL(0, (int)arena.used());
+    TEST_ASSERT_NOT_NULL(arena.allocateRecord(64));
+}
+
+// Test: Filling an arena allocates nothing after the block itself
+void test_single_allocation() {
+    unsigned long before = ESP.getThreadAllocations();
+    ESPrawArena arena(16384);
+    TEST_ASSERT_EQUAL(1, (int)(ESP.getThreadAllocations() - before));
+    TEST_ASSERT_EQUAL(16384, (int)arena.capacity());
+
+    before = ESP.getThreadAllocations();
+    ESPrawViewList<TestRecord> list;
+    for (int i = 0; i < 100; i++) {
+        TestRecord* record = (TestRecord*)arena.allocateRecord(sizeof(TestRecord));
+        TEST_ASSERT_NOT_NULL(record);
+        TEST_ASSERT_TRUE(arena.copyText("a listing item title", 20, record->name));
+        list.append(record);
+    }
+    TEST_ASSERT_EQUAL(0, (int)(ESP.getThreadAllocations() - before));
+    TEST_ASSERT_EQUAL(100, (int)list.size());
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_records_form_array);
+    RUN_TEST(test_text);
+    RUN_TEST(test_full_and_reset);
+    RUN_TEST(test_single_allocation);
+
+    return UNITY_END();
+}
@@ -0,0 +1,326 @@
+/**
+ * test_espraw_async.cpp - Unit tests for the non-blocking request engine
+ *
+ * Builds the real ESPrawAsyncEngine against the host Arduino stand-in and
+ * drives it with a fake clock and a scripted connection. The engine never
+ * sleeps: every wait is a deadline checked against the time passed to
+ * poll(), which is what lets these tests run on a fake clock.
+ */
+
+#include <unity.h>
+#include <string>
+#include <deque>
+#include <vector>
+#include "ESPrawAsync.h"
+
+// Scripted connection: answers each request with the next queued response
+class FakeClient : public Client {
+public:
+    FakeClient()
+        : connects(0), failConnects(0), trickle(0), closeAfterResponse(false),
+          dropNextRequest(false), _open(false), _pendingRequests(0), _readPos(0) {}
+
+    int connect(const char*, uint16_t) override {
+        connects++;
+        if (failConnects > 0) {
+            failConnects--;
+            return 0;
+        }
+        _open = true;
+        _pendingRequests = 0;
+        _incoming.clear();
+        _readPos = 0;
+        return 1;
+    }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        if (!_open) {
+            return 0;
+        }
+        std::string data((const char*)buffer, size);
+        written += data;
+        if (data.find("\r\n\r\n") != std::string::npos) {
+            _pendingRequests++;
+        }
+        return size;
+    }
+
+    int available() override {
+        serveNext();
+        int left = (int)(_incoming.size() - _readPos);
+        return trickle > 0 && left > trickle ? trickle : left;
+    }
+
+    int read() override {
+        uint8_t c;
+        return read(&c, 1) == 1 ? c : -1;
+    }
+
+    int read(uint8_t* buffer, size_t size) override {
+        int count = 0;
+        while ((size_t)count < size && _readPos < _incoming.size()) {
+            buffer[count++] = (uint8_t)_incoming[_readPos++];
+        }
+        if (_readPos == _incoming.size() && closeAfterResponse) {
+            _open = false;
+        }
+        return count;
+    }
+
+    int peek() override { return _readPos < _incoming.size() ? (uint8_t)_incoming[_readPos] : -1; }
+    void flush() override {}
+    void stop() override { _open = false; }
+    uint8_t connected() override { return _open || _readPos < _incoming.size(); }
+    operator bool() override { return _open; }
+
+    std::deque<std::string> responses;
+    std::string written;
+    int connects;
+    int failConnects;
+    int trickle;               // Bytes made available per call (0 = all)
+    bool closeAfterResponse;
+    bool dropNextRequest;      // Close silently instead of answering the next request
+
+private:
+    void serveNext() {
+        if (!_open || _pendingRequests == 0 || _readPos < _incoming.size()) {
+            return;
+        }
+        _pendingRequests--;
+        if (dropNextRequest) {
+            dropNextRequest = false;
+            _open = false;
+            return;
+        }
+        if (!responses.empty()) {
+            _incoming = responses.front();
+            _readPos = 0;
+            responses.pop_front();
+        }
+    }
+
+    bool _open;
+    int _pendingRequests;
+    std::string _incoming;
+    size_t _readPos;
+};
+
+static std::string httpResponse(int status, const std::string& body, const std::string& headers = "") {
+    return "HTTP/1.1 " + std::to_string(status) + " X\r\nContent-Length: " +
+           std::to_string(body.size()) + "\r\n" + headers + "\r\n" + body;
+}
+
+static ESPrawRequestConfig testConfig() {
+    ESPrawRequestConfig config;
+    config.maxRetries = 3;
+    config.retryDelay = 1000;
+    config.requestTimeout = 5000;
+    config.keepAlive = true;
+    return config;
+}
+
+// Poll without advancing the clock until the request leaves the I/O states
+static int pollWhileBusy(ESPrawAsyncEngine& engine, ESPrawAsyncHandle handle, unsigned long now) {
+    int polls = 0;
+    ESPrawAsyncState state;
+    do {
+        engine.poll(now);
+        polls++;
+        state = engine.getState(handle);
+    } while (polls < 1000 && state != ESPrawAsyncState::DONE && state != ESPrawAsyncState::WAITING &&
+             state != ESPrawAsyncState::IDLE);
+    return polls;
+}
+
+// Test: A chunked response arriving in small pieces is assembled across polls
+void test_async_get_completes_over_polls() {
+    std::string padding(1500, ' ');
+    FakeClient client;
+    client.trickle = 7;
+    client.responses.push_back("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                               "6\r\n{\"a\":1\r\n3\r\n,\"b\r\n5dc\r\n" + padding + "\r\n"
+                               "5\r\n\":22}\r\n0\r\n\r\n");
+
+    ESPrawAsyncEngine engine(client, "oauth.reddit.com", 443);
+    engine.begin(testConfig());
+
+    ESPrawAsyncHandle handle = engine.submit(ESPrawRequestMethod::GET, "/r/esp32/hot?limit=5",
+                                             "Accept: application/json\r\n");
+    TEST_ASSERT_NOT_EQUAL(ESPRAW_ASYNC_INVALID_HANDLE, handle);
+    TEST_ASSERT_EQUAL(ESPrawAsyncState::QUEUED, engine.getState(handle));
+
+    // Each poll moves at most ESPRAW_ASYNC_IO_BUDGET bytes
+    int polls = pollWhileBusy(engine, handle, 0);
+    TEST_ASSERT_GREATER_OR_EQUAL(3 + 1500 / ESPRAW_ASYNC_IO_BUDGET, polls);
+    TEST_ASSERT_EQUAL(ESPrawAsyncState::DONE, engine.getState(handle));
+    TEST_ASSERT_EQUAL(0, engine.pending());
+
+    TEST_ASSERT_EQUAL(0, client.written.find("GET /r/esp32/hot?limit=5 HTTP/1.1\r\n"));
+    TEST_ASSERT_TRUE(client.written.find("Host: oauth.reddit.com\r\n") != std::string::npos);
+    TEST_ASSERT_TRUE(client.written.find("Accept: application/json\r\n") != std::string::npos);
+
+    ESPrawResponse response;
+    TEST_ASSERT_TRUE(engine.takeResponse(handle, response));
+    TEST_ASSERT_TRUE(response.success);
+    TEST_ASSERT_EQUAL(200, response.statusCode);
+    TEST_ASSERT_EQUAL_STRING(("{\"a\":1,\"b" + padding + "\":22}").c_str(), response.body.c_str());
+    TEST_ASSERT_EQUAL(ESPrawAsyncState::IDLE, engine.getState(handle));
+}
+
+// Test: Retry backoff is a deadline, not a sleep
+void test_async_backoff_is_a_deadline() {
+    FakeClient client;
+    client.responses.push_back(httpResponse(500, "oops"));
+    client.responses.push_back(httpResponse(200, "{}"));
+
+    ESPrawAsyncEngine engine(client, "oauth.reddit.com", 443);
+    engine.begin(testConfig());
+    ESPrawAsyncHandle handle = engine.submit(ESPrawRequestMethod::GET, "/api/v1/me", "");
+
+    pollWhileBusy(engine, handle, 1000);
+    TEST_ASSERT_EQUAL(ESPrawAsyncState::WAITING, engine.getState(handle));
+
+    // First retry waits retryDelay * 2
+    for (unsigned long now = 1000; now < 3000; now += 100) {
+        TEST_ASSERT_TRUE(engine.poll(now));
+        TEST_ASSERT_EQUAL(ESPrawAsyncState::WAITING, engine.getState(handle));
+    }
+
+    pollWhileBusy(engine, handle, 3000);
+    ESPrawResponse response;
+    TEST_ASSERT_TRUE(engine.takeResponse(handle, response));
+    TEST_ASSERT_TRUE(response.success);
+    TEST_ASSERT_EQUAL_STRING("{}", response.body.c_str());
+}
+
+// Test: Rate limit waits and Retry-After are honored without blocking
+void test_async_rate_limit_and_retry_after() {
+    FakeClient client;
+    client.responses.push_back(httpResponse(429, "", "Retry-After: 3\r\n"));
+    client.responses.push_back(httpResponse(200, "ok"));
+
+    ESPrawAsyncEngine engine(client, "oauth.reddit.com", 443);
+    engine.begin(testConfig());
+
+    unsigned long limitedUntil = 5000;
+    int sent = 0;
+    engine.setWaitHook([&limitedUntil](unsigned long now) {
+        return now < limitedUntil ? limitedUntil - now : 0;
+    });
+    engine.setSentHook([&sent](unsigned long) { sent++; });
+
+    ESPrawAsyncHandle handle = engine.submit(ESPrawRequestMethod::GET, "/hot", "");
+    engine.poll(0);
+    TEST_ASSERT_EQUAL(ESPrawAsyncState::WAITING, engine.getState(handle));
+    engine.poll(4999);
+    TEST_ASSERT_EQUAL(0, sent);
+
+    pollWhileBusy(engine, handle, 5000);
+    TEST_ASSERT_EQUAL(1, sent);
+    TEST_ASSERT_EQUAL(ESPrawAsyncState::WAITING, engine.getState(handle));
+
+    // Retry-After (3 s) outweighs the first backoff step (2 s)
+    engine.poll(7999);
+    TEST_ASSERT_EQUAL(ESPrawAsyncState::WAITING, engine.getState(handle));
+    pollWhileBusy(engine, handle, 8000);
+    TEST_ASSERT_EQUAL(2, sent);
+    TEST_ASSERT_EQUAL(ESPrawAsyncState::DONE, engine.getState(handle));
+}
+
+// Test: Requests waiting on backoff don't hold up the others
+void test_async_requests_in_flight() {
+    FakeClient client;
+    client.responses.push_back(httpResponse(503, ""));
+    client.responses.push_back(httpResponse(200, "two"));
+    client.responses.push_back(httpResponse(200, "three"));
+    client.responses.push_back(httpResponse(200, "one"));
+
+    ESPrawAsyncEngine engine(client, "oauth.reddit.com", 443);
+    engine.begin(testConfig());
+
+    std::vector<std::string> finished;
+    ESPrawAsyncCallback callback = [&finished](ESPrawAsyncHandle, const ESPrawResponse& response) {
+        finished.push_back(response.body.c_str());
+    };
+
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_NOT_EQUAL(ESPRAW_ASYNC_INVALID_HANDLE,
+                              engine.submit(ESPrawRequestMethod::GET, "/hot", "", "", "", callback));
+    }
+    TEST_ASSERT_EQUAL(3, engine.pending());
+
+    unsigned long now = 0;
+    while (engine.poll(now) && now < 10000) {
+        now += 10;
+    }
+
+    TEST_ASSERT_EQUAL(3, (int)finished.size());
+    TEST_ASSERT_EQUAL_STRING("two", finished[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("three", finished[1].c_str());
+    TEST_ASSERT_EQUAL_STRING("one", finished[2].c_str());
+    TEST_ASSERT_EQUAL(1, client.connects); // All over one kept-alive connection
+
+    // Slots released by callbacks are reusable; the table has a fixed size
+    for (int i = 0; i < ESPRAW_ASYNC_MAX_REQUESTS; i++) {
+        TEST_ASSERT_NOT_EQUAL(ESPRAW_ASYNC_INVALID_HANDLE,
+                              engine.submit(ESPrawRequestMethod::GET, "/hot", ""));
+    }
+    TEST_ASSERT_EQUAL(ESPRAW_ASYNC_INVALID_HANDLE, engine.submit(ESPrawRequestMethod::GET, "/hot", ""));
+}
+
+// Test: Stale keep-alive connections reconnect for free; silence times out
+void test_async_reconnect_and_timeout() {
+    FakeClient client;
+    client.responses.push_back(httpResponse(200, "first"));
+    client.responses.push_back(httpResponse(200, "second"));
+
+    ESPrawRequestConfig config = testConfig();
+    config.maxRetries = 0;
+    ESPrawAsyncEngine engine(client, "oauth.reddit.com", 443);
+    engine.begin(config);
+
+    ESPrawResponse response;
+    ESPrawAsyncHandle first = engine.submit(ESPrawRequestMethod::GET, "/a", "");
+    pollWhileBusy(engine, first, 0);
+    TEST_ASSERT_TRUE(engine.takeResponse(first, response));
+    TEST_ASSERT_TRUE(response.success);
+
+    // Server dropped the idle connection: reconnect without a retry attempt
+    client.dropNextRequest = true;
+    ESPrawAsyncHandle second = engine.submit(ESPrawRequestMethod::GET, "/b", "");
+    pollWhileBusy(engine, second, 100);
+    TEST_ASSERT_TRUE(engine.takeResponse(second, response));
+    TEST_ASSERT_TRUE(response.success);
+    TEST_ASSERT_EQUAL_STRING("second", response.body.c_str());
+    TEST_ASSERT_EQUAL(2, client.connects);
+
+    // No answer at all: fails once requestTimeout passes
+    ESPrawAsyncHandle third = engine.submit(ESPrawRequestMethod::GET, "/c", "");
+    for (int i = 0; i < 10; i++) {
+        engine.poll(200);
+    }
+    TEST_ASSERT_EQUAL(ESPrawAsyncState::RECEIVING, engine.getState(third));
+    engine.poll(5199);
+    TEST_ASSERT_EQUAL(ESPrawAsyncState::RECEIVING, engine.getState(third));
+    engine.poll(5200);
+    TEST_ASSERT_TRUE(engine.takeResponse(third, response));
+    TEST_ASSERT_FALSE(response.success);
+    TEST_ASSERT_EQUAL_STRING("Request timed out", response.error.c_str());
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_async_get_completes_over_polls);
+    RUN_TEST(test_async_backoff_is_a_deadline);
+    RUN_TEST(test_async_rate_limit_and_retry_after);
+    RUN_TEST(test_async_requests_in_flight);
+    RUN_TEST(test_async_reconnect_and_timeout);
+
+    return UNITY_END();
+}
@@ -1,35 +1,57 @@
 /**
  * test_espraw_auth.cpp - Unit tests for ESPraw authentication
+ *
+ * Token refresh runs against the loopback stand-in server, which counts
+ * the token requests; API requests are answered from a replay transport.
  */
 
 #include <unity.h>
+#include <Arduino.h>
 #include <string>
 #include <cstring>
+#include "replay_reddit.h"
 
-// Mock implementations for testing without Arduino
-#ifndef ARDUINO
-class String {
-public:
-    std::string _str;
-    String() {}
-    String(const char* s) : _str(s) {}
-    String(const std::string& s) : _str(s) {}
-    String(int n) : _str(std::to_string(n)) {}
-    const char* c_str() const { return _str.c_str(); }
-    size_t length() const { return _str.length(); }
-    bool isEmpty() const { return _str.empty(); }
-    bool operator==(const char* s) const { return _str == s; }
-    String operator+(const String& s) const { return String(_str + s._str); }
-    void operator+=(const String& s) { _str += s._str; }
-    String substring(size_t start, size_t end) const { 
-        return String(_str.substr(start, end - start)); 
+static StandinServer* tokenServer;
+static ESPraw* reddit;
+static ESPrawReplayTransport* replay;
+
+// Authenticate against the token server, answering API requests from transport
+static void beginReddit(ESPrawReplayTransport* transport,
+                        unsigned long refreshMargin = ESPRAW_TOKEN_REFRESH_MARGIN) {
+    replay = transport;
+    reddit = beginReplayReddit(*tokenServer, *replay, ESPrawRequestConfig(), refreshMargin);
+    TEST_ASSERT_NOT_NULL(reddit);
+}
+
+// Poll ESPraw from a loop until the client uses the given token
+static bool pollForToken(const char* accessToken, unsigned long timeoutMs) {
+    unsigned long start = millis();
+    while (millis() - start < timeoutMs) {
+        reddit->poll();
+        if (reddit->getClient().getAccessToken() == accessToken) {
+            return true;
+        }
+        delay(1);
     }
-    int indexOf(const char* s) const {
-        size_t pos = _str.find(s);
-        return (pos == std::string::npos) ? -1 : (int)pos;
+    return false;
+}
+
+/**
+ * Rejects requests made with a revoked token, as Reddit does with a
+ * token it dropped before its stated expiry
+ */
+class RevokingTransport : public ESPrawReplayTransport {
+public:
+    String revoked;
+
+    int send(ESPrawRequestMethod method, const String& url, const String& headers,
+             const String& body) override {
+        if (headers.indexOf("Bearer " + revoked + "\r\n") >= 0) {
+            return ESPrawReplayTransport::send(method, "/revoked", headers, body);
+        }
+        return ESPrawReplayTransport::send(method, url, headers, body);
     }
 };
-#endif
 
 // Test: URL encoding
 void test_url_encoding() {
@@ -79,6 +101,92 @@ void test_token_remaining_validity() {
     TEST_ASSERT_EQUAL_UINT32(0, remaining);
 }
 
+// Test: A request finding the token expired joins the background refresh
+// already in flight instead of sending a second token request
+void test_refresh_single_flight() {
+    tokenServer->body = standinTokenBody("first", 60);
+    beginReddit(new ESPrawReplayTransport());
+    replay->addResponse("/api/v1/me", 200, "{\"name\":\"maker\"}");
+    TEST_ASSERT_EQUAL(1, (int)tokenServer->requestsServed);
+
+    // Reddit's 60 s safety margin leaves this token expiring right away
+    unsigned long start = millis();
+    while (!reddit->getAuth().getToken().isExpired() && millis() - start < 3000) {
+        delay(10);
+    }
+    TEST_ASSERT_TRUE(reddit->getAuth().getToken().isExpired());
+
+    tokenServer->body = standinTokenBody("second", 3600);
+    TEST_ASSERT_TRUE(reddit->getAuth().startRefresh());
+    TEST_ASSERT_TRUE(reddit->getAuth().startRefresh());
+
+    ESPrawResponse response = reddit->get("/api/v1/me");
+    TEST_ASSERT_TRUE(response.success);
+    TEST_ASSERT_EQUAL(2, (int)tokenServer->requestsServed);
+    TEST_ASSERT_FALSE(reddit->getAuth().isRefreshing());
+    TEST_ASSERT_EQUAL_STRING("second", reddit->getClient().getAccessToken().c_str());
+
+    // The new token is good for an hour: nothing more to refresh
+    TEST_ASSERT_TRUE(reddit->get("/api/v1/me").success);
+    TEST_ASSERT_FALSE(reddit->getAuth().poll());
+    TEST_ASSERT_EQUAL(2, (int)tokenServer->requestsServed);
+}
+
+// Test: A 401 refreshes the token once and replays the request with it
+void test_unauthorized_refreshes_and_replays() {
+    tokenServer->body = standinTokenBody("first", 3600);
+    RevokingTransport* revoking = new RevokingTransport();
+    revoking->revoked = "first";
+    beginReddit(revoking);
+    replay->addResponse("/revoked", 401, "{\"message\":\"Unauthorized\",\"error\":401}");
+    replay->addResponse("/api/v1/me", 200, "{\"name\":\"maker\"}");
+
+    tokenServer->body = standinTokenBody("second", 3600);
+    ESPrawResponse response = reddit->get("/api/v1/me");
+    TEST_ASSERT_TRUE(response.success);
+    TEST_ASSERT_EQUAL(200, response.statusCode);
+    TEST_ASSERT_EQUAL(2, (int)replay->getRequestCount());
+    TEST_ASSERT_EQUAL(2, (int)tokenServer->requestsServed);
+    TEST_ASSERT_EQUAL_STRING("second", reddit->getClient().getAccessToken().c_str());
+
+    // A token that keeps being rejected is refreshed and replayed only once
+    revoking->revoked = "second";
+    tokenServer->body = standinTokenBody("second", 3600);
+    response = reddit->get("/api/v1/me");
+    TEST_ASSERT_FALSE(response.success);
+    TEST_ASSERT_EQUAL(401, response.statusCode);
+    TEST_ASSERT_EQUAL(4, (int)replay->getRequestCount());
+    TEST_ASSERT_EQUAL(3, (int)tokenServer->requestsServed);
+}
+
+// Test: poll() refreshes the token once it is within the margin, while
+// it is still valid, and leaves it alone before that
+void test_proactive_refresh_at_margin() {
+    // Valid for 3540 s once Reddit's safety margin is taken off
+    tokenServer->body = standinTokenBody("first", 3600);
+    beginReddit(new ESPrawReplayTransport(), 3500);
+    TEST_ASSERT_FALSE(reddit->getAuth().needsRefresh());
+    TEST_ASSERT_FALSE(pollForToken("second", 100));
+    TEST_ASSERT_EQUAL(1, (int)tokenServer->requestsServed);
+
+    endReplayReddit(reddit);
+    delete replay;
+
+    beginReddit(new ESPrawReplayTransport(), 3540);
+    TEST_ASSERT_TRUE(reddit->getAuth().needsRefresh());
+    TEST_ASSERT_FALSE(reddit->getAuth().getToken().isExpired());
+
+    tokenServer->body = standinTokenBody("second", 7200);
+    TEST_ASSERT_TRUE(pollForToken("second", 3000));
+    TEST_ASSERT_EQUAL(3, (int)tokenServer->requestsServed);
+    TEST_ASSERT_FALSE(reddit->getAuth().needsRefresh());
+
+    // Requests go on with the new token and no further refresh
+    replay->addResponse("/api/v1/me", 200, "{\"name\":\"maker\"}");
+    TEST_ASSERT_TRUE(reddit->get("/api/v1/me").success);
+    TEST_ASSERT_EQUAL(3, (int)tokenServer->requestsServed);
+}
+
 // Test: Basic auth header creation (base64 concept)
 void test_basic_auth_concept() {
     // Test that we understand basic auth format
@@ -98,8 +206,17 @@ void test_oauth2_grant_types() {
     TEST_ASSERT_EQUAL_STRING("client_credentials", client_creds);
 }
 
-void setUp(void) {}
-void tearDown(void) {}
+void setUp(void) {
+    tokenServer = new StandinServer();
+    reddit = nullptr;
+    replay = nullptr;
+}
+
+void tearDown(void) {
+    endReplayReddit(reddit);
+    delete replay;
+    delete tokenServer;
+}
 
 int main(int argc, char **argv) {
     UNITY_BEGIN();
@@ -107,6 +224,9 @@ int main(int argc, char **argv) {
     RUN_TEST(test_url_encoding);
     RUN_TEST(test_token_expiration_check);
     RUN_TEST(test_token_remaining_validity);
+    RUN_TEST(test_refresh_single_flight);
+    RUN_TEST(test_unauthorized_refreshes_and_replays);
+    RUN_TEST(test_proactive_refresh_at_margin);
     RUN_TEST(test_basic_auth_concept);
     RUN_TEST(test_oauth2_grant_types);
     
@@ -0,0 +1,134 @@
+/**
+ * test_espraw_cache.cpp - Unit tests for the response cache
+ *
+ * Drives ESPrawResponseCache with explicit timestamps, like the rate
+ * limiter tests.
+ */
+
+#include <unity.h>
+#include "../src/ESPrawCache.h"
+
+static const char* ABOUT_URL = "https://oauth.reddit.com/r/esp32/about";
+
+// Test: A stored response is a hit until its TTL passes
+void test_fresh_hit_then_expiry() {
+    ESPrawResponseCache cache;
+    TEST_ASSERT_TRUE(cache.store(ABOUT_URL, "{\"subscribers\":1}", "", "", 60, 1000));
+
+    const ESPrawCacheEntry* entry = cache.find(ABOUT_URL, 60999);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_TRUE(entry->isFresh(60999));
+    TEST_ASSERT_EQUAL_STRING("{\"subscribers\":1}", entry->body.c_str());
+
+    entry = cache.find(ABOUT_URL, 61000);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_FALSE(entry->isFresh(61000));
+    TEST_ASSERT_FALSE(entry->hasValidator());
+
+    TEST_ASSERT_NULL(cache.find("https://oauth.reddit.com/r/arduino/about", 61000));
+
+    const ESPrawCacheStats& stats = cache.getStats();
+    TEST_ASSERT_EQUAL(1, (int)stats.hits);
+    TEST_ASSERT_EQUAL(2, (int)stats.misses);
+    TEST_ASSERT_EQUAL(1, (int)stats.stores);
+}
+
+// Test: A 304 makes a stale entry fresh again
+void test_revalidation() {
+    ESPrawResponseCache cache;
+    cache.store(ABOUT_URL, "{}", "\"abc\"", "Tue, 01 Sep 2026 10:00:00 GMT", 10, 0);
+
+    const ESPrawCacheEntry* entry = cache.find(ABOUT_URL, 20000);
+    TEST_ASSERT_FALSE(entry->isFresh(20000));
+    TEST_ASSERT_TRUE(entry->hasValidator());
+    TEST_ASSERT_EQUAL_STRING("\"abc\"", entry->etag.c_str());
+
+    entry = cache.revalidated(ABOUT_URL, 20000);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_TRUE(entry->isFresh(29999));
+    TEST_ASSERT_EQUAL_STRING("{}", entry->body.c_str());
+    TEST_ASSERT_EQUAL(1, (int)cache.getStats().revalidations);
+
+    TEST_ASSERT_NULL(cache.revalidated("https://oauth.reddit.com/api/v1/me", 20000));
+}
+
+// Test: The least recently used entries go first and the budget holds
+void test_lru_eviction() {
+    String body(std::string(200, 'x'));
+    size_t cost = ESPrawCacheEntry().cost() + strlen("/a") + body.length();
+    ESPrawResponseCache cache(cost * 3);
+
+    cache.store("/a", body, "", "", 60, 0);
+    cache.store("/b", body, "", "", 60, 0);
+    cache.store("/c", body, "", "", 60, 0);
+    TEST_ASSERT_EQUAL(3, (int)cache.size());
+    TEST_ASSERT_EQUAL(cost * 3, cache.bytesUsed());
+
+    cache.find("/a", 100);   // /b is now the least recently used
+    cache.store("/d", body, "", "", 60, 100);
+
+    TEST_ASSERT_EQUAL(3, (int)cache.size());
+    TEST_ASSERT_TRUE(cache.bytesUsed() <= cache.getByteBudget());
+    TEST_ASSERT_NOT_NULL(cache.find("/a", 100));
+    TEST_ASSERT_NULL(cache.find("/b", 100));
+    TEST_ASSERT_NOT_NULL(cache.find("/c", 100));
+    TEST_ASSERT_EQUAL(1, (int)cache.getStats().evictions);
+
+    cache.clear();
+    TEST_ASSERT_EQUAL(0, (int)cache.size());
+    TEST_ASSERT_EQUAL(0, (int)cache.bytesUsed());
+}
+
+// Test: Oversized and zero-TTL responses are not kept; replacing updates the size
+void test_store_limits() {
+    ESPrawResponseCache cache(512);
+    TEST_ASSERT_FALSE(cache.store("/big", String(std::string(1024, 'x')), "", "", 60, 0));
+    TEST_ASSERT_FALSE(cache.store("/nocache", "{}", "", "", 0, 0));
+    TEST_ASSERT_EQUAL(0, (int)cache.size());
+
+    TEST_ASSERT_TRUE(cache.store("/a", "{\"v\":1}", "", "", 60, 0));
+    size_t small = cache.bytesUsed();
+    TEST_ASSERT_TRUE(cache.store("/a", "{\"v\":1000}", "", "", 60, 0));
+    TEST_ASSERT_EQUAL(1, (int)cache.size());
+    TEST_ASSERT_EQUAL(small + 3, cache.bytesUsed());
+
+    // A response that no longer fits drops the old one too
+    TEST_ASSERT_FALSE(cache.store("/a", String(std::string(1024, 'x')), "", "", 60, 0));
+    TEST_ASSERT_EQUAL(0, (int)cache.size());
+    TEST_ASSERT_EQUAL(0, (int)cache.bytesUsed());
+}
+
+// Test: Per-endpoint TTLs override the default
+void test_ttl_rules() {
+    ESPrawResponseCache cache(4096, 30);
+    TEST_ASSERT_EQUAL(30, (int)cache.getTtl("/r/{}/about"));
+
+    TEST_ASSERT_TRUE(cache.setTtl("/r/{}/about", 600));
+    TEST_ASSERT_TRUE(cache.setTtl("/api/v1/me", 0));
+    TEST_ASSERT_EQUAL(600, (int)cache.getTtl("/r/{}/about"));
+    TEST_ASSERT_EQUAL(0, (int)cache.getTtl("/api/v1/me"));
+    TEST_ASSERT_EQUAL(30, (int)cache.getTtl("/r/{}/hot"));
+
+    TEST_ASSERT_TRUE(cache.setTtl("/r/{}/about", 300));
+    TEST_ASSERT_EQUAL(300, (int)cache.getTtl("/r/{}/about"));
+
+    for (int i = 2; i < ESPRAW_CACHE_TTL_RULES; i++) {
+        TEST_ASSERT_TRUE(cache.setTtl("/rule/" + String(i), 1));
+    }
+    TEST_ASSERT_FALSE(cache.setTtl("/one/too/many", 1));
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_fresh_hit_then_expiry);
+    RUN_TEST(test_revalidation);
+    RUN_TEST(test_lru_eviction);
+    RUN_TEST(test_store_limits);
+    RUN_TEST(test_ttl_rules);
+
+    return UNITY_END();
+}
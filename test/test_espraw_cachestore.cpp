@@ -0,0 +1,207 @@
+/**
+ * test_espraw_cachestore.cpp - Unit tests for the persistent cache tier
+ *
+ * Builds the real ESPrawFileCacheStore against the host Arduino stand-in
+ * and keeps responses in a temporary directory. A new store (and cache)
+ * on the same directory stands in for a reboot.
+ */
+
+#include <unity.h>
+#include <stdlib.h>
+#include "ESPrawCacheStore.h"
+#include "ESPrawCache.h"
+
+static const char* STORE_DIR = "test_espraw_cachestore.tmp";
+
+static ESPrawStoredResponse makeResponse(const String& key, const String& body, uint64_t age = 0) {
+    ESPrawStoredResponse response;
+    response.key = key;
+    response.body = body;
+    response.etag = "\"" + key + "\"";
+    response.storedAt = ESPrawStoredToken::wallClock() - age;
+    response.ttl = 600;
+    return response;
+}
+
+// Test: Saves are written in batches and survive a reboot
+void test_batched_writes_persist() {
+    ESPrawFileCacheStore store(STORE_DIR);
+    TEST_ASSERT_TRUE(store.begin());
+
+    for (int i = 0; i < ESPRAW_FILE_CACHE_BATCH - 1; i++) {
+        TEST_ASSERT_TRUE(store.save(makeResponse("/r/" + String(i) + "/about", "{\"n\":1}")));
+    }
+    TEST_ASSERT_EQUAL(0, (int)store.getWrites());
+    TEST_ASSERT_EQUAL(ESPRAW_FILE_CACHE_BATCH - 1, (int)store.size());
+
+    // Not yet written, but already readable
+    ESPrawStoredResponse loaded;
+    TEST_ASSERT_TRUE(store.load("/r/0/about", loaded));
+
+    store.save(makeResponse("/api/v1/me", "{\"name\":\"me\"}\n{\"line\":2}"));
+    TEST_ASSERT_EQUAL(ESPRAW_FILE_CACHE_BATCH, (int)store.getWrites());
+
+    ESPrawFileCacheStore rebooted(STORE_DIR);
+    TEST_ASSERT_TRUE(rebooted.begin());
+    TEST_ASSERT_EQUAL(ESPRAW_FILE_CACHE_BATCH, (int)rebooted.size());
+    TEST_ASSERT_EQUAL(store.bytesUsed(), rebooted.bytesUsed());
+    TEST_ASSERT_TRUE(rebooted.load("/api/v1/me", loaded));
+    TEST_ASSERT_EQUAL_STRING("{\"name\":\"me\"}\n{\"line\":2}", loaded.body.c_str());
+    TEST_ASSERT_EQUAL_STRING("\"/api/v1/me\"", loaded.etag.c_str());
+    TEST_ASSERT_EQUAL(600, (int)loaded.ttl);
+    TEST_ASSERT_FALSE(rebooted.load("/r/none/about", loaded));
+}
+
+// Test: Keys whose file names collide replace each other cleanly
+void test_colliding_keys() {
+    // Both keys hash to 363632e7
+    const char* first = "/r/sub518895/about";
+    const char* second = "/r/sub1199280/about";
+
+    // Size of the second entry on its own
+    ESPrawFileCacheStore alone(STORE_DIR);
+    alone.begin();
+    alone.save(makeResponse(second, "{\"n\":2}"));
+    alone.flush();
+    size_t secondBytes = alone.bytesUsed();
+    alone.remove(second);
+
+    ESPrawFileCacheStore store(STORE_DIR);
+    store.begin();
+    store.save(makeResponse(first, "{\"n\":1}"));
+    store.flush();
+    store.save(makeResponse(second, "{\"n\":2}"));
+    store.flush();
+    TEST_ASSERT_EQUAL(1, (int)store.size());
+    TEST_ASSERT_EQUAL(secondBytes, store.bytesUsed());
+
+    ESPrawStoredResponse loaded;
+    TEST_ASSERT_FALSE(store.load(first, loaded));
+    TEST_ASSERT_TRUE(store.load(second, loaded));
+    TEST_ASSERT_EQUAL_STRING("{\"n\":2}", loaded.body.c_str());
+
+    // Forgetting the displaced key leaves the file alone
+    store.remove(first);
+    TEST_ASSERT_TRUE(store.load(second, loaded));
+
+    ESPrawFileCacheStore rebooted(STORE_DIR);
+    TEST_ASSERT_TRUE(rebooted.begin());
+    TEST_ASSERT_EQUAL(1, (int)rebooted.size());
+    TEST_ASSERT_TRUE(rebooted.load(second, loaded));
+
+    rebooted.remove(second);
+    TEST_ASSERT_EQUAL(0, (int)rebooted.bytesUsed());
+}
+
+// Test: Saving the same content again does not rewrite the file
+void test_identical_save_skipped() {
+    ESPrawFileCacheStore store(STORE_DIR);
+    store.begin();
+
+    store.save(makeResponse("/r/esp32/about", "{\"subscribers\":1}"));
+    store.flush();
+    TEST_ASSERT_EQUAL(1, (int)store.getWrites());
+
+    store.save(makeResponse("/r/esp32/about", "{\"subscribers\":1}"));
+    store.flush();
+    TEST_ASSERT_EQUAL(1, (int)store.getWrites());
+
+    store.save(makeResponse("/r/esp32/about", "{\"subscribers\":2}"));
+    store.flush();
+    TEST_ASSERT_EQUAL(2, (int)store.getWrites());
+
+    store.remove("/r/esp32/about");
+    ESPrawStoredResponse loaded;
+    TEST_ASSERT_FALSE(store.load("/r/esp32/about", loaded));
+    TEST_ASSERT_EQUAL(0, (int)store.bytesUsed());
+}
+
+// Test: Expired files go at startup and the oldest go at the byte cap
+void test_eviction() {
+    {
+        ESPrawFileCacheStore store(STORE_DIR);
+        store.begin();
+        store.save(makeResponse("/expired", "{}", 600 + ESPRAW_CACHE_MAX_STALE + 10));
+        store.save(makeResponse("/kept", "{}", 600 + ESPRAW_CACHE_MAX_STALE - 10));
+    }
+
+    ESPrawFileCacheStore store(STORE_DIR, 400);
+    store.begin();
+    ESPrawStoredResponse loaded;
+    TEST_ASSERT_FALSE(store.load("/expired", loaded));
+    TEST_ASSERT_TRUE(store.load("/kept", loaded));
+
+    // Two more ~190-byte files push the oldest one out
+    String body(std::string(150, 'x'));
+    store.save(makeResponse("/a", body, 5));
+    store.save(makeResponse("/b", body, 0));
+    store.flush();
+    TEST_ASSERT_TRUE(store.bytesUsed() <= 400);
+    TEST_ASSERT_FALSE(store.load("/kept", loaded));
+    TEST_ASSERT_TRUE(store.load("/a", loaded));
+    TEST_ASSERT_TRUE(store.load("/b", loaded));
+
+    TEST_ASSERT_FALSE(store.save(makeResponse("/huge", String(std::string(500, 'x')))));
+}
+
+// Test: After a reboot the cache answers from flash, fresh or stale by wall-clock age
+void test_cache_warm_boot() {
+    {
+        ESPrawFileCacheStore store(STORE_DIR);
+        store.begin();
+        ESPrawResponseCache cache;
+        cache.setStore(&store);
+        cache.store("/r/esp32/about", "{\"n\":1}", "\"e1\"", "", 600, millis());
+        store.save(makeResponse("/r/old/about", "{\"n\":2}", 700));
+    }
+
+    ESPrawFileCacheStore store(STORE_DIR);
+    store.begin();
+    ESPrawResponseCache cache;
+    cache.setStore(&store);
+    cache.setStaleWindow(300);
+
+    unsigned long now = millis();
+    const ESPrawCacheEntry* entry = cache.find("/r/esp32/about", now);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_TRUE(entry->isFresh(now));
+    TEST_ASSERT_EQUAL_STRING("{\"n\":1}", entry->body.c_str());
+    TEST_ASSERT_EQUAL_STRING("\"e1\"", entry->etag.c_str());
+
+    // 100 s past its TTL: answered while it is revalidated
+    entry = cache.find("/r/old/about", now);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_FALSE(entry->isFresh(now));
+    TEST_ASSERT_TRUE(entry->isServable(now, cache.getStaleWindow() * 1000UL));
+
+    const ESPrawCacheStats& stats = cache.getStats();
+    TEST_ASSERT_EQUAL(2, (int)stats.storeLoads);
+    TEST_ASSERT_EQUAL(1, (int)stats.hits);
+    TEST_ASSERT_EQUAL(1, (int)stats.staleHits);
+
+    // Revalidation touches RAM only
+    unsigned long writes = store.getWrites();
+    cache.revalidated("/r/old/about", now);
+    store.flush();
+    TEST_ASSERT_EQUAL(writes, store.getWrites());
+}
+
+void setUp(void) {
+    system("rm -rf test_espraw_cachestore.tmp");
+}
+
+void tearDown(void) {
+    system("rm -rf test_espraw_cachestore.tmp");
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_batched_writes_persist);
+    RUN_TEST(test_colliding_keys);
+    RUN_TEST(test_identical_save_skipped);
+    RUN_TEST(test_eviction);
+    RUN_TEST(test_cache_warm_boot);
+
+    return UNITY_END();
+}
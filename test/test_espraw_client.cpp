@@ -6,6 +6,8 @@
 #include <vector>
 #include <string>
 #include <cstring>
+#include "standin_server.h"
+#include "ESPrawClient.h"
 
 // Test: Rate limit tracking
 void test_rate_limit_tracking() {
@@ -132,6 +134,187 @@ void test_retry_logic() {
     TEST_ASSERT_EQUAL(3, attemptCount);
 }
 
+// Client configured for the stand-in server
+static void beginClient(ESPrawClient& client, const StandinServer& server, bool keepAlive) {
+    ESPrawRequestConfig config;
+    config.apiBaseUrl = "http://127.0.0.1:" + String(server.port());
+    config.keepAlive = keepAlive;
+    config.maxRetries = 0;
+    config.retryDelay = 10;
+    TEST_ASSERT_TRUE(client.begin(config));
+}
+
+// Test: Keep-alive reuses a single connection
+void test_keep_alive_reuses_connection() {
+    StandinServer server;
+    TEST_ASSERT_TRUE(server.start());
+    
+    {
+        ESPrawClient client;
+        beginClient(client, server, true);
+        for (int i = 0; i < 5; i++) {
+            TEST_ASSERT_EQUAL(200, client.get("/r/test/hot").statusCode);
+        }
+        
+        const ESPrawConnectionStats& stats = client.getConnectionStats();
+        TEST_ASSERT_EQUAL(5, stats.requests);
+        TEST_ASSERT_EQUAL(1, stats.freshConnections);
+        TEST_ASSERT_EQUAL(4, stats.reusedConnections);
+        TEST_ASSERT_EQUAL(0, stats.staleReconnects);
+    }
+    
+    server.stop();
+    TEST_ASSERT_EQUAL(1, server.acceptedConnections.load());
+    TEST_ASSERT_EQUAL(5, server.requestsServed.load());
+}
+
+// Test: Without keep-alive every request handshakes again
+void test_no_keep_alive_opens_connection_per_request() {
+    StandinServer server;
+    TEST_ASSERT_TRUE(server.start());
+    
+    {
+        ESPrawClient client;
+        beginClient(client, server, false);
+        for (int i = 0; i < 5; i++) {
+            TEST_ASSERT_EQUAL(200, client.get("/r/test/hot").statusCode);
+        }
+        
+        const ESPrawConnectionStats& stats = client.getConnectionStats();
+        TEST_ASSERT_EQUAL(5, stats.freshConnections);
+        TEST_ASSERT_EQUAL(0, stats.reusedConnections);
+    }
+    
+    server.stop();
+    TEST_ASSERT_EQUAL(5, server.acceptedConnections.load());
+    TEST_ASSERT_TRUE(server.lastRequest().find("Connection: close") != std::string::npos);
+}
+
+// Test: A connection the server closed in between is not reused
+void test_keep_alive_reconnects_after_server_close() {
+    StandinServer server;
+    server.maxRequestsPerConnection = 2;
+    TEST_ASSERT_TRUE(server.start());
+    
+    {
+        ESPrawClient client;
+        beginClient(client, server, true);
+        for (int i = 0; i < 5; i++) {
+            TEST_ASSERT_EQUAL(200, client.get("/r/test/hot").statusCode);
+            usleep(20000); // Let the server's FIN arrive before the next request
+        }
+        
+        const ESPrawConnectionStats& stats = client.getConnectionStats();
+        TEST_ASSERT_EQUAL(3, stats.freshConnections);
+        TEST_ASSERT_EQUAL(2, stats.reusedConnections);
+        TEST_ASSERT_EQUAL(0, stats.staleReconnects);
+    }
+    
+    server.stop();
+    TEST_ASSERT_EQUAL(3, server.acceptedConnections.load());
+    TEST_ASSERT_EQUAL(5, server.requestsServed.load());
+}
+
+// Test: A reused connection that dies mid-request is reopened once,
+// without spending a retry
+void test_keep_alive_reconnects_stale_connection() {
+    StandinServer server;
+    server.dropAfterRequests = 2;
+    TEST_ASSERT_TRUE(server.start());
+    
+    {
+        ESPrawClient client;
+        beginClient(client, server, true);
+        for (int i = 0; i < 5; i++) {
+            ESPrawResponse response = client.get("/r/test/hot");
+            TEST_ASSERT_TRUE(response.success);
+            TEST_ASSERT_EQUAL(200, response.statusCode);
+        }
+        
+        // Requests 3 and 5 first went out on a connection the server dropped
+        const ESPrawConnectionStats& stats = client.getConnectionStats();
+        TEST_ASSERT_EQUAL(2, stats.staleReconnects);
+        TEST_ASSERT_EQUAL(7, stats.requests);
+        TEST_ASSERT_EQUAL(3, stats.freshConnections);
+        TEST_ASSERT_EQUAL(4, stats.reusedConnections);
+    }
+    
+    server.stop();
+    TEST_ASSERT_EQUAL(3, server.acceptedConnections.load());
+    TEST_ASSERT_EQUAL(5, server.requestsServed.load());
+}
+
+// Test: Header budget only blocks once the server budget is spent
+void test_header_rate_limit_budget() {
+    ESPrawHeaderRateLimiter limiter;
+    
+    // No headers seen yet: nothing to enforce
+    TEST_ASSERT_TRUE(limiter.canRequest(0));
+    TEST_ASSERT_FALSE(limiter.update("1.0", "", "600", 0));
+    TEST_ASSERT_FALSE(limiter.hasBudget());
+    
+    TEST_ASSERT_TRUE(limiter.update("598.0", "2.0", "30", 1000));
+    TEST_ASSERT_TRUE(limiter.canRequest(1000));
+    
+    limiter.recordRequest(1000);
+    TEST_ASSERT_TRUE(limiter.canRequest(1000));
+    limiter.recordRequest(1000);
+    TEST_ASSERT_FALSE(limiter.canRequest(1000));
+    TEST_ASSERT_EQUAL_UINT32(30000, limiter.timeUntilNextRequest(1000));
+    TEST_ASSERT_EQUAL_UINT32(20000, limiter.timeUntilNextRequest(11000));
+    TEST_ASSERT_EQUAL_FLOAT(600.0f, limiter.getUsed());
+    
+    // Budget is restored when the reported period ends
+    TEST_ASSERT_TRUE(limiter.canRequest(31000));
+    TEST_ASSERT_EQUAL_UINT32(0, limiter.timeUntilNextRequest(31000));
+}
+
+// Test: Reset timing is correct across millis() rollover
+void test_header_rate_limit_rollover() {
+    ESPrawHeaderRateLimiter limiter;
+    unsigned long start = (unsigned long)-5000; // 5 s before millis() wraps
+    
+    limiter.update("100.0", "0.0", "10", start);
+    TEST_ASSERT_FALSE(limiter.canRequest(start));
+    TEST_ASSERT_FALSE(limiter.canRequest(start + 8000)); // Wrapped past zero
+    TEST_ASSERT_EQUAL_UINT32(2000, limiter.timeUntilNextRequest(start + 8000));
+    TEST_ASSERT_TRUE(limiter.canRequest(start + 10000));
+}
+
+// Test: Spending a stand-in server's budget never triggers a 429
+void test_header_rate_limit_against_server() {
+    StandinServer server;
+    server.rateLimitBudget = 3;
+    server.rateLimitPeriodMs = 1000;
+    TEST_ASSERT_TRUE(server.start());
+    
+    int waits = 0;
+    
+    {
+        ESPrawClient client;
+        ESPrawRequestConfig config;
+        config.apiBaseUrl = "http://127.0.0.1:" + String(server.port());
+        config.rateLimitMode = ESPrawRateLimitMode::SERVER_HEADERS;
+        config.maxRetries = 0;
+        TEST_ASSERT_TRUE(client.begin(config));
+        
+        for (int i = 0; i < 7; i++) {
+            ESPrawResponse response = client.get("/r/test/new");
+            TEST_ASSERT_EQUAL(200, response.statusCode);
+            if (response.timing.rateLimitWait > 0) {
+                waits++;
+            }
+        }
+        TEST_ASSERT_TRUE(client.getServerRateLimit().hasBudget());
+    }
+    
+    server.stop();
+    TEST_ASSERT_EQUAL(0, server.rateLimited.load());
+    TEST_ASSERT_EQUAL(7, server.requestsServed.load());
+    // Budget of 3 per period: only the 4th and 7th requests had to wait
+    TEST_ASSERT_EQUAL(2, waits);
+}
+
 void setUp(void) {}
 void tearDown(void) {}
 
@@ -145,6 +328,13 @@ int main(int argc, char **argv) {
     RUN_TEST(test_exponential_backoff_calculation);
     RUN_TEST(test_url_building);
     RUN_TEST(test_retry_logic);
+    RUN_TEST(test_keep_alive_reuses_connection);
+    RUN_TEST(test_no_keep_alive_opens_connection_per_request);
+    RUN_TEST(test_keep_alive_reconnects_after_server_close);
+    RUN_TEST(test_keep_alive_reconnects_stale_connection);
+    RUN_TEST(test_header_rate_limit_budget);
+    RUN_TEST(test_header_rate_limit_rollover);
+    RUN_TEST(test_header_rate_limit_against_server);
     
     return UNITY_END();
 }
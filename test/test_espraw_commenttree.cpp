@@ -0,0 +1,206 @@
+/**
+ * test_espraw_commenttree.cpp - Unit tests for the flat comment tree
+ *
+ * Feeds comment pages shaped like Reddit's (replies ahead of the comment's
+ * own fields, "more" placeholders, empty-string replies) to CommentTree
+ * through an in-memory stream.
+ */
+
+#include <unity.h>
+#include <string>
+#include "models/CommentTree.h"
+
+// Stream over a fixed string
+class StringStream : public Stream {
+public:
+    explicit StringStream(const std::string& data) : _data(data), _pos(0) {
+        setTimeout(0);
+    }
+
+    int available() override { return _data.size() - _pos; }
+    int read() override { return _pos < _data.size() ? (uint8_t)_data[_pos++] : -1; }
+    int peek() override { return _pos < _data.size() ? (uint8_t)_data[_pos] : -1; }
+    size_t write(uint8_t) override { return 0; }
+
+private:
+    std::string _data;
+    size_t _pos;
+};
+
+static std::string listing(const std::string& children) {
+    return "{\"kind\":\"Listing\",\"data\":{\"after\":null,\"children\":[" + children + "],\"before\":null}}";
+}
+
+// A comment with Reddit's field order: replies come first
+static std::string comment(const std::string& id, const std::string& author, int score,
+                           const std::string& replies = "", const std::string& body = "") {
+    return "{\"kind\":\"t1\",\"data\":{\"likes\":null,\"replies\":" +
+           (replies.empty() ? std::string("\"\"") : listing(replies)) +
+           ",\"saved\":false,\"id\":\"" + id + "\",\"author\":\"" + author +
+           "\",\"is_submitter\":" + (author == "op" ? "true" : "false") +
+           ",\"body\":\"" + (body.empty() ? "Comment " + id : body) +
+           "\",\"score\":" + std::to_string(score) +
+           ",\"all_awardings\":[{\"name\":\"x\"}],\"score_hidden\":false}}";
+}
+
+static std::string page(const std::string& comments) {
+    std::string submission = "{\"kind\":\"t3\",\"data\":{\"id\":\"p1\",\"title\":\"[brackets] {braces}\"}}";
+    return "[" + listing(submission) + "," + listing(comments) + "]";
+}
+
+//   a (5)
+//     b (3)
+//       c (1)
+//     d (-2)
+//       e (9)
+//   f (4)
+//   more
+static std::string samplePage() {
+    std::string a = comment("a", "alice", 5,
+                            comment("b", "bob", 3, comment("c", "alice", 1)) + "," +
+                            comment("d", "op", -2, comment("e", "bob", 9)));
+    std::string more = "{\"kind\":\"more\",\"data\":{\"count\":12,\"children\":[\"x1\",\"x2\"]}}";
+    return page(a + "," + comment("f", "carol", 4) + "," + more);
+}
+
+static bool parse(CommentTree& tree, const std::string& text) {
+    StringStream body(text);
+    return tree.parse(body);
+}
+
+// Test: Comments are stored in pre-order with parents, depths and subtree sizes
+void test_preorder_layout() {
+    CommentTree tree;
+    TEST_ASSERT_TRUE(parse(tree, samplePage()));
+    TEST_ASSERT_EQUAL(6, (int)tree.size());
+
+    const char* ids = "abcdef";
+    const int parents[] = { -1, 0, 1, 0, 3, -1 };
+    const int depths[] = { 0, 1, 2, 1, 2, 0 };
+    const int descendants[] = { 4, 1, 0, 1, 0, 0 };
+    for (size_t i = 0; i < tree.size(); i++) {
+        const CommentTreeNode& node = tree.at(i);
+        TEST_ASSERT_EQUAL(ids[i], tree.getString(node.id)[0]);
+        TEST_ASSERT_EQUAL(parents[i], node.parent);
+        TEST_ASSERT_EQUAL(depths[i], node.depth);
+        TEST_ASSERT_EQUAL(descendants[i], (int)node.descendants);
+    }
+
+    TEST_ASSERT_EQUAL_STRING("Comment d", tree.getString(tree.at(3).body));
+    TEST_ASSERT_EQUAL(-2, tree.at(3).score);
+    TEST_ASSERT_EQUAL(ESPRAW_COMMENT_NODE_SUBMITTER, tree.at(3).flags);
+    TEST_ASSERT_EQUAL(5, (int)tree.skip(0));
+    TEST_ASSERT_EQUAL(3, (int)tree.skip(1));
+
+    // Repeated authors share one string
+    TEST_ASSERT_EQUAL(tree.at(0).author, tree.at(2).author);
+    TEST_ASSERT_EQUAL(tree.at(1).author, tree.at(4).author);
+    TEST_ASSERT_EQUAL_STRING("alice", tree.getString(tree.at(2).author));
+}
+
+// Test: Depth and score limits drop comments together with their replies
+void test_pruning() {
+    CommentTree tree;
+    tree.setMaxDepth(2);
+    TEST_ASSERT_TRUE(parse(tree, samplePage()));
+    TEST_ASSERT_EQUAL(4, (int)tree.size());
+    TEST_ASSERT_EQUAL(2, (int)tree.at(0).descendants);
+    TEST_ASSERT_EQUAL_STRING("d", tree.getString(tree.at(2).id));
+
+    tree.setMaxDepth(0);
+    tree.setMinScore(2);
+    TEST_ASSERT_TRUE(parse(tree, samplePage()));
+    TEST_ASSERT_EQUAL(3, (int)tree.size());
+    TEST_ASSERT_EQUAL_STRING("a", tree.getString(tree.at(0).id));
+    TEST_ASSERT_EQUAL_STRING("b", tree.getString(tree.at(1).id));
+    TEST_ASSERT_EQUAL_STRING("f", tree.getString(tree.at(2).id));
+    TEST_ASSERT_EQUAL(1, (int)tree.at(0).descendants);
+
+    // Pruned strings are given back: same pool as a page without them
+    CommentTree kept;
+    std::string a = comment("a", "alice", 5, comment("b", "bob", 3));
+    TEST_ASSERT_TRUE(parse(kept, page(a + "," + comment("f", "carol", 4))));
+    TEST_ASSERT_EQUAL(kept.poolSize(), tree.poolSize());
+}
+
+// Test: Interning stays exact across many authors and pruned replies
+void test_many_authors() {
+    // Every third comment has a pruned reply whose author is seen only there
+    std::string comments;
+    std::string keptComments;
+    for (int i = 0; i < 300; i++) {
+        std::string id = "c" + std::to_string(i);
+        std::string author = "user" + std::to_string(i % 70);
+        std::string reply = i % 3 == 0 ? comment("r" + std::to_string(i), "gone" + std::to_string(i), -1) : "";
+        comments += (i > 0 ? "," : "") + comment(id, author, 1, reply);
+        keptComments += (i > 0 ? "," : "") + comment(id, author, 1);
+    }
+
+    CommentTree tree;
+    tree.setMinScore(0);
+    TEST_ASSERT_TRUE(parse(tree, page(comments)));
+    TEST_ASSERT_EQUAL(300, (int)tree.size());
+    for (size_t i = 0; i < tree.size(); i++) {
+        std::string author = "user" + std::to_string(i % 70);
+        TEST_ASSERT_EQUAL_STRING(author.c_str(), tree.getString(tree.at(i).author));
+        TEST_ASSERT_EQUAL(tree.at(i % 70).author, tree.at(i).author);
+    }
+
+    CommentTree kept;
+    TEST_ASSERT_TRUE(parse(kept, page(keptComments)));
+    TEST_ASSERT_EQUAL(kept.poolSize(), tree.poolSize());
+}
+
+// Test: Escapes are decoded and long bodies are cut at a character boundary
+void test_strings() {
+    CommentTree tree;
+    std::string body = "Line\\none \\\"quoted\\\" caf\\u00e9 \\ud83d\\ude00 \xe2\x82\xac";
+    TEST_ASSERT_TRUE(parse(tree, page(comment("a", "alice", 1, "", body))));
+    TEST_ASSERT_EQUAL_STRING("Line\none \"quoted\" caf\xc3\xa9 \xf0\x9f\x98\x80 \xe2\x82\xac",
+                             tree.getString(tree.at(0).body));
+
+    // "caf" fits in 4 bytes, the 2-byte "é" does not
+    tree.setMaxBodyLength(4);
+    TEST_ASSERT_TRUE(parse(tree, page(comment("a", "alice", 1, "", "caf\xc3\xa9s"))));
+    TEST_ASSERT_EQUAL_STRING("caf", tree.getString(tree.at(0).body));
+    tree.setMaxBodyLength(5);
+    TEST_ASSERT_TRUE(parse(tree, page(comment("a", "alice", 1, "", "caf\xc3\xa9s"))));
+    TEST_ASSERT_EQUAL_STRING("caf\xc3\xa9", tree.getString(tree.at(0).body));
+}
+
+// Test: Bad input fails with an error and keeps the comments finished before it
+void test_malformed_input() {
+    CommentTree tree;
+    TEST_ASSERT_FALSE(parse(tree, "\"not a page\""));
+    TEST_ASSERT_FALSE(tree.getError().isEmpty());
+
+    std::string full = samplePage();
+    TEST_ASSERT_FALSE(parse(tree, full.substr(0, full.find("\"id\":\"f\""))));
+    TEST_ASSERT_EQUAL(5, (int)tree.size());
+    TEST_ASSERT_EQUAL_STRING("e", tree.getString(tree.at(4).id));
+    TEST_ASSERT_FALSE(tree.getError().isEmpty());
+
+    // Cut inside a reply: its whole top-level thread goes
+    TEST_ASSERT_FALSE(parse(tree, full.substr(0, full.find("\"id\":\"e\""))));
+    TEST_ASSERT_EQUAL(0, (int)tree.size());
+
+    // A bare comment listing works as well
+    TEST_ASSERT_TRUE(parse(tree, listing(comment("z", "zed", 1))));
+    TEST_ASSERT_EQUAL(1, (int)tree.size());
+    TEST_ASSERT_TRUE(tree.getError().isEmpty());
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_preorder_layout);
+    RUN_TEST(test_pruning);
+    RUN_TEST(test_many_authors);
+    RUN_TEST(test_strings);
+    RUN_TEST(test_malformed_input);
+
+    return UNITY_END();
+}
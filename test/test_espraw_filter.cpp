@@ -0,0 +1,156 @@
+/**
+ * test_espraw_filter.cpp - Unit tests for response field filters
+ *
+ * Each test deserializes a trimmed Reddit fixture through a filter built
+ * by ESPrawFilter and checks which fields survive.
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "ESPrawFilter.h"
+
+// A t3 thing with fields the models read and some they never do
+static const char* SUBMISSION_THING =
+    "{\"kind\":\"t3\",\"data\":{"
+    "\"id\":\"abc123\",\"name\":\"t3_abc123\",\"created_utc\":1700000000.0,"
+    "\"title\":\"ESP32 weather station\",\"author\":\"maker\",\"subreddit\":\"esp32\","
+    "\"score\":42,\"num_comments\":7,\"is_self\":false,"
+    "\"thumbnail\":\"https://b.thumbs.redditmedia.com/x.jpg\","
+    "\"preview\":{\"images\":[{\"source\":{\"url\":\"https://i.redd.it/x.jpg\",\"width\":640}}]},"
+    "\"all_awardings\":[{\"name\":\"Helpful\",\"count\":1}],"
+    "\"media\":null,\"body\":\"not a submission field\"}}";
+
+// A t1 thing
+static const char* COMMENT_THING =
+    "{\"kind\":\"t1\",\"data\":{"
+    "\"id\":\"c1\",\"name\":\"t1_c1\",\"body\":\"Nice build!\",\"author\":\"reader\","
+    "\"parent_id\":\"t3_abc123\",\"link_id\":\"t3_abc123\",\"score\":5,\"depth\":0,"
+    "\"body_html\":\"&lt;p&gt;Nice build!&lt;/p&gt;\",\"author_flair_richtext\":[],"
+    "\"title\":\"not a comment field\",\"gildings\":{}}}";
+
+// A listing of two submissions
+static const char* SUBMISSION_LISTING =
+    "{\"kind\":\"Listing\",\"data\":{\"after\":\"t3_b\",\"before\":null,\"dist\":2,\"modhash\":\"\","
+    "\"children\":["
+    "{\"kind\":\"t3\",\"data\":{\"id\":\"a\",\"title\":\"First\",\"score\":1,\"thumbnail\":\"self\"}},"
+    "{\"kind\":\"t3\",\"data\":{\"id\":\"b\",\"title\":\"Second\",\"score\":2,\"preview\":{}}}"
+    "]}}";
+
+// Test: buildThing() keeps the submission fields and drops the rest
+void test_submission_thing_filter() {
+    DynamicJsonDocument filter(ESPrawFilter::submission().capacity());
+    ESPrawFilter::submission().buildThing(filter);
+    TEST_ASSERT_FALSE(filter.overflowed());
+
+    DynamicJsonDocument doc(2048);
+    DeserializationError error = deserializeJson(doc, SUBMISSION_THING, DeserializationOption::Filter(filter));
+    TEST_ASSERT_FALSE(error);
+
+    TEST_ASSERT_EQUAL_STRING("t3", doc["kind"].as<const char*>());
+    JsonObject data = doc["data"];
+    TEST_ASSERT_EQUAL_STRING("abc123", data["id"].as<const char*>());
+    TEST_ASSERT_EQUAL_STRING("t3_abc123", data["name"].as<const char*>());
+    TEST_ASSERT_EQUAL_STRING("ESP32 weather station", data["title"].as<const char*>());
+    TEST_ASSERT_EQUAL(42, data["score"].as<int>());
+    TEST_ASSERT_EQUAL(7, data["num_comments"].as<int>());
+    TEST_ASSERT_TRUE(data.containsKey("is_self"));
+    TEST_ASSERT_TRUE(data.containsKey("created_utc"));
+
+    TEST_ASSERT_FALSE(data.containsKey("thumbnail"));
+    TEST_ASSERT_FALSE(data.containsKey("preview"));
+    TEST_ASSERT_FALSE(data.containsKey("all_awardings"));
+    TEST_ASSERT_FALSE(data.containsKey("media"));
+    TEST_ASSERT_FALSE(data.containsKey("body"));
+}
+
+// Test: comment() keeps the comment fields and drops the rest
+void test_comment_thing_filter() {
+    DynamicJsonDocument filter(ESPrawFilter::comment().capacity());
+    ESPrawFilter::comment().buildThing(filter);
+
+    DynamicJsonDocument doc(2048);
+    TEST_ASSERT_FALSE(deserializeJson(doc, COMMENT_THING, DeserializationOption::Filter(filter)));
+
+    JsonObject data = doc["data"];
+    TEST_ASSERT_EQUAL_STRING("Nice build!", data["body"].as<const char*>());
+    TEST_ASSERT_EQUAL_STRING("reader", data["author"].as<const char*>());
+    TEST_ASSERT_EQUAL_STRING("t3_abc123", data["parent_id"].as<const char*>());
+    TEST_ASSERT_EQUAL(5, data["score"].as<int>());
+    TEST_ASSERT_TRUE(data.containsKey("depth"));
+
+    TEST_ASSERT_FALSE(data.containsKey("body_html"));
+    TEST_ASSERT_FALSE(data.containsKey("author_flair_richtext"));
+    TEST_ASSERT_FALSE(data.containsKey("gildings"));
+    TEST_ASSERT_FALSE(data.containsKey("title"));
+}
+
+// Test: buildListing() applies the fields to every child
+void test_listing_filter() {
+    DynamicJsonDocument filter(ESPrawFilter::submission().capacity());
+    ESPrawFilter::submission().buildListing(filter);
+    TEST_ASSERT_FALSE(filter.overflowed());
+
+    DynamicJsonDocument doc(2048);
+    TEST_ASSERT_FALSE(deserializeJson(doc, SUBMISSION_LISTING, DeserializationOption::Filter(filter)));
+
+    JsonObject listing = doc["data"];
+    TEST_ASSERT_EQUAL_STRING("t3_b", listing["after"].as<const char*>());
+    TEST_ASSERT_FALSE(listing.containsKey("dist"));
+    TEST_ASSERT_FALSE(listing.containsKey("modhash"));
+
+    JsonArray children = listing["children"];
+    TEST_ASSERT_EQUAL(2, (int)children.size());
+    TEST_ASSERT_EQUAL_STRING("t3", children[1]["kind"].as<const char*>());
+    TEST_ASSERT_EQUAL_STRING("Second", children[1]["data"]["title"].as<const char*>());
+    TEST_ASSERT_EQUAL(1, children[0]["data"]["score"].as<int>());
+    TEST_ASSERT_FALSE(children[0]["data"].containsKey("thumbnail"));
+    TEST_ASSERT_FALSE(children[1]["data"].containsKey("preview"));
+}
+
+// Test: none() builds nothing to filter with
+void test_none_filter_keeps_everything() {
+    TEST_ASSERT_FALSE(ESPrawFilter::none().isEnabled());
+    TEST_ASSERT_TRUE(ESPrawFilter::submission().isEnabled());
+    TEST_ASSERT_TRUE(ESPrawFilter::thing().isEnabled());
+
+    // thing() covers the fields of every model it combines
+    DynamicJsonDocument filter(ESPrawFilter::thing().capacity());
+    ESPrawFilter::thing().buildThing(filter);
+    DynamicJsonDocument doc(2048);
+    TEST_ASSERT_FALSE(deserializeJson(doc, COMMENT_THING, DeserializationOption::Filter(filter)));
+    TEST_ASSERT_TRUE(doc["data"].containsKey("body"));
+    TEST_ASSERT_TRUE(doc["data"].containsKey("title"));
+    TEST_ASSERT_FALSE(doc["data"].containsKey("body_html"));
+}
+
+// Test: A custom profile extends a built-in one
+void test_custom_filter() {
+    static const char* fields[] = { "thumbnail" };
+    ESPrawFilter withThumbnail(ESPrawFilter::submission(), fields, 1);
+
+    DynamicJsonDocument filter(withThumbnail.capacity());
+    withThumbnail.buildThing(filter);
+    TEST_ASSERT_FALSE(filter.overflowed());
+
+    DynamicJsonDocument doc(2048);
+    TEST_ASSERT_FALSE(deserializeJson(doc, SUBMISSION_THING, DeserializationOption::Filter(filter)));
+    TEST_ASSERT_EQUAL_STRING("https://b.thumbs.redditmedia.com/x.jpg", doc["data"]["thumbnail"].as<const char*>());
+    TEST_ASSERT_EQUAL_STRING("ESP32 weather station", doc["data"]["title"].as<const char*>());
+    TEST_ASSERT_FALSE(doc["data"].containsKey("preview"));
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_submission_thing_filter);
+    RUN_TEST(test_comment_thing_filter);
+    RUN_TEST(test_listing_filter);
+    RUN_TEST(test_none_filter_keeps_everything);
+    RUN_TEST(test_custom_filter);
+
+    return UNITY_END();
+}
@@ -0,0 +1,169 @@
+/**
+ * test_espraw_hal.cpp - Unit tests for the host Arduino stand-in
+ *
+ * The library's host build talks to the network through hal/: WiFiClient
+ * over POSIX sockets and HTTPClient on top of it. These tests run them
+ * against the local stand-in server.
+ */
+
+#include <unity.h>
+#include <string>
+#include "standin_server.h"
+#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
+#include <WiFi.h>
+#include <base64.h>
+
+static String urlFor(const StandinServer& server, const char* path) {
+    return String("http://127.0.0.1:") + String(server.port()) + path;
+}
+
+// Test: Keep-alive requests share one connection; collected headers are kept
+void test_http_get_reuses_connection() {
+    StandinServer server;
+    server.body = "{\"kind\":\"Listing\"}";
+    server.extraHeaders = "X-Test: yes\r\nX-Ignored: no\r\n";
+    TEST_ASSERT_TRUE(server.start());
+
+    WiFiClientSecure client;
+    HTTPClient http;
+    static const char* keys[] = { "X-Test" };
+
+    for (int i = 0; i < 3; i++) {
+        http.setReuse(true);
+        TEST_ASSERT_TRUE(http.begin(client, urlFor(server, "/r/esp32/hot?limit=1")));
+        http.collectHeaders(keys, 1);
+        TEST_ASSERT_EQUAL(200, http.GET());
+        TEST_ASSERT_EQUAL(18, http.getSize());
+        TEST_ASSERT_EQUAL_STRING("yes", http.header("X-Test").c_str());
+        TEST_ASSERT_EQUAL_STRING("", http.header("X-Ignored").c_str());
+        TEST_ASSERT_EQUAL_STRING("{\"kind\":\"Listing\"}", http.getString().c_str());
+        http.end();
+        TEST_ASSERT_TRUE(client.connected());
+    }
+
+    TEST_ASSERT_EQUAL(1, server.acceptedConnections.load());
+    TEST_ASSERT_EQUAL(3, server.requestsServed.load());
+    TEST_ASSERT_TRUE(server.lastRequest().find("GET /r/esp32/hot?limit=1 HTTP/1.1") == 0);
+}
+
+// Test: POST sends the body, user agent and added headers
+void test_http_post_sends_headers_and_body() {
+    StandinServer server;
+    TEST_ASSERT_TRUE(server.start());
+
+    WiFiClient client;
+    HTTPClient http;
+    TEST_ASSERT_TRUE(http.begin(client, urlFor(server, "/api/comment")));
+    http.addHeader("User-Agent", "ESPraw-test");
+    http.addHeader("Authorization", "Bearer abc");
+    TEST_ASSERT_EQUAL(200, http.POST("text=hi"));
+    http.end();
+
+    std::string request = server.lastRequest();
+    TEST_ASSERT_TRUE(request.find("POST /api/comment HTTP/1.1") == 0);
+    TEST_ASSERT_TRUE(request.find("User-Agent: ESPraw-test\r\n") != std::string::npos);
+    TEST_ASSERT_TRUE(request.find("Authorization: Bearer abc\r\n") != std::string::npos);
+    TEST_ASSERT_TRUE(request.find("Content-Length: 7") != std::string::npos);
+    TEST_ASSERT_TRUE(request.find("Host: 127.0.0.1:") != std::string::npos);
+}
+
+// Test: Chunked bodies are decoded by getString() but raw on getStream()
+void test_http_chunked_response() {
+    StandinServer server;
+    server.body = std::string(2000, 'x');
+    server.chunkSize = 300;
+    TEST_ASSERT_TRUE(server.start());
+
+    WiFiClient client;
+    HTTPClient http;
+    static const char* keys[] = { "Transfer-Encoding" };
+
+    TEST_ASSERT_TRUE(http.begin(client, urlFor(server, "/")));
+    http.collectHeaders(keys, 1);
+    TEST_ASSERT_EQUAL(200, http.GET());
+    TEST_ASSERT_EQUAL(-1, http.getSize());
+    TEST_ASSERT_EQUAL_STRING("chunked", http.header("Transfer-Encoding").c_str());
+    TEST_ASSERT_EQUAL_STRING(server.body.c_str(), http.getString().c_str());
+    http.end();
+
+    // The connection is still usable, and the stream shows the chunk framing
+    TEST_ASSERT_TRUE(http.begin(client, urlFor(server, "/")));
+    TEST_ASSERT_EQUAL(200, http.GET());
+    char head[5] = { 0 };
+    http.getStream().setTimeout(1000);
+    TEST_ASSERT_EQUAL(5, (int)http.getStream().readBytes(head, 5));
+    TEST_ASSERT_EQUAL_MEMORY("12c\r\n", head, 5);
+    http.end();
+
+    TEST_ASSERT_EQUAL(1, server.acceptedConnections.load());
+}
+
+// Test: Connection: close from either side means a new connection per request
+void test_http_connection_close() {
+    StandinServer server;
+    server.maxRequestsPerConnection = 1;
+    TEST_ASSERT_TRUE(server.start());
+
+    WiFiClient client;
+    HTTPClient http;
+    for (int i = 0; i < 2; i++) {
+        http.setReuse(true);
+        TEST_ASSERT_TRUE(http.begin(client, urlFor(server, "/")));
+        TEST_ASSERT_EQUAL(200, http.GET());
+        http.getString();
+        http.end();
+        TEST_ASSERT_FALSE(client.connected());
+    }
+    TEST_ASSERT_EQUAL(2, server.acceptedConnections.load());
+
+    http.setReuse(false);
+    TEST_ASSERT_TRUE(http.begin(client, urlFor(server, "/")));
+    TEST_ASSERT_EQUAL(200, http.GET());
+    http.end();
+    TEST_ASSERT_TRUE(server.lastRequest().find("Connection: close") != std::string::npos);
+}
+
+// Test: Connection failures map to the ESP32 error codes
+void test_http_connection_refused() {
+    int port;
+    {
+        StandinServer server;
+        TEST_ASSERT_TRUE(server.start());
+        port = server.port();
+    }
+
+    WiFiClient client;
+    HTTPClient http;
+    TEST_ASSERT_TRUE(http.begin(client, String("http://127.0.0.1:") + String(port) + "/"));
+    TEST_ASSERT_EQUAL(HTTPC_ERROR_CONNECTION_REFUSED, http.GET());
+    TEST_ASSERT_EQUAL_STRING("connection refused", HTTPClient::errorToString(HTTPC_ERROR_CONNECTION_REFUSED).c_str());
+    TEST_ASSERT_FALSE(http.begin(client, "not a url"));
+}
+
+// Test: Remaining core pieces: base64, WiFi status, delay
+void test_core_stand_ins() {
+    TEST_ASSERT_EQUAL_STRING("dXNlcjpwYXNz", base64::encode(String("user:pass")).c_str());
+    TEST_ASSERT_EQUAL_STRING("YQ==", base64::encode(String("a")).c_str());
+    TEST_ASSERT_EQUAL(WL_CONNECTED, WiFi.status());
+
+    unsigned long start = millis();
+    delay(20);
+    TEST_ASSERT_TRUE(millis() - start >= 20);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_http_get_reuses_connection);
+    RUN_TEST(test_http_post_sends_headers_and_body);
+    RUN_TEST(test_http_chunked_response);
+    RUN_TEST(test_http_connection_close);
+    RUN_TEST(test_http_connection_refused);
+    RUN_TEST(test_core_stand_ins);
+
+    return UNITY_END();
+}
@@ -0,0 +1,111 @@
+/**
+ * test_espraw_heap.cpp - Unit tests for heap instrumentation
+ *
+ * Runs ESPrawSystemHeapProbe against the counting allocator behind the
+ * host ESP stand-in.
+ */
+
+#include <unity.h>
+#include <thread>
+#include "../src/ESPrawHeap.h"
+
+static volatile char* sink;
+
+// Test: The probe counts allocations, bytes and the peak of a call
+void test_probe_counts_allocations() {
+    ESPrawSystemHeapProbe probe;
+    ESPrawHeapStats stats;
+
+    probe.start();
+    char* a = (char*)malloc(1000);
+    char* b = new char[3000];
+    sink = a;
+    delete[] b;
+    free(a);
+    probe.stop(stats);
+
+    TEST_ASSERT_EQUAL(2, (int)stats.allocations);
+    TEST_ASSERT_EQUAL(4000, (int)stats.bytesAllocated);
+    TEST_ASSERT_TRUE(stats.peakDelta >= 4000);
+    TEST_ASSERT_TRUE(stats.peakDelta < 4200);
+    TEST_ASSERT_EQUAL(stats.freeBefore, stats.freeAfter);
+}
+
+// Test: Memory kept by a call shows as lower free heap afterwards
+void test_probe_free_heap() {
+    ESPrawSystemHeapProbe probe;
+    ESPrawHeapStats stats;
+
+    probe.start();
+    String kept;
+    kept.reserve(2000);
+    probe.stop(stats);
+
+    TEST_ASSERT_EQUAL(1, (int)stats.allocations);
+    TEST_ASSERT_TRUE(stats.freeBefore - stats.freeAfter >= 2000);
+    TEST_ASSERT_TRUE(stats.maxBlockAfter <= stats.maxBlockBefore);
+    TEST_ASSERT_TRUE(stats.peakDelta >= 2000);
+}
+
+// Test: Allocations on other threads are not charged to the call
+void test_probe_ignores_other_threads() {
+    ESPrawSystemHeapProbe probe;
+    ESPrawHeapStats stats;
+
+    probe.start();
+    std::thread other([]() {
+        for (int i = 0; i < 100; i++) {
+            free(malloc(500));
+        }
+    });
+    other.join();
+    probe.stop(stats);
+
+    // Starting the thread itself may allocate a little on this one
+    TEST_ASSERT_TRUE(stats.allocations < 10);
+    TEST_ASSERT_TRUE(stats.bytesAllocated < 50000);
+}
+
+// Test: Totals add up calls and keep the worst peak and smallest block
+void test_totals() {
+    ESPrawHeapTotals totals;
+
+    ESPrawHeapStats first;
+    first.allocations = 10;
+    first.bytesAllocated = 800;
+    first.peakDelta = 600;
+    first.freeBefore = 200000;
+    first.freeAfter = 199900;
+    first.maxBlockAfter = 110000;
+    totals.add(first);
+
+    ESPrawHeapStats second;
+    second.allocations = 5;
+    second.bytesAllocated = 300;
+    second.peakDelta = 200;
+    second.freeBefore = 199900;
+    second.freeAfter = 199950;
+    second.maxBlockAfter = 120000;
+    totals.add(second);
+
+    TEST_ASSERT_EQUAL(2, (int)totals.calls);
+    TEST_ASSERT_EQUAL(15, (int)totals.allocations);
+    TEST_ASSERT_EQUAL(1100, (int)totals.bytesAllocated);
+    TEST_ASSERT_EQUAL(600, (int)totals.maxPeakDelta);
+    TEST_ASSERT_EQUAL(110000, (int)totals.minMaxBlock);
+    TEST_ASSERT_EQUAL(50, (int)totals.heapDrift);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_probe_counts_allocations);
+    RUN_TEST(test_probe_free_heap);
+    RUN_TEST(test_probe_ignores_other_threads);
+    RUN_TEST(test_totals);
+
+    return UNITY_END();
+}
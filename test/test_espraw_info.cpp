@@ -0,0 +1,241 @@
+/**
+ * test_espraw_info.cpp - Unit tests for looking up objects by fullname
+ * and for ESPraw::submission(), which goes through the same lookup
+ *
+ * The token comes from the loopback stand-in server; /api/info requests
+ * are answered from a replay transport.
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <vector>
+#include <string>
+#include "replay_reddit.h"
+
+static StandinServer* tokenServer;
+static ESPraw* reddit;
+static ESPrawReplayTransport* replay;
+
+// Fullname of the n-th tracked post (t3_p000, t3_p001, ...)
+static String postName(int n) {
+    char name[16];
+    snprintf(name, sizeof(name), "t3_p%03d", n);
+    return String(name);
+}
+
+// /api/info answer listing the given fullnames
+static String infoListing(const std::vector<String>& fullnames) {
+    std::string json = "{\"kind\":\"Listing\",\"data\":{\"after\":null,\"dist\":" +
+                       std::to_string(fullnames.size()) + ",\"children\":[";
+    for (size_t i = 0; i < fullnames.size(); i++) {
+        std::string name = fullnames[i].c_str();
+        std::string kind = name.substr(0, 2);
+        std::string id = name.substr(3);
+        if (i > 0) {
+            json += ",";
+        }
+        json += "{\"kind\":\"" + kind + "\",\"data\":{\"id\":\"" + id + "\",\"name\":\"" + name +
+                "\",\"title\":\"Post " + id + "\",\"body\":\"Comment " + id +
+                "\",\"display_name\":\"" + id + "\",\"score\":" + std::to_string(i + 1) + "}}";
+    }
+    json += "],\"before\":null}}";
+    return String(json.c_str());
+}
+
+// Posts first to last-1
+static std::vector<String> postNames(int first, int last) {
+    std::vector<String> names;
+    for (int n = first; n < last; n++) {
+        names.push_back(postName(n));
+    }
+    return names;
+}
+
+// Record the answer to the batch starting at the first fullname
+static void addBatch(const std::vector<String>& fullnames) {
+    replay->addResponse("/api/info?id=" + fullnames[0] + ",", 200, infoListing(fullnames));
+}
+
+// Look up fullnames, appending the fullname of each result
+static int lookUp(const std::vector<String>& fullnames, std::vector<String>& seen) {
+    return reddit->info(fullnames,
+        [&](Submission& post) { seen.push_back(post.getFullname()); return true; },
+        [&](Comment& comment) { seen.push_back(comment.getFullname()); return true; },
+        [&](Subreddit& sub) { seen.push_back("t5_" + sub.getDisplayName()); return true; });
+}
+
+void setUp(void) {
+    tokenServer = new StandinServer();
+    tokenServer->body = standinTokenBody();
+    replay = new ESPrawReplayTransport();
+
+    // Failures are reported at once rather than after retry backoff
+    ESPrawRequestConfig requestConfig;
+    requestConfig.maxRetries = 0;
+
+    reddit = beginReplayReddit(*tokenServer, *replay, requestConfig);
+    TEST_ASSERT_NOT_NULL(reddit);
+}
+
+void tearDown(void) {
+    endReplayReddit(reddit);
+    delete replay;
+    delete tokenServer;
+}
+
+// Test: A full batch goes out as one request
+void test_info_single_batch() {
+    std::vector<String> tracked = postNames(0, ESPRAW_INFO_BATCH_SIZE);
+    addBatch(tracked);
+
+    std::vector<String> seen;
+    TEST_ASSERT_EQUAL(ESPRAW_INFO_BATCH_SIZE, lookUp(tracked, seen));
+    TEST_ASSERT_EQUAL(1, (int)replay->getRequestCount());
+    TEST_ASSERT_TRUE(replay->getLastRequest().endsWith(",t3_p099&limit=100"));
+    TEST_ASSERT_EQUAL_STRING("t3_p000", seen[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("t3_p099", seen[99].c_str());
+}
+
+// Test: A longer list is split into batches and the results merged in order
+void test_info_splits_batches() {
+    std::vector<String> tracked = postNames(0, 250);
+    addBatch(postNames(0, 100));
+    addBatch(postNames(100, 200));
+    addBatch(postNames(200, 250));
+
+    std::vector<String> seen;
+    TEST_ASSERT_EQUAL(250, lookUp(tracked, seen));
+    TEST_ASSERT_EQUAL(3, (int)replay->getRequestCount());
+    TEST_ASSERT_TRUE(replay->getLastRequest().startsWith("GET /api/info?id=t3_p200,t3_p201,"));
+    TEST_ASSERT_TRUE(replay->getLastRequest().endsWith(",t3_p249&limit=50"));
+
+    TEST_ASSERT_EQUAL(250, (int)seen.size());
+    for (int n = 0; n < 250; n++) {
+        TEST_ASSERT_EQUAL_STRING(postName(n).c_str(), seen[n].c_str());
+    }
+}
+
+// Test: Kinds are mixed in one batch, and missing objects are left out
+void test_info_mixed_kinds() {
+    std::vector<String> tracked = { "t3_a", "t1_b", "t5_c", "t3_gone" };
+    replay->addResponse("/api/info?id=t3_a,t1_b,t5_c,t3_gone&limit=4", 200,
+                        infoListing({ "t3_a", "t1_b", "t5_c" }));
+
+    std::vector<String> seen;
+    TEST_ASSERT_EQUAL(3, lookUp(tracked, seen));
+    TEST_ASSERT_EQUAL(3, (int)seen.size());
+    TEST_ASSERT_EQUAL_STRING("t3_a", seen[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("t1_b", seen[1].c_str());
+    TEST_ASSERT_EQUAL_STRING("t5_c", seen[2].c_str());
+}
+
+// Test: Kinds come from the fullnames, shared through the string pool
+void test_info_kinds() {
+    ESPrawStringPool pool;
+    reddit->setStringPool(&pool);
+    std::vector<String> tracked = { "t3_a", "t1_b", "t3_c", "t5_d" };
+    replay->addResponse("/api/info", 200, infoListing(tracked));
+
+    std::vector<String> kinds;
+    std::vector<Submission> kept;
+    TEST_ASSERT_EQUAL(4, reddit->info(tracked,
+        [&](Submission& post) {
+            kinds.push_back(post.getKind());
+            kept.push_back(std::move(post));
+            return true;
+        },
+        [&](Comment& comment) { kinds.push_back(comment.getKind()); return true; },
+        [&](Subreddit& sub) { kinds.push_back(sub.getKind()); return true; }));
+    TEST_ASSERT_EQUAL_STRING("t3", kinds[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("t1", kinds[1].c_str());
+    TEST_ASSERT_EQUAL_STRING("t3", kinds[2].c_str());
+    TEST_ASSERT_EQUAL_STRING("t5", kinds[3].c_str());
+
+    // The second submission found "t3" in the pool, held by the first
+    TEST_ASSERT_EQUAL(1, (int)pool.getStats().hits);
+
+    reddit->setStringPool(nullptr);
+}
+
+// Test: A callback stopping ends the lookup without the later batches
+void test_info_stop_skips_later_batches() {
+    addBatch(postNames(0, 100));
+    addBatch(postNames(100, 150));
+
+    int visited = reddit->info(postNames(0, 150), [](Submission& post) {
+        return post.getFullname() != "t3_p010";
+    });
+    TEST_ASSERT_EQUAL(11, visited);
+    TEST_ASSERT_EQUAL(1, (int)replay->getRequestCount());
+}
+
+// Test: Fullnames without a kind prefix are rejected before any request
+void test_info_rejects_bare_ids() {
+    std::vector<String> seen;
+    std::vector<String> bare = { "t3_a", "abc123" };
+    TEST_ASSERT_EQUAL(-1, lookUp(bare, seen));
+
+    std::vector<String> account = { "t2_a" };
+    TEST_ASSERT_EQUAL(-1, lookUp(account, seen));
+
+    std::vector<String> empty = { "t3_" };
+    TEST_ASSERT_EQUAL(-1, lookUp(empty, seen));
+
+    TEST_ASSERT_EQUAL(0, (int)replay->getRequestCount());
+    TEST_ASSERT_EQUAL(0, (int)seen.size());
+}
+
+// Test: A failed request is reported
+void test_info_request_failure() {
+    replay->addResponse("/api/info", 403, "{\"message\":\"Forbidden\",\"error\":403}");
+
+    std::vector<String> seen;
+    TEST_ASSERT_EQUAL(-1, lookUp(postNames(0, 3), seen));
+}
+
+// Test: submission() fetches the post alone through /api/info
+void test_submission_found() {
+    replay->addResponse("/api/info?id=t3_abc123&limit=1", 200, infoListing({ "t3_abc123" }));
+
+    ESPrawPtr<Submission> post = reddit->submission("abc123");
+    TEST_ASSERT_NOT_NULL(post.get());
+    TEST_ASSERT_EQUAL_STRING("abc123", post->getId().c_str());
+    TEST_ASSERT_EQUAL_STRING("t3_abc123", post->getFullname().c_str());
+    TEST_ASSERT_EQUAL_STRING("Post abc123", post->getTitle().c_str());
+    TEST_ASSERT_EQUAL(1, post->getScore());
+    TEST_ASSERT_EQUAL(1, (int)replay->getRequestCount());
+
+    // The URL form takes the same route
+    ESPrawPtr<Submission> byUrl =
+        reddit->submissionByUrl("https://www.reddit.com/r/esp32/comments/abc123/weather_station/");
+    TEST_ASSERT_NOT_NULL(byUrl.get());
+    TEST_ASSERT_EQUAL_STRING("GET /api/info?id=t3_abc123&limit=1", replay->getLastRequest().c_str());
+}
+
+// Test: submission() returns nullptr when /api/info has nothing for the ID
+void test_submission_not_found() {
+    replay->addResponse("/api/info", 200, infoListing({}));
+
+    TEST_ASSERT_NULL(reddit->submission("gone").get());
+    TEST_ASSERT_EQUAL_STRING("GET /api/info?id=t3_gone&limit=1", replay->getLastRequest().c_str());
+
+    // Nor is anything requested for a URL without a submission ID
+    TEST_ASSERT_NULL(reddit->submissionByUrl("https://www.reddit.com/r/esp32/").get());
+    TEST_ASSERT_EQUAL(1, (int)replay->getRequestCount());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_info_single_batch);
+    RUN_TEST(test_info_splits_batches);
+    RUN_TEST(test_info_mixed_kinds);
+    RUN_TEST(test_info_kinds);
+    RUN_TEST(test_info_stop_skips_later_batches);
+    RUN_TEST(test_info_rejects_bare_ids);
+    RUN_TEST(test_info_request_failure);
+    RUN_TEST(test_submission_found);
+    RUN_TEST(test_submission_not_found);
+
+    return UNITY_END();
+}
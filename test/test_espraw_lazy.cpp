@@ -0,0 +1,196 @@
+/**
+ * test_espraw_lazy.cpp - Unit tests for lazily parsed models
+ *
+ * Builds Submission and Comment in both parse modes from the same JSON
+ * and checks that they agree, that detach() outlives the document, and
+ * that a ListingIterator in LAZY mode hands out readable objects.
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+#include "replay_reddit.h"
+#include "models/ListingIterator.h"
+
+static const char* SUBMISSION_DATA =
+    "{\"id\":\"abc123\",\"name\":\"t3_abc123\",\"created\":1700000100,\"created_utc\":1700000000,"
+    "\"title\":\"ESP32 weather station\",\"author\":\"maker\",\"subreddit\":\"esp32\","
+    "\"selftext\":\"Build log\",\"url\":\"https://example.com/ws\",\"domain\":\"example.com\","
+    "\"permalink\":\"/r/esp32/comments/abc123/\",\"score\":42,\"upvote_ratio\":97,"
+    "\"num_comments\":7,\"over_18\":false,\"spoiler\":true,\"locked\":false,"
+    "\"stickied\":true,\"is_self\":true}";
+
+static const char* COMMENT_DATA =
+    "{\"id\":\"c1\",\"name\":\"t1_c1\",\"created_utc\":1700000500,\"body\":\"Nice build!\","
+    "\"author\":\"reader\",\"subreddit\":\"esp32\",\"parent_id\":\"t3_abc123\","
+    "\"link_id\":\"t3_abc123\",\"permalink\":\"/r/esp32/comments/abc123/_/c1/\","
+    "\"score\":5,\"depth\":2,\"is_submitter\":true,\"score_hidden\":false}";
+
+static StandinServer* tokenServer;
+static ESPraw* reddit;
+static ESPrawReplayTransport* replay;
+
+// Compare every field of two submissions
+static void assertSameSubmission(const Submission& expected, const Submission& actual) {
+    TEST_ASSERT_EQUAL(expected.isValid(), actual.isValid());
+    TEST_ASSERT_EQUAL_STRING(expected.getId().c_str(), actual.getId().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getFullname().c_str(), actual.getFullname().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getKind().c_str(), actual.getKind().c_str());
+    TEST_ASSERT_EQUAL_UINT32(expected.getCreated(), actual.getCreated());
+    TEST_ASSERT_EQUAL_UINT32(expected.getCreatedUtc(), actual.getCreatedUtc());
+    TEST_ASSERT_EQUAL_STRING(expected.getTitle().c_str(), actual.getTitle().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getAuthor().c_str(), actual.getAuthor().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getSubreddit().c_str(), actual.getSubreddit().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getSelftext().c_str(), actual.getSelftext().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getUrl().c_str(), actual.getUrl().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getDomain().c_str(), actual.getDomain().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getPermalink().c_str(), actual.getPermalink().c_str());
+    TEST_ASSERT_EQUAL(expected.getScore(), actual.getScore());
+    TEST_ASSERT_EQUAL(expected.getUpvoteRatio(), actual.getUpvoteRatio());
+    TEST_ASSERT_EQUAL(expected.getNumComments(), actual.getNumComments());
+    TEST_ASSERT_EQUAL(expected.isOver18(), actual.isOver18());
+    TEST_ASSERT_EQUAL(expected.isSpoiler(), actual.isSpoiler());
+    TEST_ASSERT_EQUAL(expected.isLocked(), actual.isLocked());
+    TEST_ASSERT_EQUAL(expected.isStickied(), actual.isStickied());
+    TEST_ASSERT_EQUAL(expected.isSelf(), actual.isSelf());
+}
+
+// Compare every field of two comments
+static void assertSameComment(const Comment& expected, const Comment& actual) {
+    TEST_ASSERT_EQUAL(expected.isValid(), actual.isValid());
+    TEST_ASSERT_EQUAL_STRING(expected.getId().c_str(), actual.getId().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getFullname().c_str(), actual.getFullname().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getKind().c_str(), actual.getKind().c_str());
+    TEST_ASSERT_EQUAL_UINT32(expected.getCreatedUtc(), actual.getCreatedUtc());
+    TEST_ASSERT_EQUAL_STRING(expected.getBody().c_str(), actual.getBody().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getAuthor().c_str(), actual.getAuthor().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getSubreddit().c_str(), actual.getSubreddit().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getParentId().c_str(), actual.getParentId().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getLinkId().c_str(), actual.getLinkId().c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.getPermalink().c_str(), actual.getPermalink().c_str());
+    TEST_ASSERT_EQUAL(expected.getScore(), actual.getScore());
+    TEST_ASSERT_EQUAL(expected.getDepth(), actual.getDepth());
+    TEST_ASSERT_EQUAL(expected.isSubmitter(), actual.isSubmitter());
+    TEST_ASSERT_EQUAL(expected.isScoreHidden(), actual.isScoreHidden());
+}
+
+void setUp(void) {
+    tokenServer = new StandinServer();
+    tokenServer->body = standinTokenBody();
+    replay = new ESPrawReplayTransport();
+    reddit = beginReplayReddit(*tokenServer, *replay);
+    TEST_ASSERT_NOT_NULL(reddit);
+}
+
+void tearDown(void) {
+    endReplayReddit(reddit);
+    delete replay;
+    delete tokenServer;
+}
+
+// Test: LAZY submission getters return what EAGER parsing copies
+void test_lazy_submission_matches_eager() {
+    DynamicJsonDocument doc(2048);
+    TEST_ASSERT_FALSE(deserializeJson(doc, SUBMISSION_DATA));
+
+    Submission eager(reddit, doc.as<JsonObject>());
+    Submission lazy(reddit, doc.as<JsonObject>(), ESPrawParseMode::LAZY);
+    TEST_ASSERT_FALSE(eager.isLazy());
+    TEST_ASSERT_TRUE(lazy.isLazy());
+    TEST_ASSERT_EQUAL_STRING("t3", eager.getKind().c_str());
+    TEST_ASSERT_EQUAL(42, eager.getScore());
+
+    assertSameSubmission(eager, lazy);
+
+    // Fields missing from the JSON fall back to the same defaults
+    DynamicJsonDocument sparse(256);
+    TEST_ASSERT_FALSE(deserializeJson(sparse, "{\"id\":\"x\"}"));
+    assertSameSubmission(Submission(reddit, sparse.as<JsonObject>()),
+                         Submission(reddit, sparse.as<JsonObject>(), ESPrawParseMode::LAZY));
+}
+
+// Test: LAZY comment getters return what EAGER parsing copies
+void test_lazy_comment_matches_eager() {
+    DynamicJsonDocument doc(2048);
+    TEST_ASSERT_FALSE(deserializeJson(doc, COMMENT_DATA));
+
+    Comment eager(reddit, doc.as<JsonObject>());
+    Comment lazy(reddit, doc.as<JsonObject>(), ESPrawParseMode::LAZY);
+    TEST_ASSERT_TRUE(lazy.isLazy());
+    TEST_ASSERT_EQUAL_STRING("Nice build!", eager.getBody().c_str());
+
+    assertSameComment(eager, lazy);
+}
+
+// Test: detach() keeps the values once the document is reused
+void test_detach_survives_document_reuse() {
+    DynamicJsonDocument doc(2048);
+    TEST_ASSERT_FALSE(deserializeJson(doc, SUBMISSION_DATA));
+    Submission expected(reddit, doc.as<JsonObject>());
+
+    // Read one field first: detach() decodes the rest
+    Submission post(reddit, doc.as<JsonObject>(), ESPrawParseMode::LAZY);
+    TEST_ASSERT_EQUAL_STRING("maker", post.getAuthor().c_str());
+    post.detach();
+    TEST_ASSERT_FALSE(post.isLazy());
+
+    TEST_ASSERT_FALSE(deserializeJson(doc, COMMENT_DATA));
+    Comment reply(reddit, doc.as<JsonObject>(), ESPrawParseMode::LAZY);
+    reply.detach();
+
+    // The next item replaced everything the lazy objects pointed into
+    TEST_ASSERT_FALSE(deserializeJson(doc, "{\"id\":\"zzz\",\"title\":\"Other\",\"score\":1}"));
+    assertSameSubmission(expected, post);
+    TEST_ASSERT_EQUAL_STRING("Nice build!", reply.getBody().c_str());
+    TEST_ASSERT_EQUAL_STRING("t1_c1", reply.getFullname().c_str());
+    TEST_ASSERT_EQUAL(2, reply.getDepth());
+}
+
+// Test: Objects handed to callbacks in LAZY mode read correctly there
+void test_iterator_lazy_mode() {
+    replay->addResponse("/r/esp32/new", 200,
+        "{\"kind\":\"Listing\",\"data\":{\"after\":null,\"children\":["
+        "{\"kind\":\"t3\",\"data\":{\"id\":\"a\",\"name\":\"t3_a\",\"title\":\"First\",\"author\":\"maker\",\"score\":1}},"
+        "{\"kind\":\"t3\",\"data\":{\"id\":\"b\",\"name\":\"t3_b\",\"title\":\"Second\",\"author\":\"reader\",\"score\":2}},"
+        "{\"kind\":\"t3\",\"data\":{\"id\":\"c\",\"name\":\"t3_c\",\"title\":\"Third\",\"author\":\"maker\",\"score\":3}}"
+        "]}}");
+
+    ListingIterator iterator(reddit, "/r/esp32/new");
+    iterator.setParseMode(ESPrawParseMode::LAZY);
+    std::vector<Submission> kept;
+    std::string titles;
+    int lazy = 0;
+
+    TEST_ASSERT_EQUAL(3, iterator.forEachSubmission([&](Submission& post) {
+        lazy += post.isLazy() ? 1 : 0;
+        titles += post.getTitle().c_str();
+        TEST_ASSERT_EQUAL_STRING("t3", post.getKind().c_str());
+        if (post.getScore() != 2) {
+            post.detach();
+            kept.push_back(std::move(post));
+        }
+        return true;
+    }));
+
+    TEST_ASSERT_EQUAL(3, lazy);
+    TEST_ASSERT_EQUAL_STRING("FirstSecondThird", titles.c_str());
+
+    // Detached copies outlive the item buffer
+    TEST_ASSERT_EQUAL(2, (int)kept.size());
+    TEST_ASSERT_EQUAL_STRING("First", kept[0].getTitle().c_str());
+    TEST_ASSERT_EQUAL_STRING("maker", kept[1].getAuthor().c_str());
+    TEST_ASSERT_EQUAL_STRING("t3_c", kept[1].getFullname().c_str());
+    TEST_ASSERT_EQUAL(3, kept[1].getScore());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_lazy_submission_matches_eager);
+    RUN_TEST(test_lazy_comment_matches_eager);
+    RUN_TEST(test_detach_survives_document_reuse);
+    RUN_TEST(test_iterator_lazy_mode);
+
+    return UNITY_END();
+}
@@ -0,0 +1,218 @@
+/**
+ * test_espraw_listing.cpp - Unit tests for the streaming listing iterator
+ *
+ * The token comes from the loopback stand-in server; API requests are
+ * answered from a replay transport, so each test controls every page.
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <vector>
+#include <string>
+#include "replay_reddit.h"
+#include "models/ListingIterator.h"
+
+static StandinServer* tokenServer;
+static ESPraw* reddit;
+static ESPrawReplayTransport* replay;
+
+/**
+ * Build a listing page
+ * @param after Cursor of the next page (nullptr for the last page)
+ * @param kinds Kind of each child ("t3", "t1", "more")
+ * @param ids ID of each child
+ */
+static String page(const char* after, const std::vector<std::string>& kinds,
+                   const std::vector<std::string>& ids) {
+    std::string json = "{\"kind\":\"Listing\",\"data\":{\"after\":";
+    json += after ? std::string("\"") + after + "\"" : std::string("null");
+    json += ",\"dist\":" + std::to_string(ids.size()) + ",\"children\":[";
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (i > 0) {
+            json += ",";
+        }
+        const std::string& kind = kinds[i];
+        json += "{\"kind\":\"" + kind + "\",\"data\":{\"id\":\"" + ids[i] + "\",\"name\":\"" +
+                kind + "_" + ids[i] + "\",\"title\":\"Post " + ids[i] + "\",\"body\":\"Comment " +
+                ids[i] + "\",\"score\":" + std::to_string(i + 1) + "}}";
+    }
+    json += "],\"before\":null}}";
+    return String(json.c_str());
+}
+
+// Page of submissions
+static String posts(const char* after, const std::vector<std::string>& ids) {
+    return page(after, std::vector<std::string>(ids.size(), "t3"), ids);
+}
+
+void setUp(void) {
+    tokenServer = new StandinServer();
+    tokenServer->body = standinTokenBody();
+    replay = new ESPrawReplayTransport();
+    reddit = beginReplayReddit(*tokenServer, *replay);
+    TEST_ASSERT_NOT_NULL(reddit);
+}
+
+void tearDown(void) {
+    endReplayReddit(reddit);
+    delete replay;
+    delete tokenServer;
+}
+
+// Test: A blocking call from a callback is rejected instead of reading
+// the rest of the page from the nested response
+void test_nested_request_rejected() {
+    replay->addResponse("/api/v1/me", 200, "{\"name\":\"maker\"}");
+    replay->addResponse("/r/esp32/new", 200, posts(nullptr, {"a", "b", "c"}));
+
+    ListingIterator iterator(reddit, "/r/esp32/new");
+    std::vector<std::string> seen;
+    std::vector<std::string> errors;
+    int visited = iterator.forEachSubmission([&](Submission& post) {
+        seen.push_back(post.getId().c_str());
+        ESPrawResponse nested = reddit->get("/api/v1/me");
+        errors.push_back(nested.success ? "" : nested.error.c_str());
+        return true;
+    });
+
+    TEST_ASSERT_EQUAL(3, visited);
+    TEST_ASSERT_EQUAL(3, (int)seen.size());
+    TEST_ASSERT_EQUAL_STRING("c", seen[2].c_str());
+    TEST_ASSERT_EQUAL_STRING("Request already in progress", errors[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("Request already in progress", errors[2].c_str());
+    TEST_ASSERT_EQUAL(1, (int)replay->getRequestCount());
+
+    // The connection is free again once the iteration returns
+    TEST_ASSERT_TRUE(reddit->get("/api/v1/me").success);
+}
+
+// Replay a five-post listing in pages of two; more specific paths first
+static void addPagedListing() {
+    replay->addResponse("/r/esp32/new?limit=2&after=t3_d&count=4", 200, posts(nullptr, {"e"}));
+    replay->addResponse("/r/esp32/new?limit=2&after=t3_b&count=2", 200, posts("t3_d", {"c", "d"}));
+    replay->addResponse("/r/esp32/new?limit=2", 200, posts("t3_b", {"a", "b"}));
+}
+
+// Visit submissions, appending their IDs, until the one to stop at
+static int visit(ListingIterator& iterator, std::string& seen, const char* stopAt = "") {
+    return iterator.forEachSubmission([&](Submission& post) {
+        seen += post.getId().c_str();
+        return post.getId() != stopAt;
+    });
+}
+
+// Test: Pages are followed through the after cursor and count
+void test_paging() {
+    addPagedListing();
+
+    ListingIterator iterator(reddit, "/r/esp32/new");
+    iterator.setPageSize(2);
+    std::string seen;
+
+    TEST_ASSERT_EQUAL(5, visit(iterator, seen));
+    TEST_ASSERT_EQUAL_STRING("abcde", seen.c_str());
+    TEST_ASSERT_EQUAL(3, (int)replay->getRequestCount());
+    TEST_ASSERT_FALSE(iterator.hasMore());
+    TEST_ASSERT_TRUE(iterator.getError().isEmpty());
+}
+
+// Test: The limit trims the last request and ends the iteration
+void test_limit() {
+    replay->addResponse("/r/esp32/new?limit=1&after=t3_b&count=2", 200, posts("t3_c", {"c"}));
+    addPagedListing();
+
+    ListingIterator iterator(reddit, "/r/esp32/new");
+    iterator.setPageSize(2);
+    iterator.setLimit(3);
+    std::string seen;
+
+    TEST_ASSERT_EQUAL(3, visit(iterator, seen));
+    TEST_ASSERT_EQUAL_STRING("abc", seen.c_str());
+    TEST_ASSERT_EQUAL(2, (int)replay->getRequestCount());
+    TEST_ASSERT_EQUAL_STRING("GET /r/esp32/new?limit=1&after=t3_b&count=2",
+                             replay->getLastRequest().c_str());
+    TEST_ASSERT_FALSE(iterator.hasMore());
+}
+
+// Test: An iteration stopped mid-page resumes with the next item
+void test_early_stop_resumes() {
+    addPagedListing();
+
+    ListingIterator iterator(reddit, "/r/esp32/new");
+    iterator.setPageSize(2);
+    std::string seen;
+
+    TEST_ASSERT_EQUAL(3, visit(iterator, seen, "c"));
+    TEST_ASSERT_EQUAL_STRING("abc", seen.c_str());
+    TEST_ASSERT_TRUE(iterator.hasMore());
+    TEST_ASSERT_EQUAL_STRING("t3_b", iterator.getAfter().c_str());
+
+    // The second page is requested again and "c" is not repeated
+    TEST_ASSERT_EQUAL(2, visit(iterator, seen));
+    TEST_ASSERT_EQUAL_STRING("abcde", seen.c_str());
+    TEST_ASSERT_EQUAL(4, (int)replay->getRequestCount());
+    TEST_ASSERT_FALSE(iterator.hasMore());
+
+    // Stopping on the last item of a page resumes on the next page
+    iterator.reset();
+    seen = "";
+    TEST_ASSERT_EQUAL(2, visit(iterator, seen, "b"));
+    TEST_ASSERT_EQUAL(3, visit(iterator, seen));
+    TEST_ASSERT_EQUAL_STRING("abcde", seen.c_str());
+}
+
+// Test: A resumed page keeps the size it was first requested with
+void test_early_stop_resumes_within_limit() {
+    replay->addResponse("/r/esp32/new?limit=1&after=t3_b&count=2", 200, posts("t3_c", {"c"}));
+    addPagedListing();
+
+    ListingIterator iterator(reddit, "/r/esp32/new");
+    iterator.setPageSize(2);
+    iterator.setLimit(3);
+    std::string seen;
+
+    TEST_ASSERT_EQUAL(1, visit(iterator, seen, "a"));
+    TEST_ASSERT_EQUAL_STRING("GET /r/esp32/new?limit=2", replay->getLastRequest().c_str());
+    TEST_ASSERT_EQUAL(2, visit(iterator, seen));
+    TEST_ASSERT_EQUAL_STRING("abc", seen.c_str());
+    TEST_ASSERT_FALSE(iterator.hasMore());
+}
+
+// Test: "more" placeholders are skipped but keep their place in the page
+void test_more_skipped() {
+    replay->addResponse("/comments/abc", 200,
+                        page(nullptr, {"t1", "more", "t1"}, {"c1", "m1", "c2"}));
+
+    ListingIterator iterator(reddit, "/comments/abc");
+    std::string seen;
+    auto onComment = [&](Comment& comment) {
+        seen += comment.getId().c_str();
+        return comment.getId() != "c1";
+    };
+
+    TEST_ASSERT_EQUAL(1, iterator.forEachComment(onComment));
+    TEST_ASSERT_EQUAL(1, iterator.forEachComment(onComment));
+    TEST_ASSERT_EQUAL_STRING("c1c2", seen.c_str());
+
+    // Listings of mixed kinds skip them too
+    ListingIterator things(reddit, "/comments/abc");
+    int comments = 0;
+    TEST_ASSERT_EQUAL(2, things.forEachThing(nullptr, [&](Comment&) {
+        comments++;
+        return true;
+    }, nullptr));
+    TEST_ASSERT_EQUAL(2, comments);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_nested_request_rejected);
+    RUN_TEST(test_paging);
+    RUN_TEST(test_limit);
+    RUN_TEST(test_early_stop_resumes);
+    RUN_TEST(test_early_stop_resumes_within_limit);
+    RUN_TEST(test_more_skipped);
+
+    return UNITY_END();
+}
@@ -0,0 +1,133 @@
+/**
+ * test_espraw_pool.cpp - Unit tests for model pools and owning pointers
+ *
+ * Allocation counts come from the counting allocator behind the host
+ * ESP stand-in.
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <Esp.h>
+#include <set>
+#include <vector>
+#include "ESPrawPool.h"
+
+static int liveModels = 0;
+
+// Stands in for a model: polymorphic, with a String member
+class TestModel {
+public:
+    explicit TestModel(const String& name) : _name(name) { liveModels++; }
+    virtual ~TestModel() { liveModels--; }
+    const String& getName() const { return _name; }
+
+private:
+    String _name;
+};
+
+// Test: Released slots are handed out again
+void test_slots_reused() {
+    ESPrawPool<TestModel> pool(2);
+    TEST_ASSERT_EQUAL(2, (int)pool.capacity());
+
+    TestModel* first = pool.create("first");
+    TestModel* second = pool.create("second");
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_NULL(pool.create("third"));
+    TEST_ASSERT_EQUAL(2, (int)pool.inUse());
+    TEST_ASSERT_TRUE(pool.owns(first));
+    TEST_ASSERT_EQUAL_STRING("second", second->getName().c_str());
+
+    pool.destroy(first);
+    TEST_ASSERT_EQUAL(1, liveModels);
+    TestModel* again = pool.create("again");
+    TEST_ASSERT_TRUE(again == first);
+
+    pool.destroy(again);
+    pool.destroy(second);
+    TEST_ASSERT_EQUAL(0, (int)pool.inUse());
+    TEST_ASSERT_EQUAL(0, liveModels);
+}
+
+// Test: Pointers return objects to the pool, or to the heap without one
+void test_pointers() {
+    ESPrawPool<TestModel> pool(1);
+    {
+        ESPrawPtr<TestModel> pooled = ESPrawPool<TestModel>::make(&pool, "pooled");
+        ESPrawPtr<TestModel> overflow = ESPrawPool<TestModel>::make(&pool, "overflow");
+        ESPrawPtr<TestModel> heap = ESPrawPool<TestModel>::make(nullptr, "heap");
+
+        TEST_ASSERT_TRUE(pool.owns(pooled.get()));
+        TEST_ASSERT_FALSE(pool.owns(overflow.get()));
+        TEST_ASSERT_FALSE(pool.owns(heap.get()));
+        TEST_ASSERT_EQUAL(1, (int)pool.overflows());
+        TEST_ASSERT_EQUAL(3, liveModels);
+
+        // Moving keeps the slot with the object
+        ESPrawPtr<TestModel> moved = std::move(pooled);
+        TEST_ASSERT_TRUE(pool.owns(moved.get()));
+        TEST_ASSERT_EQUAL(1, (int)pool.inUse());
+    }
+    TEST_ASSERT_EQUAL(0, (int)pool.inUse());
+    TEST_ASSERT_EQUAL(0, liveModels);
+}
+
+/**
+ * Poll once a minute for a day: look up a model while the previous
+ * poll's response body is still alive, as a bot's loop() does
+ * @param pool Pool for the lookups, or nullptr for the heap
+ * @param blocks Receives every distinct address a model was built at
+ * @return Allocations made by the polls
+ */
+static unsigned long soak(ESPrawPool<TestModel>* pool, std::set<const void*>& blocks) {
+    const int polls = 24 * 60;
+    std::vector<const void*> addresses;
+    addresses.reserve(polls);
+    String body;
+    unsigned long before = ESP.getThreadAllocations();
+
+    for (int minute = 0; minute < polls; minute++) {
+        ESPrawPtr<TestModel> sub = ESPrawPool<TestModel>::make(pool, "esp32_and_friends_subreddit");
+        addresses.push_back(sub.get());
+        body = String(std::string(64 + (minute * 37) % 512, 'x').c_str());
+    }
+
+    unsigned long allocations = ESP.getThreadAllocations() - before;
+    blocks.insert(addresses.begin(), addresses.end());
+    return allocations;
+}
+
+// Test: A day of polling builds every model in the same few slots
+void test_soak_day_of_polling() {
+    std::set<const void*> heapBlocks;
+    unsigned long heapAllocations = soak(nullptr, heapBlocks);
+
+    ESPrawPool<TestModel> pool(4);
+    std::set<const void*> pooledBlocks;
+    unsigned long pooledAllocations = soak(&pool, pooledBlocks);
+
+    // One object allocation fewer per poll, and nothing left outstanding
+    TEST_ASSERT_EQUAL(24 * 60, (int)(heapAllocations - pooledAllocations));
+    TEST_ASSERT_EQUAL(1, (int)pooledBlocks.size());
+    TEST_ASSERT_TRUE(pool.owns((const TestModel*)*pooledBlocks.begin()));
+    TEST_ASSERT_EQUAL(0, (int)pool.overflows());
+    TEST_ASSERT_EQUAL(0, (int)pool.inUse());
+    TEST_ASSERT_EQUAL(0, liveModels);
+}
+
+void setUp(void) {
+    liveModels = 0;
+}
+
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_slots_reused);
+    RUN_TEST(test_pointers);
+    RUN_TEST(test_soak_day_of_polling);
+
+    return UNITY_END();
+}
@@ -0,0 +1,148 @@
+/**
+ * test_espraw_ratelimit.cpp - Unit tests for the rate limiters
+ *
+ * Builds the real limiters from ESPrawRateLimit.cpp and drives them with a
+ * fake clock, including across the point where millis() wraps to zero.
+ */
+
+#include <unity.h>
+#include <vector>
+#include <climits>
+#include "ESPrawRateLimit.h"
+
+// A few seconds before millis() wraps
+static const unsigned long NEAR_WRAP = ULONG_MAX - 4999;
+
+// Greedy client: sends whenever the limiter allows, for `duration` ms
+static std::vector<unsigned long> sendGreedily(ESPrawRateLimiter& limiter, unsigned long start,
+                                               unsigned long duration, unsigned long step) {
+    std::vector<unsigned long> sent;
+    for (unsigned long elapsed = 0; elapsed < duration; elapsed += step) {
+        unsigned long now = start + elapsed;
+        while (limiter.canRequest(now)) {
+            limiter.recordRequest(now);
+            sent.push_back(now);
+        }
+    }
+    return sent;
+}
+
+// Most requests sent within any `window` ms (times may wrap)
+static size_t maxInWindow(const std::vector<unsigned long>& sent, unsigned long window) {
+    size_t best = 0;
+    size_t first = 0;
+    for (size_t i = 0; i < sent.size(); i++) {
+        while (sent[i] - sent[first] >= window) {
+            first++;
+        }
+        if (i - first + 1 > best) {
+            best = i - first + 1;
+        }
+    }
+    return best;
+}
+
+// Test: Token bucket allows a burst, then one request per interval
+void test_token_bucket_burst_then_rate() {
+    ESPrawTokenBucketLimiter limiter(60, 60000, 5);
+
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(limiter.canRequest(1000));
+        limiter.recordRequest(1000);
+    }
+    TEST_ASSERT_FALSE(limiter.canRequest(1000));
+    TEST_ASSERT_EQUAL_UINT32(1000, limiter.timeUntilNextRequest(1000));
+    TEST_ASSERT_EQUAL_UINT32(1, limiter.timeUntilNextRequest(1999));
+    TEST_ASSERT_TRUE(limiter.canRequest(2000));
+
+    // Idle time refills the bucket up to the burst size only
+    TEST_ASSERT_EQUAL_UINT32(0, limiter.timeUntilNextRequest(1000000));
+    std::vector<unsigned long> sent = sendGreedily(limiter, 1000000, 1, 1);
+    TEST_ASSERT_EQUAL(5, (int)sent.size());
+}
+
+// Test: Token bucket budget holds across millis() rollover
+void test_token_bucket_rollover() {
+    ESPrawTokenBucketLimiter limiter(60, 60000, 10);
+    std::vector<unsigned long> sent = sendGreedily(limiter, NEAR_WRAP, 300000, 50);
+
+    // Burst plus one request per second for the rest of the 300 s
+    TEST_ASSERT_INT_WITHIN(1, 10 + 300, (int)sent.size());
+    TEST_ASSERT_TRUE(maxInWindow(sent, 60000) <= 60 + 10);
+    TEST_ASSERT_TRUE(sent.back() < NEAR_WRAP); // The run really wrapped
+}
+
+// Test: Uneven rates don't drift (interval kept in microseconds)
+void test_token_bucket_fractional_interval() {
+    ESPrawTokenBucketLimiter limiter(7, 1000, 1);
+    std::vector<unsigned long> sent = sendGreedily(limiter, 0, 1000000, 1);
+
+    // A 142 ms integer interval would allow 7042; polling once per ms
+    // only costs a few requests to sub-millisecond lateness
+    TEST_ASSERT_INT_WITHIN(7, 7000, (int)sent.size());
+    TEST_ASSERT_TRUE(sent.size() <= 7000);
+}
+
+// Test: Sliding window is exact: `limit` per window, no stale waits
+void test_sliding_window_exact() {
+    ESPrawSlidingWindowLimiter limiter(3, 10000);
+
+    limiter.recordRequest(0);
+    limiter.recordRequest(4000);
+    limiter.recordRequest(4500);
+    TEST_ASSERT_FALSE(limiter.canRequest(9999));
+    TEST_ASSERT_EQUAL_UINT32(1, limiter.timeUntilNextRequest(9999));
+    TEST_ASSERT_EQUAL(3, (int)limiter.getCount(9999));
+
+    // Frees up the instant the oldest request leaves the window
+    TEST_ASSERT_TRUE(limiter.canRequest(10000));
+    TEST_ASSERT_EQUAL(2, (int)limiter.getCount(10000));
+    limiter.recordRequest(10000);
+    TEST_ASSERT_EQUAL_UINT32(4000, limiter.timeUntilNextRequest(10000));
+
+    limiter.reset();
+    TEST_ASSERT_TRUE(limiter.canRequest(10000));
+}
+
+// Test: Sliding window never exceeds its limit, across millis() rollover
+void test_sliding_window_rollover() {
+    ESPrawSlidingWindowLimiter limiter(60, 60000);
+    std::vector<unsigned long> sent = sendGreedily(limiter, NEAR_WRAP, 600000, 7);
+
+    TEST_ASSERT_EQUAL(60, (int)maxInWindow(sent, 60000));
+    TEST_ASSERT_EQUAL(600, (int)sent.size());
+    TEST_ASSERT_TRUE(sent.back() < NEAR_WRAP);
+}
+
+// Test: All limiters can be used through the common interface
+void test_limiters_share_interface() {
+    ESPrawTokenBucketLimiter bucket(2, 1000, 2);
+    ESPrawSlidingWindowLimiter window(2, 1000);
+    ESPrawHeaderRateLimiter header;
+    header.update("0", "2", "1", 0);
+
+    ESPrawRateLimiter* limiters[] = { &bucket, &window, &header };
+    for (ESPrawRateLimiter* limiter : limiters) {
+        limiter->recordRequest(0);
+        limiter->recordRequest(0);
+        TEST_ASSERT_FALSE(limiter->canRequest(0));
+        TEST_ASSERT_TRUE(limiter->timeUntilNextRequest(0) > 0);
+        TEST_ASSERT_TRUE(limiter->canRequest(1000));
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_token_bucket_burst_then_rate);
+    RUN_TEST(test_token_bucket_rollover);
+    RUN_TEST(test_token_bucket_fractional_interval);
+    RUN_TEST(test_sliding_window_exact);
+    RUN_TEST(test_sliding_window_rollover);
+    RUN_TEST(test_limiters_share_interface);
+
+    return UNITY_END();
+}
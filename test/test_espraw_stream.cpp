@@ -0,0 +1,193 @@
+/**
+ * test_espraw_stream.cpp - Unit tests for streamed response bodies
+ * 
+ * Builds the real ESPrawBodyStream against the host Arduino stand-in and
+ * feeds it from a fake connection stream.
+ */
+
+#include <unity.h>
+#include <string>
+#include <cstring>
+#include <new>
+#include "ESPrawStream.h"
+
+// Allocation tracking: counts every operator new while armed
+static bool trackAllocations = false;
+static size_t allocationCount = 0;
+static size_t largestAllocation = 0;
+
+void* operator new(size_t size) {
+    if (trackAllocations) {
+        allocationCount++;
+        if (size > largestAllocation) {
+            largestAllocation = size;
+        }
+    }
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+// Fake connection stream serving a fixed byte buffer without allocating
+class FakeStream : public Stream {
+public:
+    FakeStream(const char* data, size_t length) : _data(data), _length(length), _pos(0) {
+        setTimeout(0);
+    }
+    
+    int available() override { return _length - _pos; }
+    int read() override { return _pos < _length ? (uint8_t)_data[_pos++] : -1; }
+    int peek() override { return _pos < _length ? (uint8_t)_data[_pos] : -1; }
+    size_t write(uint8_t) override { return 0; }
+    
+    size_t position() const { return _pos; }
+
+private:
+    const char* _data;
+    size_t _length;
+    size_t _pos;
+};
+
+// Encode a body with chunked transfer encoding
+static std::string chunkEncode(const std::string& body, size_t chunkSize) {
+    std::string out;
+    char line[32];
+    for (size_t pos = 0; pos < body.size(); pos += chunkSize) {
+        size_t n = body.size() - pos < chunkSize ? body.size() - pos : chunkSize;
+        snprintf(line, sizeof(line), "%zx\r\n", n);
+        out += line;
+        out += body.substr(pos, n);
+        out += "\r\n";
+    }
+    out += "0\r\n\r\n";
+    return out;
+}
+
+// Read a stream one byte at a time, the way ArduinoJson consumes it
+static std::string readAll(ESPrawBodyStream& body) {
+    std::string out;
+    char c;
+    while (body.readBytes(&c, 1) == 1) {
+        out += c;
+    }
+    return out;
+}
+
+// Test: Content-Length bodies stop at the declared length
+void test_content_length_body() {
+    const char* raw = "{\"kind\":\"Listing\"}HTTP/1.1 200 OK";
+    FakeStream source(raw, strlen(raw));
+    ESPrawBodyStream body(source, 18, false);
+    
+    TEST_ASSERT_EQUAL_STRING("{\"kind\":\"Listing\"}", readAll(body).c_str());
+    TEST_ASSERT_TRUE(body.isComplete());
+    TEST_ASSERT_EQUAL(18, body.bytesRead());
+    TEST_ASSERT_EQUAL(18, source.position());
+}
+
+// Test: Chunked bodies are decoded, including extensions and trailers
+void test_chunked_body() {
+    const char* raw = "5;ext=1\r\n{\"a\":\r\n4\r\n12}\n\r\n0\r\nX-Trailer: 1\r\n\r\nNEXT";
+    FakeStream source(raw, strlen(raw));
+    ESPrawBodyStream body(source, -1, true);
+    
+    // Only decoded body bytes count as available, never the chunk framing
+    TEST_ASSERT_EQUAL(0, body.available());
+    TEST_ASSERT_EQUAL('{', body.read());
+    TEST_ASSERT_EQUAL(4, body.available());
+    char head[4];
+    TEST_ASSERT_EQUAL(4, body.readBytes(head, 4));
+    TEST_ASSERT_EQUAL(0, body.available());
+    
+    TEST_ASSERT_EQUAL_STRING("12}\n", readAll(body).c_str());
+    TEST_ASSERT_TRUE(body.isComplete());
+    // The next response on a kept-alive connection must be left untouched
+    TEST_ASSERT_EQUAL(strlen(raw) - 4, source.position());
+}
+
+// Test: drain() consumes the rest of the body
+void test_drain_consumes_body() {
+    std::string raw = chunkEncode("{\"data\":{}}   ", 4) + "NEXT";
+    FakeStream source(raw.data(), raw.size());
+    ESPrawBodyStream body(source, -1, true);
+    
+    TEST_ASSERT_EQUAL('{', body.read());
+    body.drain();
+    
+    TEST_ASSERT_TRUE(body.isComplete());
+    TEST_ASSERT_EQUAL(-1, body.read());
+    TEST_ASSERT_EQUAL(raw.size() - 4, source.position());
+}
+
+// Test: Unknown-length bodies are read until the connection closes
+void test_unknown_length_body() {
+    const char* raw = "[1,2,3]";
+    FakeStream source(raw, strlen(raw));
+    ESPrawBodyStream body(source, -1, false);
+    
+    TEST_ASSERT_EQUAL('[', body.peek());
+    TEST_ASSERT_EQUAL_STRING("[1,2,3]", readAll(body).c_str());
+    TEST_ASSERT_TRUE(body.isComplete());
+}
+
+// Test: Streaming a large body never allocates a body-sized buffer
+void test_streaming_does_not_allocate_body() {
+    std::string listing = "{\"kind\":\"Listing\",\"data\":{\"children\":[";
+    while (listing.size() < 32768) {
+        listing += "{\"kind\":\"t3\",\"data\":{\"title\":\"Streaming from the socket\",\"score\":42}},";
+    }
+    listing += "{}]}}";
+    std::string raw = chunkEncode(listing, 1024);
+    
+    FakeStream source(raw.data(), raw.size());
+    
+    allocationCount = 0;
+    largestAllocation = 0;
+    trackAllocations = true;
+    
+    ESPrawBodyStream body(source, -1, true);
+    size_t total = 0;
+    unsigned long checksum = 0;
+    char c;
+    while (body.readBytes(&c, 1) == 1) {
+        checksum += (uint8_t)c;
+        total++;
+    }
+    
+    trackAllocations = false;
+    
+    unsigned long expected = 0;
+    for (size_t i = 0; i < listing.size(); i++) {
+        expected += (uint8_t)listing[i];
+    }
+    
+    TEST_ASSERT_EQUAL(listing.size(), total);
+    TEST_ASSERT_EQUAL_UINT32(expected, checksum);
+    TEST_ASSERT_EQUAL(0, allocationCount);
+    TEST_ASSERT_TRUE(largestAllocation < listing.size());
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_content_length_body);
+    RUN_TEST(test_chunked_body);
+    RUN_TEST(test_drain_consumes_body);
+    RUN_TEST(test_unknown_length_body);
+    RUN_TEST(test_streaming_does_not_allocate_body);
+    
+    return UNITY_END();
+}
@@ -0,0 +1,151 @@
+/**
+ * test_espraw_stringpool.cpp - Unit tests for the shared string pool
+ *
+ * Heap figures come from the counting allocator behind the host ESP
+ * stand-in.
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <Esp.h>
+#include <vector>
+#include "ESPrawStringPool.h"
+
+// Test: Equal strings share one copy
+void test_dedupe() {
+    ESPrawStringPool pool(8);
+
+    ESPrawInternedString first = pool.intern("esp32_projects");
+    ESPrawInternedString second = pool.intern("esp32_projects");
+    ESPrawInternedString other = pool.intern("arduino");
+
+    TEST_ASSERT_TRUE(first.isShared());
+    TEST_ASSERT_TRUE(&first.str() == &second.str());
+    TEST_ASSERT_EQUAL_STRING("esp32_projects", second.str().c_str());
+    TEST_ASSERT_EQUAL_STRING("arduino", other.str().c_str());
+    TEST_ASSERT_EQUAL(2, (int)pool.size());
+
+    const ESPrawStringPoolStats& stats = pool.getStats();
+    TEST_ASSERT_EQUAL(3, (int)stats.lookups);
+    TEST_ASSERT_EQUAL(1, (int)stats.hits);
+    TEST_ASSERT_EQUAL(15, (int)stats.bytesShared);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.333f, stats.dedupeRatio());
+
+    pool.resetStats();
+    TEST_ASSERT_EQUAL(0, (int)pool.getStats().lookups);
+}
+
+// Test: A string leaves the table when its last user goes
+void test_reference_counting() {
+    ESPrawStringPool pool(8);
+    {
+        ESPrawInternedString name = pool.intern("spez");
+        ESPrawInternedString copy(name);
+        ESPrawInternedString moved(std::move(copy));
+        ESPrawInternedString assigned;
+        assigned = moved;
+        TEST_ASSERT_FALSE(copy.isShared());
+        TEST_ASSERT_TRUE(&assigned.str() == &name.str());
+
+        assigned = ESPrawInternedString(String("own"));
+        TEST_ASSERT_FALSE(assigned.isShared());
+        TEST_ASSERT_EQUAL_STRING("own", assigned.str().c_str());
+        TEST_ASSERT_EQUAL(1, (int)pool.size());
+    }
+    TEST_ASSERT_EQUAL(0, (int)pool.size());
+
+    // The string comes back as a new entry
+    ESPrawInternedString again = pool.intern("spez");
+    TEST_ASSERT_EQUAL(1, (int)pool.size());
+    TEST_ASSERT_EQUAL(0, (int)pool.getStats().hits);
+}
+
+// Test: Full tables and long strings fall back to own copies
+void test_bounds() {
+    ESPrawStringPool pool(2, 8);
+
+    ESPrawInternedString a = pool.intern("a");
+    ESPrawInternedString b = pool.intern("b");
+    ESPrawInternedString c = pool.intern("c");
+    ESPrawInternedString longer = pool.intern("much_too_long");
+    ESPrawInternedString missing = pool.intern(nullptr);
+
+    TEST_ASSERT_TRUE(b.isShared());
+    TEST_ASSERT_FALSE(c.isShared());
+    TEST_ASSERT_FALSE(longer.isShared());
+    TEST_ASSERT_EQUAL_STRING("c", c.str().c_str());
+    TEST_ASSERT_EQUAL_STRING("much_too_long", longer.str().c_str());
+    TEST_ASSERT_EQUAL_STRING("", missing.str().c_str());
+    TEST_ASSERT_EQUAL(2, (int)pool.size());
+    TEST_ASSERT_EQUAL(2, (int)pool.getStats().rejected);
+    TEST_ASSERT_EQUAL(4, (int)pool.getStats().lookups);
+}
+
+// Test: Strings stay valid after the pool is destroyed
+void test_outlives_pool() {
+    ESPrawInternedString kept;
+    {
+        ESPrawStringPool pool(4);
+        kept = pool.intern("AskReddit");
+    }
+    TEST_ASSERT_EQUAL_STRING("AskReddit", kept.str().c_str());
+    ESPrawInternedString copy = kept;
+    TEST_ASSERT_TRUE(&copy.str() == &kept.str());
+}
+
+/**
+ * Keep the author and subreddit of a scanned r/all page
+ * @param pool String pool, or nullptr for own copies
+ * @return Heap bytes held by the fields
+ */
+static long scanAll(ESPrawStringPool* pool) {
+    const int items = 500;
+    std::vector<ESPrawInternedString> fields;
+    fields.reserve(items * 2);
+    long before = ESP.getThreadHeapUsed();
+
+    char author[32];
+    char subreddit[32];
+    for (int i = 0; i < items; i++) {
+        snprintf(author, sizeof(author), "long_time_lurker_%d", i % 100);
+        snprintf(subreddit, sizeof(subreddit), "popular_subreddit_%d", i % 25);
+        if (pool != nullptr) {
+            fields.push_back(pool->intern(author));
+            fields.push_back(pool->intern(subreddit));
+        } else {
+            fields.push_back(ESPrawInternedString(String(author)));
+            fields.push_back(ESPrawInternedString(String(subreddit)));
+        }
+    }
+
+    return ESP.getThreadHeapUsed() - before;
+}
+
+// Test: Pooling repeated fields holds a fraction of the heap
+void test_scanner_memory() {
+    long copied = scanAll(nullptr);
+
+    ESPrawStringPool pool;
+    long pooled = scanAll(&pool);
+
+    // 125 distinct strings among 1000 fields, released with them
+    TEST_ASSERT_EQUAL(125, (int)(pool.getStats().lookups - pool.getStats().hits));
+    TEST_ASSERT_EQUAL(0, (int)pool.size());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.875f, pool.getStats().dedupeRatio());
+    TEST_ASSERT_TRUE(pooled * 2 < copied);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_dedupe);
+    RUN_TEST(test_reference_counting);
+    RUN_TEST(test_bounds);
+    RUN_TEST(test_outlives_pool);
+    RUN_TEST(test_scanner_memory);
+
+    return UNITY_END();
+}
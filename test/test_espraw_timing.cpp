@@ -0,0 +1,109 @@
+/**
+ * test_espraw_timing.cpp - Unit tests for per-endpoint latency statistics
+ */
+
+#include <unity.h>
+#include "../src/ESPrawTiming.h"
+
+// Test: Durations land in power-of-two millisecond buckets
+void test_histogram_buckets() {
+    TEST_ASSERT_EQUAL(0, ESPrawLatencyHistogram::bucketFor(0));
+    TEST_ASSERT_EQUAL(0, ESPrawLatencyHistogram::bucketFor(999));
+    TEST_ASSERT_EQUAL(1, ESPrawLatencyHistogram::bucketFor(1000));
+    TEST_ASSERT_EQUAL(2, ESPrawLatencyHistogram::bucketFor(3999));
+    TEST_ASSERT_EQUAL(8, ESPrawLatencyHistogram::bucketFor(250000));
+    TEST_ASSERT_EQUAL(ESPRAW_LATENCY_BUCKETS - 1, ESPrawLatencyHistogram::bucketFor(600000000));
+
+    TEST_ASSERT_EQUAL(1000, ESPrawLatencyHistogram::bucketLimit(0));
+    TEST_ASSERT_EQUAL(256000, ESPrawLatencyHistogram::bucketLimit(8));
+}
+
+// Test: Percentiles report the upper bound of their bucket
+void test_histogram_percentile() {
+    ESPrawLatencyHistogram histogram;
+    TEST_ASSERT_EQUAL(0, histogram.percentile(50));
+
+    for (int i = 0; i < 90; i++) {
+        histogram.add(150000);    // 128-256 ms
+    }
+    for (int i = 0; i < 10; i++) {
+        histogram.add(3000000);   // 2-4 s
+    }
+
+    TEST_ASSERT_EQUAL(100, (int)histogram.count());
+    TEST_ASSERT_EQUAL(256000, histogram.percentile(50));
+    TEST_ASSERT_EQUAL(256000, histogram.percentile(90));
+    TEST_ASSERT_EQUAL(4096000, histogram.percentile(95));
+    TEST_ASSERT_EQUAL(4096000, histogram.percentile(100));
+    TEST_ASSERT_EQUAL(3000000, (int)histogram.lastMicros);
+}
+
+// Test: Counts are halved every window so recent samples dominate
+void test_histogram_decay() {
+    ESPrawLatencyHistogram histogram;
+    for (int i = 0; i < ESPRAW_LATENCY_WINDOW; i++) {
+        histogram.add(500);
+    }
+    TEST_ASSERT_EQUAL(ESPRAW_LATENCY_WINDOW / 2, (int)histogram.count());
+
+    for (int i = 0; i < ESPRAW_LATENCY_WINDOW * 3; i++) {
+        histogram.add(20000);
+    }
+    TEST_ASSERT_EQUAL(32000, histogram.percentile(90));
+    TEST_ASSERT_EQUAL(ESPRAW_LATENCY_WINDOW * 4, (int)histogram.samples);
+}
+
+// Test: URLs are folded into endpoints without names, ids or queries
+void test_normalize_endpoint() {
+    const char* base = "https://oauth.reddit.com";
+    TEST_ASSERT_EQUAL_STRING("/r/{}/hot",
+        ESPrawLatencyTracker::normalizeEndpoint("https://oauth.reddit.com/r/esp32/hot?limit=25", base).c_str());
+    TEST_ASSERT_EQUAL_STRING("/comments/{}",
+        ESPrawLatencyTracker::normalizeEndpoint("https://oauth.reddit.com/comments/abc123", base).c_str());
+    TEST_ASSERT_EQUAL_STRING("/r/{}/comments/{}/{}",
+        ESPrawLatencyTracker::normalizeEndpoint("https://oauth.reddit.com/r/esp32/comments/abc/title", base).c_str());
+    TEST_ASSERT_EQUAL_STRING("/user/{}/about",
+        ESPrawLatencyTracker::normalizeEndpoint("https://oauth.reddit.com/user/spez/about", base).c_str());
+    TEST_ASSERT_EQUAL_STRING("/api/v1/me",
+        ESPrawLatencyTracker::normalizeEndpoint("https://oauth.reddit.com/api/v1/me", base).c_str());
+    TEST_ASSERT_EQUAL_STRING("/by_id/{}",
+        ESPrawLatencyTracker::normalizeEndpoint("http://127.0.0.1:8080/by_id/t3_a,t3_b", "http://127.0.0.1:8080").c_str());
+}
+
+// Test: A full tracker replaces its least recently used endpoint
+void test_tracker_replaces_least_recent() {
+    ESPrawLatencyTracker tracker;
+    for (int i = 0; i < ESPRAW_LATENCY_ENDPOINTS; i++) {
+        tracker.record("/endpoint/" + String(i), 1000);
+    }
+    TEST_ASSERT_EQUAL(ESPRAW_LATENCY_ENDPOINTS, (int)tracker.size());
+
+    // Touch the oldest one so the second oldest goes instead
+    tracker.record("/endpoint/0", 2000);
+    tracker.record("/api/v1/me", 3000);
+
+    TEST_ASSERT_EQUAL(ESPRAW_LATENCY_ENDPOINTS, (int)tracker.size());
+    TEST_ASSERT_NOT_NULL(tracker.find("/endpoint/0"));
+    TEST_ASSERT_NULL(tracker.find("/endpoint/1"));
+    TEST_ASSERT_EQUAL(2, (int)tracker.find("/endpoint/0")->samples);
+    TEST_ASSERT_EQUAL(1, (int)tracker.find("/api/v1/me")->samples);
+
+    tracker.reset();
+    TEST_ASSERT_EQUAL(0, (int)tracker.size());
+    TEST_ASSERT_NULL(tracker.find("/api/v1/me"));
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_histogram_buckets);
+    RUN_TEST(test_histogram_percentile);
+    RUN_TEST(test_histogram_decay);
+    RUN_TEST(test_normalize_endpoint);
+    RUN_TEST(test_tracker_replaces_least_recent);
+
+    return UNITY_END();
+}
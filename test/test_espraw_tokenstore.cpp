@@ -0,0 +1,121 @@
+/**
+ * test_espraw_tokenstore.cpp - Unit tests for persistent token storage
+ *
+ * Builds the real ESPrawTokenStore against the host Arduino stand-in and
+ * keeps tokens in a temporary file.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include "ESPrawTokenStore.h"
+
+static const char* STORE_PATH = "test_espraw_tokenstore.tmp";
+static const uint64_t NOW = 1700000000ULL;
+
+static ESPrawToken makeToken(unsigned long validFor) {
+    ESPrawToken token;
+    token.accessToken = "abc123";
+    token.tokenType = "bearer";
+    token.scope = "*";
+    token.expiresAt = millis() / 1000 + validFor;
+    token.isValid = true;
+    return token;
+}
+
+// Test: Expiry is converted to wall-clock time and back
+void test_capture_and_restore() {
+    ESPrawStoredToken stored = ESPrawStoredToken::capture(makeToken(3000), "client:user", NOW);
+    TEST_ASSERT_EQUAL_STRING("client:user", stored.owner.c_str());
+    TEST_ASSERT_TRUE(stored.expiresAt >= NOW + 2999 && stored.expiresAt <= NOW + 3000);
+
+    // After a reboot 1000 s later the token has the rest of its validity
+    ESPrawToken token = stored.restore(NOW + 1000);
+    TEST_ASSERT_TRUE(token.isValid);
+    TEST_ASSERT_FALSE(token.isExpired());
+    TEST_ASSERT_EQUAL_STRING("abc123", token.accessToken.c_str());
+    TEST_ASSERT_UINT32_WITHIN(1, 2000, token.remainingValidity());
+
+    // Too late: the token has expired on the wall clock
+    TEST_ASSERT_FALSE(stored.restore(NOW + 3000).isValid);
+    TEST_ASSERT_FALSE(ESPrawStoredToken().restore(NOW).isValid);
+}
+
+// Test: File store round-trips a token and forgets it on clear()
+void test_file_store_round_trip() {
+    ESPrawFileTokenStore store(STORE_PATH);
+    ESPrawStoredToken loaded;
+
+    store.clear();
+    TEST_ASSERT_FALSE(store.load(loaded));
+
+    ESPrawStoredToken saved = ESPrawStoredToken::capture(makeToken(3600), "client", NOW);
+    saved.scope = ""; // Empty fields survive too
+    TEST_ASSERT_TRUE(store.save(saved));
+
+    TEST_ASSERT_TRUE(store.load(loaded));
+    TEST_ASSERT_EQUAL_STRING("client", loaded.owner.c_str());
+    TEST_ASSERT_EQUAL_STRING("abc123", loaded.accessToken.c_str());
+    TEST_ASSERT_EQUAL_STRING("bearer", loaded.tokenType.c_str());
+    TEST_ASSERT_EQUAL_STRING("", loaded.scope.c_str());
+    TEST_ASSERT_TRUE(loaded.expiresAt == saved.expiresAt);
+
+    store.clear();
+    TEST_ASSERT_FALSE(store.load(loaded));
+}
+
+// Test: The token file is readable by its owner only
+void test_file_store_is_private() {
+    ESPrawFileTokenStore store(STORE_PATH);
+    ESPrawStoredToken saved = ESPrawStoredToken::capture(makeToken(3600), "client", NOW);
+
+    // An existing file with a wider mode is narrowed as well
+    FILE* file = fopen(STORE_PATH, "w");
+    TEST_ASSERT_NOT_NULL(file);
+    fclose(file);
+    TEST_ASSERT_EQUAL(0, chmod(STORE_PATH, 0644));
+
+    TEST_ASSERT_TRUE(store.save(saved));
+    struct stat info;
+    TEST_ASSERT_EQUAL(0, stat(STORE_PATH, &info));
+    TEST_ASSERT_EQUAL_HEX(0600, info.st_mode & 0777);
+
+    store.clear();
+    TEST_ASSERT_TRUE(store.save(saved));
+    TEST_ASSERT_EQUAL(0, stat(STORE_PATH, &info));
+    TEST_ASSERT_EQUAL_HEX(0600, info.st_mode & 0777);
+
+    store.clear();
+}
+
+// Test: A truncated file is not mistaken for a token
+void test_file_store_rejects_truncated_file() {
+    FILE* file = fopen(STORE_PATH, "w");
+    fputs("client\nabc123\n", file);
+    fclose(file);
+
+    ESPrawFileTokenStore store(STORE_PATH);
+    ESPrawStoredToken loaded;
+    TEST_ASSERT_FALSE(store.load(loaded));
+    store.clear();
+}
+
+// Test: The host clock counts as set
+void test_wall_clock() {
+    TEST_ASSERT_TRUE(ESPrawStoredToken::wallClock() >= ESPRAW_MIN_WALL_CLOCK);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_capture_and_restore);
+    RUN_TEST(test_file_store_round_trip);
+    RUN_TEST(test_file_store_is_private);
+    RUN_TEST(test_file_store_rejects_truncated_file);
+    RUN_TEST(test_wall_clock);
+
+    return UNITY_END();
+}
@@ -0,0 +1,178 @@
+/**
+ * test_espraw_transport.cpp - Unit tests for ESPraw transports
+ *
+ * ESPrawHttpTransport runs over the host HAL against the local stand-in
+ * server; ESPrawReplayTransport needs no network at all.
+ */
+
+#include <unity.h>
+#include <string>
+#include "standin_server.h"
+#include "../src/ESPrawTransport.h"
+
+static String urlFor(const StandinServer& server, const char* path) {
+    return String("http://127.0.0.1:") + String(server.port()) + path;
+}
+
+// Test: Base URLs split into scheme, host, port and path prefix
+void test_url_parse() {
+    ESPrawUrl url;
+    TEST_ASSERT_TRUE(ESPrawUrl::parse("https://oauth.reddit.com", url));
+    TEST_ASSERT_TRUE(url.secure);
+    TEST_ASSERT_EQUAL_STRING("oauth.reddit.com", url.host.c_str());
+    TEST_ASSERT_EQUAL(443, url.port);
+    TEST_ASSERT_EQUAL_STRING("", url.path.c_str());
+
+    TEST_ASSERT_TRUE(ESPrawUrl::parse("http://127.0.0.1:8080/reddit/", url));
+    TEST_ASSERT_FALSE(url.secure);
+    TEST_ASSERT_EQUAL_STRING("127.0.0.1", url.host.c_str());
+    TEST_ASSERT_EQUAL(8080, url.port);
+    TEST_ASSERT_EQUAL_STRING("/reddit", url.path.c_str());
+
+    TEST_ASSERT_FALSE(ESPrawUrl::parse("ftp://example.com", url));
+    TEST_ASSERT_FALSE(ESPrawUrl::parse("http://", url));
+    TEST_ASSERT_FALSE(ESPrawUrl::parse("http://host:0", url));
+}
+
+// Test: Connection setup is timed for new connections only
+void test_http_transport_timing() {
+    StandinServer server;
+    server.body = "{}";
+    TEST_ASSERT_TRUE(server.start());
+
+    ESPrawHttpTransport transport;
+    transport.setKeepAlive(true);
+
+    TEST_ASSERT_EQUAL(200, transport.send(ESPrawRequestMethod::GET, urlFor(server, "/api/v1/me"), "", ""));
+    ESPrawTiming fresh;
+    transport.addTiming(fresh);
+    transport.getString();
+    transport.end();
+    TEST_ASSERT_TRUE(fresh.connect > 0);
+
+    TEST_ASSERT_EQUAL(200, transport.send(ESPrawRequestMethod::GET, urlFor(server, "/api/v1/me"), "", ""));
+    ESPrawTiming reused;
+    transport.addTiming(reused);
+    transport.getString();
+    transport.end();
+    TEST_ASSERT_EQUAL(0, (int)reused.dns);
+    TEST_ASSERT_EQUAL(0, (int)reused.connect);
+    TEST_ASSERT_EQUAL(1, server.acceptedConnections.load());
+}
+
+// Test: The HTTP transport sends header lines and reuses the connection
+void test_http_transport_keep_alive() {
+    StandinServer server;
+    server.body = "{\"kind\":\"Listing\"}";
+    server.extraHeaders = "Retry-After: 7\r\n";
+    TEST_ASSERT_TRUE(server.start());
+
+    ESPrawHttpTransport transport;
+    transport.setKeepAlive(true);
+    for (int i = 0; i < 3; i++) {
+        int code = transport.send(ESPrawRequestMethod::GET, urlFor(server, "/r/esp32/hot"),
+                                  "User-Agent: ESPraw-test\r\nAuthorization: bearer abc\r\n", "");
+        TEST_ASSERT_EQUAL(200, code);
+        TEST_ASSERT_EQUAL_STRING("7", transport.header("Retry-After").c_str());
+        TEST_ASSERT_EQUAL(18, transport.getSize());
+        TEST_ASSERT_EQUAL_STRING("{\"kind\":\"Listing\"}", transport.getString().c_str());
+        transport.end();
+        TEST_ASSERT_TRUE(transport.connected());
+    }
+
+    TEST_ASSERT_EQUAL(1, server.acceptedConnections.load());
+    std::string request = server.lastRequest();
+    TEST_ASSERT_TRUE(request.find("GET /r/esp32/hot HTTP/1.1") == 0);
+    TEST_ASSERT_TRUE(request.find("User-Agent: ESPraw-test\r\n") != std::string::npos);
+    TEST_ASSERT_TRUE(request.find("Authorization: bearer abc") != std::string::npos);
+
+    transport.stop();
+    TEST_ASSERT_FALSE(transport.connected());
+}
+
+// Test: POST bodies go out; without keep-alive each request connects anew
+void test_http_transport_post() {
+    StandinServer server;
+    TEST_ASSERT_TRUE(server.start());
+
+    ESPrawHttpTransport transport;
+    transport.setKeepAlive(false);
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL(200, transport.send(ESPrawRequestMethod::POST, urlFor(server, "/api/vote"),
+                                              "Content-Type: application/x-www-form-urlencoded\r\n",
+                                              "dir=1&id=t3_abc"));
+        transport.end();
+    }
+
+    TEST_ASSERT_EQUAL(2, server.acceptedConnections.load());
+    std::string request = server.lastRequest();
+    TEST_ASSERT_TRUE(request.find("POST /api/vote HTTP/1.1") == 0);
+    TEST_ASSERT_TRUE(request.find("Content-Length: 15") != std::string::npos);
+}
+
+// Test: Recorded responses are matched by path prefix, others get 404
+void test_replay_transport_matching() {
+    ESPrawReplayTransport replay;
+    replay.addResponse("/r/esp32/hot", 200, "{\"kind\":\"Listing\"}",
+                       "X-Ratelimit-Remaining: 99\r\nRetry-After: 3\r\n");
+    replay.addResponse("/api/vote", 200, "{}");
+
+    TEST_ASSERT_EQUAL(200, replay.send(ESPrawRequestMethod::GET,
+                                       "https://oauth.reddit.com/r/esp32/hot?limit=5", "", ""));
+    TEST_ASSERT_EQUAL_STRING("GET /r/esp32/hot?limit=5", replay.getLastRequest().c_str());
+    TEST_ASSERT_EQUAL_STRING("99", replay.header("x-ratelimit-remaining").c_str());
+    TEST_ASSERT_EQUAL_STRING("3", replay.header("Retry-After").c_str());
+    TEST_ASSERT_EQUAL_STRING("", replay.header("X-Ratelimit-Used").c_str());
+    TEST_ASSERT_EQUAL(18, replay.getSize());
+    TEST_ASSERT_EQUAL_STRING("{\"kind\":\"Listing\"}", replay.getString().c_str());
+    replay.end();
+
+    TEST_ASSERT_EQUAL(404, replay.send(ESPrawRequestMethod::DELETE_METHOD,
+                                       "https://oauth.reddit.com/api/del", "", ""));
+    TEST_ASSERT_EQUAL_STRING("DELETE /api/del", replay.getLastRequest().c_str());
+    TEST_ASSERT_EQUAL_STRING("", replay.getString().c_str());
+    replay.end();
+
+    TEST_ASSERT_EQUAL(2, (int)replay.getRequestCount());
+    replay.clear();
+    TEST_ASSERT_EQUAL(0, (int)replay.getRequestCount());
+    TEST_ASSERT_EQUAL(404, replay.send(ESPrawRequestMethod::POST, "/api/vote", "", "dir=1"));
+}
+
+// Test: The replay body can be streamed, and connected() follows stop()
+void test_replay_transport_stream() {
+    ESPrawReplayTransport replay;
+    replay.addResponse("/", 200, "abcdef");
+    TEST_ASSERT_FALSE(replay.connected());
+
+    TEST_ASSERT_EQUAL(200, replay.send(ESPrawRequestMethod::GET, "http://localhost/x", "", ""));
+    TEST_ASSERT_TRUE(replay.connected());
+
+    Stream& stream = replay.getStream();
+    TEST_ASSERT_EQUAL('a', stream.read());
+    TEST_ASSERT_EQUAL('b', stream.peek());
+    char buffer[8] = { 0 };
+    TEST_ASSERT_EQUAL(5, (int)stream.readBytes(buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_STRING("bcdef", buffer);
+    TEST_ASSERT_EQUAL(-1, stream.read());
+    replay.end();
+
+    replay.stop();
+    TEST_ASSERT_FALSE(replay.connected());
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_url_parse);
+    RUN_TEST(test_http_transport_keep_alive);
+    RUN_TEST(test_http_transport_timing);
+    RUN_TEST(test_http_transport_post);
+    RUN_TEST(test_replay_transport_matching);
+    RUN_TEST(test_replay_transport_stream);
+
+    return UNITY_END();
+}
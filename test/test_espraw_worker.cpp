@@ -0,0 +1,196 @@
+/**
+ * test_espraw_worker.cpp - Unit tests for the worker task and its rings
+ *
+ * Builds the real ESPrawWorker against the host Arduino stand-in, where the
+ * worker task is a std::thread, and replaces the network with a fake
+ * executor.
+ */
+
+#include <unity.h>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <string>
+#include "ESPrawWorker.h"
+
+// Test: Ring keeps FIFO order, reports full/empty and survives counter wrap
+void test_ring_fifo_and_bounds() {
+    ESPrawSpscRing<int, 4> ring;
+    int value = 0;
+
+    TEST_ASSERT_FALSE(ring.pop(value));
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(ring.push(i));
+    }
+    TEST_ASSERT_FALSE(ring.push(99));
+    TEST_ASSERT_EQUAL(4, (int)ring.size());
+
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(ring.pop(value));
+        TEST_ASSERT_EQUAL(i, value);
+    }
+    TEST_ASSERT_FALSE(ring.pop(value));
+
+    // Many cycles move the free-running indices well past the capacity
+    for (int i = 0; i < 10000; i++) {
+        TEST_ASSERT_TRUE(ring.push(i));
+        TEST_ASSERT_TRUE(ring.pop(value));
+        TEST_ASSERT_EQUAL(i, value);
+    }
+}
+
+// Test: Ring hands values across threads in order without loss
+void test_ring_across_threads() {
+    static ESPrawSpscRing<uint32_t, 8> ring;
+    const uint32_t COUNT = 200000;
+
+    std::thread producer([]() {
+        for (uint32_t i = 0; i < COUNT; i++) {
+            while (!ring.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    while (expected < COUNT) {
+        uint32_t value;
+        if (ring.pop(value)) {
+            ordered = ordered && value == expected;
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL(0, (int)ring.size());
+}
+
+// Poll until the given number of jobs has been delivered (or give up)
+static int pollUntil(ESPrawWorker& worker, int count) {
+    int delivered = 0;
+    for (int i = 0; i < 5000 && delivered < count; i++) {
+        delivered += worker.poll();
+        if (delivered < count) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    return delivered;
+}
+
+// Test: Jobs run on the worker thread; callbacks run in poll() on the caller
+void test_worker_runs_jobs_off_thread() {
+    std::thread::id mainThread = std::this_thread::get_id();
+    std::atomic<int> offThread(0);
+
+    ESPrawWorker worker([&](ESPrawWorkerJob& job) {
+        if (std::this_thread::get_id() != mainThread) {
+            offThread++;
+        }
+        job.response.statusCode = 200;
+        job.response.success = true;
+        job.response.body = job.endpoint + "?" + job.params;
+    });
+    TEST_ASSERT_TRUE(worker.begin());
+    TEST_ASSERT_TRUE(worker.isRunning());
+
+    std::vector<std::string> bodies;
+    bool callbacksOnMain = true;
+    ESPrawWorkerCallback callback = [&](uint32_t, const ESPrawResponse& response) {
+        callbacksOnMain = callbacksOnMain && std::this_thread::get_id() == mainThread;
+        bodies.push_back(response.body.c_str());
+    };
+
+    uint32_t first = worker.get("/r/a/hot", "limit=1", callback);
+    uint32_t second = worker.get("/r/b/new", "limit=2", callback);
+    TEST_ASSERT_NOT_EQUAL(0, first);
+    TEST_ASSERT_NOT_EQUAL(first, second);
+
+    TEST_ASSERT_EQUAL(2, pollUntil(worker, 2));
+    TEST_ASSERT_EQUAL(0, worker.pending());
+    TEST_ASSERT_EQUAL(2, offThread.load());
+    TEST_ASSERT_TRUE(callbacksOnMain);
+    TEST_ASSERT_EQUAL(2, (int)bodies.size());
+    TEST_ASSERT_EQUAL_STRING("/r/a/hot?limit=1", bodies[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("/r/b/new?limit=2", bodies[1].c_str());
+
+    worker.stop();
+    TEST_ASSERT_FALSE(worker.isRunning());
+    TEST_ASSERT_EQUAL(0, worker.get("/r/a/hot"));
+}
+
+// Test: The queue is bounded and slots come back once results are delivered
+void test_worker_queue_is_bounded() {
+    std::atomic<bool> release(false);
+    ESPrawWorker worker([&](ESPrawWorkerJob& job) {
+        while (!release) {
+            std::this_thread::yield();
+        }
+        job.response.success = true;
+    });
+    TEST_ASSERT_TRUE(worker.begin());
+
+    for (int i = 0; i < ESPRAW_WORKER_QUEUE_SIZE; i++) {
+        TEST_ASSERT_NOT_EQUAL(0, worker.get("/hot"));
+    }
+    TEST_ASSERT_EQUAL(0, worker.get("/hot"));
+    TEST_ASSERT_EQUAL(ESPRAW_WORKER_QUEUE_SIZE, worker.pending());
+
+    release = true;
+    TEST_ASSERT_EQUAL(ESPRAW_WORKER_QUEUE_SIZE, pollUntil(worker, ESPRAW_WORKER_QUEUE_SIZE));
+    TEST_ASSERT_EQUAL(0, worker.pending());
+    TEST_ASSERT_NOT_EQUAL(0, worker.get("/hot"));
+    TEST_ASSERT_EQUAL(1, pollUntil(worker, 1));
+}
+
+// Test: Body handlers run on the worker and their results reach the caller
+void test_worker_parses_on_worker_thread() {
+    ESPrawWorker worker([](ESPrawWorkerJob& job) {
+        // Stand-in for getStream(): hand the handler a body stream
+        class BodyStream : public Stream {
+        public:
+            explicit BodyStream(const char* data) : _data(data) {}
+            int available() override { return strlen(_data); }
+            int read() override { return *_data ? (uint8_t)*_data++ : -1; }
+            int peek() override { return *_data ? (uint8_t)*_data : -1; }
+            size_t write(uint8_t) override { return 0; }
+        private:
+            const char* _data;
+        } body("42 comments");
+        job.response.success = job.handler(body);
+    });
+    TEST_ASSERT_TRUE(worker.begin());
+
+    int parsed = 0; // Written on the worker, read after delivery
+    bool success = false;
+    worker.get("/comments/abc", "", [&](uint32_t, const ESPrawResponse& response) {
+        success = response.success;
+    }, [&parsed](Stream& body) {
+        while (body.peek() >= '0' && body.peek() <= '9') {
+            parsed = parsed * 10 + (body.read() - '0');
+        }
+        return parsed > 0;
+    });
+
+    TEST_ASSERT_EQUAL(1, pollUntil(worker, 1));
+    TEST_ASSERT_TRUE(success);
+    TEST_ASSERT_EQUAL(42, parsed);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_ring_fifo_and_bounds);
+    RUN_TEST(test_ring_across_threads);
+    RUN_TEST(test_worker_runs_jobs_off_thread);
+    RUN_TEST(test_worker_queue_is_bounded);
+    RUN_TEST(test_worker_parses_on_worker_thread);
+
+    return UNITY_END();
+}